@@ -0,0 +1,136 @@
+#include "BundleAdjustmentModel.h"
+#include "RigTransformCache.h"
+
+#include "benchmark/benchmark.h"
+
+using BundleAdjustment::BundleAdjustmentModel;
+using BundleAdjustment::NumberOfCameraParameters;
+using BundleAdjustment::NumberOfPoseParameters;
+
+namespace {
+// Parameter blocks of a non-reference camera on a multi-camera platform
+struct CollinearityParameters {
+  double camera[NumberOfCameraParameters] = {
+      0.1, -0.2, 50.0, 0.0, 1e-5, 1e-8, 1e-11, 1e-4, 2e-4, 1e-5, 1e-4, 2e-4};
+  double point[3] = {100.0, 200.0, 5.0};
+  double bodyFrame[NumberOfPoseParameters] = {95.0, 210.0, 1000.0,
+                                              0.02, -0.03, 0.5};
+  double refCameraToBodyFrame[NumberOfPoseParameters] = {0.1,   0.2,  -0.3,
+                                                         0.01, 0.02, 0.03};
+  double nonRefCameraToRefCamera[NumberOfPoseParameters] = {0.3,   -0.1, 0.05,
+                                                            0.15, -0.05, 0.1};
+};
+
+/**
+ * Evaluate the given cost function once per iteration, and report the
+ * evaluation time per residual block
+ * @param[in] withJacobians Flag to evaluate Jacobians as well
+ * @param[in] withCameraJacobian Flag to evaluate the Jacobian of the camera
+ * IOPs (i.e., unset for constant IOPs, which ceres skips)
+ */
+template <typename TRotation = BundleAdjustment::EulerAnglesRotation>
+void RunCostFunction(benchmark::State &state,
+                     const ceres::CostFunction &costFunction,
+                     const bool withJacobians,
+                     const bool withCameraJacobian = true) {
+  constexpr int PoseSize =
+      BundleAdjustment::GetNumberOfPoseParameters<TRotation>();
+  CollinearityParameters params;
+  // Convert the poses to the given rotation parameterization
+  const double *eulerPoses[] = {params.bodyFrame, params.refCameraToBodyFrame,
+                                params.nonRefCameraToRefCamera};
+  double poses[3][PoseSize];
+  for (unsigned int i = 0; i < 3; ++i) {
+    std::copy(eulerPoses[i], eulerPoses[i] + 3, poses[i]);
+    TRotation::FromEulerAngles(eulerPoses[i] + 3, poses[i] + 3);
+  }
+  double *parameters[] = {params.camera, params.point, poses[0], poses[1],
+                          poses[2]};
+  double cameraJacobian[2 * NumberOfCameraParameters];
+  double pointJacobian[2 * 3];
+  double bodyFrameJacobian[2 * PoseSize];
+  double refCameraJacobian[2 * PoseSize];
+  double nonRefCameraJacobian[2 * PoseSize];
+  double *jacobians[] = {withCameraJacobian ? cameraJacobian : nullptr,
+                         pointJacobian, bodyFrameJacobian, refCameraJacobian,
+                         nonRefCameraJacobian};
+  double residuals[2];
+  for (auto _ : state) {
+    costFunction.Evaluate(parameters, residuals,
+                          withJacobians ? jacobians : nullptr);
+    benchmark::DoNotOptimize(residuals);
+    benchmark::DoNotOptimize(cameraJacobian);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["TimePerResidual"] = benchmark::Counter(
+      static_cast<double>(state.iterations()),
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+} // namespace
+
+static void BM_CollinearityAutoDiffCost(benchmark::State &state) {
+  std::unique_ptr<ceres::CostFunction> costFunction(
+      BundleAdjustmentModel::CollinearityFrameCameraCost::Create(
+          Eigen::Vector2d(2.5, -1.5)));
+  RunCostFunction(state, *costFunction, state.range(0) != 0);
+}
+BENCHMARK(BM_CollinearityAutoDiffCost)->Arg(0)->Arg(1);
+
+/// Arg: 0 = residuals only, 1 = with Jacobians, 2 = with Jacobians except
+/// the (constant) camera IOPs
+static void BM_CollinearityAnalyticCost(benchmark::State &state) {
+  BundleAdjustmentModel::CollinearityFrameCameraAnalyticCost costFunction(
+      Eigen::Vector2d(2.5, -1.5));
+  RunCostFunction(state, costFunction, state.range(0) != 0,
+                  state.range(0) != 2);
+}
+BENCHMARK(BM_CollinearityAnalyticCost)->Arg(0)->Arg(1)->Arg(2);
+
+/// Image point corrected for the distortions up front; Arg: see
+/// BM_CollinearityAnalyticCost
+static void BM_CollinearityDistortionFreeCost(benchmark::State &state) {
+  BundleAdjustmentModel::CollinearityDistortionFreeCost<
+      BundleAdjustment::EulerAnglesRotation>
+      costFunction(Eigen::Vector2d(2.5, -1.5));
+  RunCostFunction(state, costFunction, state.range(0) != 0,
+                  state.range(0) != 2);
+}
+BENCHMARK(BM_CollinearityDistortionFreeCost)->Arg(0)->Arg(1)->Arg(2);
+
+/// Transformation read from an up-to-date RigTransformCache (i.e., the cost
+/// per residual block within a solver iteration); Arg: see
+/// BM_CollinearityAnalyticCost
+static void BM_CollinearityCachedCost(benchmark::State &state) {
+  CollinearityParameters params;
+  BundleAdjustment::RigTransformCache<BundleAdjustment::EulerAnglesRotation>
+      cache;
+  const std::size_t index =
+      cache.addRigTransform(params.bodyFrame, params.refCameraToBodyFrame,
+                            params.nonRefCameraToRefCamera);
+  cache.update(state.range(0) != 0);
+  BundleAdjustment::CollinearityCachedCost<
+      BundleAdjustment::EulerAnglesRotation>
+      costFunction(cache, index, Eigen::Vector2d(2.5, -1.5),
+                   Eigen::Matrix2d::Identity());
+  RunCostFunction(state, costFunction, state.range(0) != 0,
+                  state.range(0) != 2);
+}
+BENCHMARK(BM_CollinearityCachedCost)->Arg(0)->Arg(1)->Arg(2);
+
+static void BM_CollinearityAngleAxisAnalyticCost(benchmark::State &state) {
+  using BundleAdjustment::AngleAxisRotation;
+  BundleAdjustmentModel::CollinearityAnalyticCost<AngleAxisRotation>
+      costFunction(Eigen::Vector2d(2.5, -1.5));
+  RunCostFunction<AngleAxisRotation>(state, costFunction, state.range(0) != 0);
+}
+BENCHMARK(BM_CollinearityAngleAxisAnalyticCost)->Arg(0)->Arg(1);
+
+static void BM_CollinearityQuaternionAnalyticCost(benchmark::State &state) {
+  using BundleAdjustment::QuaternionRotation;
+  BundleAdjustmentModel::CollinearityAnalyticCost<QuaternionRotation>
+      costFunction(Eigen::Vector2d(2.5, -1.5));
+  RunCostFunction<QuaternionRotation>(state, costFunction,
+                                      state.range(0) != 0);
+}
+BENCHMARK(BM_CollinearityQuaternionAnalyticCost)->Arg(0)->Arg(1);
@@ -0,0 +1,74 @@
+#include "ProjectionKernel.h"
+
+#include "benchmark/benchmark.h"
+
+using BundleAdjustment::BundleAdjustmentModel;
+using BundleAdjustment::ProjectionKernel;
+
+namespace {
+// Parameter blocks of a non-reference camera on a multi-camera platform
+const double Camera[12] = {0.1, -0.2, 50.0, 0.0, 1e-5, 1e-8,
+                           1e-11, 1e-4, 2e-4, 1e-5, 1e-4, 2e-4};
+const double BodyFrame[6] = {95.0, 210.0, 1000.0, 0.02, -0.03, 0.5};
+const double RefCameraToBodyFrame[6] = {0.1, 0.2, -0.3, 0.01, 0.02, 0.03};
+const double NonRefCameraToRefCamera[6] = {0.3, -0.1, 0.05, 0.15, -0.05, 0.1};
+
+/// 2^16 object points below the camera (i.e., in the layout of the object
+/// point section of Core::ParameterArena)
+std::vector<double> PrepareObjectPoints() {
+  const std::size_t number = 1 << 16;
+  std::vector<double> objectPoints(3 * number);
+  for (std::size_t i = 0; i < number; ++i) {
+    objectPoints[3 * i] = 100.0 * ((i * 37) % number) / number;
+    objectPoints[3 * i + 1] = 200.0 + 100.0 * ((i * 53) % number) / number;
+    objectPoints[3 * i + 2] = 5.0 * (i % 3);
+  }
+  return objectPoints;
+}
+} // namespace
+
+/// One ComputeCollinearityProjection per object point (reference)
+static void BM_ComputeCollinearityProjection(benchmark::State &state) {
+  const std::vector<double> objectPoints = PrepareObjectPoints();
+  const std::size_t size = objectPoints.size() / 3;
+  std::vector<double> x(size);
+  std::vector<double> y(size);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < size; ++i) {
+      double projection[2];
+      BundleAdjustmentModel::ComputeCollinearityProjection(
+          Camera, objectPoints.data() + 3 * i, BodyFrame, RefCameraToBodyFrame,
+          NonRefCameraToRefCamera, projection);
+      x[i] = projection[0];
+      y[i] = projection[1];
+    }
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ComputeCollinearityProjection);
+
+/// Arg: 0 = scalar, 1 = AVX2, 2 = AVX-512 (skipped if not supported)
+static void BM_ProjectionKernel(benchmark::State &state) {
+  const auto instructionSet =
+      static_cast<ProjectionKernel::InstructionSet>(state.range(0));
+  if (!ProjectionKernel::IsSupported(instructionSet)) {
+    state.SkipWithError("The instruction set is not supported");
+    return;
+  }
+  const std::vector<double> objectPoints = PrepareObjectPoints();
+  const std::size_t size = objectPoints.size() / 3;
+  std::vector<double> x(size);
+  std::vector<double> y(size);
+  for (auto _ : state) {
+    ProjectionKernel kernel = ProjectionKernel::Create(
+        Camera, BodyFrame, RefCameraToBodyFrame, NonRefCameraToRefCamera);
+    kernel.setInstructionSet(instructionSet);
+    kernel.project(size, objectPoints.data(), x.data(), y.data());
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ProjectionKernel)->Arg(0)->Arg(1)->Arg(2);
@@ -0,0 +1,548 @@
+/**
+ * End-to-end scaling benchmark of the bundle adjustment.
+ * For every size (number of images), a synthetic block is generated (see
+ * Core::SyntheticBlockGenerator), its object points and EOPs are perturbed
+ * (except the datum, i.e., the images of the first and the last exposure of
+ * the first strip), and it is adjusted with ProblemBuilder and ceres. The
+ * report records the wall time of every phase, the peak resident set size,
+ * the iterations, the initial and final RMS of the weighted residuals (i.e.,
+ * sigma naught), and the number of threads of every case.
+ * Regressions are detected by the scaling exponents, i.e., the slopes of
+ * log(time) and log(peak memory) over log(number of images) across the cases:
+ * the setup phases and the memory have to scale (almost) linearly, and the
+ * solver time per iteration at most with the given exponent. The benchmark
+ * exits with 1 if an exponent exceeds its threshold, and with 2 for invalid
+ * arguments. Progress is written to the standard error, so that the report
+ * on the standard output (without --output) is valid JSON.
+ *
+ * Usage: BundleAdjustmentScaling [--name=value ...], with
+ *   --sizes                Comma-separated numbers of images
+ *                          (1000,3000,10000,30000,100000)
+ *   --oblique              Oblique rig of five cameras (0)
+ *   --points-per-image     Object points per nadir image (100)
+ *   --max-iterations       Maximum number of solver iterations (10)
+ *   --linear-solver        iterative (ITERATIVE_SCHUR) or sparse
+ *                          (SPARSE_SCHUR) (iterative)
+ *   --threads              Number of threads (0 = hardware threads)
+ *   --seed                 Seed of the block and of the perturbations (1)
+ *   --max-exponent         Threshold of the setup phases and the memory (1.25)
+ *   --max-solve-exponent   Threshold of the solver time per iteration (1.5)
+ *   --min-seconds          Minimum time of a phase to be fitted (0.01)
+ *   --output               Path of the JSON report (none)
+ */
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eigen3/Eigen/Geometry"
+
+#include "ImageBlock.h"
+#include "ProblemBuilder.h"
+#include "RandomNumber.h"
+#include "SyntheticBlockGenerator.h"
+
+namespace {
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, Core::ObjectPoint, DataType>;
+using ProblemBuilderType = BundleAdjustment::ProblemBuilder<ImageBlockType>;
+
+/// Standard deviations of the perturbations (in m and degrees)
+constexpr double PointSigma = 0.5;
+constexpr double PositionSigma = 0.2;
+constexpr double AttitudeSigma = 0.01;
+
+struct Arguments {
+  std::vector<std::size_t> sizes = {1000, 3000, 10000, 30000, 100000};
+  bool oblique = false;
+  double pointsPerImage = 100.0;
+  int maxIterations = 10;
+  ceres::LinearSolverType linearSolverType = ceres::ITERATIVE_SCHUR;
+  unsigned int threads = 0;
+  std::uint64_t seed = 1;
+  double maxExponent = 1.25;
+  double maxSolveExponent = 1.5;
+  double minSeconds = 0.01;
+  std::string output;
+};
+
+/// Phases of a case, in the order of their execution
+enum Phase { Generate, Load, Perturb, Build, Solve, WriteBack, NumberOfPhases };
+const char *const PhaseNames[NumberOfPhases] = {
+    "generate", "load", "perturb", "build", "solve", "writeBack"};
+
+struct Case {
+  std::size_t requestedImages = 0;
+  std::size_t images = 0;
+  std::size_t points = 0;
+  std::size_t observations = 0;
+  unsigned int strips = 0;
+  unsigned int exposuresPerStrip = 0;
+  /// Wall-clock time of every phase in seconds
+  double seconds[NumberOfPhases] = {};
+  /// Peak resident set size in bytes
+  double peakMemory = 0.0;
+  int iterations = 0;
+  double initialRms = 0.0;
+  double finalRms = 0.0;
+  int threads = 0;
+  std::string termination;
+};
+
+/// Scaling exponent of a quantity, and its threshold
+struct Exponent {
+  std::string name;
+  double value;
+  double threshold;
+  /// Number of cases of the fit
+  std::size_t numberOfCases;
+
+  bool isValid() const { return numberOfCases >= 2; }
+  bool isRegression() const { return isValid() && value > threshold; }
+};
+
+void PrintUsage() {
+  std::cerr << "Usage: BundleAdjustmentScaling [--sizes=1000,3000,...] "
+               "[--oblique=0|1]\n"
+               "  [--points-per-image=100] [--max-iterations=10] "
+               "[--linear-solver=iterative|sparse]\n"
+               "  [--threads=0] [--seed=1] [--max-exponent=1.25] "
+               "[--max-solve-exponent=1.5]\n"
+               "  [--min-seconds=0.01] [--output=report.json]\n";
+}
+
+/// Parse the arguments
+/// Note: This function throws std::invalid_argument for unknown arguments or
+/// invalid values.
+Arguments ParseArguments(int argc, char **argv) {
+  Arguments arguments;
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument = argv[i];
+    const std::size_t separator = argument.find('=');
+    if (argument.compare(0, 2, "--") != 0 || separator == std::string::npos) {
+      throw std::invalid_argument("Invalid argument " + argument + "!");
+    }
+    const std::string name = argument.substr(2, separator - 2);
+    const std::string value = argument.substr(separator + 1);
+    try {
+      if (name == "sizes") {
+        arguments.sizes.clear();
+        std::istringstream stream(value);
+        std::string size;
+        while (std::getline(stream, size, ',')) {
+          arguments.sizes.push_back(std::stoul(size));
+          if (arguments.sizes.back() == 0) {
+            throw std::invalid_argument("Empty size");
+          }
+        }
+      } else if (name == "oblique") {
+        arguments.oblique = std::stoi(value) != 0;
+      } else if (name == "points-per-image") {
+        arguments.pointsPerImage = std::stod(value);
+      } else if (name == "max-iterations") {
+        arguments.maxIterations = std::stoi(value);
+      } else if (name == "linear-solver") {
+        if (value == "iterative") {
+          arguments.linearSolverType = ceres::ITERATIVE_SCHUR;
+        } else if (value == "sparse") {
+          arguments.linearSolverType = ceres::SPARSE_SCHUR;
+        } else {
+          throw std::invalid_argument("Unknown linear solver");
+        }
+      } else if (name == "threads") {
+        arguments.threads = static_cast<unsigned int>(std::stoul(value));
+      } else if (name == "seed") {
+        arguments.seed = std::stoull(value);
+      } else if (name == "max-exponent") {
+        arguments.maxExponent = std::stod(value);
+      } else if (name == "max-solve-exponent") {
+        arguments.maxSolveExponent = std::stod(value);
+      } else if (name == "min-seconds") {
+        arguments.minSeconds = std::stod(value);
+      } else if (name == "output") {
+        arguments.output = value;
+      } else {
+        throw std::invalid_argument("Unknown argument");
+      }
+    } catch (const std::logic_error &) {
+      // std::invalid_argument and std::out_of_range of the conversions
+      throw std::invalid_argument("Invalid argument " + argument + "!");
+    }
+  }
+  if (arguments.sizes.empty() || arguments.pointsPerImage <= 0.0 ||
+      arguments.maxIterations < 0) {
+    throw std::invalid_argument("Invalid sizes, points or iterations!");
+  }
+  return arguments;
+}
+
+/**
+ * Reset the peak resident set size of the process to the current one
+ * @return False if the peak cannot be reset (i.e., not on Linux), so that the
+ * peak of a case includes the previous cases
+ */
+bool ResetPeakMemory() {
+  std::ofstream file("/proc/self/clear_refs");
+  file << "5";
+  file.close();
+  return !file.fail();
+}
+
+/// Get the peak resident set size of the process in bytes
+double GetPeakMemory() {
+  std::ifstream file("/proc/self/status");
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return 1024.0 * std::stod(line.substr(6));
+    }
+  }
+  // Linux reports ru_maxrss in kB
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return 1024.0 * static_cast<double>(usage.ru_maxrss);
+}
+
+double GetSeconds(const std::chrono::steady_clock::time_point &start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+/**
+ * Perturb the object points and the EOPs of the images (except the datum)
+ * with normal noise
+ * @param[in] isDatum The flag of every image to keep its EOPs
+ */
+void PerturbImageBlock(const std::vector<bool> &isDatum,
+                       const std::uint64_t seed, ImageBlockType &imageBlock) {
+  Core::RandomNormalGenerator pointNoise(0.0, PointSigma, seed, 1);
+  for (Core::Handle handle = 0; handle < imageBlock.getNumberOfObjectPoints();
+       ++handle) {
+    auto &point = imageBlock.getObjectPoint(handle);
+    for (int i = 0; i < 3; ++i) {
+      point[i] += pointNoise.getRandomNumber();
+    }
+  }
+
+  Core::RandomNormalGenerator positionNoise(0.0, PositionSigma, seed, 2);
+  Core::RandomNormalGenerator attitudeNoise(0.0, AttitudeSigma * M_PI / 180.0,
+                                            seed, 3);
+  for (Core::Handle handle = 0; handle < imageBlock.getNumberOfImages();
+       ++handle) {
+    if (isDatum[handle]) {
+      continue;
+    }
+    auto &image = *imageBlock.getImage(handle);
+    const auto &translation = image.getTranslation();
+    image.setTranslation(translation[0] + positionNoise.getRandomNumber(),
+                         translation[1] + positionNoise.getRandomNumber(),
+                         translation[2] + positionNoise.getRandomNumber());
+    const Eigen::Matrix3d rotation =
+        image.getRotationMatrix() *
+        (Eigen::AngleAxisd(attitudeNoise.getRandomNumber(),
+                           Eigen::Vector3d::UnitX()) *
+         Eigen::AngleAxisd(attitudeNoise.getRandomNumber(),
+                           Eigen::Vector3d::UnitY()) *
+         Eigen::AngleAxisd(attitudeNoise.getRandomNumber(),
+                           Eigen::Vector3d::UnitZ()))
+            .toRotationMatrix();
+    image.setRotationFromMatrix(rotation);
+  }
+}
+
+std::string GetTermination(const ceres::TerminationType type) {
+  switch (type) {
+  case ceres::CONVERGENCE:
+    return "convergence";
+  case ceres::NO_CONVERGENCE:
+    return "noConvergence";
+  case ceres::FAILURE:
+    return "failure";
+  default:
+    return "other";
+  }
+}
+
+double GetRms(const double cost, const int numberOfResiduals) {
+  return numberOfResiduals > 0 ? std::sqrt(2.0 * cost / numberOfResiduals)
+                               : 0.0;
+}
+
+/// Generate, perturb and adjust a block of (about) the given number of images
+Case RunCase(const Arguments &arguments, const std::size_t size) {
+  Case result;
+  result.requestedImages = size;
+
+  // Almost square blocks: the strips are about four times as long as the
+  // block is wide, since the base is about half of the strip spacing
+  const unsigned int camerasPerExposure = arguments.oblique ? 5 : 1;
+  const std::size_t exposures =
+      (size + camerasPerExposure - 1) / camerasPerExposure;
+  Core::SyntheticBlockGenerator::Options options;
+  options.seed = arguments.seed;
+  options.hasObliqueCameras = arguments.oblique;
+  options.numberOfPointsPerImage = arguments.pointsPerImage;
+  options.numberOfThreads = arguments.threads;
+  options.numberOfStrips = std::max(
+      1u, static_cast<unsigned int>(std::lround(std::sqrt(exposures / 4.0))));
+  options.numberOfExposuresPerStrip = static_cast<unsigned int>(
+      (exposures + options.numberOfStrips - 1) / options.numberOfStrips);
+  result.strips = options.numberOfStrips;
+  result.exposuresPerStrip = options.numberOfExposuresPerStrip;
+
+  ResetPeakMemory();
+  auto start = std::chrono::steady_clock::now();
+  const Core::SyntheticBlockGenerator::Block block =
+      Core::SyntheticBlockGenerator::Create(options);
+  result.seconds[Generate] = GetSeconds(start);
+
+  ImageBlockType imageBlock;
+  start = std::chrono::steady_clock::now();
+  Core::SyntheticBlockGenerator::Load(block, imageBlock);
+  result.seconds[Load] = GetSeconds(start);
+  result.images = imageBlock.getNumberOfImages();
+  result.points = imageBlock.getNumberOfObjectPoints();
+  result.observations = imageBlock.getObservations().size();
+
+  // Datum: all images of the first and the last exposure of the first strip
+  // (the images are in the order of the block)
+  const std::string first = "0_0_";
+  const std::string last =
+      "0_" + std::to_string(options.numberOfExposuresPerStrip - 1) + "_";
+  std::vector<bool> isDatum(block.images.size());
+  for (std::size_t i = 0; i < block.images.size(); ++i) {
+    const std::string &id = block.images[i].id;
+    isDatum[i] = id.compare(0, first.size(), first) == 0 ||
+                 id.compare(0, last.size(), last) == 0;
+  }
+
+  start = std::chrono::steady_clock::now();
+  PerturbImageBlock(isDatum, arguments.seed, imageBlock);
+  result.seconds[Perturb] = GetSeconds(start);
+
+  start = std::chrono::steady_clock::now();
+  ProblemBuilderType builder(imageBlock);
+  builder.build();
+  for (Core::Handle handle = 0; handle < isDatum.size(); ++handle) {
+    if (isDatum[handle]) {
+      builder.getProblem().SetParameterBlockConstant(
+          builder.getBodyFrameParameters(handle));
+    }
+  }
+  result.seconds[Build] = GetSeconds(start);
+
+  ceres::Solver::Options solverOptions;
+  builder.configureSolverOptions(solverOptions, arguments.linearSolverType);
+  if (arguments.threads != 0) {
+    solverOptions.num_threads = static_cast<int>(arguments.threads);
+  }
+  solverOptions.max_num_iterations = arguments.maxIterations;
+  ceres::Solver::Summary summary;
+  start = std::chrono::steady_clock::now();
+  ceres::Solve(solverOptions, &builder.getProblem(), &summary);
+  result.seconds[Solve] = GetSeconds(start);
+
+  start = std::chrono::steady_clock::now();
+  builder.writeBack();
+  result.seconds[WriteBack] = GetSeconds(start);
+
+  result.peakMemory = GetPeakMemory();
+  result.iterations = static_cast<int>(summary.iterations.size());
+  result.initialRms = GetRms(summary.initial_cost, summary.num_residuals);
+  result.finalRms = GetRms(summary.final_cost, summary.num_residuals);
+  result.threads = summary.num_threads_used;
+  result.termination = GetTermination(summary.termination_type);
+  return result;
+}
+
+/**
+ * Fit the scaling exponent of a quantity, i.e., the least-squares slope of
+ * log(value) over log(number of images)
+ * @param[in] values The value of every case (values below the minimum are
+ * not fitted, e.g., phases which are too short to be timed reliably)
+ */
+Exponent FitExponent(const std::string &name, const std::vector<Case> &cases,
+                     const std::vector<double> &values, const double minimum,
+                     const double threshold) {
+  double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+  std::size_t number = 0;
+  for (std::size_t i = 0; i < cases.size(); ++i) {
+    if (values[i] < minimum || cases[i].images == 0) {
+      continue;
+    }
+    const double x = std::log(static_cast<double>(cases[i].images));
+    const double y = std::log(values[i]);
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+    ++number;
+  }
+  const double denominator = number * sumXX - sumX * sumX;
+  Exponent exponent;
+  exponent.name = name;
+  exponent.threshold = threshold;
+  exponent.numberOfCases = denominator > 1e-12 ? number : 0;
+  exponent.value = exponent.isValid()
+                       ? (number * sumXY - sumX * sumY) / denominator
+                       : std::numeric_limits<double>::quiet_NaN();
+  return exponent;
+}
+
+std::vector<Exponent> FitExponents(const Arguments &arguments,
+                                   const std::vector<Case> &cases) {
+  std::vector<Exponent> exponents;
+  std::vector<double> values(cases.size());
+  for (int phase = 0; phase < NumberOfPhases; ++phase) {
+    if (phase == Solve) {
+      continue;
+    }
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+      values[i] = cases[i].seconds[phase];
+    }
+    exponents.push_back(FitExponent(PhaseNames[phase], cases, values,
+                                    arguments.minSeconds,
+                                    arguments.maxExponent));
+  }
+  for (std::size_t i = 0; i < cases.size(); ++i) {
+    values[i] = cases[i].seconds[Solve] / std::max(cases[i].iterations, 1);
+  }
+  exponents.push_back(FitExponent("solvePerIteration", cases, values,
+                                  arguments.minSeconds / 10.0,
+                                  arguments.maxSolveExponent));
+  for (std::size_t i = 0; i < cases.size(); ++i) {
+    values[i] = cases[i].peakMemory;
+  }
+  exponents.push_back(FitExponent("peakMemory", cases, values, 1.0,
+                                  arguments.maxExponent));
+  return exponents;
+}
+
+/// Write a number (null for NaN, which is not valid JSON)
+void WriteNumber(std::ostream &stream, const double value) {
+  if (std::isfinite(value)) {
+    stream << value;
+  } else {
+    stream << "null";
+  }
+}
+
+void WriteReport(std::ostream &stream, const Arguments &arguments,
+                 const bool isPeakMemoryReset, const std::vector<Case> &cases,
+                 const std::vector<Exponent> &exponents) {
+  stream << std::setprecision(6);
+  stream << "{\n  \"context\": {\n"
+         << "    \"hardwareThreads\": " << std::thread::hardware_concurrency()
+         << ",\n    \"oblique\": " << (arguments.oblique ? "true" : "false")
+         << ",\n    \"pointsPerImage\": " << arguments.pointsPerImage
+         << ",\n    \"maxIterations\": " << arguments.maxIterations
+         << ",\n    \"linearSolver\": \""
+         << (arguments.linearSolverType == ceres::ITERATIVE_SCHUR ? "iterative"
+                                                                  : "sparse")
+         << "\",\n    \"seed\": " << arguments.seed
+         << ",\n    \"peakMemoryPerCase\": "
+         << (isPeakMemoryReset ? "true" : "false") << "\n  },\n";
+
+  stream << "  \"cases\": [";
+  for (std::size_t i = 0; i < cases.size(); ++i) {
+    const Case &result = cases[i];
+    stream << (i == 0 ? "\n" : ",\n") << "    {\"requestedImages\": "
+           << result.requestedImages << ", \"images\": " << result.images
+           << ", \"points\": " << result.points
+           << ", \"observations\": " << result.observations
+           << ", \"strips\": " << result.strips
+           << ", \"exposuresPerStrip\": " << result.exposuresPerStrip
+           << ",\n     \"seconds\": {";
+    double total = 0.0;
+    for (int phase = 0; phase < NumberOfPhases; ++phase) {
+      stream << "\"" << PhaseNames[phase] << "\": " << result.seconds[phase]
+             << ", ";
+      total += result.seconds[phase];
+    }
+    stream << "\"total\": " << total
+           << "},\n     \"peakMemory\": " << result.peakMemory
+           << ", \"iterations\": " << result.iterations
+           << ", \"initialRms\": " << result.initialRms
+           << ", \"finalRms\": " << result.finalRms
+           << ", \"threads\": " << result.threads << ", \"termination\": \""
+           << result.termination << "\"}";
+  }
+  stream << "\n  ],\n";
+
+  stream << "  \"exponents\": [";
+  bool isRegression = false;
+  for (std::size_t i = 0; i < exponents.size(); ++i) {
+    const Exponent &exponent = exponents[i];
+    stream << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << exponent.name
+           << "\", \"value\": ";
+    WriteNumber(stream, exponent.value);
+    stream << ", \"threshold\": " << exponent.threshold
+           << ", \"cases\": " << exponent.numberOfCases << ", \"regression\": "
+           << (exponent.isRegression() ? "true" : "false") << "}";
+    isRegression = isRegression || exponent.isRegression();
+  }
+  stream << "\n  ],\n  \"regression\": " << (isRegression ? "true" : "false")
+         << "\n}\n";
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Arguments arguments;
+  try {
+    arguments = ParseArguments(argc, argv);
+  } catch (const std::invalid_argument &error) {
+    std::cerr << error.what() << std::endl;
+    PrintUsage();
+    return 2;
+  }
+
+  const bool isPeakMemoryReset = ResetPeakMemory();
+  std::vector<Case> cases;
+  for (const std::size_t size : arguments.sizes) {
+    std::cerr << "Running " << size << " images..." << std::flush;
+    cases.push_back(RunCase(arguments, size));
+    const Case &result = cases.back();
+    std::cerr << " build " << result.seconds[Build] << " s, solve "
+              << result.seconds[Solve] << " s (" << result.iterations
+              << " iterations), peak " << result.peakMemory / (1 << 20)
+              << " MiB, RMS " << result.initialRms << " -> "
+              << result.finalRms << std::endl;
+  }
+
+  const std::vector<Exponent> exponents = FitExponents(arguments, cases);
+  bool isRegression = false;
+  for (const Exponent &exponent : exponents) {
+    if (exponent.isValid()) {
+      std::cerr << "Exponent of " << exponent.name << ": " << exponent.value
+                << " (threshold " << exponent.threshold << ")"
+                << (exponent.isRegression() ? " REGRESSION" : "") << std::endl;
+    }
+    isRegression = isRegression || exponent.isRegression();
+  }
+
+  if (!arguments.output.empty()) {
+    std::ofstream file(arguments.output);
+    WriteReport(file, arguments, isPeakMemoryReset, cases, exponents);
+    if (!file) {
+      std::cerr << "Cannot write " << arguments.output << "!" << std::endl;
+      return 2;
+    }
+  } else {
+    WriteReport(std::cout, arguments, isPeakMemoryReset, cases, exponents);
+  }
+  return isRegression ? 1 : 0;
+}
@@ -0,0 +1,375 @@
+#include "BundleAdjustmentModel.h"
+#include "InteriorOrientation.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using BundleAdjustment::BundleAdjustmentModel;
+using BundleAdjustment::NumberOfCameraParameters;
+using BundleAdjustment::NumberOfPoseParameters;
+
+// Parameter blocks of a non-reference camera on a multi-camera platform
+struct CollinearityParameters {
+  double camera[NumberOfCameraParameters] = {
+      0.1, -0.2, 50.0, 0.0, 1e-5, 1e-8, 1e-11, 1e-4, 2e-4, 1e-5, 1e-4, 2e-4};
+  double point[3] = {100.0, 200.0, 5.0};
+  double bodyFrame[NumberOfPoseParameters] = {95.0, 210.0, 1000.0,
+                                              0.02, -0.03, 0.5};
+  double refCameraToBodyFrame[NumberOfPoseParameters] = {0.1,   0.2,  -0.3,
+                                                         0.01, 0.02, 0.03};
+  double nonRefCameraToRefCamera[NumberOfPoseParameters] = {0.3,   -0.1, 0.05,
+                                                            0.15, -0.05, 0.1};
+
+  std::vector<double *> blocks() {
+    return {camera, point, bodyFrame, refCameraToBodyFrame,
+            nonRefCameraToRefCamera};
+  }
+};
+
+// Evaluate cost function with Jacobians stored in row-major order
+void EvaluateCost(const ceres::CostFunction &costFunction,
+                  CollinearityParameters &params, double residuals[2],
+                  std::vector<std::vector<double>> &jacobians) {
+  auto blocks = params.blocks();
+  std::vector<double *> jacobianPointers;
+  jacobians.resize(blocks.size());
+  for (unsigned int i = 0; i < blocks.size(); ++i) {
+    jacobians[i].assign(2 * costFunction.parameter_block_sizes()[i], 0.0);
+    jacobianPointers.push_back(jacobians[i].data());
+  }
+  ASSERT_TRUE(costFunction.Evaluate(blocks.data(), residuals,
+                                    jacobianPointers.data()));
+}
+
+TEST(BundleAdjustmentModel, ProjectionWithDistortionGivesZeroResiduals) {
+  CollinearityParameters params;
+  double projection[2];
+  BundleAdjustmentModel::ComputeCollinearityProjection(
+      params.camera, params.point, params.bodyFrame,
+      params.refCameraToBodyFrame, params.nonRefCameraToRefCamera, projection);
+
+  // Add distortions through Core::InteriorOrientation
+  Core::InteriorOrientation<double, 9> iops;
+  iops.xyc << params.camera[0], params.camera[1], params.camera[2];
+  for (unsigned int i = 0; i < 9; ++i) {
+    iops.distortionParameters[i] = params.camera[3 + i];
+  }
+  auto imagePoint = iops.addDistortion(projection[0] - params.camera[0],
+                                       projection[1] - params.camera[1], 1e-12);
+
+  BundleAdjustmentModel::CollinearityFrameCameraAnalyticCost cost(imagePoint);
+  double residuals[2];
+  std::vector<std::vector<double>> jacobians;
+  EvaluateCost(cost, params, residuals, jacobians);
+  EXPECT_NEAR(residuals[0], 0.0, 1e-9);
+  EXPECT_NEAR(residuals[1], 0.0, 1e-9);
+}
+
+TEST(BundleAdjustmentModel, AnalyticJacobiansMatchAutoDiff) {
+  CollinearityParameters params;
+  const Eigen::Vector2d imagePoint(2.5, -1.5);
+  Eigen::Matrix2d covariance;
+  covariance << 0.25, 0.05, 0.05, 0.16;
+  const Eigen::Matrix2d sqrtInformation =
+      BundleAdjustmentModel::ComputeSquareRootInformation(covariance);
+
+  BundleAdjustmentModel::CollinearityFrameCameraAnalyticCost analyticCost(
+      imagePoint, sqrtInformation);
+  std::unique_ptr<ceres::CostFunction> autoDiffCost(
+      BundleAdjustmentModel::CollinearityFrameCameraCost::Create(
+          imagePoint, sqrtInformation));
+
+  double analyticResiduals[2];
+  double autoDiffResiduals[2];
+  std::vector<std::vector<double>> analyticJacobians;
+  std::vector<std::vector<double>> autoDiffJacobians;
+  EvaluateCost(analyticCost, params, analyticResiduals, analyticJacobians);
+  EvaluateCost(*autoDiffCost, params, autoDiffResiduals, autoDiffJacobians);
+
+  EXPECT_NEAR(analyticResiduals[0], autoDiffResiduals[0], 1e-10);
+  EXPECT_NEAR(analyticResiduals[1], autoDiffResiduals[1], 1e-10);
+  for (unsigned int block = 0; block < analyticJacobians.size(); ++block) {
+    for (unsigned int i = 0; i < analyticJacobians[block].size(); ++i) {
+      EXPECT_NEAR(analyticJacobians[block][i], autoDiffJacobians[block][i],
+                  1e-8 * (1.0 + std::abs(autoDiffJacobians[block][i])))
+          << "block " << block << ", element " << i;
+    }
+  }
+}
+
+TEST(BundleAdjustmentModel, AnalyticJacobiansMatchNumericalDifferences) {
+  CollinearityParameters params;
+  const Eigen::Vector2d imagePoint(-3.0, 4.0);
+  BundleAdjustmentModel::CollinearityFrameCameraAnalyticCost cost(imagePoint);
+
+  double residuals[2];
+  std::vector<std::vector<double>> jacobians;
+  EvaluateCost(cost, params, residuals, jacobians);
+
+  // Central differences for every parameter
+  auto blocks = params.blocks();
+  for (unsigned int block = 0; block < blocks.size(); ++block) {
+    const int blockSize = cost.parameter_block_sizes()[block];
+    for (int i = 0; i < blockSize; ++i) {
+      double &value = blocks[block][i];
+      const double original = value;
+      const double step = 1e-6 * std::max(1.0, std::abs(original));
+      double forwardResiduals[2];
+      double backwardResiduals[2];
+      value = original + step;
+      ASSERT_TRUE(cost.Evaluate(blocks.data(), forwardResiduals, nullptr));
+      value = original - step;
+      ASSERT_TRUE(cost.Evaluate(blocks.data(), backwardResiduals, nullptr));
+      value = original;
+      for (unsigned int row = 0; row < 2; ++row) {
+        const double numerical =
+            (forwardResiduals[row] - backwardResiduals[row]) / (2.0 * step);
+        const double analytic = jacobians[block][row * blockSize + i];
+        EXPECT_NEAR(analytic, numerical, 1e-5 * (1.0 + std::abs(numerical)))
+            << "block " << block << ", parameter " << i << ", row " << row;
+      }
+    }
+  }
+}
+
+// Compare the analytic and auto-differentiated costs of a rotation
+// parameterization with the Euler angle cost at the same poses
+template <typename TRotation> void CompareRotationParameterization() {
+  constexpr int PoseSize =
+      BundleAdjustment::GetNumberOfPoseParameters<TRotation>();
+  CollinearityParameters params;
+  auto eulerBlocks = params.blocks();
+  std::vector<std::vector<double>> poses(3, std::vector<double>(PoseSize));
+  std::vector<double *> blocks = {params.camera, params.point};
+  for (unsigned int i = 0; i < 3; ++i) {
+    std::copy(eulerBlocks[2 + i], eulerBlocks[2 + i] + 3, poses[i].data());
+    TRotation::FromEulerAngles(eulerBlocks[2 + i] + 3, poses[i].data() + 3);
+    blocks.push_back(poses[i].data());
+  }
+  const Eigen::Vector2d imagePoint(2.5, -1.5);
+  BundleAdjustmentModel::CollinearityFrameCameraAnalyticCost eulerCost(
+      imagePoint);
+  BundleAdjustmentModel::CollinearityAnalyticCost<TRotation> analyticCost(
+      imagePoint);
+  std::unique_ptr<ceres::CostFunction> autoDiffCost(
+      BundleAdjustmentModel::CollinearityCost<TRotation>::Create(imagePoint));
+
+  double eulerResiduals[2];
+  double analyticResiduals[2];
+  double autoDiffResiduals[2];
+  std::vector<std::vector<double>> analyticJacobians(5);
+  std::vector<std::vector<double>> autoDiffJacobians(5);
+  std::vector<double *> analyticPointers;
+  std::vector<double *> autoDiffPointers;
+  for (unsigned int i = 0; i < 5; ++i) {
+    analyticJacobians[i].assign(2 * analyticCost.parameter_block_sizes()[i],
+                                0.0);
+    autoDiffJacobians[i].assign(analyticJacobians[i].size(), 0.0);
+    analyticPointers.push_back(analyticJacobians[i].data());
+    autoDiffPointers.push_back(autoDiffJacobians[i].data());
+  }
+  ASSERT_TRUE(eulerCost.Evaluate(eulerBlocks.data(), eulerResiduals, nullptr));
+  ASSERT_TRUE(analyticCost.Evaluate(blocks.data(), analyticResiduals,
+                                    analyticPointers.data()));
+  ASSERT_TRUE(autoDiffCost->Evaluate(blocks.data(), autoDiffResiduals,
+                                     autoDiffPointers.data()));
+
+  for (unsigned int i = 0; i < 2; ++i) {
+    EXPECT_NEAR(analyticResiduals[i], eulerResiduals[i], 1e-9);
+    EXPECT_NEAR(analyticResiduals[i], autoDiffResiduals[i], 1e-10);
+  }
+  for (unsigned int block = 2; block < 5; ++block) {
+    for (unsigned int i = 0; i < analyticJacobians[block].size(); ++i) {
+      EXPECT_NEAR(analyticJacobians[block][i], autoDiffJacobians[block][i],
+                  1e-8 * (1.0 + std::abs(autoDiffJacobians[block][i])))
+          << "block " << block << ", element " << i;
+    }
+  }
+}
+
+TEST(BundleAdjustmentModel, RotationParameterizations) {
+  CompareRotationParameterization<BundleAdjustment::AngleAxisRotation>();
+  CompareRotationParameterization<BundleAdjustment::QuaternionRotation>();
+
+  // Small angle-axis vectors use the first order approximation
+  double angleAxis[3] = {1e-9, -2e-9, 3e-9};
+  Eigen::Matrix3d rotation;
+  BundleAdjustment::AngleAxisRotation::ToRotationMatrix(angleAxis, rotation);
+  EXPECT_TRUE((rotation.transpose() * rotation)
+                  .isApprox(Eigen::Matrix3d::Identity(), 1e-12));
+
+  // Euler angles at gimbal lock survive the round trip through quaternions
+  const double eulerAngles[3] = {0.3, M_PI / 2.0, 0.2};
+  double quaternion[4];
+  double recoveredAngles[3];
+  BundleAdjustment::QuaternionRotation::FromEulerAngles(eulerAngles,
+                                                        quaternion);
+  BundleAdjustment::QuaternionRotation::ToEulerAngles(quaternion,
+                                                      recoveredAngles);
+  Eigen::Matrix3d expected;
+  Eigen::Matrix3d recovered;
+  BundleAdjustment::EulerAnglesRotation::ToRotationMatrix(eulerAngles,
+                                                          expected);
+  BundleAdjustment::EulerAnglesRotation::ToRotationMatrix(recoveredAngles,
+                                                          recovered);
+  EXPECT_TRUE(recovered.isApprox(expected, 1e-10));
+}
+
+TEST(BundleAdjustmentModel, PoseManifolds) {
+  EXPECT_EQ(BundleAdjustment::CreatePoseManifold<
+                BundleAdjustment::EulerAnglesRotation>(),
+            nullptr);
+  std::unique_ptr<ceres::Manifold> manifold(
+      BundleAdjustment::CreatePoseManifold<
+          BundleAdjustment::QuaternionRotation>());
+  ASSERT_NE(manifold, nullptr);
+  ASSERT_EQ(manifold->AmbientSize(), 7);
+  ASSERT_EQ(manifold->TangentSize(), 6);
+
+  // Plus and Minus are inverse to each other
+  const double angles[3] = {0.1, -0.2, 0.3};
+  double pose[7] = {100.0, 200.0, 300.0};
+  BundleAdjustment::QuaternionRotation::FromEulerAngles(angles, pose + 3);
+  const double delta[6] = {0.5, -0.25, 1.0, 0.01, -0.02, 0.03};
+  double posePlusDelta[7];
+  double recoveredDelta[6];
+  ASSERT_TRUE(manifold->Plus(pose, delta, posePlusDelta));
+  ASSERT_TRUE(manifold->Minus(posePlusDelta, pose, recoveredDelta));
+  for (unsigned int i = 0; i < 6; ++i) {
+    EXPECT_NEAR(recoveredDelta[i], delta[i], 1e-12);
+  }
+
+  // Plus Jacobian against central differences
+  double jacobian[7 * 6];
+  ASSERT_TRUE(manifold->PlusJacobian(pose, jacobian));
+  const double step = 1e-6;
+  for (unsigned int col = 0; col < 6; ++col) {
+    double forwardDelta[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    double backwardDelta[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    forwardDelta[col] = step;
+    backwardDelta[col] = -step;
+    double forward[7];
+    double backward[7];
+    ASSERT_TRUE(manifold->Plus(pose, forwardDelta, forward));
+    ASSERT_TRUE(manifold->Plus(pose, backwardDelta, backward));
+    for (unsigned int row = 0; row < 7; ++row) {
+      EXPECT_NEAR(jacobian[row * 6 + col],
+                  (forward[row] - backward[row]) / (2.0 * step), 1e-8)
+          << "row " << row << ", column " << col;
+    }
+  }
+}
+
+// Compare the analytic and auto-differentiated costs of a distortion model
+template <typename TDistortion>
+void CheckDistortionModel(const double *const camera,
+                          const Eigen::Vector2d &imagePoint) {
+  constexpr int NumberOfCameraParameters =
+      BundleAdjustment::GetNumberOfCameraParameters<TDistortion>();
+  CollinearityParameters params;
+  std::vector<double> cameraBlock(camera, camera + NumberOfCameraParameters);
+  std::vector<double *> blocks = params.blocks();
+  blocks[0] = cameraBlock.data();
+
+  BundleAdjustmentModel::CollinearityAnalyticCost<
+      BundleAdjustment::EulerAnglesRotation, TDistortion>
+      analyticCost(imagePoint);
+  std::unique_ptr<ceres::CostFunction> autoDiffCost(
+      BundleAdjustmentModel::CollinearityCost<
+          BundleAdjustment::EulerAnglesRotation,
+          TDistortion>::Create(imagePoint));
+  ASSERT_EQ(analyticCost.parameter_block_sizes()[0], NumberOfCameraParameters);
+
+  double analyticResiduals[2];
+  double autoDiffResiduals[2];
+  std::vector<std::vector<double>> analyticJacobians(blocks.size());
+  std::vector<std::vector<double>> autoDiffJacobians(blocks.size());
+  std::vector<double *> analyticPointers;
+  std::vector<double *> autoDiffPointers;
+  for (unsigned int i = 0; i < blocks.size(); ++i) {
+    analyticJacobians[i].assign(2 * analyticCost.parameter_block_sizes()[i],
+                                0.0);
+    autoDiffJacobians[i].assign(analyticJacobians[i].size(), 0.0);
+    analyticPointers.push_back(analyticJacobians[i].data());
+    autoDiffPointers.push_back(autoDiffJacobians[i].data());
+  }
+  ASSERT_TRUE(analyticCost.Evaluate(blocks.data(), analyticResiduals,
+                                    analyticPointers.data()));
+  ASSERT_TRUE(autoDiffCost->Evaluate(blocks.data(), autoDiffResiduals,
+                                     autoDiffPointers.data()));
+
+  EXPECT_NEAR(analyticResiduals[0], autoDiffResiduals[0], 1e-10);
+  EXPECT_NEAR(analyticResiduals[1], autoDiffResiduals[1], 1e-10);
+  for (unsigned int block = 0; block < blocks.size(); ++block) {
+    for (unsigned int i = 0; i < analyticJacobians[block].size(); ++i) {
+      EXPECT_NEAR(analyticJacobians[block][i], autoDiffJacobians[block][i],
+                  1e-8 * (1.0 + std::abs(autoDiffJacobians[block][i])))
+          << "block " << block << ", element " << i;
+    }
+  }
+}
+
+TEST(BundleAdjustmentModel, DistortionModels) {
+  const Eigen::Vector2d imagePoint(2.5, -1.5);
+  const double radialCamera[7] = {0.1, -0.2, 50.0, 1e-4, 1e-5, 1e-8, 1e-11};
+  CheckDistortionModel<Core::RadialDistortion>(radialCamera, imagePoint);
+  // Fisheye lens with a short principal distance
+  const double fisheyeCamera[7] = {0.1, -0.2, 8.0, -0.02, 3e-3, -1e-4, 1e-5};
+  CheckDistortionModel<Core::EquidistantDistortion>(fisheyeCamera, imagePoint);
+  CheckDistortionModel<Core::EquidistantDistortion>(
+      fisheyeCamera, Eigen::Vector2d(0.1 + 1e-5, -0.2 - 2e-5));
+}
+
+TEST(BundleAdjustmentModel, DistortionFreeCostMatchesFullModel) {
+  CollinearityParameters params;
+  const Eigen::Vector2d imagePoint(2.5, -1.5);
+  Eigen::Matrix2d covariance;
+  covariance << 0.25, 0.05, 0.05, 0.16;
+  const Eigen::Matrix2d sqrtInformation =
+      BundleAdjustmentModel::ComputeSquareRootInformation(covariance);
+
+  // Correct the image point for the distortions up front
+  double distortion[2];
+  BundleAdjustmentModel::ComputeDistortion(params.camera, imagePoint[0],
+                                           imagePoint[1], distortion);
+  const Eigen::Vector2d correctedImagePoint(imagePoint[0] - distortion[0],
+                                            imagePoint[1] - distortion[1]);
+
+  BundleAdjustmentModel::CollinearityFrameCameraAnalyticCost fullCost(
+      imagePoint, sqrtInformation);
+  BundleAdjustmentModel::CollinearityDistortionFreeCost<
+      BundleAdjustment::EulerAnglesRotation>
+      distortionFreeCost(correctedImagePoint, sqrtInformation);
+
+  double fullResiduals[2];
+  double distortionFreeResiduals[2];
+  std::vector<std::vector<double>> fullJacobians;
+  std::vector<std::vector<double>> distortionFreeJacobians;
+  EvaluateCost(fullCost, params, fullResiduals, fullJacobians);
+  EvaluateCost(distortionFreeCost, params, distortionFreeResiduals,
+               distortionFreeJacobians);
+
+  EXPECT_NEAR(distortionFreeResiduals[0], fullResiduals[0], 1e-10);
+  EXPECT_NEAR(distortionFreeResiduals[1], fullResiduals[1], 1e-10);
+  // Object point and poses
+  for (unsigned int block = 1; block < fullJacobians.size(); ++block) {
+    for (unsigned int i = 0; i < fullJacobians[block].size(); ++i) {
+      EXPECT_NEAR(distortionFreeJacobians[block][i], fullJacobians[block][i],
+                  1e-10 * (1.0 + std::abs(fullJacobians[block][i])))
+          << "block " << block << ", element " << i;
+    }
+  }
+  // Principal distance, and no distortion parameters
+  const int cameraSize = NumberOfCameraParameters;
+  for (unsigned int row = 0; row < 2; ++row) {
+    EXPECT_NEAR(distortionFreeJacobians[0][row * cameraSize + 2],
+                fullJacobians[0][row * cameraSize + 2], 1e-10);
+    for (int i = 3; i < cameraSize; ++i) {
+      EXPECT_EQ(distortionFreeJacobians[0][row * cameraSize + i], 0.0);
+    }
+  }
+}
@@ -0,0 +1,374 @@
+#include "ProblemBuilder.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, Core::ObjectPoint, DataType>;
+using ProblemBuilderType = BundleAdjustment::ProblemBuilder<ImageBlockType>;
+using BundleAdjustment::BundleAdjustmentModel;
+
+/**
+ * Prepare a block with a two-camera rig (camera2 is mounted to camera1)
+ * flying over a grid of object points. Image points are simulated in pixels
+ * with the collinearity model.
+ */
+void PrepareImageBlock(ImageBlockType &imageBlock) {
+  CameraType camera;
+  camera.width = 4000;
+  camera.height = 3000;
+  camera.xPixelSize = 0.01;
+  camera.yPixelSize = 0.012;
+  camera.xyc = Core::Point<DataType, 3>(Eigen::Vector3d(0.05, -0.03, 50.0));
+  camera.distortionParameters =
+      Core::Point<DataType, 9>(Eigen::Matrix<DataType, 9, 1>::Zero());
+  imageBlock.addCamera("camera1", std::make_shared<CameraType>(camera));
+  Core::ExteriorOrientation<DataType> mounting;
+  mounting.setTranslation(0.2, 0.0, 0.0);
+  mounting.setRotation(1.0, -2.0, 5.0);
+  imageBlock.addCamera(
+      "camera2", std::make_shared<CameraType>("camera1", mounting, camera));
+
+  // Four epochs, each with an image of both cameras
+  for (unsigned int epoch = 0; epoch < 4; ++epoch) {
+    for (const std::string cameraId : {"camera1", "camera2"}) {
+      auto image = std::make_shared<ImageType>();
+      image->setCameraId(cameraId);
+      image->setTranslation(100.0 * (epoch % 2), 100.0 * (epoch / 2),
+                            500.0 + 5.0 * epoch);
+      image->setRotation(1.0 * epoch, -0.5 * epoch, 10.0 * epoch);
+      imageBlock.addImage(cameraId + "_" + std::to_string(epoch), image);
+    }
+  }
+
+  // Object points observed in all images
+  unsigned int pointIndex = 0;
+  for (int i = -3; i <= 3; ++i) {
+    for (int j = -3; j <= 3; ++j) {
+      Core::ObjectPoint point(50.0 + 40.0 * i, 50.0 + 40.0 * j,
+                              3.0 * ((i + j) % 3));
+      imageBlock.addObjectPoint(std::to_string(pointIndex++), point);
+    }
+  }
+
+  // Simulate image points
+  ProblemBuilderType builder(imageBlock);
+  builder.build();
+  for (Core::Handle imageHandle = 0;
+       imageHandle < imageBlock.getNumberOfImages(); ++imageHandle) {
+    auto &image = imageBlock.getImage(imageHandle);
+    const Core::Handle cameraHandle =
+        imageBlock.getCameraHandleOfImage(imageHandle);
+    const auto &imageCamera = imageBlock.getCamera(cameraHandle);
+    double identity[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    double *nonRefCameraParams =
+        cameraHandle == 0 ? identity
+                          : builder.getMountingParameters(cameraHandle);
+    for (Core::Handle pointHandle = 0;
+         pointHandle < imageBlock.getNumberOfObjectPoints(); ++pointHandle) {
+      double projection[2];
+      BundleAdjustmentModel::ComputeCollinearityProjection(
+          builder.getCameraParameters(cameraHandle),
+          builder.getObjectPointParameters(pointHandle),
+          builder.getBodyFrameParameters(imageHandle),
+          builder.getMountingParameters(0), nonRefCameraParams, projection);
+      auto pixel = imageCamera->ConvertImageCoordinatesToPixel(projection[0],
+                                                               projection[1]);
+      const std::string pointId = imageBlock.getObjectPointId(pointHandle);
+      image->addPoint(pointId, Core::ImagePoint(pixel[1], pixel[0]));
+      imageBlock.getObjectPoint(pointHandle)
+          .mTiePointIds[imageBlock.getImageId(imageHandle)] = pointId;
+    }
+  }
+  imageBlock.buildObservations();
+}
+
+TEST(ProblemBuilder, ParameterBlocksAndOrdering) {
+  ImageBlockType imageBlock;
+  PrepareImageBlock(imageBlock);
+  ProblemBuilderType builder(imageBlock);
+  builder.build();
+
+  auto &problem = builder.getProblem();
+  EXPECT_EQ(problem.NumResidualBlocks(), 8 * 49);
+  // 49 points, 8 images, 2 IOPs, 2 mountings and the identity mounting
+  EXPECT_EQ(problem.NumParameterBlocks(), 49 + 8 + 2 + 2 + 1);
+
+  const auto &ordering = builder.getOrdering();
+  EXPECT_EQ(ordering->NumElements(), problem.NumParameterBlocks());
+  EXPECT_EQ(ordering->NumGroups(), 3);
+  EXPECT_EQ(ordering->GroupSize(0), 49);
+  EXPECT_EQ(ordering->GroupSize(1), 8);
+  EXPECT_EQ(ordering->GroupSize(2), 5);
+  EXPECT_EQ(ordering->GroupId(builder.getObjectPointParameters(0)), 0);
+  EXPECT_EQ(ordering->GroupId(builder.getBodyFrameParameters(3)), 1);
+  EXPECT_EQ(ordering->GroupId(builder.getMountingParameters(1)), 2);
+  EXPECT_TRUE(problem.IsParameterBlockConstant(builder.getCameraParameters(0)));
+  // One cached transformation per image
+  ASSERT_NE(builder.getRigTransformCache(), nullptr);
+  EXPECT_EQ(builder.getRigTransformCache()->getNumberOfRigTransforms(), 8);
+
+  // Rotation angles are converted to radians
+  EXPECT_NEAR(builder.getBodyFrameParameters(2)[5], 10.0 * M_PI / 180.0,
+              1e-12);
+
+  ceres::Solver::Options solverOptions;
+  builder.configureSolverOptions(solverOptions, ceres::ITERATIVE_SCHUR);
+  EXPECT_EQ(solverOptions.linear_solver_type, ceres::ITERATIVE_SCHUR);
+  EXPECT_EQ(solverOptions.preconditioner_type, ceres::CLUSTER_JACOBI);
+  EXPECT_EQ(solverOptions.linear_solver_ordering, ordering);
+}
+
+TEST(ProblemBuilder, BuildAgainAfterEnablingSelfCalibration) {
+  ImageBlockType imageBlock;
+  PrepareImageBlock(imageBlock);
+  ProblemBuilderType builder(imageBlock);
+  builder.build();
+  EXPECT_TRUE(builder.isInteriorOrientationConstant(1));
+
+  // The second build replaces the problem instead of adding to it
+  auto options = builder.getOptions();
+  options.selfCalibrationCameraIds.push_back("camera2");
+  builder.setOptions(options);
+  builder.build();
+  EXPECT_FALSE(builder.isInteriorOrientationConstant(1));
+  auto &problem = builder.getProblem();
+  EXPECT_EQ(problem.NumResidualBlocks(), 8 * 49);
+  EXPECT_EQ(problem.NumParameterBlocks(), 49 + 8 + 2 + 2 + 1);
+  EXPECT_EQ(builder.getOrdering()->NumElements(), problem.NumParameterBlocks());
+  EXPECT_FALSE(
+      problem.IsParameterBlockConstant(builder.getCameraParameters(1)));
+  ASSERT_NE(builder.getRigTransformCache(), nullptr);
+  EXPECT_EQ(builder.getRigTransformCache()->getNumberOfRigTransforms(), 8);
+
+  // All residual blocks refer to the current arena and cache, and vanish at
+  // the simulated parameters
+  double cost = -1.0;
+  ASSERT_TRUE(problem.Evaluate(ceres::Problem::EvaluateOptions(), &cost,
+                               nullptr, nullptr, nullptr));
+  EXPECT_NEAR(cost, 0.0, 1e-12);
+}
+
+TEST(ProblemBuilder, EvaluateAfterChangingPoseBlocks) {
+  // The same block with (builder) and without (reference) the rig transform
+  // cache
+  ImageBlockType imageBlock;
+  ImageBlockType referenceImageBlock;
+  PrepareImageBlock(imageBlock);
+  PrepareImageBlock(referenceImageBlock);
+  ProblemBuilderType builder(imageBlock);
+  builder.build();
+  ProblemBuilderType::Options options;
+  options.useRigTransformCache = false;
+  ProblemBuilderType referenceBuilder(referenceImageBlock, options);
+  referenceBuilder.build();
+  auto &problem = builder.getProblem();
+  auto &referenceProblem = referenceBuilder.getProblem();
+
+  double cost = -1.0;
+  ASSERT_TRUE(problem.Evaluate(ceres::Problem::EvaluateOptions(), &cost,
+                               nullptr, nullptr, nullptr));
+  EXPECT_NEAR(cost, 0.0, 1e-12);
+
+  // Change pose blocks outside of the solver, i.e., after the cache was
+  // updated by the evaluation above
+  for (ProblemBuilderType *poseBuilder : {&builder, &referenceBuilder}) {
+    poseBuilder->getBodyFrameParameters(3)[0] += 1.0;
+    poseBuilder->getBodyFrameParameters(5)[4] -= 0.01;
+    poseBuilder->getMountingParameters(1)[5] += 0.02;
+  }
+  std::vector<double> residuals;
+  std::vector<double> gradient;
+  std::vector<double> referenceResiduals;
+  std::vector<double> referenceGradient;
+  double referenceCost = -1.0;
+  ASSERT_TRUE(problem.Evaluate(ceres::Problem::EvaluateOptions(), &cost,
+                               &residuals, &gradient, nullptr));
+  ASSERT_TRUE(referenceProblem.Evaluate(ceres::Problem::EvaluateOptions(),
+                                        &referenceCost, &referenceResiduals,
+                                        &referenceGradient, nullptr));
+  EXPECT_GT(referenceCost, 1e-6);
+  EXPECT_NEAR(cost, referenceCost, 1e-12 * referenceCost);
+  ASSERT_EQ(residuals.size(), referenceResiduals.size());
+  for (std::size_t i = 0; i < residuals.size(); ++i) {
+    EXPECT_NEAR(residuals[i], referenceResiduals[i], 1e-9);
+  }
+  ASSERT_EQ(gradient.size(), referenceGradient.size());
+  for (std::size_t i = 0; i < gradient.size(); ++i) {
+    EXPECT_NEAR(gradient[i], referenceGradient[i],
+                1e-9 * (1.0 + std::abs(referenceGradient[i])));
+  }
+
+  // Cost functions evaluated directly (i.e., without the evaluation
+  // callback) compose the transformations of changed pose blocks themselves
+  for (ProblemBuilderType *poseBuilder : {&builder, &referenceBuilder}) {
+    poseBuilder->getBodyFrameParameters(3)[5] += 0.03;
+  }
+  std::vector<ceres::ResidualBlockId> residualBlocks;
+  std::vector<ceres::ResidualBlockId> referenceResidualBlocks;
+  problem.GetResidualBlocks(&residualBlocks);
+  referenceProblem.GetResidualBlocks(&referenceResidualBlocks);
+  ASSERT_EQ(residualBlocks.size(), referenceResidualBlocks.size());
+  for (std::size_t i = 0; i < residualBlocks.size(); ++i) {
+    std::vector<double *> parameterBlocks;
+    std::vector<double *> referenceParameterBlocks;
+    problem.GetParameterBlocksForResidualBlock(residualBlocks[i],
+                                               &parameterBlocks);
+    referenceProblem.GetParameterBlocksForResidualBlock(
+        referenceResidualBlocks[i], &referenceParameterBlocks);
+    double blockResiduals[2];
+    double referenceBlockResiduals[2];
+    ASSERT_TRUE(
+        problem.GetCostFunctionForResidualBlock(residualBlocks[i])
+            ->Evaluate(parameterBlocks.data(), blockResiduals, nullptr));
+    ASSERT_TRUE(referenceProblem
+                    .GetCostFunctionForResidualBlock(
+                        referenceResidualBlocks[i])
+                    ->Evaluate(referenceParameterBlocks.data(),
+                               referenceBlockResiduals, nullptr));
+    EXPECT_NEAR(blockResiduals[0], referenceBlockResiduals[0], 1e-9);
+    EXPECT_NEAR(blockResiduals[1], referenceBlockResiduals[1], 1e-9);
+  }
+}
+
+/**
+ * Perturb the body frame EOPs of the image block, and recover them with the
+ * given rotation parameterization of the pose parameter blocks
+ */
+template <typename TRotation>
+void RecoverPerturbedBodyFrames(const bool useRigTransformCache = true) {
+  ImageBlockType imageBlock;
+  PrepareImageBlock(imageBlock);
+
+  // Keep the true EOPs, and perturb them in the image block
+  std::vector<Eigen::Matrix<double, 6, 1>> trueEOPs;
+  for (Core::Handle handle = 0; handle < imageBlock.getNumberOfImages();
+       ++handle) {
+    auto &image = imageBlock.getImage(handle);
+    Eigen::Matrix<double, 6, 1> eop;
+    eop << image->getTranslation(), image->getRotationInDegrees();
+    trueEOPs.push_back(eop);
+    image->setTranslation(eop[0] + 0.5, eop[1] - 0.3, eop[2] + 0.4);
+    image->setRotation(eop[3] + 0.1, eop[4] - 0.1, eop[5] + 0.2);
+  }
+
+  using BuilderType =
+      BundleAdjustment::ProblemBuilder<ImageBlockType, TRotation>;
+  typename BuilderType::Options options;
+  options.fixObjectPoints = true;
+  options.useRigTransformCache = useRigTransformCache;
+  BuilderType builder(imageBlock, options);
+  builder.build();
+  ceres::Solver::Options solverOptions;
+  builder.configureSolverOptions(solverOptions);
+  solverOptions.function_tolerance = 1e-14;
+  solverOptions.parameter_tolerance = 1e-14;
+  solverOptions.max_num_iterations = 20;
+  ceres::Solver::Summary summary;
+  ceres::Solve(solverOptions, &builder.getProblem(), &summary);
+  EXPECT_LT(summary.final_cost, 1e-12);
+
+  builder.writeBack();
+  for (Core::Handle handle = 0; handle < imageBlock.getNumberOfImages();
+       ++handle) {
+    const auto &image = imageBlock.getImage(handle);
+    for (unsigned int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(image->getTranslation()[i], trueEOPs[handle][i], 1e-6);
+      EXPECT_NEAR(image->getRotationInDegrees()[i], trueEOPs[handle][3 + i],
+                  1e-6);
+    }
+  }
+}
+
+TEST(ProblemBuilder, RecoverPerturbedBodyFrames) {
+  RecoverPerturbedBodyFrames<BundleAdjustment::EulerAnglesRotation>();
+  RecoverPerturbedBodyFrames<BundleAdjustment::EulerAnglesRotation>(false);
+}
+
+TEST(ProblemBuilder, RecoverPerturbedBodyFramesWithQuaternions) {
+  RecoverPerturbedBodyFrames<BundleAdjustment::QuaternionRotation>();
+  RecoverPerturbedBodyFrames<BundleAdjustment::AngleAxisRotation>();
+}
+
+TEST(ProblemBuilder, DistortionFreeObservationsOfConstantCameras) {
+  // Image points are simulated without distortions, so that the distortions
+  // set afterwards are the (only) errors of the image points
+  ImageBlockType imageBlock;
+  ImageBlockType referenceImageBlock;
+  for (ImageBlockType *block : {&imageBlock, &referenceImageBlock}) {
+    PrepareImageBlock(*block);
+    for (Core::Handle handle = 0; handle < block->getNumberOfCameras();
+         ++handle) {
+      auto &distortionParameters =
+          block->getCamera(handle)->distortionParameters;
+      distortionParameters[1] = 1e-5;
+      distortionParameters[4] = 2e-5;
+    }
+  }
+
+  // Distortion-free fast path (camera1) and full model (camera2, which is
+  // self-calibrated)
+  ProblemBuilderType::Options options;
+  options.selfCalibrationCameraIds.push_back("camera2");
+  ProblemBuilderType builder(imageBlock, options);
+  builder.build();
+  EXPECT_TRUE(builder.isInteriorOrientationConstant(0));
+  EXPECT_FALSE(builder.isInteriorOrientationConstant(1));
+  auto &problem = builder.getProblem();
+  EXPECT_EQ(problem.NumParameterBlocks(), 49 + 8 + 2 + 2 + 1);
+  EXPECT_TRUE(problem.IsParameterBlockConstant(builder.getCameraParameters(0)));
+  EXPECT_FALSE(
+      problem.IsParameterBlockConstant(builder.getCameraParameters(1)));
+
+  // Full model for all image points
+  options.precorrectDistortions = false;
+  ProblemBuilderType referenceBuilder(referenceImageBlock, options);
+  referenceBuilder.build();
+  auto &referenceProblem = referenceBuilder.getProblem();
+
+  // Both have the same residuals
+  std::vector<ceres::ResidualBlockId> residualBlocks;
+  std::vector<ceres::ResidualBlockId> referenceResidualBlocks;
+  problem.GetResidualBlocks(&residualBlocks);
+  referenceProblem.GetResidualBlocks(&referenceResidualBlocks);
+  ASSERT_EQ(residualBlocks.size(), referenceResidualBlocks.size());
+  for (std::size_t i = 0; i < residualBlocks.size(); ++i) {
+    std::vector<double *> parameterBlocks;
+    std::vector<double *> referenceParameterBlocks;
+    problem.GetParameterBlocksForResidualBlock(residualBlocks[i],
+                                               &parameterBlocks);
+    referenceProblem.GetParameterBlocksForResidualBlock(
+        referenceResidualBlocks[i], &referenceParameterBlocks);
+    double residuals[2];
+    double referenceResiduals[2];
+    ASSERT_TRUE(problem.GetCostFunctionForResidualBlock(residualBlocks[i])
+                    ->Evaluate(parameterBlocks.data(), residuals, nullptr));
+    ASSERT_TRUE(referenceProblem
+                    .GetCostFunctionForResidualBlock(
+                        referenceResidualBlocks[i])
+                    ->Evaluate(referenceParameterBlocks.data(),
+                               referenceResiduals, nullptr));
+    EXPECT_GT(std::abs(referenceResiduals[0]) + std::abs(referenceResiduals[1]),
+              1e-6);
+    EXPECT_NEAR(residuals[0], referenceResiduals[0], 1e-9);
+    EXPECT_NEAR(residuals[1], referenceResiduals[1], 1e-9);
+  }
+
+  // IOPs of the distortion-free camera made variable without building the
+  // problem again
+  ceres::Solver::Options solverOptions;
+  EXPECT_NO_THROW(builder.configureSolverOptions(solverOptions));
+  problem.SetParameterBlockVariable(builder.getCameraParameters(0));
+  EXPECT_THROW(builder.configureSolverOptions(solverOptions),
+               std::runtime_error);
+  referenceProblem.SetParameterBlockVariable(
+      referenceBuilder.getCameraParameters(0));
+  EXPECT_NO_THROW(referenceBuilder.configureSolverOptions(solverOptions));
+}
@@ -0,0 +1,113 @@
+#include "ProjectionKernel.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using BundleAdjustment::BundleAdjustmentModel;
+using BundleAdjustment::ProjectionKernel;
+
+namespace {
+// Parameter blocks of a non-reference camera on a multi-camera platform
+const double Camera[12] = {0.1, -0.2, 50.0, 0.0, 1e-5, 1e-8,
+                           1e-11, 1e-4, 2e-4, 1e-5, 1e-4, 2e-4};
+const double BodyFrame[6] = {95.0, 210.0, 1000.0, 0.02, -0.03, 0.5};
+const double RefCameraToBodyFrame[6] = {0.1, 0.2, -0.3, 0.01, 0.02, 0.03};
+const double NonRefCameraToRefCamera[6] = {0.3, -0.1, 0.05, 0.15, -0.05, 0.1};
+
+/// Object points below the camera (37 points, i.e., with remainders for all
+/// vector widths)
+std::vector<double> PrepareObjectPoints() {
+  std::vector<double> objectPoints;
+  for (unsigned int i = 0; i < 37; ++i) {
+    objectPoints.push_back(60.0 + 2.0 * i);
+    objectPoints.push_back(250.0 - 3.0 * (i % 7));
+    objectPoints.push_back(5.0 * (i % 3));
+  }
+  return objectPoints;
+}
+
+/// All instruction sets supported by the build and the CPU
+std::vector<ProjectionKernel::InstructionSet> GetInstructionSets() {
+  std::vector<ProjectionKernel::InstructionSet> instructionSets;
+  for (const auto instructionSet : {ProjectionKernel::InstructionSet::Scalar,
+                                    ProjectionKernel::InstructionSet::AVX2,
+                                    ProjectionKernel::InstructionSet::AVX512}) {
+    if (ProjectionKernel::IsSupported(instructionSet)) {
+      instructionSets.push_back(instructionSet);
+    }
+  }
+  return instructionSets;
+}
+} // namespace
+
+TEST(ProjectionKernel, MatchesCollinearityProjection) {
+  const std::vector<double> objectPoints = PrepareObjectPoints();
+  const std::size_t size = objectPoints.size() / 3;
+  ProjectionKernel kernel = ProjectionKernel::Create(
+      Camera, BodyFrame, RefCameraToBodyFrame, NonRefCameraToRefCamera);
+  EXPECT_EQ(kernel.getInstructionSet(),
+            ProjectionKernel::GetDefaultInstructionSet());
+
+  for (const auto instructionSet : GetInstructionSets()) {
+    kernel.setInstructionSet(instructionSet);
+    std::vector<double> x(size);
+    std::vector<double> y(size);
+    std::vector<double> depths(size);
+    kernel.project(size, objectPoints.data(), x.data(), y.data(),
+                   depths.data());
+    for (std::size_t i = 0; i < size; ++i) {
+      double projection[2];
+      BundleAdjustmentModel::ComputeCollinearityProjection(
+          Camera, objectPoints.data() + 3 * i, BodyFrame, RefCameraToBodyFrame,
+          NonRefCameraToRefCamera, projection);
+      EXPECT_NEAR(x[i], projection[0], 1e-10)
+          << "instruction set " << static_cast<int>(instructionSet)
+          << ", point " << i;
+      EXPECT_NEAR(y[i], projection[1], 1e-10)
+          << "instruction set " << static_cast<int>(instructionSet)
+          << ", point " << i;
+      // The points are in front of the camera
+      EXPECT_LT(depths[i], -900.0);
+    }
+
+    // Without depths
+    std::vector<double> xWithoutDepths(size);
+    std::vector<double> yWithoutDepths(size);
+    kernel.project(size, objectPoints.data(), xWithoutDepths.data(),
+                   yWithoutDepths.data());
+    EXPECT_EQ(xWithoutDepths, x);
+    EXPECT_EQ(yWithoutDepths, y);
+  }
+}
+
+TEST(ProjectionKernel, RotationParameterizations) {
+  using BundleAdjustment::QuaternionRotation;
+  const std::vector<double> objectPoints = PrepareObjectPoints();
+  const std::size_t size = objectPoints.size() / 3;
+  const double *eulerPoses[] = {BodyFrame, RefCameraToBodyFrame,
+                                NonRefCameraToRefCamera};
+  double poses[3][7];
+  for (unsigned int i = 0; i < 3; ++i) {
+    std::copy(eulerPoses[i], eulerPoses[i] + 3, poses[i]);
+    QuaternionRotation::FromEulerAngles(eulerPoses[i] + 3, poses[i] + 3);
+  }
+
+  std::vector<double> expectedX(size);
+  std::vector<double> expectedY(size);
+  ProjectionKernel::Create(Camera, BodyFrame, RefCameraToBodyFrame,
+                           NonRefCameraToRefCamera)
+      .project(size, objectPoints.data(), expectedX.data(), expectedY.data());
+  std::vector<double> x(size);
+  std::vector<double> y(size);
+  ProjectionKernel::Create<QuaternionRotation>(Camera, poses[0], poses[1],
+                                               poses[2])
+      .project(size, objectPoints.data(), x.data(), y.data());
+  for (std::size_t i = 0; i < size; ++i) {
+    EXPECT_NEAR(x[i], expectedX[i], 1e-10);
+    EXPECT_NEAR(y[i], expectedY[i], 1e-10);
+  }
+}
@@ -0,0 +1,199 @@
+#include "RigTransformCache.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using BundleAdjustment::BundleAdjustmentModel;
+using BundleAdjustment::EulerAnglesRotation;
+using BundleAdjustment::NumberOfCameraParameters;
+using BundleAdjustment::NumberOfPoseParameters;
+using CacheType = BundleAdjustment::RigTransformCache<EulerAnglesRotation>;
+using CachedCostType =
+    BundleAdjustment::CollinearityCachedCost<EulerAnglesRotation>;
+
+namespace {
+// Parameter blocks of two epochs of a non-reference camera on a multi-camera
+// platform
+struct RigParameters {
+  double camera[NumberOfCameraParameters] = {
+      0.1, -0.2, 50.0, 0.0, 1e-5, 1e-8, 1e-11, 1e-4, 2e-4, 1e-5, 1e-4, 2e-4};
+  double point[3] = {100.0, 200.0, 5.0};
+  double bodyFrames[2][NumberOfPoseParameters] = {
+      {95.0, 210.0, 1000.0, 0.02, -0.03, 0.5},
+      {105.0, 190.0, 990.0, -0.01, 0.04, 0.6}};
+  double refCameraToBodyFrame[NumberOfPoseParameters] = {0.1,   0.2,  -0.3,
+                                                         0.01, 0.02, 0.03};
+  double nonRefCameraToRefCamera[NumberOfPoseParameters] = {0.3,   -0.1, 0.05,
+                                                            0.15, -0.05, 0.1};
+
+  std::vector<double *> blocks(const unsigned int epoch) {
+    return {camera, point, bodyFrames[epoch], refCameraToBodyFrame,
+            nonRefCameraToRefCamera};
+  }
+};
+
+// Evaluate cost function with Jacobians stored in row-major order
+void EvaluateCost(const ceres::CostFunction &costFunction,
+                  std::vector<double *> blocks, double residuals[2],
+                  std::vector<std::vector<double>> &jacobians) {
+  std::vector<double *> jacobianPointers;
+  jacobians.resize(blocks.size());
+  for (unsigned int i = 0; i < blocks.size(); ++i) {
+    jacobians[i].assign(2 * costFunction.parameter_block_sizes()[i], 0.0);
+    jacobianPointers.push_back(jacobians[i].data());
+  }
+  ASSERT_TRUE(costFunction.Evaluate(blocks.data(), residuals,
+                                    jacobianPointers.data()));
+}
+
+// Compare the cached cost with the analytic cost of the image point
+void CompareWithAnalyticCost(const CachedCostType &cachedCost,
+                             RigParameters &params, const unsigned int epoch,
+                             const Eigen::Vector2d &imagePoint) {
+  BundleAdjustmentModel::CollinearityFrameCameraAnalyticCost analyticCost(
+      imagePoint);
+  double residuals[2];
+  double expectedResiduals[2];
+  std::vector<std::vector<double>> jacobians;
+  std::vector<std::vector<double>> expectedJacobians;
+  EvaluateCost(cachedCost, params.blocks(epoch), residuals, jacobians);
+  EvaluateCost(analyticCost, params.blocks(epoch), expectedResiduals,
+               expectedJacobians);
+  EXPECT_NEAR(residuals[0], expectedResiduals[0], 1e-12);
+  EXPECT_NEAR(residuals[1], expectedResiduals[1], 1e-12);
+  for (unsigned int block = 0; block < jacobians.size(); ++block) {
+    for (unsigned int i = 0; i < jacobians[block].size(); ++i) {
+      EXPECT_NEAR(jacobians[block][i], expectedJacobians[block][i],
+                  1e-12 * (1.0 + std::abs(expectedJacobians[block][i])))
+          << "block " << block << ", element " << i;
+    }
+  }
+}
+} // namespace
+
+TEST(RigTransformCache, ComposesTransformations) {
+  RigParameters params;
+  CacheType cache;
+  for (unsigned int epoch = 0; epoch < 2; ++epoch) {
+    EXPECT_EQ(cache.addRigTransform(params.bodyFrames[epoch],
+                                    params.refCameraToBodyFrame,
+                                    params.nonRefCameraToRefCamera),
+              epoch);
+  }
+  EXPECT_EQ(cache.getNumberOfRigTransforms(), 2);
+  EXPECT_FALSE(cache.isUpToDate());
+
+  // Residuals only, then Jacobians at the same point
+  cache.PrepareForEvaluation(false, true);
+  EXPECT_TRUE(cache.isUpToDate());
+  EXPECT_FALSE(cache.hasDerivatives());
+  cache.PrepareForEvaluation(true, false);
+  EXPECT_TRUE(cache.hasDerivatives());
+
+  for (unsigned int epoch = 0; epoch < 2; ++epoch) {
+    BundleAdjustmentModel::RigTransform<EulerAnglesRotation> expected;
+    BundleAdjustmentModel::ComposeRigTransform(
+        params.bodyFrames[epoch], params.refCameraToBodyFrame,
+        params.nonRefCameraToRefCamera, expected, true);
+    const auto &rigTransform = cache.getRigTransform(epoch);
+    EXPECT_TRUE(rigTransform.rotation.isApprox(expected.rotation, 1e-15));
+    EXPECT_TRUE(
+        rigTransform.translation.isApprox(expected.translation, 1e-15));
+    for (unsigned int i = 0; i < 9; ++i) {
+      EXPECT_TRUE(rigTransform.rotationDerivatives[i].isApprox(
+          expected.rotationDerivatives[i], 1e-15));
+    }
+  }
+
+  // A new evaluation point (e.g., a new body frame)
+  params.bodyFrames[1][5] += 0.1;
+  cache.PrepareForEvaluation(false, true);
+  EXPECT_FALSE(cache.hasDerivatives());
+  BundleAdjustmentModel::RigTransform<EulerAnglesRotation> expected;
+  BundleAdjustmentModel::ComposeRigTransform(
+      params.bodyFrames[1], params.refCameraToBodyFrame,
+      params.nonRefCameraToRefCamera, expected, false);
+  EXPECT_TRUE(cache.getRigTransform(1).rotation.isApprox(expected.rotation,
+                                                         1e-15));
+  EXPECT_TRUE(cache.isComposedFrom(1, params.bodyFrames[1],
+                                   params.refCameraToBodyFrame,
+                                   params.nonRefCameraToRefCamera));
+
+  // Pose blocks modified outside of ceres, and an invalidated cache
+  params.refCameraToBodyFrame[0] += 0.1;
+  EXPECT_FALSE(cache.isComposedFrom(1, params.bodyFrames[1],
+                                    params.refCameraToBodyFrame,
+                                    params.nonRefCameraToRefCamera));
+  cache.invalidate();
+  EXPECT_FALSE(cache.isUpToDate());
+  EXPECT_FALSE(cache.hasDerivatives());
+}
+
+TEST(RigTransformCache, CachedCostMatchesAnalyticCost) {
+  RigParameters params;
+  CacheType cache;
+  std::vector<std::unique_ptr<CachedCostType>> costs;
+  const Eigen::Vector2d imagePoints[2] = {Eigen::Vector2d(2.5, -1.5),
+                                          Eigen::Vector2d(-3.0, 4.0)};
+  for (unsigned int epoch = 0; epoch < 2; ++epoch) {
+    const std::size_t index = cache.addRigTransform(
+        params.bodyFrames[epoch], params.refCameraToBodyFrame,
+        params.nonRefCameraToRefCamera);
+    costs.emplace_back(new CachedCostType(cache, index, imagePoints[epoch],
+                                          Eigen::Matrix2d::Identity()));
+  }
+
+  // The cache is not up to date, or holds no derivatives
+  CompareWithAnalyticCost(*costs[1], params, 1, imagePoints[1]);
+  cache.update(false);
+  CompareWithAnalyticCost(*costs[1], params, 1, imagePoints[1]);
+
+  // Transformations and derivatives from the cache
+  cache.PrepareForEvaluation(true, true);
+  for (unsigned int epoch = 0; epoch < 2; ++epoch) {
+    CompareWithAnalyticCost(*costs[epoch], params, epoch,
+                            imagePoints[epoch]);
+  }
+
+  // Stale transformations (i.e., pose blocks modified after the update)
+  params.bodyFrames[0][3] += 0.05;
+  params.nonRefCameraToRefCamera[1] -= 0.2;
+  for (unsigned int epoch = 0; epoch < 2; ++epoch) {
+    CompareWithAnalyticCost(*costs[epoch], params, epoch,
+                            imagePoints[epoch]);
+  }
+}
+
+TEST(RigTransformCache, DistortionFreeCachedCost) {
+  RigParameters params;
+  CacheType cache;
+  const std::size_t index = cache.addRigTransform(
+      params.bodyFrames[0], params.refCameraToBodyFrame,
+      params.nonRefCameraToRefCamera);
+  cache.update(true);
+  const Eigen::Vector2d imagePoint(2.5, -1.5);
+  CachedCostType cachedCost(cache, index, imagePoint,
+                            Eigen::Matrix2d::Identity(), true);
+  BundleAdjustmentModel::CollinearityDistortionFreeCost<EulerAnglesRotation>
+      distortionFreeCost(imagePoint);
+
+  double residuals[2];
+  double expectedResiduals[2];
+  std::vector<std::vector<double>> jacobians;
+  std::vector<std::vector<double>> expectedJacobians;
+  EvaluateCost(cachedCost, params.blocks(0), residuals, jacobians);
+  EvaluateCost(distortionFreeCost, params.blocks(0), expectedResiduals,
+               expectedJacobians);
+  EXPECT_NEAR(residuals[0], expectedResiduals[0], 1e-12);
+  EXPECT_NEAR(residuals[1], expectedResiduals[1], 1e-12);
+  for (unsigned int block = 0; block < jacobians.size(); ++block) {
+    for (unsigned int i = 0; i < jacobians[block].size(); ++i) {
+      EXPECT_NEAR(jacobians[block][i], expectedJacobians[block][i],
+                  1e-12 * (1.0 + std::abs(expectedJacobians[block][i])));
+    }
+  }
+}
@@ -6,8 +6,28 @@
 #include "ceres/rotation.h"
 
 #include "ImageBlock.h"
+#include "RotationParameterization.h"
 
 namespace BundleAdjustment {
+/// Number of distortion parameters of the default frame camera model
+constexpr int NumberOfDistortionParameters =
+    Core::BrownDistortion::NumberOfParameters;
+/// Number of camera parameters (i.e., xp, yp, c and distortion parameters)
+constexpr int NumberOfCameraParameters = 3 + NumberOfDistortionParameters;
+/// Number of camera parameters with the given distortion model (see
+/// Core/DistortionModel.h)
+template <typename TDistortion> constexpr int GetNumberOfCameraParameters() {
+  return 3 + TDistortion::NumberOfParameters;
+}
+/// Number of parameters for each set of EOPs (i.e., X, Y, Z, omega, phi and
+/// kappa; rotation angles are in radians)
+constexpr int NumberOfPoseParameters = 6;
+/// Number of parameters for each set of EOPs with the given rotation
+/// parameterization (i.e., X, Y, Z and the rotation parameters)
+template <typename TRotation> constexpr int GetNumberOfPoseParameters() {
+  return 3 + TRotation::NumberOfParameters;
+}
+
 class BundleAdjustmentModel {
 public:
   /// Defalut constructor and destructor
@@ -20,6 +40,8 @@ public:
    * @param[in] cameraIOPs A (3 + n) x 1 array containing IOPs of the utilized
    * cameras (i.e., xp, yp, c and n distortion parameters)
    * @param[in] objectPoint A 3 x 1 array containing object point coordinates
+   * Note: The pose arrays are (3 + n) x 1 arrays with the n rotation
+   * parameters of TRotation (i.e., 6 x 1 arrays for the default Euler angles).
    * @param[in] bodyFrameParams A 6 x 1 array containing the eops of the body
    * frame at each imaging epoch (Note: If a direct geo-referencing unit is
    * onboard, the body frame is defined at the center of GNSS/INS unit.
@@ -31,31 +53,257 @@ public:
    * @param[in] nonRefCameraToRefCameraParams A 6 x 1 array contaning the
    * relative orientation parameters (i.e., lever-arm and bore-sight angles)
    * from the non-reference camera to the reference one
-   * @param[in] residuals The 2 x 1 residual array (i.e, residuals for x and y
-   * image coordinates)
-   * @param[in] imagePoint Image coordinates with variance and co-variance
-   * matrix
-   * @param[in] distortionModelFunctor The function to compute distortions at
-   * the image point with given camera IOPs
+   * @param[out] projection The 2 x 1 array of distortion-free image
+   * coordinates (i.e., xp - c * X / Z and yp - c * Y / Z)
    */
-  template <typename TDataType, typename TDistortionFunctorType>
+  template <typename TDataType, typename TRotation = EulerAnglesRotation>
   static void ComputeCollinearityProjection(
-      const TDataType *const objectPoint,
+      const TDataType *const cameraIOPs, const TDataType *const objectPoint,
       const TDataType *const bodyFrameParams,
       const TDataType *const refCameraToBodyFrameParams,
-      const TDataType *const nonRefCameraToRefCameraParams);
+      const TDataType *const nonRefCameraToRefCameraParams,
+      TDataType *projection);
+
+  /**
+   * This function computes the distortions at a measured image point with the
+   * given distortion model of Core::InteriorOrientation
+   * @param[in] cameraIOPs A (3 + n) x 1 array containing xp, yp, c and the n
+   * distortion parameters of TDistortion (i.e., 12 x 1 for the default
+   * Core::BrownDistortion)
+   * @param[in] x x coordinate of the measured image point
+   * @param[in] y y coordinate of the measured image point
+   * @param[out] distortion The 2 x 1 array of image distortions
+   */
+  template <typename TDataType, typename TDistortion = Core::BrownDistortion>
+  static void ComputeDistortion(const TDataType *const cameraIOPs,
+                                const TDataType x, const TDataType y,
+                                TDataType *distortion);
+
+  /**
+   * This function computes the upper-triangular square root of the inverse of
+   * a 2 x 2 variance-covariance matrix, which is used to weight the residuals
+   * of an image point.
+   */
+  static Eigen::Matrix2d
+  ComputeSquareRootInformation(const Eigen::Matrix2d &covariance);
+
+  /**
+   * This is the struct containing the composed transformation from a (either
+   * reference or non-reference) camera to the mapping frame, i.e.,
+   * R = R_b_m * R_c_b * R_cj_c and T = r_b_m + R_b_m * (r_c_b + R_c_b *
+   * r_cj_c), together with its partial derivatives w.r.t. the body frame,
+   * reference camera and non-reference camera parameters.
+   */
+  template <typename TRotation = EulerAnglesRotation> struct RigTransform {
+    /// Number of rotation parameters of each pose
+    static constexpr int NumberOfRotationParameters =
+        TRotation::NumberOfParameters;
+
+    /// Rotation from camera to mapping frame
+    Eigen::Matrix3d rotation;
+    /// Perspective center of the camera in the mapping frame
+    Eigen::Vector3d translation;
+    /// dR/drotation for the body frame, reference camera and non-reference
+    /// camera (NumberOfRotationParameters matrices each)
+    Eigen::Matrix3d rotationDerivatives[3 * NumberOfRotationParameters];
+    /// dT/dt for the body frame, reference camera and non-reference camera
+    Eigen::Matrix3d translationDerivatives[3];
+    /// dT/drotation for the body frame and reference camera (in this order);
+    /// T does not depend on the non-reference camera rotation
+    Eigen::Matrix<double, 3, 2 * NumberOfRotationParameters>
+        translationAngleDerivatives;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /**
+   * This function composes the body frame, reference camera and non-reference
+   * camera parameters into a single camera to mapping transformation.
+   * @param[in] withDerivatives Flag to compute the partial derivatives
+   * Note: It is instantiated for EulerAnglesRotation, AngleAxisRotation and
+   * QuaternionRotation in BundleAdjustmentModel.cpp.
+   */
+  template <typename TRotation>
+  static void ComposeRigTransform(
+      const double *const bodyFrameParams,
+      const double *const refCameraToBodyFrameParams,
+      const double *const nonRefCameraToRefCameraParams,
+      RigTransform<TRotation> &rigTransform, const bool withDerivatives);
+
+  /**
+   * This function evaluates the weighted collinearity residuals of a reduced,
+   * distortion-free image point (i.e., x - xp - distortion and
+   * y - yp - distortion) for a given composed rig transformation, together
+   * with the analytic Jacobians of the object point, body frame, reference
+   * camera and non-reference camera (i.e., jacobians[1] to jacobians[4] in
+   * the parameter block layout of CollinearityAnalyticCost; jacobians[0] is
+   * left to the caller)
+   * @param[in] c Principal distance
+   * @param[out] normalizedPoint The 2 x 1 array of X / Z and Y / Z of the
+   * object point in the camera frame (i.e., d(error)/dc)
+   */
+  template <typename TRotation>
+  static bool EvaluateReducedCollinearity(
+      const double c, const Eigen::Vector2d &reducedImagePoint,
+      const double *const objectPoint,
+      const RigTransform<TRotation> &rigTransform,
+      const Eigen::Matrix2d &sqrtInformation, double *residuals,
+      double **jacobians, double *normalizedPoint);
+
+  /**
+   * This function evaluates the weighted collinearity residuals of an image
+   * point for a given composed rig transformation, together with the analytic
+   * Jacobians in the parameter block layout of CollinearityAnalyticCost
+   * (i.e., camera, point, body frame, reference camera and non-reference
+   * camera)
+   */
+  template <typename TRotation, typename TDistortion = Core::BrownDistortion>
+  static bool EvaluateCollinearity(const double *const cameraIOPs,
+                                   const double *const objectPoint,
+                                   const RigTransform<TRotation> &rigTransform,
+                                   const Eigen::Vector2d &imagePoint,
+                                   const Eigen::Matrix2d &sqrtInformation,
+                                   double *residuals, double **jacobians);
+
+  /**
+   * This function is the counterpart of EvaluateCollinearity for image points
+   * corrected for the distortions up front (see
+   * CollinearityDistortionFreeCost)
+   */
+  template <typename TRotation, typename TDistortion = Core::BrownDistortion>
+  static bool EvaluateDistortionFreeCollinearity(
+      const double *const cameraIOPs, const double *const objectPoint,
+      const RigTransform<TRotation> &rigTransform,
+      const Eigen::Vector2d &imagePoint,
+      const Eigen::Matrix2d &sqrtInformation, double *residuals,
+      double **jacobians);
 
   /**
    * This is the struct containing the collinearity model for platforms equipped
    * with either single or multiple frame cameras
+   * Note: This functor is meant for automatic differentiation. The analytic
+   * counterpart CollinearityAnalyticCost should be preferred for large image
+   * blocks. The camera IOPs are xp, yp, c and the distortion parameters of
+   * TDistortion.
    */
-  struct CollinearityFrameCameraCost {
+  template <typename TRotation, typename TDistortion = Core::BrownDistortion>
+  struct CollinearityCost {
   public:
+    /**
+     * Constructor
+     * @param[in] imagePoint Measured image coordinates (i.e., x and y)
+     * @param[in] sqrtInformation Square root of the information matrix of the
+     * image point
+     */
+    CollinearityCost(const Eigen::Vector2d &imagePoint,
+                     const Eigen::Matrix2d &sqrtInformation);
+
     template <typename TDataType>
     bool operator()(const TDataType *const camera, const TDataType *const point,
-                    const TDataType *const eops,
-                    const TDataType *residuals) const;
+                    const TDataType *const bodyFrameParams,
+                    const TDataType *const refCameraToBodyFrameParams,
+                    const TDataType *const nonRefCameraToRefCameraParams,
+                    TDataType *residuals) const;
+
+    /// Create an auto-differentiated cost function
+    static ceres::CostFunction *
+    Create(const Eigen::Vector2d &imagePoint,
+           const Eigen::Matrix2d &sqrtInformation =
+               Eigen::Matrix2d::Identity());
+
+  private:
+    Eigen::Vector2d mImagePoint;
+    Eigen::Matrix2d mSqrtInformation;
+
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /**
+   * This is the collinearity model with hand-derived Jacobians for platforms
+   * equipped with either single or multiple frame cameras.
+   * Parameter blocks: camera IOPs (3 + m, where m is the number of
+   * distortion parameters of TDistortion), object point (3), body frame EOPs,
+   * reference camera to body frame, and non-reference camera to reference
+   * camera (3 + n each, where n is the number of rotation parameters)
+   */
+  template <typename TRotation, typename TDistortion = Core::BrownDistortion>
+  class CollinearityAnalyticCost
+      : public ceres::SizedCostFunction<
+            2, GetNumberOfCameraParameters<TDistortion>(), 3,
+            GetNumberOfPoseParameters<TRotation>(),
+            GetNumberOfPoseParameters<TRotation>(),
+            GetNumberOfPoseParameters<TRotation>()> {
+  public:
+    /**
+     * Constructor
+     * @param[in] imagePoint Measured image coordinates (i.e., x and y)
+     * @param[in] sqrtInformation Square root of the information matrix of the
+     * image point
+     */
+    CollinearityAnalyticCost(
+        const Eigen::Vector2d &imagePoint,
+        const Eigen::Matrix2d &sqrtInformation = Eigen::Matrix2d::Identity());
+
+    bool Evaluate(double const *const *parameters, double *residuals,
+                  double **jacobians) const override;
+
+  private:
+    Eigen::Vector2d mImagePoint;
+    Eigen::Matrix2d mSqrtInformation;
+
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /**
+   * This is the collinearity model for cameras with constant IOPs, whose
+   * image points are corrected for the distortions once, up front (e.g., by
+   * Core::ImageBlock::computeImageCoordinates). The distortion polynomial is
+   * not evaluated at all, which saves most of the cost of
+   * CollinearityAnalyticCost for calibrated cameras.
+   * Parameter blocks: the same as CollinearityAnalyticCost, so that both
+   * costs can be exchanged without touching the parameter blocks. The
+   * distortion parameters are not used, and the partial derivatives w.r.t.
+   * the camera IOPs treat the distortion corrections as constants (i.e.,
+   * they are only exact for a constant IOP block).
+   */
+  template <typename TRotation, typename TDistortion = Core::BrownDistortion>
+  class CollinearityDistortionFreeCost
+      : public ceres::SizedCostFunction<
+            2, GetNumberOfCameraParameters<TDistortion>(), 3,
+            GetNumberOfPoseParameters<TRotation>(),
+            GetNumberOfPoseParameters<TRotation>(),
+            GetNumberOfPoseParameters<TRotation>()> {
+  public:
+    /**
+     * Constructor
+     * @param[in] imagePoint Distortion-free image coordinates of the measured
+     * image point (i.e., x - distortion and y - distortion)
+     * @param[in] sqrtInformation Square root of the information matrix of the
+     * image point
+     */
+    CollinearityDistortionFreeCost(
+        const Eigen::Vector2d &imagePoint,
+        const Eigen::Matrix2d &sqrtInformation = Eigen::Matrix2d::Identity());
+
+    bool Evaluate(double const *const *parameters, double *residuals,
+                  double **jacobians) const override;
+
+  private:
+    Eigen::Vector2d mImagePoint;
+    Eigen::Matrix2d mSqrtInformation;
+
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
+
+  /// Collinearity models with Euler angles and the default distortion model
+  /// (i.e., the parameter layout of Core::ExteriorOrientation and
+  /// Core::InteriorOrientation)
+  using CollinearityFrameCameraCost = CollinearityCost<EulerAnglesRotation>;
+  using CollinearityFrameCameraAnalyticCost =
+      CollinearityAnalyticCost<EulerAnglesRotation>;
 };
 } // namespace BundleAdjustment
 
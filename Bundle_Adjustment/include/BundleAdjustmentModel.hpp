@@ -1,11 +1,13 @@
 #include "BundleAdjustmentModel.h"
 
 namespace BundleAdjustment {
-template <typename TDataType>
-void ComputeCollinearityProjection(
-    const TDataType *const objectPoint, const TDataType *const bodyFrameParams,
+template <typename TDataType, typename TRotation>
+void BundleAdjustmentModel::ComputeCollinearityProjection(
+    const TDataType *const cameraIOPs, const TDataType *const objectPoint,
+    const TDataType *const bodyFrameParams,
     const TDataType *const refCameraToBodyFrameParams,
-    const TDataType *const nonRefCameraToRefCameraParams) {
+    const TDataType *const nonRefCameraToRefCameraParams,
+    TDataType *projection) {
   /// Object point coordinates in mapping frame
   Eigen::Matrix<TDataType, 3, 1> rIm;
   rIm(0) = *(objectPoint + 0);
@@ -19,26 +21,313 @@ void ComputeCollinearityProjection(
   translationFromBodyFrameToMapping(1) = *(bodyFrameParams + 1);
   translationFromBodyFrameToMapping(2) = *(bodyFrameParams + 2);
   // Rotation
-  Eigen::Matrix<TDataType, 3, 1> rotationAngles;
-  rotationAngles(0) = *(bodyFrameParams + 3);
-  rotationAngles(1) = *(bodyFrameParams + 4);
-  rotationAngles(2) = *(bodyFrameParams + 5);
-  auto rotationFromBodyFrameToMapping = Core::ExteriorOrientation<
-      TDataType>::CreateRotationMatrixFromEluerAnglesInRadians(rotationAngles);
-
-  /// From reference camera to mapping frame
+  Eigen::Matrix<TDataType, 3, 3> rotationFromBodyFrameToMapping;
+  TRotation::ToRotationMatrix(bodyFrameParams + 3,
+                              rotationFromBodyFrameToMapping);
+
+  /// From reference camera to body frame
   // Translation
   Eigen::Matrix<TDataType, 3, 1> translationFromRefCameraToBodyFrame;
   translationFromRefCameraToBodyFrame(0) = *(refCameraToBodyFrameParams + 0);
   translationFromRefCameraToBodyFrame(1) = *(refCameraToBodyFrameParams + 1);
   translationFromRefCameraToBodyFrame(2) = *(refCameraToBodyFrameParams + 2);
   // Rotation
-  rotationAngles(0) = *(refCameraToBodyFrameParams + 3);
-  rotationAngles(1) = *(refCameraToBodyFrameParams + 4);
-  rotationAngles(2) = *(refCameraToBodyFrameParams + 5);
-  auto rotationFromRefCameraToMapping = Core::ExteriorOrientation<
-      TDataType>::CreateRotationMatrixFromEluerAnglesInRadians(rotationAngles);
+  Eigen::Matrix<TDataType, 3, 3> rotationFromRefCameraToBodyFrame;
+  TRotation::ToRotationMatrix(refCameraToBodyFrameParams + 3,
+                              rotationFromRefCameraToBodyFrame);
 
   /// From non-reference camera to reference camera
+  // Translation
+  Eigen::Matrix<TDataType, 3, 1> translationFromNonRefCameraToRefCamera;
+  translationFromNonRefCameraToRefCamera(0) =
+      *(nonRefCameraToRefCameraParams + 0);
+  translationFromNonRefCameraToRefCamera(1) =
+      *(nonRefCameraToRefCameraParams + 1);
+  translationFromNonRefCameraToRefCamera(2) =
+      *(nonRefCameraToRefCameraParams + 2);
+  // Rotation
+  Eigen::Matrix<TDataType, 3, 3> rotationFromNonRefCameraToRefCamera;
+  TRotation::ToRotationMatrix(nonRefCameraToRefCameraParams + 3,
+                              rotationFromNonRefCameraToRefCamera);
+
+  /// From camera to mapping frame
+  // R_cj_m = R_b_m * R_c_b * R_cj_c
+  Eigen::Matrix<TDataType, 3, 3> rotationFromCameraToMapping =
+      rotationFromBodyFrameToMapping * rotationFromRefCameraToBodyFrame *
+      rotationFromNonRefCameraToRefCamera;
+  // r_cj_m = r_b_m + R_b_m * (r_c_b + R_c_b * r_cj_c)
+  Eigen::Matrix<TDataType, 3, 1> translationFromCameraToMapping =
+      translationFromBodyFrameToMapping +
+      rotationFromBodyFrameToMapping *
+          (translationFromRefCameraToBodyFrame +
+           rotationFromRefCameraToBodyFrame *
+               translationFromNonRefCameraToRefCamera);
+
+  /// Object point in the camera frame
+  Eigen::Matrix<TDataType, 3, 1> rIc = rotationFromCameraToMapping.transpose() *
+                                       (rIm - translationFromCameraToMapping);
+
+  /// Distortion-free image coordinates
+  const TDataType xp = *(cameraIOPs + 0);
+  const TDataType yp = *(cameraIOPs + 1);
+  const TDataType c = *(cameraIOPs + 2);
+  projection[0] = xp - c * rIc(0) / rIc(2);
+  projection[1] = yp - c * rIc(1) / rIc(2);
+}
+
+template <typename TDataType, typename TDistortion>
+void BundleAdjustmentModel::ComputeDistortion(const TDataType *const cameraIOPs,
+                                              const TDataType x,
+                                              const TDataType y,
+                                              TDataType *distortion) {
+  // Note: This is the array version of
+  // Core::InteriorOrientation::calculateDistortion
+  TDistortion::Compute(cameraIOPs + 3, cameraIOPs[2], x - cameraIOPs[0],
+                       y - cameraIOPs[1], distortion);
+}
+
+template <typename TRotation>
+bool BundleAdjustmentModel::EvaluateReducedCollinearity(
+    const double c, const Eigen::Vector2d &reducedImagePoint,
+    const double *const objectPoint,
+    const RigTransform<TRotation> &rigTransform,
+    const Eigen::Matrix2d &sqrtInformation, double *residuals,
+    double **jacobians, double *normalizedPoint) {
+  /// Object point in the camera frame: p = R^T * (rIm - T)
+  const Eigen::Vector3d difference =
+      Eigen::Map<const Eigen::Vector3d>(objectPoint) - rigTransform.translation;
+  const Eigen::Vector3d rIc = rigTransform.rotation.transpose() * difference;
+  if (rIc(2) == 0.0) {
+    return false;
+  }
+
+  const double inverseZ = 1.0 / rIc(2);
+  const double u = rIc(0) * inverseZ;
+  const double v = rIc(1) * inverseZ;
+  normalizedPoint[0] = u;
+  normalizedPoint[1] = v;
+
+  /// Unweighted residuals: measured - xp - distortion - (-c * X / Z)
+  const Eigen::Vector2d error(reducedImagePoint[0] + c * u,
+                              reducedImagePoint[1] + c * v);
+  Eigen::Map<Eigen::Vector2d> weightedResiduals(residuals);
+  weightedResiduals = sqrtInformation * error;
+
+  if (jacobians == nullptr) {
+    return true;
+  }
+
+  typedef Eigen::Matrix<double, 2, 3, Eigen::RowMajor> Matrix23;
+  /// d(error)/d(rIc)
+  Matrix23 errorWrtCameraPoint;
+  errorWrtCameraPoint << c * inverseZ, 0.0, -c * u * inverseZ,
+      // 2nd row
+      0.0, c * inverseZ, -c * v * inverseZ;
+  /// Weighted d(residuals)/d(rIc) and d(residuals)/d(rIm) = ... * R^T
+  const Matrix23 residualWrtCameraPoint = sqrtInformation * errorWrtCameraPoint;
+  const Matrix23 residualWrtObjectPoint =
+      residualWrtCameraPoint * rigTransform.rotation.transpose();
+
+  // Object point
+  if (jacobians[1] != nullptr) {
+    Eigen::Map<Matrix23> jacobian(jacobians[1]);
+    jacobian = residualWrtObjectPoint;
+  }
+
+  // Body frame (2), reference camera (3) and non-reference camera (4)
+  constexpr int NumberOfRotationParameters = TRotation::NumberOfParameters;
+  for (int block = 0; block < 3; ++block) {
+    double *jacobianBlock = jacobians[2 + block];
+    if (jacobianBlock == nullptr) {
+      continue;
+    }
+    Eigen::Map<Eigen::Matrix<double, 2, GetNumberOfPoseParameters<TRotation>(),
+                             Eigen::RowMajor>>
+        jacobian(jacobianBlock);
+    // Translation: d(rIc)/dt = -R^T * dT/dt
+    jacobian.template leftCols<3>() =
+        -residualWrtObjectPoint * rigTransform.translationDerivatives[block];
+    // Rotation: d(rIc)/dangle = dR^T/dangle * (rIm - T) - R^T * dT/dangle
+    for (int i = 0; i < NumberOfRotationParameters; ++i) {
+      const int index = NumberOfRotationParameters * block + i;
+      Eigen::Vector3d cameraPointDerivative =
+          rigTransform.rotationDerivatives[index].transpose() * difference;
+      Eigen::Vector2d columnDerivative =
+          residualWrtCameraPoint * cameraPointDerivative;
+      if (block < 2) {
+        columnDerivative -=
+            residualWrtObjectPoint *
+            rigTransform.translationAngleDerivatives.col(index);
+      }
+      jacobian.col(3 + i) = columnDerivative;
+    }
+  }
+  return true;
+}
+
+template <typename TRotation, typename TDistortion>
+bool BundleAdjustmentModel::EvaluateCollinearity(
+    const double *const cameraIOPs, const double *const objectPoint,
+    const RigTransform<TRotation> &rigTransform,
+    const Eigen::Vector2d &imagePoint,
+    const Eigen::Matrix2d &sqrtInformation, double *residuals,
+    double **jacobians) {
+  const double xp = cameraIOPs[0];
+  const double yp = cameraIOPs[1];
+  const double c = cameraIOPs[2];
+
+  /// Distortions at the measured image point
+  const double *const distortionParameters = cameraIOPs + 3;
+  const double dx = imagePoint[0] - xp;
+  const double dy = imagePoint[1] - yp;
+  double distortion[2];
+  TDistortion::Compute(distortionParameters, c, dx, dy, distortion);
+
+  double normalizedPoint[2];
+  if (!EvaluateReducedCollinearity(
+          c, Eigen::Vector2d(dx - distortion[0], dy - distortion[1]),
+          objectPoint, rigTransform, sqrtInformation, residuals, jacobians,
+          normalizedPoint)) {
+    return false;
+  }
+
+  // Camera IOPs
+  if (jacobians != nullptr && jacobians[0] != nullptr) {
+    // Number of distortion parameters
+    constexpr int Size = TDistortion::NumberOfParameters;
+    typedef Eigen::Matrix<double, 2, 3 + Size, Eigen::RowMajor> CameraJacobian;
+    Eigen::Map<CameraJacobian> jacobian(jacobians[0]);
+    // Derivatives of the distortions w.r.t. dx, dy, c and the distortion
+    // parameters
+    Eigen::Matrix2d distortionWrtPoint;
+    Eigen::Matrix<double, 2, 1 + Size, Eigen::RowMajor> distortionWrtParameters;
+    TDistortion::ComputeJacobians(distortionParameters, c, dx, dy,
+                                  distortionWrtPoint, &distortionWrtParameters);
+
+    CameraJacobian errorWrtCamera;
+    // xp, yp (note: d(dx)/d(xp) = -1 and d(dy)/d(yp) = -1)
+    errorWrtCamera.template leftCols<2>() =
+        distortionWrtPoint - Eigen::Matrix2d::Identity();
+    // c and distortion parameters
+    errorWrtCamera.template rightCols<1 + Size>() = -distortionWrtParameters;
+    errorWrtCamera(0, 2) += normalizedPoint[0];
+    errorWrtCamera(1, 2) += normalizedPoint[1];
+    jacobian = sqrtInformation * errorWrtCamera;
+  }
+  return true;
+}
+
+template <typename TRotation, typename TDistortion>
+bool BundleAdjustmentModel::EvaluateDistortionFreeCollinearity(
+    const double *const cameraIOPs, const double *const objectPoint,
+    const RigTransform<TRotation> &rigTransform,
+    const Eigen::Vector2d &imagePoint,
+    const Eigen::Matrix2d &sqrtInformation, double *residuals,
+    double **jacobians) {
+  double normalizedPoint[2];
+  if (!EvaluateReducedCollinearity(
+          cameraIOPs[2],
+          Eigen::Vector2d(imagePoint[0] - cameraIOPs[0],
+                          imagePoint[1] - cameraIOPs[1]),
+          objectPoint, rigTransform, sqrtInformation, residuals, jacobians,
+          normalizedPoint)) {
+    return false;
+  }
+
+  // Camera IOPs (xp, yp and c only; the distortions are corrected already)
+  if (jacobians != nullptr && jacobians[0] != nullptr) {
+    typedef Eigen::Matrix<double, 2, GetNumberOfCameraParameters<TDistortion>(),
+                          Eigen::RowMajor>
+        CameraJacobian;
+    CameraJacobian errorWrtCamera = CameraJacobian::Zero();
+    errorWrtCamera(0, 0) = -1.0;
+    errorWrtCamera(1, 1) = -1.0;
+    errorWrtCamera(0, 2) = normalizedPoint[0];
+    errorWrtCamera(1, 2) = normalizedPoint[1];
+    Eigen::Map<CameraJacobian> jacobian(jacobians[0]);
+    jacobian = sqrtInformation * errorWrtCamera;
+  }
+  return true;
+}
+
+template <typename TRotation, typename TDistortion>
+BundleAdjustmentModel::CollinearityCost<TRotation, TDistortion>::
+    CollinearityCost(const Eigen::Vector2d &imagePoint,
+                     const Eigen::Matrix2d &sqrtInformation)
+    : mImagePoint(imagePoint), mSqrtInformation(sqrtInformation) {}
+
+template <typename TRotation, typename TDistortion>
+ceres::CostFunction *
+BundleAdjustmentModel::CollinearityCost<TRotation, TDistortion>::Create(
+    const Eigen::Vector2d &imagePoint, const Eigen::Matrix2d &sqrtInformation) {
+  return new ceres::AutoDiffCostFunction<
+      CollinearityCost, 2, GetNumberOfCameraParameters<TDistortion>(), 3,
+      GetNumberOfPoseParameters<TRotation>(),
+      GetNumberOfPoseParameters<TRotation>(),
+      GetNumberOfPoseParameters<TRotation>()>(
+      new CollinearityCost(imagePoint, sqrtInformation));
+}
+
+template <typename TRotation, typename TDistortion>
+BundleAdjustmentModel::CollinearityAnalyticCost<TRotation, TDistortion>::
+    CollinearityAnalyticCost(const Eigen::Vector2d &imagePoint,
+                             const Eigen::Matrix2d &sqrtInformation)
+    : mImagePoint(imagePoint), mSqrtInformation(sqrtInformation) {}
+
+template <typename TRotation, typename TDistortion>
+bool BundleAdjustmentModel::CollinearityAnalyticCost<
+    TRotation, TDistortion>::Evaluate(double const *const *parameters,
+                                      double *residuals,
+                                      double **jacobians) const {
+  RigTransform<TRotation> rigTransform;
+  ComposeRigTransform(parameters[2], parameters[3], parameters[4], rigTransform,
+                      jacobians != nullptr);
+  return EvaluateCollinearity<TRotation, TDistortion>(
+      parameters[0], parameters[1], rigTransform, mImagePoint,
+      mSqrtInformation, residuals, jacobians);
+}
+
+template <typename TRotation, typename TDistortion>
+BundleAdjustmentModel::CollinearityDistortionFreeCost<TRotation, TDistortion>::
+    CollinearityDistortionFreeCost(const Eigen::Vector2d &imagePoint,
+                                   const Eigen::Matrix2d &sqrtInformation)
+    : mImagePoint(imagePoint), mSqrtInformation(sqrtInformation) {}
+
+template <typename TRotation, typename TDistortion>
+bool BundleAdjustmentModel::CollinearityDistortionFreeCost<
+    TRotation, TDistortion>::Evaluate(double const *const *parameters,
+                                      double *residuals,
+                                      double **jacobians) const {
+  RigTransform<TRotation> rigTransform;
+  ComposeRigTransform(parameters[2], parameters[3], parameters[4], rigTransform,
+                      jacobians != nullptr);
+  return EvaluateDistortionFreeCollinearity<TRotation, TDistortion>(
+      parameters[0], parameters[1], rigTransform, mImagePoint,
+      mSqrtInformation, residuals, jacobians);
+}
+
+template <typename TRotation, typename TDistortion>
+template <typename TDataType>
+bool BundleAdjustmentModel::CollinearityCost<TRotation, TDistortion>::
+operator()(
+    const TDataType *const camera, const TDataType *const point,
+    const TDataType *const bodyFrameParams,
+    const TDataType *const refCameraToBodyFrameParams,
+    const TDataType *const nonRefCameraToRefCameraParams,
+    TDataType *residuals) const {
+  TDataType projection[2];
+  ComputeCollinearityProjection<TDataType, TRotation>(
+      camera, point, bodyFrameParams, refCameraToBodyFrameParams,
+      nonRefCameraToRefCameraParams, projection);
+  // Note: Distortions are evaluated at the measured image point
+  const TDataType x = static_cast<TDataType>(mImagePoint[0]);
+  const TDataType y = static_cast<TDataType>(mImagePoint[1]);
+  TDataType distortion[2];
+  ComputeDistortion<TDataType, TDistortion>(camera, x, y, distortion);
+  const TDataType dx = x - distortion[0] - projection[0];
+  const TDataType dy = y - distortion[1] - projection[1];
+  residuals[0] = mSqrtInformation(0, 0) * dx + mSqrtInformation(0, 1) * dy;
+  residuals[1] = mSqrtInformation(1, 0) * dx + mSqrtInformation(1, 1) * dy;
+  return true;
 }
 } // namespace BundleAdjustment
@@ -0,0 +1,198 @@
+#ifndef BUNDLEADJUSTMENT_PROBLEMBUILDER_H
+#define BUNDLEADJUSTMENT_PROBLEMBUILDER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BundleAdjustmentModel.h"
+#include "ParameterArena.h"
+#include "RigTransformCache.h"
+
+namespace BundleAdjustment {
+/**
+ * This is the class to turn a Core::ImageBlock into a ceres::Problem.
+ * Parameter blocks:
+ * - Body frame EOPs of every image (X, Y, Z and the rotation parameters of
+ *   TRotation, e.g., omega, phi and kappa in radians)
+ * - Mounting parameters of every camera (FrameCamera::getMountingParameters);
+ *   reference cameras are mounted to the body frame, and non-reference
+ *   cameras to their reference camera
+ * - IOPs of every camera (xp, yp, c and the distortion parameters of the
+ *   distortion model of the camera type)
+ * - Object point coordinates
+ * The builder also emits the elimination ordering for Schur-based solvers,
+ * i.e., object points (group 0), body frame EOPs (group 1), and mounting
+ * parameters and IOPs (group 2).
+ * All parameter blocks point straight into the parameter arena of the image
+ * block (see ImageBlock::buildParameterArena), so there is no copy between
+ * the image block and the solver except when the arena is built and written
+ * back. With a rotation parameterization other than Euler angles (i.e.,
+ * AngleAxisRotation or QuaternionRotation), the body frame and mounting
+ * parameters live in a separate pose arena of the builder instead; they are
+ * converted from Euler angles in build() and back to them in writeBack() only.
+ * Note: The observations of the image block have to be built beforehand (see
+ * ImageBlock::buildObservations and ImageBlock::setObservations). Image points
+ * are measured in pixels, and converted to image coordinates with the IOPs of
+ * their camera.
+ */
+template <typename TImageBlockType,
+          typename TRotation = EulerAnglesRotation>
+class ProblemBuilder {
+public:
+  /// Number of parameters of each body frame and mounting parameter block
+  static constexpr int NumberOfPoseParameters =
+      GetNumberOfPoseParameters<TRotation>();
+  /// Distortion model of the cameras (see Core::InteriorOrientation)
+  using DistortionModel =
+      typename TImageBlockType::CameraType::DistortionModel;
+  /// Number of parameters of each IOP block
+  static constexpr int NumberOfCameraParameters =
+      GetNumberOfCameraParameters<DistortionModel>();
+
+  /// Options to set up the problem
+  struct Options {
+    /// Flag to use CollinearityAnalyticCost (True) or the
+    /// auto-differentiated CollinearityCost (False)
+    bool useAnalyticJacobians = true;
+    /// Flag to compose the camera to mapping transformation of every image
+    /// once per evaluation (see RigTransformCache and
+    /// CollinearityCachedCost) instead of once per image point (analytic
+    /// Jacobians only)
+    bool useRigTransformCache = true;
+    /// Flags to keep parameter blocks constant
+    bool fixInteriorOrientation = true;
+    bool fixMountingParameters = true;
+    bool fixBodyFrame = false;
+    bool fixObjectPoints = false;
+    /// IDs of the cameras whose IOPs are adjusted even if
+    /// fixInteriorOrientation is set (i.e., self-calibration of individual
+    /// cameras)
+    std::vector<std::string> selfCalibrationCameraIds;
+    /// Flag to correct the image points of cameras with constant IOPs for the
+    /// distortions once in build(), and use CollinearityDistortionFreeCost
+    /// for them (False: the full model is evaluated for all image points)
+    bool precorrectDistortions = true;
+    /// Scale of the Huber loss in units of the weighted residuals (<= 0: no
+    /// robust loss)
+    double huberLossScale = 0.0;
+  };
+
+  /**
+   * Constructor
+   * Note: The image block has to outlive the builder, since writeBack()
+   * copies the adjusted parameters to it.
+   */
+  explicit ProblemBuilder(TImageBlockType &imageBlock,
+                          const Options &options = Options());
+
+  /**
+   * Build the parameter arena of the image block, and register all parameter
+   * blocks and residual blocks.
+   * The image points of cameras with constant IOPs (see
+   * isInteriorOrientationConstant) get CollinearityDistortionFreeCost, unless
+   * precorrectDistortions is unset; all others get the full collinearity
+   * model. Note: The choice is made here, i.e., the problem has to be built
+   * again after enabling the self-calibration of a camera (see setOptions).
+   * Building again discards the previous problem, ordering and rig transform
+   * cache, and starts from the parameters of the image block, so call
+   * writeBack() first to keep adjusted parameters, and configureSolverOptions
+   * again afterwards.
+   * With useRigTransformCache, the residual blocks read the transformations
+   * of their images from the rig transform cache of the builder, which is
+   * the evaluation callback of the problem (i.e., it is updated whenever
+   * ceres evaluates the problem).
+   * This function throws std::invalid_argument if an image has no camera in
+   * the image block, or a non-reference camera refers to an unknown reference
+   * camera.
+   */
+  void build();
+
+  /// Accessors of the options (changes take effect in the next build())
+  const Options &getOptions() const;
+  void setOptions(const Options &options);
+
+  /// Get the ceres problem (replaced by every build())
+  ceres::Problem &getProblem();
+  /// Check if the IOP block of a camera is kept constant (see Options)
+  bool isInteriorOrientationConstant(const Core::Handle cameraHandle) const;
+  /// Get the elimination ordering (points, poses, then rig and IOP blocks)
+  const std::shared_ptr<ceres::ParameterBlockOrdering> &getOrdering() const;
+
+  /**
+   * Set up the linear solver of the given solver options for this problem
+   * @param[in] linearSolverType SPARSE_SCHUR (default) or ITERATIVE_SCHUR
+   * with CLUSTER_JACOBI preconditioner; other types are set as they are,
+   * without the elimination ordering
+   * This function throws std::runtime_error if the IOP block of a camera
+   * with distortion-free image points was made variable after build() (see
+   * Options::selfCalibrationCameraIds instead).
+   */
+  void configureSolverOptions(
+      ceres::Solver::Options &solverOptions,
+      const ceres::LinearSolverType linearSolverType =
+          ceres::SPARSE_SCHUR) const;
+
+  /// Get the rig transform cache (nullptr without useRigTransformCache)
+  RigTransformCache<TRotation> *getRigTransformCache();
+
+  /// Copy the adjusted parameters in the arena(s) back to the image block
+  /// (and invalidate the rig transform cache)
+  void writeBack();
+
+  /// Accessors of the parameter blocks by handle
+  double *getBodyFrameParameters(const Core::Handle imageHandle);
+  double *getMountingParameters(const Core::Handle cameraHandle);
+  double *getCameraParameters(const Core::Handle cameraHandle);
+  double *getObjectPointParameters(const Core::Handle pointHandle);
+
+private:
+  /// Flag of pose parameter blocks pointing into the image block arena
+  static constexpr bool UsesEulerAngles =
+      TRotation::Type == RotationType::EulerAngles;
+  /// Sections of the pose arena
+  enum PoseSection : std::size_t { MountingPoses = 0, BodyFramePoses = 1 };
+
+  /// Resolve the reference camera of every camera
+  void initializeReferenceCameras();
+  /// Resolve the constant IOP blocks of all cameras
+  void initializeConstantCameras();
+  /// Convert the Euler angle poses of the image block arena to the pose arena
+  void initializePoseArena();
+  /// Add a parameter block once, and put it into the given ordering group
+  void addParameterBlock(double *values, const int size, const int group,
+                         const bool isConstant, std::vector<bool> &added,
+                         const std::size_t index);
+  /// Add a pose parameter block once with its manifold
+  void addPoseParameterBlock(double *values, const int group,
+                             const bool isConstant, std::vector<bool> &added,
+                             const std::size_t index);
+
+  TImageBlockType &mImageBlock;
+  Options mOptions;
+  /// Composed transformations of the images (shared by the residual blocks,
+  /// so it has to outlive the problem)
+  std::unique_ptr<RigTransformCache<TRotation>> mRigTransformCache;
+  std::unique_ptr<ceres::Problem> mProblem;
+  std::shared_ptr<ceres::ParameterBlockOrdering> mOrdering;
+
+  /// Body frame and mounting parameters in the layout of TRotation (unused
+  /// for Euler angles)
+  Core::ParameterArena<double> mPoseArena;
+  /// Manifold shared by all pose parameter blocks (owned by the problem once
+  /// it is used; nullptr for Euclidean poses)
+  ceres::Manifold *mPoseManifold = nullptr;
+  /// Identity non-reference mounting shared by all reference cameras
+  double mIdentityMounting[NumberOfPoseParameters];
+  /// Handle of the reference camera of every camera
+  std::vector<Core::Handle> mReferenceCameraHandles;
+  /// Flag of the constant IOP block of every camera
+  std::vector<bool> mConstantCameras;
+  /// Flag of the cameras with CollinearityDistortionFreeCost
+  std::vector<bool> mDistortionFreeCameras;
+};
+} // namespace BundleAdjustment
+
+#include "ProblemBuilder.hpp"
+
+#endif // BUNDLEADJUSTMENT_PROBLEMBUILDER_H
@@ -0,0 +1,375 @@
+#include "ProblemBuilder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace BundleAdjustment {
+template <typename TImageBlockType, typename TRotation>
+ProblemBuilder<TImageBlockType, TRotation>::ProblemBuilder(
+    TImageBlockType &imageBlock, const Options &options)
+    : mImageBlock(imageBlock), mOptions(options),
+      mProblem(new ceres::Problem()),
+      mOrdering(std::make_shared<ceres::ParameterBlockOrdering>()) {
+  std::fill(mIdentityMounting, mIdentityMounting + 3, 0.0);
+  TRotation::SetIdentity(mIdentityMounting + 3);
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::build() {
+  // Discard the previous problem (and the pose manifold it owns) before the
+  // arenas and the rig transform cache its blocks refer to
+  mProblem.reset();
+  mPoseManifold = nullptr;
+  // The rig transform cache is the evaluation callback of the problem, so
+  // that ceres updates it before every evaluation (i.e., in ceres::Solve and
+  // ceres::Problem::Evaluate)
+  const bool useRigTransformCache =
+      mOptions.useRigTransformCache && mOptions.useAnalyticJacobians;
+  mRigTransformCache.reset(useRigTransformCache
+                               ? new RigTransformCache<TRotation>()
+                               : nullptr);
+  ceres::Problem::Options problemOptions;
+  problemOptions.evaluation_callback = mRigTransformCache.get();
+  mProblem.reset(new ceres::Problem(problemOptions));
+  mOrdering = std::make_shared<ceres::ParameterBlockOrdering>();
+  mImageBlock.buildParameterArena();
+  initializeReferenceCameras();
+  initializeConstantCameras();
+  mDistortionFreeCameras.assign(mImageBlock.getNumberOfCameras(), false);
+  if (!UsesEulerAngles) {
+    initializePoseArena();
+  }
+
+  const auto &observations = mImageBlock.getObservations();
+  // Convert all image points from pixels to image coordinates in one batch;
+  // image points of cameras with constant IOPs are corrected for the
+  // distortions as well (the others are converted again below)
+  const bool precorrectDistortions =
+      mOptions.precorrectDistortions &&
+      std::find(mConstantCameras.begin(), mConstantCameras.end(), true) !=
+          mConstantCameras.end();
+  decltype(observations.x) imageX;
+  decltype(observations.y) imageY;
+  mImageBlock.computeImageCoordinates(imageX, imageY, precorrectDistortions);
+  std::vector<bool> addedBodyFrames(mImageBlock.getNumberOfImages(), false);
+  std::vector<bool> addedMountings(mImageBlock.getNumberOfCameras(), false);
+  std::vector<bool> addedCameras(mImageBlock.getNumberOfCameras(), false);
+  std::vector<bool> addedPoints(mImageBlock.getNumberOfObjectPoints(), false);
+  std::vector<bool> addedIdentity(1, false);
+  // Index of the transformation of every image in the rig transform cache
+  std::vector<std::size_t> rigTransformIndices;
+  if (useRigTransformCache) {
+    rigTransformIndices.assign(mImageBlock.getNumberOfImages(),
+                               mImageBlock.getNumberOfImages());
+  }
+
+  // Robust loss shared by all residual blocks (owned by the problem)
+  ceres::LossFunction *lossFunction =
+      mOptions.huberLossScale > 0.0 && observations.size() > 0
+          ? new ceres::HuberLoss(mOptions.huberLossScale)
+          : nullptr;
+
+  for (std::size_t i = 0; i < observations.size(); ++i) {
+    const Core::Handle imageHandle = observations.imageHandles[i];
+    const Core::Handle pointHandle = observations.pointHandles[i];
+    const Core::Handle cameraHandle = observations.cameraHandles[i];
+    if (cameraHandle == Core::InvalidHandle) {
+      throw std::invalid_argument(
+          "Cannot find the camera of the given image in the image block!");
+    }
+    const auto &camera = mImageBlock.getCamera(cameraHandle);
+    const bool isConstantCamera = mConstantCameras[cameraHandle];
+    const bool isDistortionFree = precorrectDistortions && isConstantCamera;
+    if (isDistortionFree) {
+      mDistortionFreeCameras[cameraHandle] = true;
+    }
+
+    // Convert the square root information of the image point from pixels to
+    // image coordinates (i.e., S_image = S_pixel * J^-1, where
+    // J = diag(xPixelSize, -yPixelSize))
+    Eigen::Vector2d imagePoint(static_cast<double>(imageX[i]),
+                               static_cast<double>(imageY[i]));
+    if (precorrectDistortions && !isConstantCamera) {
+      imagePoint = camera
+                       ->ConvertPixelToImageCoordinates(observations.y[i],
+                                                        observations.x[i])
+                       .template cast<double>();
+    }
+    const Eigen::Matrix2d pixelSqrtInformation =
+        observations.getSquareRootInformation(i).template cast<double>();
+    Eigen::Matrix2d sqrtInformation;
+    sqrtInformation.col(0) =
+        pixelSqrtInformation.col(0) / static_cast<double>(camera->xPixelSize);
+    sqrtInformation.col(1) =
+        -pixelSqrtInformation.col(1) / static_cast<double>(camera->yPixelSize);
+
+    // Parameter blocks of this observation
+    double *cameraParams = getCameraParameters(cameraHandle);
+    double *pointParams = getObjectPointParameters(pointHandle);
+    double *bodyFrameParams = getBodyFrameParameters(imageHandle);
+    const Core::Handle referenceHandle = mReferenceCameraHandles[cameraHandle];
+    double *refCameraParams = getMountingParameters(referenceHandle);
+    double *nonRefCameraParams = referenceHandle == cameraHandle
+                                     ? mIdentityMounting
+                                     : getMountingParameters(cameraHandle);
+
+    addParameterBlock(pointParams, 3, 0, mOptions.fixObjectPoints,
+                      addedPoints, pointHandle);
+    addPoseParameterBlock(bodyFrameParams, 1, mOptions.fixBodyFrame,
+                          addedBodyFrames, imageHandle);
+    addParameterBlock(cameraParams, NumberOfCameraParameters, 2,
+                      isConstantCamera, addedCameras, cameraHandle);
+    addPoseParameterBlock(refCameraParams, 2, mOptions.fixMountingParameters,
+                          addedMountings, referenceHandle);
+    if (referenceHandle == cameraHandle) {
+      addPoseParameterBlock(nonRefCameraParams, 2, true, addedIdentity, 0);
+    } else {
+      addPoseParameterBlock(nonRefCameraParams, 2,
+                            mOptions.fixMountingParameters, addedMountings,
+                            cameraHandle);
+    }
+
+    ceres::CostFunction *costFunction = nullptr;
+    if (useRigTransformCache) {
+      std::size_t &index = rigTransformIndices[imageHandle];
+      if (index == rigTransformIndices.size()) {
+        index = mRigTransformCache->addRigTransform(
+            bodyFrameParams, refCameraParams, nonRefCameraParams);
+      }
+      costFunction = new CollinearityCachedCost<TRotation, DistortionModel>(
+          *mRigTransformCache, index, imagePoint, sqrtInformation,
+          isDistortionFree);
+    } else if (isDistortionFree) {
+      costFunction =
+          new BundleAdjustmentModel::CollinearityDistortionFreeCost<
+              TRotation, DistortionModel>(imagePoint, sqrtInformation);
+    } else if (mOptions.useAnalyticJacobians) {
+      costFunction = new BundleAdjustmentModel::CollinearityAnalyticCost<
+          TRotation, DistortionModel>(imagePoint, sqrtInformation);
+    } else {
+      costFunction =
+          BundleAdjustmentModel::CollinearityCost<TRotation, DistortionModel>::
+              Create(imagePoint, sqrtInformation);
+    }
+    mProblem->AddResidualBlock(costFunction, lossFunction, cameraParams,
+                               pointParams, bodyFrameParams, refCameraParams,
+                               nonRefCameraParams);
+  }
+}
+
+template <typename TImageBlockType, typename TRotation>
+const typename ProblemBuilder<TImageBlockType, TRotation>::Options &
+ProblemBuilder<TImageBlockType, TRotation>::getOptions() const {
+  return mOptions;
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::setOptions(
+    const Options &options) {
+  mOptions = options;
+}
+
+template <typename TImageBlockType, typename TRotation>
+ceres::Problem &ProblemBuilder<TImageBlockType, TRotation>::getProblem() {
+  return *mProblem;
+}
+
+template <typename TImageBlockType, typename TRotation>
+bool ProblemBuilder<TImageBlockType, TRotation>::isInteriorOrientationConstant(
+    const Core::Handle cameraHandle) const {
+  return mConstantCameras.at(cameraHandle);
+}
+
+template <typename TImageBlockType, typename TRotation>
+const std::shared_ptr<ceres::ParameterBlockOrdering> &
+ProblemBuilder<TImageBlockType, TRotation>::getOrdering() const {
+  return mOrdering;
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::configureSolverOptions(
+    ceres::Solver::Options &solverOptions,
+    const ceres::LinearSolverType linearSolverType) const {
+  // The distortion-free image points of a camera are only valid while its
+  // IOP block is constant
+  for (Core::Handle handle = 0; handle < mDistortionFreeCameras.size();
+       ++handle) {
+    if (mDistortionFreeCameras[handle] &&
+        !mProblem->IsParameterBlockConstant(
+            mImageBlock.getParameterArena().getBlock(
+                TImageBlockType::CameraSection, handle))) {
+      throw std::runtime_error(
+          "The IOPs of a camera with distortion-free image points are not "
+          "constant; build the problem again after enabling the "
+          "self-calibration of the camera!");
+    }
+  }
+  solverOptions.linear_solver_type = linearSolverType;
+  solverOptions.num_threads =
+      std::max(1u, std::thread::hardware_concurrency());
+  if (linearSolverType == ceres::SPARSE_SCHUR ||
+      linearSolverType == ceres::DENSE_SCHUR ||
+      linearSolverType == ceres::ITERATIVE_SCHUR) {
+    solverOptions.linear_solver_ordering = mOrdering;
+  }
+  if (linearSolverType == ceres::ITERATIVE_SCHUR) {
+    solverOptions.preconditioner_type = ceres::CLUSTER_JACOBI;
+    solverOptions.visibility_clustering_type = ceres::CANONICAL_VIEWS;
+    solverOptions.use_explicit_schur_complement = false;
+  }
+}
+
+template <typename TImageBlockType, typename TRotation>
+RigTransformCache<TRotation> *
+ProblemBuilder<TImageBlockType, TRotation>::getRigTransformCache() {
+  return mRigTransformCache.get();
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::writeBack() {
+  // The last evaluation of the solver may have been at a rejected step, so
+  // the cached transformations are composed again before they are used
+  if (mRigTransformCache) {
+    mRigTransformCache->invalidate();
+  }
+  if (!UsesEulerAngles) {
+    auto &arena = mImageBlock.getParameterArena();
+    const PoseSection poseSections[2] = {MountingPoses, BodyFramePoses};
+    const std::size_t arenaSections[2] = {TImageBlockType::MountingSection,
+                                          TImageBlockType::BodyFrameSection};
+    for (unsigned int section = 0; section < 2; ++section) {
+      for (std::size_t i = 0;
+           i < mPoseArena.getNumberOfBlocks(poseSections[section]); ++i) {
+        const double *pose = mPoseArena.getBlock(poseSections[section], i);
+        double *eulerPose = arena.getBlock(arenaSections[section], i);
+        std::copy(pose, pose + 3, eulerPose);
+        TRotation::ToEulerAngles(pose + 3, eulerPose + 3);
+      }
+    }
+  }
+  mImageBlock.updateFromParameterArena();
+}
+
+template <typename TImageBlockType, typename TRotation>
+double *ProblemBuilder<TImageBlockType, TRotation>::getBodyFrameParameters(
+    const Core::Handle imageHandle) {
+  if (!UsesEulerAngles) {
+    return mPoseArena.getBlock(BodyFramePoses, imageHandle);
+  }
+  return mImageBlock.getParameterArena().getBlock(
+      TImageBlockType::BodyFrameSection, imageHandle);
+}
+
+template <typename TImageBlockType, typename TRotation>
+double *ProblemBuilder<TImageBlockType, TRotation>::getMountingParameters(
+    const Core::Handle cameraHandle) {
+  if (!UsesEulerAngles) {
+    return mPoseArena.getBlock(MountingPoses, cameraHandle);
+  }
+  return mImageBlock.getParameterArena().getBlock(
+      TImageBlockType::MountingSection, cameraHandle);
+}
+
+template <typename TImageBlockType, typename TRotation>
+double *ProblemBuilder<TImageBlockType, TRotation>::getCameraParameters(
+    const Core::Handle cameraHandle) {
+  return mImageBlock.getParameterArena().getBlock(
+      TImageBlockType::CameraSection, cameraHandle);
+}
+
+template <typename TImageBlockType, typename TRotation>
+double *ProblemBuilder<TImageBlockType, TRotation>::getObjectPointParameters(
+    const Core::Handle pointHandle) {
+  return mImageBlock.getParameterArena().getBlock(
+      TImageBlockType::ObjectPointSection, pointHandle);
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::initializeReferenceCameras() {
+  const Core::Handle numberOfCameras = mImageBlock.getNumberOfCameras();
+  mReferenceCameraHandles.resize(numberOfCameras);
+  for (Core::Handle handle = 0; handle < numberOfCameras; ++handle) {
+    const auto &camera = mImageBlock.getCamera(handle);
+    // An empty reference camera id, or the id of the camera itself, means
+    // that the camera is a reference camera
+    const std::string &referenceCameraId = camera->getReferenceCameraId();
+    if (referenceCameraId.empty() ||
+        referenceCameraId == mImageBlock.getCameraId(handle)) {
+      mReferenceCameraHandles[handle] = handle;
+    } else {
+      mReferenceCameraHandles[handle] =
+          mImageBlock.getCameraHandle(referenceCameraId);
+    }
+  }
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::initializeConstantCameras() {
+  const Core::Handle numberOfCameras = mImageBlock.getNumberOfCameras();
+  mConstantCameras.assign(numberOfCameras, mOptions.fixInteriorOrientation);
+  for (Core::Handle handle = 0; handle < numberOfCameras; ++handle) {
+    const std::string &cameraId = mImageBlock.getCameraId(handle);
+    if (std::find(mOptions.selfCalibrationCameraIds.begin(),
+                  mOptions.selfCalibrationCameraIds.end(),
+                  cameraId) != mOptions.selfCalibrationCameraIds.end()) {
+      mConstantCameras[handle] = false;
+    }
+  }
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::initializePoseArena() {
+  const auto &arena = mImageBlock.getParameterArena();
+  mPoseArena.clear();
+  mPoseArena.addSection(mImageBlock.getNumberOfCameras(),
+                        NumberOfPoseParameters);
+  mPoseArena.addSection(mImageBlock.getNumberOfImages(),
+                        NumberOfPoseParameters);
+  mPoseArena.freeze();
+  const PoseSection poseSections[2] = {MountingPoses, BodyFramePoses};
+  const std::size_t arenaSections[2] = {TImageBlockType::MountingSection,
+                                        TImageBlockType::BodyFrameSection};
+  for (unsigned int section = 0; section < 2; ++section) {
+    for (std::size_t i = 0;
+         i < mPoseArena.getNumberOfBlocks(poseSections[section]); ++i) {
+      const double *eulerPose = arena.getBlock(arenaSections[section], i);
+      double *pose = mPoseArena.getBlock(poseSections[section], i);
+      std::copy(eulerPose, eulerPose + 3, pose);
+      TRotation::FromEulerAngles(eulerPose + 3, pose + 3);
+    }
+  }
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::addParameterBlock(
+    double *values, const int size, const int group, const bool isConstant,
+    std::vector<bool> &added, const std::size_t index) {
+  if (added[index]) {
+    return;
+  }
+  added[index] = true;
+  mProblem->AddParameterBlock(values, size);
+  if (isConstant) {
+    mProblem->SetParameterBlockConstant(values);
+  }
+  mOrdering->AddElementToGroup(values, group);
+}
+
+template <typename TImageBlockType, typename TRotation>
+void ProblemBuilder<TImageBlockType, TRotation>::addPoseParameterBlock(
+    double *values, const int group, const bool isConstant,
+    std::vector<bool> &added, const std::size_t index) {
+  if (added[index]) {
+    return;
+  }
+  addParameterBlock(values, NumberOfPoseParameters, group, isConstant, added,
+                    index);
+  if (mPoseManifold == nullptr) {
+    mPoseManifold = CreatePoseManifold<TRotation>();
+  }
+  if (mPoseManifold != nullptr) {
+    mProblem->SetManifold(values, mPoseManifold);
+  }
+}
+} // namespace BundleAdjustment
@@ -0,0 +1,103 @@
+#ifndef BUNDLEADJUSTMENT_PROJECTIONKERNEL_H
+#define BUNDLEADJUSTMENT_PROJECTIONKERNEL_H
+
+#include "BundleAdjustmentModel.h"
+
+namespace BundleAdjustment {
+/**
+ * This is the batched version of
+ * BundleAdjustmentModel::ComputeCollinearityProjection for many object points
+ * seen by one camera at one imaging epoch (e.g., reprojection error reports,
+ * visibility checks and Monte Carlo studies).
+ * The body frame, reference camera and non-reference camera parameters are
+ * composed once, and the object points are projected with AVX2 instructions
+ * if the CPU supports them, or with a scalar loop otherwise. The AVX-512
+ * kernel has to be selected explicitly (see setInstructionSet), since it was
+ * slower than the AVX2 kernel for large arrays of points on the CPUs at hand.
+ * Note: The vectorized kernels are only built with the CMake option
+ * BUNDLEADJUSTMENT_ENABLE_SIMD on x86-64 with GCC or Clang. Results of the
+ * instruction sets agree up to rounding (i.e., FMA instructions).
+ */
+class ProjectionKernel {
+public:
+  /// Instruction sets of the kernel
+  enum class InstructionSet { Scalar, AVX2, AVX512 };
+
+  /**
+   * Constructor
+   * @param[in] rotation Rotation from the camera to the mapping frame
+   * @param[in] translation Perspective center of the camera in the mapping
+   * frame
+   * @param[in] cameraIOPs A 3 x 1 array containing xp, yp and c (i.e., the
+   * leading entries of the IOP block; distortion parameters are ignored)
+   */
+  ProjectionKernel(const Eigen::Matrix3d &rotation,
+                   const Eigen::Vector3d &translation,
+                   const double *const cameraIOPs);
+
+  /**
+   * Create a kernel from the parameter blocks of ComputeCollinearityProjection
+   * (i.e., 3 + n pose arrays with the n rotation parameters of TRotation)
+   */
+  template <typename TRotation = EulerAnglesRotation>
+  static ProjectionKernel
+  Create(const double *const cameraIOPs,
+         const double *const bodyFrameParams,
+         const double *const refCameraToBodyFrameParams,
+         const double *const nonRefCameraToRefCameraParams);
+
+  /**
+   * Project object points to distortion-free image coordinates (i.e.,
+   * xp - c * X / Z and yp - c * Y / Z)
+   * @param[in] size The number of object points
+   * @param[in] objectPoints A size x 3 array of object point coordinates in
+   * the mapping frame (i.e., X, Y and Z of each point, as in the object point
+   * section of Core::ParameterArena)
+   * @param[out] x x image coordinates (size x 1)
+   * @param[out] y y image coordinates (size x 1)
+   * @param[out] depths Z coordinates of the points in the camera frame, which
+   * are negative in front of the camera (skipped if nullptr)
+   */
+  void project(const std::size_t size, const double *const objectPoints,
+               double *x, double *y, double *depths = nullptr) const;
+
+  /**
+   * Set the instruction set used by project (e.g., to compare the kernels).
+   * This function throws std::invalid_argument if the instruction set is not
+   * supported by the build or the CPU.
+   */
+  void setInstructionSet(const InstructionSet instructionSet);
+  InstructionSet getInstructionSet() const;
+
+  /// Check if the instruction set is supported by the build and the CPU
+  static bool IsSupported(const InstructionSet instructionSet);
+
+  /// The instruction set selected by the constructor (i.e., AVX2 if
+  /// supported, and Scalar otherwise)
+  static InstructionSet GetDefaultInstructionSet();
+
+private:
+  /// Rotation from the mapping to the camera frame (row-major R^T)
+  double mRotation[9];
+  /// Perspective center in the mapping frame
+  double mTranslation[3];
+  /// xp, yp and c
+  double mIOPs[3];
+  InstructionSet mInstructionSet;
+};
+
+template <typename TRotation>
+ProjectionKernel ProjectionKernel::Create(
+    const double *const cameraIOPs, const double *const bodyFrameParams,
+    const double *const refCameraToBodyFrameParams,
+    const double *const nonRefCameraToRefCameraParams) {
+  BundleAdjustmentModel::RigTransform<TRotation> rigTransform;
+  BundleAdjustmentModel::ComposeRigTransform(
+      bodyFrameParams, refCameraToBodyFrameParams,
+      nonRefCameraToRefCameraParams, rigTransform, false);
+  return ProjectionKernel(rigTransform.rotation, rigTransform.translation,
+                          cameraIOPs);
+}
+} // namespace BundleAdjustment
+
+#endif // BUNDLEADJUSTMENT_PROJECTIONKERNEL_H
@@ -0,0 +1,173 @@
+#ifndef BUNDLEADJUSTMENT_RIGTRANSFORMCACHE_H
+#define BUNDLEADJUSTMENT_RIGTRANSFORMCACHE_H
+
+#include <vector>
+
+#include "eigen3/Eigen/StdVector"
+
+#include "BundleAdjustmentModel.h"
+
+namespace BundleAdjustment {
+/**
+ * This is the class to cache the composed camera to mapping transformations
+ * (see BundleAdjustmentModel::RigTransform) of all images, i.e., one per
+ * imaging epoch and camera, so that the residual blocks of an image share a
+ * single composition of the body frame, reference camera and non-reference
+ * camera parameters.
+ * The cache is updated by ceres before the residual blocks are evaluated at a
+ * new point (i.e., as the evaluation callback of the problem; see
+ * ProblemBuilder::build), with the partial derivatives of the
+ * transformations whenever Jacobians are evaluated.
+ * Note: The cache reads the pose parameter blocks directly, which ceres keeps
+ * up to date for the evaluation callback. Every transformation keeps the
+ * values it was composed from, so that CollinearityCachedCost detects pose
+ * parameter blocks modified outside of ceres (see isComposedFrom).
+ */
+template <typename TRotation>
+class RigTransformCache : public ceres::EvaluationCallback {
+public:
+  /// Type of the cached transformations
+  using RigTransformType = BundleAdjustmentModel::RigTransform<TRotation>;
+  /// Number of parameters of each pose parameter block
+  static constexpr int NumberOfPoseParameters =
+      GetNumberOfPoseParameters<TRotation>();
+
+  /// Default constructor
+  RigTransformCache() = default;
+
+  /**
+   * Add the transformation of the given pose parameter blocks (in the layout
+   * of BundleAdjustmentModel::ComposeRigTransform), which have to outlive the
+   * cache
+   * @return The index of the transformation
+   */
+  std::size_t
+  addRigTransform(const double *const bodyFrameParams,
+                  const double *const refCameraToBodyFrameParams,
+                  const double *const nonRefCameraToRefCameraParams);
+
+  /// Get the number of cached transformations
+  std::size_t getNumberOfRigTransforms() const;
+
+  /// Get the cached transformation with the given index
+  const RigTransformType &getRigTransform(const std::size_t index) const;
+
+  /// Check if the transformations are composed (i.e., updated at least once
+  /// since the last one was added)
+  bool isUpToDate() const;
+
+  /// Check if the cached transformations hold their partial derivatives
+  bool hasDerivatives() const;
+
+  /**
+   * Check if the transformation with the given index was composed from the
+   * given values of its pose parameter blocks (i.e., it is not stale)
+   */
+  bool isComposedFrom(const std::size_t index,
+                      const double *const bodyFrameParams,
+                      const double *const refCameraToBodyFrameParams,
+                      const double *const nonRefCameraToRefCameraParams) const;
+
+  /// Mark all transformations as outdated, so that they are composed again
+  /// before they are used
+  void invalidate();
+
+  /**
+   * Compose all transformations from the current pose parameter blocks
+   * @param[in] withDerivatives Flag to compute the partial derivatives
+   * @param[in] numberOfThreads The number of threads (default = 0, i.e., the
+   * number of hardware threads)
+   */
+  void update(const bool withDerivatives,
+              const unsigned int numberOfThreads = 0);
+
+  /**
+   * Update the cache before the residual blocks are evaluated (i.e., at a
+   * new evaluation point, or if Jacobians are evaluated for the first time at
+   * the current one)
+   */
+  void PrepareForEvaluation(bool evaluateJacobians,
+                            bool newEvaluationPoint) override;
+
+private:
+  /// Pose parameter blocks of a transformation
+  struct PoseBlocks {
+    const double *bodyFrameParams;
+    const double *refCameraToBodyFrameParams;
+    const double *nonRefCameraToRefCameraParams;
+  };
+
+  std::vector<PoseBlocks> mPoseBlocks;
+  std::vector<RigTransformType, Eigen::aligned_allocator<RigTransformType>>
+      mRigTransforms;
+  /// Values of the pose parameter blocks of every transformation when it was
+  /// composed (3 * NumberOfPoseParameters each)
+  std::vector<double> mPoseValues;
+  /// Flags of up-to-date transformations and of their partial derivatives
+  bool mIsUpToDate = false;
+  bool mHasDerivatives = false;
+};
+
+/**
+ * This is the collinearity model reading the composed transformation of its
+ * image from a RigTransformCache (i.e., CollinearityAnalyticCost, or
+ * CollinearityDistortionFreeCost for image points corrected for the
+ * distortions up front, without composing the transformation).
+ * Parameter blocks: the same as CollinearityAnalyticCost. The pose parameter
+ * blocks have to be the ones of the cached transformation, so that the
+ * Jacobians w.r.t. them are exact.
+ * Note: If the cache is not up to date, the cached transformation was
+ * composed from other values of the pose parameter blocks (e.g., they were
+ * modified outside of ceres), or Jacobians are requested while the cache
+ * holds no partial derivatives, the transformation is composed from the
+ * parameter blocks instead.
+ */
+template <typename TRotation, typename TDistortion = Core::BrownDistortion>
+class CollinearityCachedCost
+    : public ceres::SizedCostFunction<
+          2, GetNumberOfCameraParameters<TDistortion>(), 3,
+          GetNumberOfPoseParameters<TRotation>(),
+          GetNumberOfPoseParameters<TRotation>(),
+          GetNumberOfPoseParameters<TRotation>()> {
+public:
+  /**
+   * Constructor
+   * @param[in] rigTransformCache The cache, which has to outlive the cost
+   * @param[in] index Index of the transformation of the image in the cache
+   * @param[in] imagePoint Measured image coordinates (i.e., x and y), or the
+   * distortion-free ones if isDistortionFree is set
+   * @param[in] sqrtInformation Square root of the information matrix of the
+   * image point
+   * @param[in] isDistortionFree Flag of image points corrected for the
+   * distortions up front
+   */
+  CollinearityCachedCost(const RigTransformCache<TRotation> &rigTransformCache,
+                         const std::size_t index,
+                         const Eigen::Vector2d &imagePoint,
+                         const Eigen::Matrix2d &sqrtInformation,
+                         const bool isDistortionFree = false);
+
+  bool Evaluate(double const *const *parameters, double *residuals,
+                double **jacobians) const override;
+
+private:
+  /// Evaluate the residuals with the given transformation
+  bool
+  evaluate(double const *const *parameters,
+           const BundleAdjustmentModel::RigTransform<TRotation> &rigTransform,
+           double *residuals, double **jacobians) const;
+
+  const RigTransformCache<TRotation> &mRigTransformCache;
+  std::size_t mIndex;
+  Eigen::Vector2d mImagePoint;
+  Eigen::Matrix2d mSqrtInformation;
+  bool mIsDistortionFree;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+} // namespace BundleAdjustment
+
+#include "RigTransformCache.hpp"
+
+#endif // BUNDLEADJUSTMENT_RIGTRANSFORMCACHE_H
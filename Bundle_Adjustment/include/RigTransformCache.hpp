@@ -0,0 +1,151 @@
+#include "RigTransformCache.h"
+
+#include <algorithm>
+
+#include "Parallel.h"
+
+namespace BundleAdjustment {
+/// RigTransformCache
+template <typename TRotation>
+constexpr int RigTransformCache<TRotation>::NumberOfPoseParameters;
+
+template <typename TRotation>
+std::size_t RigTransformCache<TRotation>::addRigTransform(
+    const double *const bodyFrameParams,
+    const double *const refCameraToBodyFrameParams,
+    const double *const nonRefCameraToRefCameraParams) {
+  mPoseBlocks.push_back({bodyFrameParams, refCameraToBodyFrameParams,
+                         nonRefCameraToRefCameraParams});
+  mRigTransforms.emplace_back();
+  mPoseValues.resize(mPoseValues.size() + 3 * NumberOfPoseParameters);
+  mIsUpToDate = false;
+  mHasDerivatives = false;
+  return mPoseBlocks.size() - 1;
+}
+
+template <typename TRotation>
+std::size_t RigTransformCache<TRotation>::getNumberOfRigTransforms() const {
+  return mRigTransforms.size();
+}
+
+template <typename TRotation>
+const typename RigTransformCache<TRotation>::RigTransformType &
+RigTransformCache<TRotation>::getRigTransform(const std::size_t index) const {
+  return mRigTransforms[index];
+}
+
+template <typename TRotation>
+bool RigTransformCache<TRotation>::isUpToDate() const {
+  return mIsUpToDate;
+}
+
+template <typename TRotation>
+bool RigTransformCache<TRotation>::hasDerivatives() const {
+  return mIsUpToDate && mHasDerivatives;
+}
+
+template <typename TRotation>
+bool RigTransformCache<TRotation>::isComposedFrom(
+    const std::size_t index, const double *const bodyFrameParams,
+    const double *const refCameraToBodyFrameParams,
+    const double *const nonRefCameraToRefCameraParams) const {
+  const double *values = &mPoseValues[3 * NumberOfPoseParameters * index];
+  return std::equal(bodyFrameParams, bodyFrameParams + NumberOfPoseParameters,
+                    values) &&
+         std::equal(refCameraToBodyFrameParams,
+                    refCameraToBodyFrameParams + NumberOfPoseParameters,
+                    values + NumberOfPoseParameters) &&
+         std::equal(nonRefCameraToRefCameraParams,
+                    nonRefCameraToRefCameraParams + NumberOfPoseParameters,
+                    values + 2 * NumberOfPoseParameters);
+}
+
+template <typename TRotation> void RigTransformCache<TRotation>::invalidate() {
+  mIsUpToDate = false;
+  mHasDerivatives = false;
+}
+
+template <typename TRotation>
+void RigTransformCache<TRotation>::update(const bool withDerivatives,
+                                          const unsigned int numberOfThreads) {
+  Core::ParallelFor(
+      mPoseBlocks.size(),
+      [&](const std::size_t begin, const std::size_t end, const unsigned int) {
+        for (std::size_t i = begin; i < end; ++i) {
+          const PoseBlocks &poseBlocks = mPoseBlocks[i];
+          double *values = &mPoseValues[3 * NumberOfPoseParameters * i];
+          std::copy(poseBlocks.bodyFrameParams,
+                    poseBlocks.bodyFrameParams + NumberOfPoseParameters,
+                    values);
+          std::copy(poseBlocks.refCameraToBodyFrameParams,
+                    poseBlocks.refCameraToBodyFrameParams +
+                        NumberOfPoseParameters,
+                    values + NumberOfPoseParameters);
+          std::copy(poseBlocks.nonRefCameraToRefCameraParams,
+                    poseBlocks.nonRefCameraToRefCameraParams +
+                        NumberOfPoseParameters,
+                    values + 2 * NumberOfPoseParameters);
+          BundleAdjustmentModel::ComposeRigTransform(
+              poseBlocks.bodyFrameParams,
+              poseBlocks.refCameraToBodyFrameParams,
+              poseBlocks.nonRefCameraToRefCameraParams, mRigTransforms[i],
+              withDerivatives);
+        }
+      },
+      numberOfThreads);
+  mIsUpToDate = true;
+  mHasDerivatives = withDerivatives;
+}
+
+template <typename TRotation>
+void RigTransformCache<TRotation>::PrepareForEvaluation(
+    bool evaluateJacobians, bool newEvaluationPoint) {
+  if (newEvaluationPoint || !mIsUpToDate ||
+      (evaluateJacobians && !mHasDerivatives)) {
+    update(evaluateJacobians);
+  }
+}
+
+/// CollinearityCachedCost
+template <typename TRotation, typename TDistortion>
+CollinearityCachedCost<TRotation, TDistortion>::CollinearityCachedCost(
+    const RigTransformCache<TRotation> &rigTransformCache,
+    const std::size_t index, const Eigen::Vector2d &imagePoint,
+    const Eigen::Matrix2d &sqrtInformation, const bool isDistortionFree)
+    : mRigTransformCache(rigTransformCache), mIndex(index),
+      mImagePoint(imagePoint), mSqrtInformation(sqrtInformation),
+      mIsDistortionFree(isDistortionFree) {}
+
+template <typename TRotation, typename TDistortion>
+bool CollinearityCachedCost<TRotation, TDistortion>::Evaluate(
+    double const *const *parameters, double *residuals,
+    double **jacobians) const {
+  if (!mRigTransformCache.isUpToDate() ||
+      (jacobians != nullptr && !mRigTransformCache.hasDerivatives()) ||
+      !mRigTransformCache.isComposedFrom(mIndex, parameters[2], parameters[3],
+                                         parameters[4])) {
+    BundleAdjustmentModel::RigTransform<TRotation> rigTransform;
+    BundleAdjustmentModel::ComposeRigTransform(
+        parameters[2], parameters[3], parameters[4], rigTransform, true);
+    return evaluate(parameters, rigTransform, residuals, jacobians);
+  }
+  return evaluate(parameters, mRigTransformCache.getRigTransform(mIndex),
+                  residuals, jacobians);
+}
+
+template <typename TRotation, typename TDistortion>
+bool CollinearityCachedCost<TRotation, TDistortion>::evaluate(
+    double const *const *parameters,
+    const BundleAdjustmentModel::RigTransform<TRotation> &rigTransform,
+    double *residuals, double **jacobians) const {
+  if (mIsDistortionFree) {
+    return BundleAdjustmentModel::EvaluateDistortionFreeCollinearity<
+        TRotation, TDistortion>(parameters[0], parameters[1], rigTransform,
+                                mImagePoint, mSqrtInformation, residuals,
+                                jacobians);
+  }
+  return BundleAdjustmentModel::EvaluateCollinearity<TRotation, TDistortion>(
+      parameters[0], parameters[1], rigTransform, mImagePoint,
+      mSqrtInformation, residuals, jacobians);
+}
+} // namespace BundleAdjustment
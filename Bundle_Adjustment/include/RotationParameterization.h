@@ -0,0 +1,119 @@
+#ifndef BUNDLEADJUSTMENT_ROTATIONPARAMETERIZATION_H
+#define BUNDLEADJUSTMENT_ROTATIONPARAMETERIZATION_H
+
+#include <memory>
+
+#include "ceres/ceres.h"
+
+#include "ExteriorOrientation.h"
+
+namespace BundleAdjustment {
+/// Representation of the rotations in the pose parameter blocks
+enum class RotationType { EulerAngles, AngleAxis, Quaternion };
+
+/**
+ * Rotation parameterizations of the pose parameter blocks (i.e., X, Y, Z and
+ * the rotation parameters). Every parameterization converts its parameters to
+ * a rotation matrix (templated, for automatic differentiation) and provides
+ * the analytic derivatives of the rotation matrix w.r.t. its parameters.
+ * Note: The rotation matrix describes the rotation from the camera (or body)
+ * frame to the mapping frame, as in Core::ExteriorOrientation. Conversions
+ * from and to Euler angles are only meant for import and export.
+ */
+
+/**
+ * Omega, phi and kappa Euler angles (in radians)
+ */
+struct EulerAnglesRotation {
+  static constexpr RotationType Type = RotationType::EulerAngles;
+  static constexpr int NumberOfParameters = 3;
+
+  template <typename TDataType>
+  static void ToRotationMatrix(const TDataType *const params,
+                               Eigen::Matrix<TDataType, 3, 3> &rotation);
+  static void
+  ToRotationMatrixDerivatives(const double *const params,
+                              Eigen::Matrix3d derivatives[NumberOfParameters]);
+  static void FromEulerAngles(const double *const angles, double *params);
+  static void ToEulerAngles(const double *const params, double *angles);
+  static void SetIdentity(double *params);
+  /// Manifold of the rotation parameters (nullptr: Euclidean)
+  static ceres::Manifold *CreateManifold();
+};
+
+/**
+ * Angle-axis vector (i.e., rotation axis scaled by the rotation angle in
+ * radians)
+ */
+struct AngleAxisRotation {
+  static constexpr RotationType Type = RotationType::AngleAxis;
+  static constexpr int NumberOfParameters = 3;
+
+  template <typename TDataType>
+  static void ToRotationMatrix(const TDataType *const params,
+                               Eigen::Matrix<TDataType, 3, 3> &rotation);
+  static void
+  ToRotationMatrixDerivatives(const double *const params,
+                              Eigen::Matrix3d derivatives[NumberOfParameters]);
+  static void FromEulerAngles(const double *const angles, double *params);
+  static void ToEulerAngles(const double *const params, double *angles);
+  static void SetIdentity(double *params);
+  static ceres::Manifold *CreateManifold();
+};
+
+/**
+ * Unit quaternion (w, x, y, z), which is kept on the unit sphere by
+ * ceres::QuaternionManifold
+ */
+struct QuaternionRotation {
+  static constexpr RotationType Type = RotationType::Quaternion;
+  static constexpr int NumberOfParameters = 4;
+
+  template <typename TDataType>
+  static void ToRotationMatrix(const TDataType *const params,
+                               Eigen::Matrix<TDataType, 3, 3> &rotation);
+  static void
+  ToRotationMatrixDerivatives(const double *const params,
+                              Eigen::Matrix3d derivatives[NumberOfParameters]);
+  static void FromEulerAngles(const double *const angles, double *params);
+  static void ToEulerAngles(const double *const params, double *angles);
+  static void SetIdentity(double *params);
+  static ceres::Manifold *CreateManifold();
+};
+
+/**
+ * This is the manifold of a pose parameter block, i.e., the Euclidean
+ * translation (X, Y and Z) followed by the rotation parameters on the given
+ * rotation manifold.
+ * Note: ceres::ProductManifold changed its interface between ceres versions,
+ * so the two parts are composed here.
+ */
+class PoseManifold : public ceres::Manifold {
+public:
+  /// Constructor (takes the ownership of the rotation manifold)
+  explicit PoseManifold(ceres::Manifold *rotationManifold);
+
+  int AmbientSize() const override;
+  int TangentSize() const override;
+  bool Plus(const double *x, const double *delta,
+            double *xPlusDelta) const override;
+  bool PlusJacobian(const double *x, double *jacobian) const override;
+  bool Minus(const double *y, const double *x,
+             double *yMinusX) const override;
+  bool MinusJacobian(const double *x, double *jacobian) const override;
+
+private:
+  std::unique_ptr<ceres::Manifold> mRotationManifold;
+};
+
+/**
+ * Manifold of a pose parameter block with the given rotation
+ * parameterization (see PoseManifold)
+ * @return nullptr if the whole block is Euclidean
+ */
+template <typename TRotation> ceres::Manifold *CreatePoseManifold();
+} // namespace BundleAdjustment
+
+#include "RotationParameterization.hpp"
+
+#endif // BUNDLEADJUSTMENT_ROTATIONPARAMETERIZATION_H
@@ -0,0 +1,84 @@
+#include "RotationParameterization.h"
+
+namespace BundleAdjustment {
+template <typename TDataType>
+void EulerAnglesRotation::ToRotationMatrix(
+    const TDataType *const params, Eigen::Matrix<TDataType, 3, 3> &rotation) {
+  const Eigen::Matrix<TDataType, 3, 1> angles(params[0], params[1], params[2]);
+  rotation = Core::ExteriorOrientation<
+      TDataType>::CreateRotationMatrixFromEluerAnglesInRadians(angles);
+}
+
+template <typename TDataType>
+void AngleAxisRotation::ToRotationMatrix(
+    const TDataType *const params, Eigen::Matrix<TDataType, 3, 3> &rotation) {
+  // Note: Unqualified calls allow ceres::Jet to be used as TDataType.
+  using std::cos;
+  using std::sin;
+  using std::sqrt;
+  const TDataType theta2 =
+      params[0] * params[0] + params[1] * params[1] + params[2] * params[2];
+  if (theta2 > TDataType(std::numeric_limits<double>::epsilon())) {
+    // Rodrigues' formula: R = cos * I + sin * [w]x + (1 - cos) * w * w^T
+    const TDataType theta = sqrt(theta2);
+    const TDataType wx = params[0] / theta;
+    const TDataType wy = params[1] / theta;
+    const TDataType wz = params[2] / theta;
+    const TDataType cosTheta = cos(theta);
+    const TDataType sinTheta = sin(theta);
+    const TDataType oneMinusCos = TDataType(1) - cosTheta;
+    rotation(0, 0) = cosTheta + wx * wx * oneMinusCos;
+    rotation(1, 0) = wz * sinTheta + wx * wy * oneMinusCos;
+    rotation(2, 0) = -wy * sinTheta + wx * wz * oneMinusCos;
+    rotation(0, 1) = wx * wy * oneMinusCos - wz * sinTheta;
+    rotation(1, 1) = cosTheta + wy * wy * oneMinusCos;
+    rotation(2, 1) = wx * sinTheta + wy * wz * oneMinusCos;
+    rotation(0, 2) = wy * sinTheta + wx * wz * oneMinusCos;
+    rotation(1, 2) = -wx * sinTheta + wy * wz * oneMinusCos;
+    rotation(2, 2) = cosTheta + wz * wz * oneMinusCos;
+  } else {
+    // First order approximation near zero: R = I + [v]x
+    rotation(0, 0) = TDataType(1);
+    rotation(1, 0) = params[2];
+    rotation(2, 0) = -params[1];
+    rotation(0, 1) = -params[2];
+    rotation(1, 1) = TDataType(1);
+    rotation(2, 1) = params[0];
+    rotation(0, 2) = params[1];
+    rotation(1, 2) = -params[0];
+    rotation(2, 2) = TDataType(1);
+  }
+}
+
+template <typename TDataType>
+void QuaternionRotation::ToRotationMatrix(
+    const TDataType *const params, Eigen::Matrix<TDataType, 3, 3> &rotation) {
+  // Note: No trigonometric functions are involved for a unit quaternion.
+  const TDataType &w = params[0];
+  const TDataType &x = params[1];
+  const TDataType &y = params[2];
+  const TDataType &z = params[3];
+  const TDataType ww = w * w;
+  const TDataType xx = x * x;
+  const TDataType yy = y * y;
+  const TDataType zz = z * z;
+  const TDataType two = TDataType(2);
+  rotation(0, 0) = ww + xx - yy - zz;
+  rotation(0, 1) = two * (x * y - w * z);
+  rotation(0, 2) = two * (x * z + w * y);
+  rotation(1, 0) = two * (x * y + w * z);
+  rotation(1, 1) = ww - xx + yy - zz;
+  rotation(1, 2) = two * (y * z - w * x);
+  rotation(2, 0) = two * (x * z - w * y);
+  rotation(2, 1) = two * (y * z + w * x);
+  rotation(2, 2) = ww - xx - yy + zz;
+}
+
+template <typename TRotation> ceres::Manifold *CreatePoseManifold() {
+  ceres::Manifold *rotationManifold = TRotation::CreateManifold();
+  if (rotationManifold == nullptr) {
+    return nullptr;
+  }
+  return new PoseManifold(rotationManifold);
+}
+} // namespace BundleAdjustment
@@ -0,0 +1,111 @@
+#include "BundleAdjustmentModel.h"
+
+namespace BundleAdjustment {
+namespace {
+/// Compute the rotation matrix and, optionally, its derivatives from a
+/// (3 + n) x 1 parameter array (i.e., X, Y, Z and the n rotation parameters)
+template <typename TRotation>
+void ComputePoseRotation(const double *const poseParams,
+                         Eigen::Matrix3d &rotation,
+                         Eigen::Matrix3d *derivatives) {
+  TRotation::ToRotationMatrix(poseParams + 3, rotation);
+  if (derivatives != nullptr) {
+    TRotation::ToRotationMatrixDerivatives(poseParams + 3, derivatives);
+  }
+}
+} // namespace
+
+Eigen::Matrix2d BundleAdjustmentModel::ComputeSquareRootInformation(
+    const Eigen::Matrix2d &covariance) {
+  Eigen::LLT<Eigen::Matrix2d> llt(covariance.inverse());
+  if (llt.info() != Eigen::Success) {
+    throw std::invalid_argument(
+        "The variance-covariance matrix of the image point is not positive "
+        "definite!");
+  }
+  return llt.matrixU();
+}
+
+template <typename TRotation>
+void BundleAdjustmentModel::ComposeRigTransform(
+    const double *const bodyFrameParams,
+    const double *const refCameraToBodyFrameParams,
+    const double *const nonRefCameraToRefCameraParams,
+    RigTransform<TRotation> &rigTransform, const bool withDerivatives) {
+  constexpr int NumberOfRotationParameters = TRotation::NumberOfParameters;
+  Eigen::Matrix3d rotationFromBodyFrameToMapping;
+  Eigen::Matrix3d rotationFromRefCameraToBodyFrame;
+  Eigen::Matrix3d rotationFromNonRefCameraToRefCamera;
+  Eigen::Matrix3d bodyDerivatives[NumberOfRotationParameters];
+  Eigen::Matrix3d refCameraDerivatives[NumberOfRotationParameters];
+  Eigen::Matrix3d nonRefCameraDerivatives[NumberOfRotationParameters];
+  ComputePoseRotation<TRotation>(bodyFrameParams,
+                                 rotationFromBodyFrameToMapping,
+                                 withDerivatives ? bodyDerivatives : nullptr);
+  ComputePoseRotation<TRotation>(
+      refCameraToBodyFrameParams, rotationFromRefCameraToBodyFrame,
+      withDerivatives ? refCameraDerivatives : nullptr);
+  ComputePoseRotation<TRotation>(
+      nonRefCameraToRefCameraParams, rotationFromNonRefCameraToRefCamera,
+      withDerivatives ? nonRefCameraDerivatives : nullptr);
+
+  const Eigen::Map<const Eigen::Vector3d> translationFromBodyFrameToMapping(
+      bodyFrameParams);
+  const Eigen::Map<const Eigen::Vector3d> translationFromRefCameraToBodyFrame(
+      refCameraToBodyFrameParams);
+  const Eigen::Map<const Eigen::Vector3d>
+      translationFromNonRefCameraToRefCamera(nonRefCameraToRefCameraParams);
+
+  // R_c_b * R_cj_c
+  const Eigen::Matrix3d rotationFromCameraToBodyFrame =
+      rotationFromRefCameraToBodyFrame * rotationFromNonRefCameraToRefCamera;
+  // r_c_b + R_c_b * r_cj_c
+  const Eigen::Vector3d translationFromCameraToBodyFrame =
+      translationFromRefCameraToBodyFrame +
+      rotationFromRefCameraToBodyFrame * translationFromNonRefCameraToRefCamera;
+
+  rigTransform.rotation =
+      rotationFromBodyFrameToMapping * rotationFromCameraToBodyFrame;
+  rigTransform.translation =
+      translationFromBodyFrameToMapping +
+      rotationFromBodyFrameToMapping * translationFromCameraToBodyFrame;
+
+  if (!withDerivatives) {
+    return;
+  }
+
+  // R_b_m * R_c_b
+  const Eigen::Matrix3d rotationFromRefCameraToMapping =
+      rotationFromBodyFrameToMapping * rotationFromRefCameraToBodyFrame;
+  for (int i = 0; i < NumberOfRotationParameters; ++i) {
+    rigTransform.rotationDerivatives[i] =
+        bodyDerivatives[i] * rotationFromCameraToBodyFrame;
+    rigTransform.rotationDerivatives[NumberOfRotationParameters + i] =
+        rotationFromBodyFrameToMapping * refCameraDerivatives[i] *
+        rotationFromNonRefCameraToRefCamera;
+    rigTransform.rotationDerivatives[2 * NumberOfRotationParameters + i] =
+        rotationFromRefCameraToMapping * nonRefCameraDerivatives[i];
+
+    rigTransform.translationAngleDerivatives.col(i) =
+        bodyDerivatives[i] * translationFromCameraToBodyFrame;
+    rigTransform.translationAngleDerivatives.col(NumberOfRotationParameters +
+                                                 i) =
+        rotationFromBodyFrameToMapping * refCameraDerivatives[i] *
+        translationFromNonRefCameraToRefCamera;
+  }
+  rigTransform.translationDerivatives[0].setIdentity();
+  rigTransform.translationDerivatives[1] = rotationFromBodyFrameToMapping;
+  rigTransform.translationDerivatives[2] = rotationFromRefCameraToMapping;
+}
+
+/// Explicit instantiations of the supported rotation parameterizations
+template void BundleAdjustmentModel::ComposeRigTransform(
+    const double *const, const double *const, const double *const,
+    RigTransform<EulerAnglesRotation> &, const bool);
+template void BundleAdjustmentModel::ComposeRigTransform(
+    const double *const, const double *const, const double *const,
+    RigTransform<AngleAxisRotation> &, const bool);
+template void BundleAdjustmentModel::ComposeRigTransform(
+    const double *const, const double *const, const double *const,
+    RigTransform<QuaternionRotation> &, const bool);
+} // namespace BundleAdjustment
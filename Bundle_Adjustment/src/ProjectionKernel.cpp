@@ -0,0 +1,213 @@
+#include "ProjectionKernel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(BUNDLEADJUSTMENT_SIMD) && defined(__x86_64__) &&                  \
+    defined(__GNUC__)
+#define BUNDLEADJUSTMENT_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace BundleAdjustment {
+namespace {
+/// Project the points [begin, end) one at a time
+void ProjectScalar(const double *const rotation,
+                   const double *const translation, const double *const iops,
+                   const std::size_t begin, const std::size_t end,
+                   const double *const objectPoints, double *x, double *y,
+                   double *depths) {
+  for (std::size_t i = begin; i < end; ++i) {
+    const double *point = objectPoints + 3 * i;
+    const double dX = point[0] - translation[0];
+    const double dY = point[1] - translation[1];
+    const double dZ = point[2] - translation[2];
+    const double X = rotation[0] * dX + rotation[1] * dY + rotation[2] * dZ;
+    const double Y = rotation[3] * dX + rotation[4] * dY + rotation[5] * dZ;
+    const double Z = rotation[6] * dX + rotation[7] * dY + rotation[8] * dZ;
+    const double scale = iops[2] / Z;
+    x[i] = iops[0] - scale * X;
+    y[i] = iops[1] - scale * Y;
+    if (depths != nullptr) {
+      depths[i] = Z;
+    }
+  }
+}
+
+#ifdef BUNDLEADJUSTMENT_X86_SIMD
+/// Project 4 points at a time, and return the number of projected points
+__attribute__((target("avx2,fma"))) std::size_t
+ProjectAVX2(const double *const rotation, const double *const translation,
+            const double *const iops, const std::size_t size,
+            const double *const objectPoints, double *x, double *y,
+            double *depths) {
+  __m256d r[9];
+  for (unsigned int i = 0; i < 9; ++i) {
+    r[i] = _mm256_set1_pd(rotation[i]);
+  }
+  const __m256d tX = _mm256_set1_pd(translation[0]);
+  const __m256d tY = _mm256_set1_pd(translation[1]);
+  const __m256d tZ = _mm256_set1_pd(translation[2]);
+  const __m256d xp = _mm256_set1_pd(iops[0]);
+  const __m256d yp = _mm256_set1_pd(iops[1]);
+  const __m256d principalDistance = _mm256_set1_pd(iops[2]);
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    // Load 4 points (i.e., x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3), and
+    // deinterleave their coordinates
+    const double *point = objectPoints + 3 * i;
+    const __m256d a = _mm256_loadu_pd(point);
+    const __m256d b = _mm256_loadu_pd(point + 4);
+    const __m256d c = _mm256_loadu_pd(point + 8);
+    // x0 x3 x2 x1, y1 y0 y3 y2 and z2 z1 z0 z3
+    const __m256d xs =
+        _mm256_blend_pd(_mm256_blend_pd(a, b, 0b0100), c, 0b0010);
+    const __m256d ys =
+        _mm256_blend_pd(_mm256_blend_pd(a, b, 0b1001), c, 0b0100);
+    const __m256d zs =
+        _mm256_blend_pd(_mm256_blend_pd(a, b, 0b0010), c, 0b1001);
+    const __m256d dX = _mm256_sub_pd(
+        _mm256_permute4x64_pd(xs, _MM_SHUFFLE(1, 2, 3, 0)), tX);
+    const __m256d dY = _mm256_sub_pd(_mm256_permute_pd(ys, 0b0101), tY);
+    const __m256d dZ = _mm256_sub_pd(
+        _mm256_permute4x64_pd(zs, _MM_SHUFFLE(3, 0, 1, 2)), tZ);
+    const __m256d X = _mm256_fmadd_pd(
+        r[0], dX, _mm256_fmadd_pd(r[1], dY, _mm256_mul_pd(r[2], dZ)));
+    const __m256d Y = _mm256_fmadd_pd(
+        r[3], dX, _mm256_fmadd_pd(r[4], dY, _mm256_mul_pd(r[5], dZ)));
+    const __m256d Z = _mm256_fmadd_pd(
+        r[6], dX, _mm256_fmadd_pd(r[7], dY, _mm256_mul_pd(r[8], dZ)));
+    const __m256d scale = _mm256_div_pd(principalDistance, Z);
+    _mm256_storeu_pd(x + i, _mm256_fnmadd_pd(scale, X, xp));
+    _mm256_storeu_pd(y + i, _mm256_fnmadd_pd(scale, Y, yp));
+    if (depths != nullptr) {
+      _mm256_storeu_pd(depths + i, Z);
+    }
+  }
+  return i;
+}
+
+/// Project 8 points at a time, and return the number of projected points
+__attribute__((target("avx512f"))) std::size_t
+ProjectAVX512(const double *const rotation, const double *const translation,
+              const double *const iops, const std::size_t size,
+              const double *const objectPoints, double *x, double *y,
+              double *depths) {
+  __m512d r[9];
+  for (unsigned int i = 0; i < 9; ++i) {
+    r[i] = _mm512_set1_pd(rotation[i]);
+  }
+  const __m512d tX = _mm512_set1_pd(translation[0]);
+  const __m512d tY = _mm512_set1_pd(translation[1]);
+  const __m512d tZ = _mm512_set1_pd(translation[2]);
+  const __m512d xp = _mm512_set1_pd(iops[0]);
+  const __m512d yp = _mm512_set1_pd(iops[1]);
+  const __m512d principalDistance = _mm512_set1_pd(iops[2]);
+  // Indices of the coordinates in the first two of three vectors of
+  // interleaved coordinates (i.e., 0 to 15), and of the rest of them in the
+  // last vector (i.e., 8 to 15, after the first 6 or 5 coordinates)
+  const __m512i xIndices = _mm512_setr_epi64(0, 3, 6, 9, 12, 15, 0, 0);
+  const __m512i yIndices = _mm512_setr_epi64(1, 4, 7, 10, 13, 0, 0, 0);
+  const __m512i zIndices = _mm512_setr_epi64(2, 5, 8, 11, 14, 0, 0, 0);
+  const __m512i xLastIndices = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 10, 13);
+  const __m512i yLastIndices = _mm512_setr_epi64(0, 1, 2, 3, 4, 8, 11, 14);
+  const __m512i zLastIndices = _mm512_setr_epi64(0, 1, 2, 3, 4, 9, 12, 15);
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    // Load 8 points, and deinterleave their coordinates
+    const double *point = objectPoints + 3 * i;
+    const __m512d a = _mm512_loadu_pd(point);
+    const __m512d b = _mm512_loadu_pd(point + 8);
+    const __m512d c = _mm512_loadu_pd(point + 16);
+    const __m512d dX = _mm512_sub_pd(
+        _mm512_permutex2var_pd(_mm512_permutex2var_pd(a, xIndices, b),
+                               xLastIndices, c),
+        tX);
+    const __m512d dY = _mm512_sub_pd(
+        _mm512_permutex2var_pd(_mm512_permutex2var_pd(a, yIndices, b),
+                               yLastIndices, c),
+        tY);
+    const __m512d dZ = _mm512_sub_pd(
+        _mm512_permutex2var_pd(_mm512_permutex2var_pd(a, zIndices, b),
+                               zLastIndices, c),
+        tZ);
+    const __m512d X = _mm512_fmadd_pd(
+        r[0], dX, _mm512_fmadd_pd(r[1], dY, _mm512_mul_pd(r[2], dZ)));
+    const __m512d Y = _mm512_fmadd_pd(
+        r[3], dX, _mm512_fmadd_pd(r[4], dY, _mm512_mul_pd(r[5], dZ)));
+    const __m512d Z = _mm512_fmadd_pd(
+        r[6], dX, _mm512_fmadd_pd(r[7], dY, _mm512_mul_pd(r[8], dZ)));
+    const __m512d scale = _mm512_div_pd(principalDistance, Z);
+    _mm512_storeu_pd(x + i, _mm512_fnmadd_pd(scale, X, xp));
+    _mm512_storeu_pd(y + i, _mm512_fnmadd_pd(scale, Y, yp));
+    if (depths != nullptr) {
+      _mm512_storeu_pd(depths + i, Z);
+    }
+  }
+  return i;
+}
+#endif
+
+} // namespace
+
+ProjectionKernel::ProjectionKernel(const Eigen::Matrix3d &rotation,
+                                   const Eigen::Vector3d &translation,
+                                   const double *const cameraIOPs)
+    : mInstructionSet(GetDefaultInstructionSet()) {
+  // Row-major R^T, i.e., the column-major storage of R
+  std::copy(rotation.data(), rotation.data() + 9, mRotation);
+  std::copy(translation.data(), translation.data() + 3, mTranslation);
+  std::copy(cameraIOPs, cameraIOPs + 3, mIOPs);
+}
+
+void ProjectionKernel::project(const std::size_t size,
+                               const double *const objectPoints, double *x,
+                               double *y, double *depths) const {
+  std::size_t begin = 0;
+#ifdef BUNDLEADJUSTMENT_X86_SIMD
+  if (mInstructionSet == InstructionSet::AVX512) {
+    begin = ProjectAVX512(mRotation, mTranslation, mIOPs, size, objectPoints,
+                          x, y, depths);
+  } else if (mInstructionSet == InstructionSet::AVX2) {
+    begin = ProjectAVX2(mRotation, mTranslation, mIOPs, size, objectPoints, x,
+                        y, depths);
+  }
+#endif
+  // Scalar kernel or the remaining points of the vectorized kernels
+  ProjectScalar(mRotation, mTranslation, mIOPs, begin, size, objectPoints, x,
+                y, depths);
+}
+
+void ProjectionKernel::setInstructionSet(
+    const InstructionSet instructionSet) {
+  if (!IsSupported(instructionSet)) {
+    throw std::invalid_argument(
+        "The instruction set is not supported by the build or the CPU!");
+  }
+  mInstructionSet = instructionSet;
+}
+
+ProjectionKernel::InstructionSet ProjectionKernel::getInstructionSet() const {
+  return mInstructionSet;
+}
+
+bool ProjectionKernel::IsSupported(const InstructionSet instructionSet) {
+  switch (instructionSet) {
+  case InstructionSet::Scalar:
+    return true;
+#ifdef BUNDLEADJUSTMENT_X86_SIMD
+  case InstructionSet::AVX2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case InstructionSet::AVX512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+ProjectionKernel::InstructionSet ProjectionKernel::GetDefaultInstructionSet() {
+  return IsSupported(InstructionSet::AVX2) ? InstructionSet::AVX2
+                                           : InstructionSet::Scalar;
+}
+} // namespace BundleAdjustment
@@ -0,0 +1,253 @@
+#include "RotationParameterization.h"
+
+namespace BundleAdjustment {
+namespace {
+using EulerRotation = Core::ExteriorOrientation<double>;
+
+/// Cross-product (skew-symmetric) matrix of a 3 x 1 vector
+Eigen::Matrix3d CrossProductMatrix(const Eigen::Vector3d &vector) {
+  Eigen::Matrix3d matrix;
+  matrix << 0.0, -vector[2], vector[1],
+      // 2nd row
+      vector[2], 0.0, -vector[0],
+      // 3rd row
+      -vector[1], vector[0], 0.0;
+  return matrix;
+}
+
+/// Rotation matrix of the given Euler angles (in radians)
+Eigen::Matrix3d EulerAnglesToRotationMatrix(const double *const angles) {
+  return EulerRotation::CreateRotationMatrixFromEluerAnglesInRadians(
+      Eigen::Vector3d(angles[0], angles[1], angles[2]));
+}
+
+/// Euler angles (in radians) of the given rotation matrix
+void RotationMatrixToEulerAngles(const Eigen::Matrix3d &rotation,
+                                 double *angles) {
+  const Eigen::Vector3d eulerAngles =
+      EulerRotation::GetEulerAnglesInRadiansFromRotationMatrix(rotation);
+  angles[0] = eulerAngles[0];
+  angles[1] = eulerAngles[1];
+  angles[2] = eulerAngles[2];
+}
+} // namespace
+
+constexpr RotationType EulerAnglesRotation::Type;
+constexpr int EulerAnglesRotation::NumberOfParameters;
+constexpr RotationType AngleAxisRotation::Type;
+constexpr int AngleAxisRotation::NumberOfParameters;
+constexpr RotationType QuaternionRotation::Type;
+constexpr int QuaternionRotation::NumberOfParameters;
+
+/// EulerAnglesRotation
+void EulerAnglesRotation::ToRotationMatrixDerivatives(
+    const double *const params,
+    Eigen::Matrix3d derivatives[NumberOfParameters]) {
+  EulerRotation::CreateRotationMatrixDerivativesFromEulerAnglesInRadians(
+      Eigen::Vector3d(params[0], params[1], params[2]), derivatives);
+}
+
+void EulerAnglesRotation::FromEulerAngles(const double *const angles,
+                                          double *params) {
+  params[0] = angles[0];
+  params[1] = angles[1];
+  params[2] = angles[2];
+}
+
+void EulerAnglesRotation::ToEulerAngles(const double *const params,
+                                        double *angles) {
+  FromEulerAngles(params, angles);
+}
+
+void EulerAnglesRotation::SetIdentity(double *params) {
+  params[0] = 0.0;
+  params[1] = 0.0;
+  params[2] = 0.0;
+}
+
+ceres::Manifold *EulerAnglesRotation::CreateManifold() { return nullptr; }
+
+/// AngleAxisRotation
+void AngleAxisRotation::ToRotationMatrixDerivatives(
+    const double *const params,
+    Eigen::Matrix3d derivatives[NumberOfParameters]) {
+  const Eigen::Vector3d angleAxis(params[0], params[1], params[2]);
+  const double theta2 = angleAxis.squaredNorm();
+  if (theta2 <= std::numeric_limits<double>::epsilon()) {
+    // dR/dv_i = [e_i]x near zero
+    for (int i = 0; i < NumberOfParameters; ++i) {
+      derivatives[i] = CrossProductMatrix(Eigen::Vector3d::Unit(i));
+    }
+    return;
+  }
+  // dR/dv_i = (v_i * [v]x + [v x ((I - R) * e_i)]x) * R / |v|^2
+  // (G. Gallego and A. Yezzi, A compact formula for the derivative of a 3-D
+  // rotation in exponential coordinates, 2014)
+  Eigen::Matrix3d rotation;
+  ToRotationMatrix(params, rotation);
+  const Eigen::Matrix3d identityMinusRotation =
+      Eigen::Matrix3d::Identity() - rotation;
+  const Eigen::Matrix3d angleAxisCross = CrossProductMatrix(angleAxis);
+  for (int i = 0; i < NumberOfParameters; ++i) {
+    derivatives[i] =
+        (angleAxis[i] * angleAxisCross +
+         CrossProductMatrix(angleAxis.cross(identityMinusRotation.col(i)))) *
+        rotation / theta2;
+  }
+}
+
+void AngleAxisRotation::FromEulerAngles(const double *const angles,
+                                        double *params) {
+  const Eigen::AngleAxisd angleAxis(EulerAnglesToRotationMatrix(angles));
+  const Eigen::Vector3d vector = angleAxis.angle() * angleAxis.axis();
+  params[0] = vector[0];
+  params[1] = vector[1];
+  params[2] = vector[2];
+}
+
+void AngleAxisRotation::ToEulerAngles(const double *const params,
+                                      double *angles) {
+  Eigen::Matrix3d rotation;
+  ToRotationMatrix(params, rotation);
+  RotationMatrixToEulerAngles(rotation, angles);
+}
+
+void AngleAxisRotation::SetIdentity(double *params) {
+  params[0] = 0.0;
+  params[1] = 0.0;
+  params[2] = 0.0;
+}
+
+ceres::Manifold *AngleAxisRotation::CreateManifold() { return nullptr; }
+
+/// QuaternionRotation
+void QuaternionRotation::ToRotationMatrixDerivatives(
+    const double *const params,
+    Eigen::Matrix3d derivatives[NumberOfParameters]) {
+  const double w = 2.0 * params[0];
+  const double x = 2.0 * params[1];
+  const double y = 2.0 * params[2];
+  const double z = 2.0 * params[3];
+  // dR/dw
+  derivatives[0] << w, -z, y,
+      // 2nd row
+      z, w, -x,
+      // 3rd row
+      -y, x, w;
+  // dR/dx
+  derivatives[1] << x, y, z,
+      // 2nd row
+      y, -x, -w,
+      // 3rd row
+      z, w, -x;
+  // dR/dy
+  derivatives[2] << -y, x, w,
+      // 2nd row
+      x, y, z,
+      // 3rd row
+      -w, z, -y;
+  // dR/dz
+  derivatives[3] << -z, -w, x,
+      // 2nd row
+      w, -z, y,
+      // 3rd row
+      x, y, z;
+}
+
+void QuaternionRotation::FromEulerAngles(const double *const angles,
+                                         double *params) {
+  Eigen::Quaterniond quaternion(EulerAnglesToRotationMatrix(angles));
+  // Keep the scalar part positive, so that small rotations stay close to the
+  // identity quaternion
+  if (quaternion.w() < 0.0) {
+    quaternion.coeffs() *= -1.0;
+  }
+  params[0] = quaternion.w();
+  params[1] = quaternion.x();
+  params[2] = quaternion.y();
+  params[3] = quaternion.z();
+}
+
+void QuaternionRotation::ToEulerAngles(const double *const params,
+                                       double *angles) {
+  const Eigen::Quaterniond quaternion(params[0], params[1], params[2],
+                                      params[3]);
+  RotationMatrixToEulerAngles(quaternion.normalized().toRotationMatrix(),
+                              angles);
+}
+
+void QuaternionRotation::SetIdentity(double *params) {
+  params[0] = 1.0;
+  params[1] = 0.0;
+  params[2] = 0.0;
+  params[3] = 0.0;
+}
+
+ceres::Manifold *QuaternionRotation::CreateManifold() {
+  return new ceres::QuaternionManifold();
+}
+
+/// PoseManifold
+PoseManifold::PoseManifold(ceres::Manifold *rotationManifold)
+    : mRotationManifold(rotationManifold) {}
+
+int PoseManifold::AmbientSize() const {
+  return 3 + mRotationManifold->AmbientSize();
+}
+
+int PoseManifold::TangentSize() const {
+  return 3 + mRotationManifold->TangentSize();
+}
+
+bool PoseManifold::Plus(const double *x, const double *delta,
+                        double *xPlusDelta) const {
+  for (int i = 0; i < 3; ++i) {
+    xPlusDelta[i] = x[i] + delta[i];
+  }
+  return mRotationManifold->Plus(x + 3, delta + 3, xPlusDelta + 3);
+}
+
+bool PoseManifold::PlusJacobian(const double *x, double *jacobian) const {
+  // Row-major AmbientSize x TangentSize matrix, which is block diagonal
+  const int ambientSize = mRotationManifold->AmbientSize();
+  const int tangentSize = mRotationManifold->TangentSize();
+  Eigen::Map<
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+      poseJacobian(jacobian, 3 + ambientSize, 3 + tangentSize);
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      rotationJacobian(ambientSize, tangentSize);
+  if (!mRotationManifold->PlusJacobian(x + 3, rotationJacobian.data())) {
+    return false;
+  }
+  poseJacobian.setZero();
+  poseJacobian.topLeftCorner<3, 3>().setIdentity();
+  poseJacobian.bottomRightCorner(ambientSize, tangentSize) = rotationJacobian;
+  return true;
+}
+
+bool PoseManifold::Minus(const double *y, const double *x,
+                         double *yMinusX) const {
+  for (int i = 0; i < 3; ++i) {
+    yMinusX[i] = y[i] - x[i];
+  }
+  return mRotationManifold->Minus(y + 3, x + 3, yMinusX + 3);
+}
+
+bool PoseManifold::MinusJacobian(const double *x, double *jacobian) const {
+  // Row-major TangentSize x AmbientSize matrix, which is block diagonal
+  const int ambientSize = mRotationManifold->AmbientSize();
+  const int tangentSize = mRotationManifold->TangentSize();
+  Eigen::Map<
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+      poseJacobian(jacobian, 3 + tangentSize, 3 + ambientSize);
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      rotationJacobian(tangentSize, ambientSize);
+  if (!mRotationManifold->MinusJacobian(x + 3, rotationJacobian.data())) {
+    return false;
+  }
+  poseJacobian.setZero();
+  poseJacobian.topLeftCorner<3, 3>().setIdentity();
+  poseJacobian.bottomRightCorner(tangentSize, ambientSize) = rotationJacobian;
+  return true;
+}
+} // namespace BundleAdjustment
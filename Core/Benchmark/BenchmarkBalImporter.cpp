@@ -0,0 +1,62 @@
+#include "BalImporter.h"
+
+#include <cstdlib>
+#include <sstream>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+/// BAL text of 1000 cameras, 100000 points and 1000000 observations
+const std::string &GetProblemText() {
+  static const std::string text = []() {
+    std::ostringstream stream;
+    stream.precision(16);
+    stream << "1000 100000 1000000\n";
+    for (unsigned int i = 0; i < 1000000; ++i) {
+      stream << i % 1000 << ' ' << i / 10 << "     "
+             << -385.989990234375 + 1e-4 * i << ' '
+             << 387.1199951171875 - 3e-4 * i << '\n';
+    }
+    for (unsigned int i = 0; i < 9000; ++i) {
+      stream << 1.5707963267948966e-2 * i << '\n';
+    }
+    for (unsigned int i = 0; i < 300000; ++i) {
+      stream << -0.6120001571722636 + 1e-5 * i << '\n';
+    }
+    return stream.str();
+  }();
+  return text;
+}
+} // namespace
+
+/// Parse the text with the given number of threads (0 = hardware threads)
+static void BM_BalImporterParse(benchmark::State &state) {
+  const std::string &text = GetProblemText();
+  for (auto _ : state) {
+    const auto problem = Core::BalImporter::Parse(
+        text.data(), text.data() + text.size(),
+        static_cast<unsigned int>(state.range(0)));
+    benchmark::DoNotOptimize(problem.points.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_BalImporterParse)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+/// Reference: tokenize the text sequentially with strtod
+static void BM_BalImporterStrtod(benchmark::State &state) {
+  const std::string &text = GetProblemText();
+  std::vector<double> values(4000000 + 9000 + 300000 + 3);
+  for (auto _ : state) {
+    const char *position = text.c_str();
+    char *end;
+    for (auto &value : values) {
+      value = std::strtod(position, &end);
+      position = end;
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_BalImporterStrtod)->Unit(benchmark::kMillisecond);
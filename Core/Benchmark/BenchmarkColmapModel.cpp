@@ -0,0 +1,106 @@
+#include "ColmapModel.h"
+#include "ImageBlock.h"
+
+#include "boost/filesystem.hpp"
+#include "benchmark/benchmark.h"
+
+namespace {
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+
+/// Number of images, object points and observations per object point
+constexpr unsigned int NumberOfImages = 200;
+constexpr unsigned int NumberOfPoints = 1000000;
+constexpr unsigned int TrackLength = 4;
+
+/// Get the directory of a temporary model, which is written on the first call
+const std::string &GetModelDirectory() {
+  static const std::string directory = []() {
+    const boost::filesystem::path path =
+        boost::filesystem::temp_directory_path() / "BenchmarkColmapModel";
+    boost::filesystem::create_directories(path);
+    Core::ColmapModel model;
+    model.cameras.push_back({1,
+                             Core::ColmapModel::CameraModel::OpenCV,
+                             6000,
+                             4000,
+                             {5000.0, 5000.0, 3000.0, 2000.0, 0.01, -0.001,
+                              1e-4, 1e-4}});
+    const unsigned int pointsPerImage =
+        NumberOfPoints * TrackLength / NumberOfImages;
+    for (unsigned int i = 0; i < NumberOfImages; ++i) {
+      model.images.push_back({i + 1, 0, {1.0, 0.0, 0.0, 0.0},
+                              {-1.0 * i, 0.0, 100.0},
+                              "image" + std::to_string(i) + ".jpg",
+                              static_cast<std::uint64_t>(i) * pointsPerImage,
+                              pointsPerImage});
+    }
+    model.points2D.resize(2 * NumberOfPoints * TrackLength);
+    model.point3DIds2D.resize(NumberOfPoints * TrackLength);
+    for (unsigned int j = 0; j < NumberOfPoints; ++j) {
+      model.point3DIds.push_back(j + 1);
+      model.points3D.insert(model.points3D.end(),
+                            {1e-3 * j, 2e-3 * j, 0.1});
+      model.colors.insert(model.colors.end(), {128, 128, 128});
+      model.errors.push_back(0.5);
+      for (unsigned int k = 0; k < TrackLength; ++k) {
+        // Observation k of point j is the image point j / NumberOfImages of
+        // image (j + k) % NumberOfImages
+        const std::uint32_t image = (j + k) % NumberOfImages;
+        const std::uint32_t point2D =
+            j / NumberOfImages * TrackLength + k;
+        const std::uint64_t index =
+            model.images[image].firstPoint2D + point2D;
+        model.points2D[2 * index] = 3000.0 + 1e-3 * j;
+        model.points2D[2 * index + 1] = 2000.0 - 1e-3 * j;
+        model.point3DIds2D[index] = j + 1;
+        model.trackImageIndices.push_back(image);
+        model.trackPoint2DIndices.push_back(point2D);
+      }
+      model.trackOffsets.push_back(model.trackImageIndices.size());
+    }
+    model.write(path.string());
+    return path.string();
+  }();
+  return directory;
+}
+} // namespace
+
+/// Read the model files
+static void BM_ColmapModelRead(benchmark::State &state) {
+  const std::string &directory = GetModelDirectory();
+  for (auto _ : state) {
+    const auto model = Core::ColmapModel::Read(directory);
+    benchmark::DoNotOptimize(model.points3D.data());
+  }
+}
+BENCHMARK(BM_ColmapModelRead)->Unit(benchmark::kMillisecond);
+
+/// Read the model files, and load them into an image block
+static void BM_ColmapModelImport(benchmark::State &state) {
+  const std::string &directory = GetModelDirectory();
+  for (auto _ : state) {
+    ImageBlockType imageBlock;
+    Core::ColmapModel::Import(directory, imageBlock);
+    benchmark::DoNotOptimize(imageBlock.getObservations().size());
+  }
+}
+BENCHMARK(BM_ColmapModelImport)->Unit(benchmark::kMillisecond);
+
+/// Create a model from an image block, and write it
+static void BM_ColmapModelExport(benchmark::State &state) {
+  const std::string &directory = GetModelDirectory();
+  ImageBlockType imageBlock;
+  Core::ColmapModel::Import(directory, imageBlock);
+  const boost::filesystem::path exportDirectory =
+      boost::filesystem::temp_directory_path() / "BenchmarkColmapModelExport";
+  boost::filesystem::create_directories(exportDirectory);
+  for (auto _ : state) {
+    Core::ColmapModel::Export(exportDirectory.string(), imageBlock);
+  }
+}
+BENCHMARK(BM_ColmapModelExport)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,73 @@
+#include "ExteriorOrientation.h"
+
+#include "benchmark/benchmark.h"
+
+using EOP = Core::ExteriorOrientation<double>;
+
+namespace {
+/// Poses of a trajectory laid out as X, Y, Z, omega, phi and kappa
+std::vector<double> PrepareTrajectory(const std::size_t numberOfPoses) {
+  std::vector<double> poses(6 * numberOfPoses);
+  for (std::size_t i = 0; i < numberOfPoses; ++i) {
+    poses[6 * i + 3] = 1e-4 * static_cast<double>(i);
+    poses[6 * i + 4] = -0.2 + 1e-5 * static_cast<double>(i);
+    poses[6 * i + 5] = 1.5 - 3e-4 * static_cast<double>(i);
+  }
+  return poses;
+}
+} // namespace
+
+/// One rotation matrix per call
+static void BM_RotationMatricesPerPose(benchmark::State &state) {
+  const auto numberOfPoses = static_cast<std::size_t>(state.range(0));
+  const auto poses = PrepareTrajectory(numberOfPoses);
+  std::vector<double> matrices(9 * numberOfPoses);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < numberOfPoses; ++i) {
+      Eigen::Map<Eigen::Matrix3d> rotation(&matrices[9 * i]);
+      rotation = EOP::CreateRotationMatrixFromEluerAnglesInRadians(
+          Eigen::Vector3d(poses[6 * i + 3], poses[6 * i + 4],
+                          poses[6 * i + 5]));
+    }
+    benchmark::DoNotOptimize(matrices.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RotationMatricesPerPose)->Arg(1 << 10)->Arg(1 << 16);
+
+/// All rotation matrices of a trajectory in one pass
+static void BM_RotationMatricesBatched(benchmark::State &state) {
+  const auto numberOfPoses = static_cast<std::size_t>(state.range(0));
+  const auto poses = PrepareTrajectory(numberOfPoses);
+  std::vector<double> matrices(9 * numberOfPoses);
+  for (auto _ : state) {
+    EOP::CreateRotationMatricesFromEulerAnglesInRadians(
+        &poses[3], 6, numberOfPoses, matrices.data());
+    benchmark::DoNotOptimize(matrices.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RotationMatricesBatched)->Arg(1 << 10)->Arg(1 << 16);
+
+/// Transformations of the mounting parameters to range(0) poses (i.e., with
+/// the rotation matrices cached after the first iteration)
+static void BM_TransformTo(benchmark::State &state) {
+  const auto numberOfPoses = static_cast<std::size_t>(state.range(0));
+  const auto poses = PrepareTrajectory(numberOfPoses);
+  EOP mounting;
+  mounting.setRotation(0.5, -1.0, 90.0);
+  mounting.setTranslation(0.1, 0.2, 0.3);
+  std::vector<EOP> bodies(numberOfPoses);
+  for (std::size_t i = 0; i < numberOfPoses; ++i) {
+    bodies[i].setRotation(poses[6 * i + 3], poses[6 * i + 4],
+                          poses[6 * i + 5], false);
+    bodies[i].setTranslation(100.0 + i, 200.0, 500.0);
+  }
+  for (auto _ : state) {
+    for (const EOP &body : bodies) {
+      benchmark::DoNotOptimize(mounting.transformTo(body));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformTo)->Arg(1)->Arg(1 << 10)->Arg(1 << 16);
@@ -0,0 +1,93 @@
+#include "ImageBlock.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+
+/// Image block with 4 cameras, and range(0) images ("image<i>") and object
+/// points ("point<i>")
+struct Fixture {
+  ImageBlockType imageBlock;
+  std::vector<std::string> imageIds;
+  std::vector<std::string> pointIds;
+
+  explicit Fixture(const benchmark::State &state) {
+    const auto number = static_cast<std::size_t>(state.range(0));
+    imageBlock.reserve(4, number, number);
+    for (int i = 0; i < 4; ++i) {
+      imageBlock.addCamera("camera" + std::to_string(i),
+                           std::make_shared<CameraType>());
+    }
+    for (std::size_t i = 0; i < number; ++i) {
+      imageIds.push_back("image" + std::to_string(i));
+      auto image = std::make_shared<ImageType>();
+      image->setCameraId("camera" + std::to_string(i % 4));
+      imageBlock.addImage(imageIds.back(), image);
+      pointIds.push_back("point" + std::to_string(i));
+      imageBlock.addObjectPoint(pointIds.back(),
+                                ObjectPointType(1.0 * i, 0.0, 0.0));
+    }
+  }
+};
+} // namespace
+
+/// Look up the handles of all images by id (in a scattered order)
+static void BM_ImageBlockImageHandleLookup(benchmark::State &state) {
+  const Fixture fixture(state);
+  const std::size_t number = fixture.imageIds.size();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < number; ++i) {
+      benchmark::DoNotOptimize(fixture.imageBlock.getImageHandle(
+          fixture.imageIds[(i * 7919) % number]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ImageBlockImageHandleLookup)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Arg(1 << 18);
+
+/// Look up all object points by id (in a scattered order)
+static void BM_ImageBlockObjectPointLookup(benchmark::State &state) {
+  Fixture fixture(state);
+  const std::size_t number = fixture.pointIds.size();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < number; ++i) {
+      benchmark::DoNotOptimize(fixture.imageBlock.getObjectPoint(
+          fixture.pointIds[(i * 7919) % number]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ImageBlockObjectPointLookup)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Arg(1 << 18);
+
+/// Look up the camera handles of all images by image handle
+static void BM_ImageBlockCameraOfImage(benchmark::State &state) {
+  const Fixture fixture(state);
+  const auto number = static_cast<Core::Handle>(state.range(0));
+  for (auto _ : state) {
+    for (Core::Handle handle = 0; handle < number; ++handle) {
+      benchmark::DoNotOptimize(
+          fixture.imageBlock.getCameraHandleOfImage(handle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ImageBlockCameraOfImage)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Arg(1 << 18);
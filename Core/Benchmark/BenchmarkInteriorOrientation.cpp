@@ -0,0 +1,186 @@
+#include "InteriorOrientation.h"
+
+#include <cmath>
+
+#include "benchmark/benchmark.h"
+
+using IOP = Core::InteriorOrientation<double, 9>;
+using Grid = Core::DistortionInversionGrid<double>;
+
+namespace {
+/// IOPs of a 5000 x 3000 camera with 5 um pixels and strong distortion
+IOP PrepareIOPs() {
+  IOP iops;
+  iops.xyc << 0.1, 0.2, 35.0;
+  iops.width = 5000;
+  iops.height = 3000;
+  iops.xPixelSize = 0.005;
+  iops.yPixelSize = 0.005;
+  iops.distortionParameters << 0.0, -2e-4, 1e-7, 0.0, 1e-5, -2e-5, 0.0, 1e-4,
+      -1e-4;
+  return iops;
+}
+
+/// Distortion-free image points spread over the image
+std::vector<Eigen::Vector2d> PrepareImagePoints(const std::size_t number) {
+  std::vector<Eigen::Vector2d> points(number);
+  for (std::size_t i = 0; i < number; ++i) {
+    points[i] << -12.0 + 24.0 * ((i * 37) % number) / number,
+        -7.0 + 14.0 * ((i * 53) % number) / number;
+  }
+  return points;
+}
+
+/**
+ * Add distortions to all image points with the given function, and report
+ * the number of points per second
+ */
+template <typename TFunction>
+void RunAddDistortion(benchmark::State &state, TFunction function) {
+  const auto points = PrepareImagePoints(1 << 12);
+  for (auto _ : state) {
+    for (const auto &point : points) {
+      benchmark::DoNotOptimize(function(point[0], point[1]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+} // namespace
+
+/// Fixed-point iterations (reference); Arg: tolerance of 10^-Arg
+static void BM_AddDistortionFixedPoint(benchmark::State &state) {
+  IOP iops = PrepareIOPs();
+  const double tolerance = std::pow(10.0, -state.range(0));
+  RunAddDistortion(state, [&](const double x, const double y) {
+    return iops.addDistortionWithFixedPointIterations(x, y, tolerance);
+  });
+}
+BENCHMARK(BM_AddDistortionFixedPoint)->Arg(5)->Arg(10);
+
+/// Newton's method with the analytic distortion Jacobian; Arg: tolerance of
+/// 10^-Arg
+static void BM_AddDistortionNewton(benchmark::State &state) {
+  IOP iops = PrepareIOPs();
+  const double tolerance = std::pow(10.0, -state.range(0));
+  RunAddDistortion(state, [&](const double x, const double y) {
+    return iops.addDistortion(x, y, tolerance);
+  });
+}
+BENCHMARK(BM_AddDistortionNewton)->Arg(5)->Arg(10);
+
+/**
+ * Grid lookup with an accuracy of 1e-5 (i.e., no refinement)
+ * Arg: 0 = bilinear, 1 = bicubic interpolation
+ */
+static void BM_AddDistortionGridLookup(benchmark::State &state) {
+  IOP iops = PrepareIOPs();
+  iops.buildDistortionInversionGrid(
+      1e-5, state.range(0) == 0 ? Grid::Interpolation::Bilinear
+                                : Grid::Interpolation::Bicubic);
+  RunAddDistortion(state, [&](const double x, const double y) {
+    return iops.addDistortion(x, y, 1e-5);
+  });
+  state.counters["GridBytes"] = static_cast<double>(
+      iops.getDistortionInversionGrid()->getMemoryUsage());
+}
+BENCHMARK(BM_AddDistortionGridLookup)->Arg(0)->Arg(1);
+
+/// Bilinear grid lookup (accuracy of 1e-4) as the initial guess of Newton's
+/// method
+static void BM_AddDistortionGridAndNewton(benchmark::State &state) {
+  IOP iops = PrepareIOPs();
+  iops.buildDistortionInversionGrid(1e-4, Grid::Interpolation::Bilinear);
+  RunAddDistortion(state, [&](const double x, const double y) {
+    return iops.addDistortion(x, y, 1e-10);
+  });
+}
+BENCHMARK(BM_AddDistortionGridAndNewton);
+
+/// Building the bicubic grid with an accuracy of 1e-6
+static void BM_BuildDistortionInversionGrid(benchmark::State &state) {
+  IOP iops = PrepareIOPs();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(iops.buildDistortionInversionGrid(1e-6));
+  }
+}
+BENCHMARK(BM_BuildDistortionInversionGrid)->Unit(benchmark::kMillisecond);
+
+/**
+ * Pixel to distortion-free image coordinates of 2^16 points
+ * Arg: 0 = one point at a time, 1 = batch conversion of the arrays
+ */
+static void BM_RemoveDistortionOfPixels(benchmark::State &state) {
+  IOP iops = PrepareIOPs();
+  const std::size_t number = 1 << 16;
+  std::vector<double> rows(number);
+  std::vector<double> cols(number);
+  for (std::size_t i = 0; i < number; ++i) {
+    rows[i] = static_cast<double>((i * 53) % iops.height);
+    cols[i] = static_cast<double>((i * 37) % iops.width);
+  }
+  std::vector<double> x(number);
+  std::vector<double> y(number);
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      for (std::size_t i = 0; i < number; ++i) {
+        const Eigen::Vector2d point =
+            iops.ConvertPixelToImageCoordinates(rows[i], cols[i]);
+        const Eigen::Vector2d distortions =
+            iops.calculateDistortion(point[0], point[1]);
+        x[i] = point[0] - distortions[0];
+        y[i] = point[1] - distortions[1];
+      }
+    } else {
+      iops.convertPixelsToImageCoordinates(number, rows.data(), cols.data(),
+                                           x.data(), y.data(), true);
+    }
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * number);
+}
+BENCHMARK(BM_RemoveDistortionOfPixels)->Arg(0)->Arg(1);
+
+/// Distortions at range(0) image points
+static void BM_CalculateDistortion(benchmark::State &state) {
+  const IOP iops = PrepareIOPs();
+  const auto points =
+      PrepareImagePoints(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (const auto &point : points) {
+      benchmark::DoNotOptimize(iops.calculateDistortion(point[0], point[1]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CalculateDistortion)->Arg(1 << 10)->Arg(1 << 16);
+
+/// Pixel to image coordinates of range(0) points, one point at a time
+static void BM_ConvertPixelToImageCoordinates(benchmark::State &state) {
+  const IOP iops = PrepareIOPs();
+  const auto number = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < number; ++i) {
+      benchmark::DoNotOptimize(iops.ConvertPixelToImageCoordinates(
+          static_cast<double>((i * 53) % iops.height),
+          static_cast<double>((i * 37) % iops.width)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvertPixelToImageCoordinates)->Arg(1 << 10)->Arg(1 << 16);
+
+/// Image coordinates to pixels of range(0) points
+static void BM_ConvertImageCoordinatesToPixel(benchmark::State &state) {
+  const IOP iops = PrepareIOPs();
+  const auto points =
+      PrepareImagePoints(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (const auto &point : points) {
+      benchmark::DoNotOptimize(
+          iops.ConvertImageCoordinatesToPixel(point[0], point[1]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvertImageCoordinatesToPixel)->Arg(1 << 10)->Arg(1 << 16);
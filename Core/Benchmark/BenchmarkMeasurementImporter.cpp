@@ -0,0 +1,127 @@
+#include "ImageBlock.h"
+#include "MeasurementImporter.h"
+
+#include <fstream>
+
+#include "boost/filesystem.hpp"
+#include "benchmark/benchmark.h"
+
+namespace {
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+
+/// Number of images, object points and observations per object point
+constexpr unsigned int NumberOfImages = 200;
+constexpr unsigned int NumberOfPoints = 250000;
+constexpr unsigned int TrackLength = 4;
+
+/// Get the path of a temporary image coordinate file, which is written on the
+/// first call (object point j is measured in the images (j + k) % n)
+const std::string &GetFilePath() {
+  static const std::string filePath = []() {
+    const boost::filesystem::path path =
+        boost::filesystem::temp_directory_path() /
+        "BenchmarkMeasurementImporter.txt";
+    std::ofstream file(path.string());
+    for (unsigned int i = 0; i < NumberOfImages; ++i) {
+      file << "image" << i << " camera\n";
+      for (unsigned int j = 0; j < NumberOfPoints; ++j) {
+        if ((i + NumberOfImages - j % NumberOfImages) % NumberOfImages <
+            TrackLength) {
+          file << "point" << j << ' ' << 1e-3 * j << ' ' << -2e-3 * i
+               << '\n';
+        }
+      }
+      file << "-99\n";
+    }
+    return path.string();
+  }();
+  return filePath;
+}
+
+/// Image block with the camera and the images, but without object points
+ImageBlockType CreateImageBlock() {
+  CameraType iops;
+  iops.width = 6000;
+  iops.height = 4000;
+  iops.xPixelSize = 0.004;
+  iops.yPixelSize = 0.004;
+  iops.xyc[0] = 0.0;
+  iops.xyc[1] = 0.0;
+  iops.xyc[2] = 50.0;
+  iops.distortionParameters.setZero();
+  ImageBlockType imageBlock;
+  imageBlock.addCamera("camera",
+                       std::make_shared<CameraType>(
+                           "camera", Core::ExteriorOrientation<DataType>(),
+                           iops));
+  for (unsigned int i = 0; i < NumberOfImages; ++i) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId("camera");
+    imageBlock.addImage("image" + std::to_string(i), image);
+  }
+  return imageBlock;
+}
+} // namespace
+
+/// Read the file line by line, add the image points to the images and the
+/// tie points to the object points, and build the observations
+static void BM_MeasurementImporterLegacy(benchmark::State &state) {
+  const std::string &filePath = GetFilePath();
+  std::size_t numberOfObservations = 0;
+  for (auto _ : state) {
+    ImageBlockType imageBlock = CreateImageBlock();
+    std::ifstream file(filePath);
+    std::string imageId, header, pointId;
+    double x, y;
+    while (file >> imageId) {
+      std::getline(file, header);
+      auto image = imageBlock.getImage(imageId);
+      const auto &camera = *imageBlock.getCamera(image->cameraId());
+      while (file >> pointId && pointId != "-99" && file >> x >> y) {
+        const auto pixel = camera.ConvertImageCoordinatesToPixel(x, y);
+        image->addPoint(pointId, Core::ImagePoint(pixel[1], pixel[0]));
+        const Core::Handle handle = imageBlock.findObjectPointHandle(pointId);
+        if (handle == Core::InvalidHandle) {
+          ObjectPointType point(0.0, 0.0, 0.0);
+          point.mTiePointIds[imageId] = pointId;
+          imageBlock.addObjectPoint(pointId, point);
+        } else {
+          imageBlock.getObjectPoint(handle).mTiePointIds[imageId] = pointId;
+        }
+      }
+    }
+    imageBlock.buildObservations();
+    numberOfObservations = imageBlock.getObservations().size();
+  }
+  state.counters["observations/s"] = benchmark::Counter(
+      static_cast<double>(numberOfObservations * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MeasurementImporterLegacy)->Unit(benchmark::kMillisecond);
+
+/// Import the file with MeasurementImporter
+static void BM_MeasurementImporterBulk(benchmark::State &state) {
+  const std::string &filePath = GetFilePath();
+  Core::MeasurementImporter::Options options;
+  options.numberOfThreads = static_cast<unsigned int>(state.range(0));
+  std::size_t numberOfObservations = 0;
+  for (auto _ : state) {
+    ImageBlockType imageBlock = CreateImageBlock();
+    numberOfObservations = Core::MeasurementImporter::ImportBlockFiles(
+                               {filePath}, imageBlock, options)
+                               .numberOfObservations;
+  }
+  state.counters["observations/s"] = benchmark::Counter(
+      static_cast<double>(numberOfObservations * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MeasurementImporterBulk)
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
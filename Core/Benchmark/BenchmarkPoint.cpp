@@ -0,0 +1,75 @@
+#include "Point.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+/**
+ * Allocate and fill a block of image points with the given covariance policy,
+ * and report the memory footprint
+ * Note: range(0) is the number of points
+ */
+template <typename TImagePoint>
+void RunImagePointAllocation(benchmark::State &state) {
+  using PointContainer =
+      std::vector<TImagePoint, Eigen::aligned_allocator<TImagePoint>>;
+  const auto numberOfPoints = static_cast<std::size_t>(state.range(0));
+  Eigen::Matrix2d variance;
+  variance << 0.25, 0.0, 0.0, 0.25;
+  const TImagePoint prototype(0.0, 0.0, variance);
+  for (auto _ : state) {
+    PointContainer points(numberOfPoints, prototype);
+    for (std::size_t i = 0; i < numberOfPoints; ++i) {
+      points[i][0] = static_cast<double>(i % 8000);
+      points[i][1] = static_cast<double>(i / 8000);
+    }
+    benchmark::DoNotOptimize(points.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["BytesPerPoint"] = static_cast<double>(sizeof(TImagePoint));
+  state.counters["MegaBytes"] =
+      static_cast<double>(sizeof(TImagePoint) * numberOfPoints) /
+      (1024.0 * 1024.0);
+}
+} // namespace
+
+static void BM_ImagePointDenseCovariance(benchmark::State &state) {
+  RunImagePointAllocation<Core::ImagePoint>(state);
+}
+
+static void BM_ImagePointNoCovariance(benchmark::State &state) {
+  RunImagePointAllocation<
+      Core::BasicImagePoint<Core::NoCovariance<double, 2>>>(state);
+}
+
+static void BM_ImagePointIsotropicCovariance(benchmark::State &state) {
+  RunImagePointAllocation<Core::IsotropicImagePoint>(state);
+}
+
+static void BM_ImagePointDiagonalCovariance(benchmark::State &state) {
+  RunImagePointAllocation<
+      Core::BasicImagePoint<Core::DiagonalCovariance<double, 2>>>(state);
+}
+
+static void BM_ImagePointPackedCovariance(benchmark::State &state) {
+  RunImagePointAllocation<
+      Core::BasicImagePoint<Core::PackedCovariance<double, 2>>>(state);
+}
+
+static void BM_ImagePointPooledCovariance(benchmark::State &state) {
+  RunImagePointAllocation<Core::PooledImagePoint>(state);
+}
+
+// 1M points and a 20M-point block
+#define CORE_POINT_BENCHMARK(name)                                            \
+  BENCHMARK(name)                                                             \
+      ->Arg(1 << 20)                                                          \
+      ->Arg(20000000)                                                         \
+      ->Iterations(1)                                                         \
+      ->Unit(benchmark::kMillisecond)
+CORE_POINT_BENCHMARK(BM_ImagePointDenseCovariance);
+CORE_POINT_BENCHMARK(BM_ImagePointNoCovariance);
+CORE_POINT_BENCHMARK(BM_ImagePointIsotropicCovariance);
+CORE_POINT_BENCHMARK(BM_ImagePointDiagonalCovariance);
+CORE_POINT_BENCHMARK(BM_ImagePointPackedCovariance);
+CORE_POINT_BENCHMARK(BM_ImagePointPooledCovariance);
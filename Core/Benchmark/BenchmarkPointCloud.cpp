@@ -0,0 +1,77 @@
+#include "Point.h"
+#include "PointCloud.h"
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+using PointCloudType = Core::PointCloud<Core::ImagePoint>;
+
+/// Point ids "point<i>" of range(0) points
+std::vector<std::string> PreparePointIds(const benchmark::State &state) {
+  std::vector<std::string> pointIds(static_cast<std::size_t>(state.range(0)));
+  for (std::size_t i = 0; i < pointIds.size(); ++i) {
+    pointIds[i] = "point" + std::to_string(i);
+  }
+  return pointIds;
+}
+
+/// Point cloud with the given points
+PointCloudType PreparePointCloud(const std::vector<std::string> &pointIds) {
+  PointCloudType pointCloud;
+  pointCloud.reservePoints(pointIds.size());
+  for (std::size_t i = 0; i < pointIds.size(); ++i) {
+    pointCloud.addPoint(pointIds[i], Core::ImagePoint(1.0 * i, 2.0 * i));
+  }
+  return pointCloud;
+}
+} // namespace
+
+/// Add range(0) points to an empty point cloud
+static void BM_PointCloudInsert(benchmark::State &state) {
+  const auto pointIds = PreparePointIds(state);
+  const Core::ImagePoint point(1.0, 2.0);
+  for (auto _ : state) {
+    PointCloudType pointCloud;
+    for (const auto &pointId : pointIds) {
+      pointCloud.addPoint(pointId, point);
+    }
+    benchmark::DoNotOptimize(pointCloud.getPoints().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointCloudInsert)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+
+/// Look up all points of a point cloud of range(0) points by id (in a
+/// scattered order)
+static void BM_PointCloudLookup(benchmark::State &state) {
+  const auto pointIds = PreparePointIds(state);
+  const PointCloudType pointCloud = PreparePointCloud(pointIds);
+  const std::size_t number = pointIds.size();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < number; ++i) {
+      benchmark::DoNotOptimize(
+          pointCloud.getPoint(pointIds[(i * 7919) % number]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointCloudLookup)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+
+/// Delete all points of a point cloud of range(0) points
+static void BM_PointCloudDelete(benchmark::State &state) {
+  const auto pointIds = PreparePointIds(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    PointCloudType pointCloud = PreparePointCloud(pointIds);
+    state.ResumeTiming();
+    for (const auto &pointId : pointIds) {
+      pointCloud.deletePoint(pointId);
+    }
+    benchmark::DoNotOptimize(pointCloud.getNumberOfPoints());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointCloudDelete)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
@@ -0,0 +1,80 @@
+#include "ImageBlock.h"
+#include "ProjectFile.h"
+
+#include "boost/filesystem.hpp"
+#include "benchmark/benchmark.h"
+
+namespace {
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, Core::ObjectPoint, DataType>;
+
+/// Number of images observing every object point
+constexpr unsigned int TrackLength = 4;
+/// Number of images in the block
+constexpr unsigned int NumberOfImages = 5000;
+
+/// Get the path of a temporary project of the given number of object points,
+/// which is written on the first call
+const std::string &GetProjectFilePath(const std::size_t numberOfPoints) {
+  static std::string path;
+  if (path.empty()) {
+    ImageBlockType imageBlock;
+    imageBlock.reserve(1, NumberOfImages, numberOfPoints);
+    imageBlock.addCamera("camera", std::make_shared<CameraType>());
+    for (unsigned int image = 0; image < NumberOfImages; ++image) {
+      auto newImage = std::make_shared<ImageType>();
+      newImage->setCameraId("camera");
+      imageBlock.addImage("image" + std::to_string(image), newImage);
+    }
+    Core::ObservationTable<DataType> observations;
+    observations.reserve(TrackLength * numberOfPoints);
+    for (std::size_t point = 0; point < numberOfPoints; ++point) {
+      imageBlock.addObjectPoint(std::to_string(point),
+                                Core::ObjectPoint(1.0 * point, 2.0, 3.0));
+      for (unsigned int i = 0; i < TrackLength; ++i) {
+        observations.addObservation((point + i) % NumberOfImages,
+                                    static_cast<Core::Handle>(point), 0,
+                                    1.0 * i, 2.0 * i);
+      }
+    }
+    imageBlock.setObservations(std::move(observations));
+    path = (boost::filesystem::temp_directory_path() /
+            "BenchmarkProjectFile.baproj")
+               .string();
+    Core::ProjectFile::Write(path, imageBlock);
+  }
+  return path;
+}
+} // namespace
+
+/// Map a project, and sum the coordinates of all observations in place
+static void BM_ProjectFileMap(benchmark::State &state) {
+  const std::string &path =
+      GetProjectFilePath(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    const Core::ProjectFile project(path);
+    const auto observations = project.getObservations();
+    double sum = 0.0;
+    for (std::size_t i = 0; i < observations.size; ++i) {
+      sum += observations.x[i] + observations.y[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_ProjectFileMap)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+/// Map a project, and rebuild the image block
+static void BM_ProjectFileLoad(benchmark::State &state) {
+  const std::string &path =
+      GetProjectFilePath(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    const Core::ProjectFile project(path);
+    ImageBlockType imageBlock;
+    project.load(imageBlock);
+    benchmark::DoNotOptimize(imageBlock.getNumberOfObjectPoints());
+  }
+}
+BENCHMARK(BM_ProjectFileLoad)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
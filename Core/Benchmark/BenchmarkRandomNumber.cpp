@@ -0,0 +1,40 @@
+#include "RandomNumber.h"
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+constexpr std::size_t NumberOfSamples = 1 << 24;
+} // namespace
+
+/// Draw normal samples one by one
+static void BM_RandomNumberSingle(benchmark::State &state) {
+  Core::RandomNormalGenerator generator(0.0, 1.0, 42);
+  std::vector<double> samples(NumberOfSamples);
+  for (auto _ : state) {
+    for (double &sample : samples) {
+      sample = generator.getRandomNumber();
+    }
+    benchmark::DoNotOptimize(samples.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NumberOfSamples);
+}
+BENCHMARK(BM_RandomNumberSingle)->Unit(benchmark::kMillisecond);
+
+/// Draw normal samples in parallel blocks (range(0) is the number of threads)
+static void BM_RandomNumberParallelFill(benchmark::State &state) {
+  std::vector<double> samples(NumberOfSamples);
+  for (auto _ : state) {
+    Core::RandomNormalGenerator::ParallelFill(
+        samples.data(), samples.size(), 0.0, 1.0, 42,
+        static_cast<unsigned int>(state.range(0)));
+    benchmark::DoNotOptimize(samples.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NumberOfSamples);
+}
+BENCHMARK(BM_RandomNumberParallelFill)
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
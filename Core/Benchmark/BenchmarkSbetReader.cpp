@@ -0,0 +1,60 @@
+#include "SbetReader.h"
+
+#include <fstream>
+
+#include "boost/filesystem.hpp"
+#include "benchmark/benchmark.h"
+
+namespace {
+using Record = Core::SbetReader::Record;
+
+/// One hour of a 200 Hz trajectory
+constexpr std::size_t NumberOfRecords = 200 * 3600;
+
+/// Get the path of a temporary SBET file, which is written on the first call
+const std::string &GetSbetFilePath() {
+  static const std::string path = []() {
+    const boost::filesystem::path filePath =
+        boost::filesystem::temp_directory_path() / "BenchmarkSbetReader.sbet";
+    std::ofstream file(filePath.string(), std::ios::binary);
+    std::vector<Record> records(NumberOfRecords, Record());
+    for (std::size_t i = 0; i < NumberOfRecords; ++i) {
+      records[i].time = 4e5 + 0.005 * static_cast<double>(i);
+      records[i].latitude = 0.9 + 1e-9 * static_cast<double>(i);
+      records[i].longitude = -1.98;
+      records[i].altitude = 1200.0;
+    }
+    file.write(reinterpret_cast<const char *>(records.data()),
+               records.size() * sizeof(Record));
+    return filePath.string();
+  }();
+  return path;
+}
+} // namespace
+
+/// Map the file, and decode all records (Arg = 0) or the windows around 2
+/// exposure times per minute (Arg = 1)
+static void BM_SbetReaderDecode(benchmark::State &state) {
+  const std::string &path = GetSbetFilePath();
+  std::vector<double> times;
+  for (double t = 30.0; t < 3600.0; t += 30.0) {
+    times.push_back(4e5 + t);
+    times.push_back(4e5 + t + 0.5);
+  }
+  const Core::SbetReader::LocalTangentPlaneConverter converter(0.9, -1.98,
+                                                               1200.0);
+  for (auto _ : state) {
+    const Core::SbetReader reader(path);
+    Core::Trajectory<double> trajectory;
+    if (state.range(0) == 0) {
+      trajectory.reserve(reader.size());
+      reader.decode(reader.getStartTime(), reader.getEndTime(), trajectory,
+                    converter);
+    } else {
+      reader.decodeWindows(times.size(), times.data(), 0.01, trajectory,
+                           converter);
+    }
+    benchmark::DoNotOptimize(trajectory.size());
+  }
+}
+BENCHMARK(BM_SbetReaderDecode)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,39 @@
+#include "ImageBlock.h"
+#include "SyntheticBlockGenerator.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+} // namespace
+
+/// Generate a block of range(0) strips of range(1) exposures of the oblique
+/// rig (range(2) = 1) or the nadir camera, and load it into an image block
+static void BM_SyntheticBlockGenerator(benchmark::State &state) {
+  Core::SyntheticBlockGenerator::Options options;
+  options.numberOfStrips = static_cast<unsigned int>(state.range(0));
+  options.numberOfExposuresPerStrip = static_cast<unsigned int>(state.range(1));
+  options.hasObliqueCameras = state.range(2) != 0;
+  std::size_t numberOfImages = 0, numberOfPoints = 0, numberOfObservations = 0;
+  for (auto _ : state) {
+    ImageBlockType imageBlock;
+    Core::SyntheticBlockGenerator::Generate(options, imageBlock);
+    numberOfImages = imageBlock.getNumberOfImages();
+    numberOfPoints = imageBlock.getNumberOfObjectPoints();
+    numberOfObservations = imageBlock.getObservations().size();
+  }
+  state.counters["images"] = static_cast<double>(numberOfImages);
+  state.counters["points"] = static_cast<double>(numberOfPoints);
+  state.counters["observations"] = static_cast<double>(numberOfObservations);
+}
+BENCHMARK(BM_SyntheticBlockGenerator)
+    ->Args({10, 100, 0})
+    ->Args({10, 100, 1})
+    ->Args({50, 200, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
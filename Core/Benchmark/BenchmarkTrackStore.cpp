@@ -0,0 +1,64 @@
+#include "Point.h"
+#include "TrackStore.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+/// Number of images observing every object point
+constexpr unsigned int TrackLength = 4;
+/// Number of images in the block
+constexpr unsigned int NumberOfImages = 1000;
+} // namespace
+
+/// Tracks stored as one tie point map per object point
+static void BM_TiePointMaps(benchmark::State &state) {
+  const auto numberOfPoints = static_cast<std::size_t>(state.range(0));
+  std::vector<std::string> imageIds;
+  for (unsigned int image = 0; image < NumberOfImages; ++image) {
+    imageIds.push_back("image" + std::to_string(image));
+  }
+  for (auto _ : state) {
+    std::vector<Core::ObjectPoint, Eigen::aligned_allocator<Core::ObjectPoint>>
+        points(numberOfPoints);
+    for (std::size_t point = 0; point < numberOfPoints; ++point) {
+      const std::string pointId = std::to_string(point);
+      for (unsigned int i = 0; i < TrackLength; ++i) {
+        points[point].mTiePointIds[imageIds[(point + i) % NumberOfImages]] =
+            pointId;
+      }
+    }
+    benchmark::DoNotOptimize(points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TiePointMaps)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+/// Tracks stored in CSR format
+static void BM_TrackStore(benchmark::State &state) {
+  const auto numberOfPoints = static_cast<std::size_t>(state.range(0));
+  std::vector<Core::Handle> pointHandles;
+  std::vector<Core::Handle> imageHandles;
+  for (std::size_t point = 0; point < numberOfPoints; ++point) {
+    for (unsigned int i = 0; i < TrackLength; ++i) {
+      pointHandles.push_back(static_cast<Core::Handle>(point));
+      imageHandles.push_back(
+          static_cast<Core::Handle>((point + i) % NumberOfImages));
+    }
+  }
+  Core::TrackStore tracks;
+  for (auto _ : state) {
+    tracks.build(pointHandles, imageHandles, numberOfPoints, NumberOfImages);
+    benchmark::DoNotOptimize(tracks);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["BytesPerPoint"] =
+      static_cast<double>(tracks.getMemoryUsage()) /
+      static_cast<double>(numberOfPoints);
+}
+BENCHMARK(BM_TrackStore)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,61 @@
+#include "Trajectory.h"
+
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+using TrajectoryType = Core::Trajectory<double>;
+
+/// One hour of a 200 Hz trajectory
+TrajectoryType CreateTrajectory() {
+  constexpr std::size_t Size = 200 * 3600;
+  TrajectoryType trajectory;
+  trajectory.reserve(Size);
+  for (std::size_t i = 0; i < Size; ++i) {
+    const double t = 0.005 * static_cast<double>(i);
+    trajectory.append(4e5 + t, TrajectoryType::PositionType(10.0 * t, 5.0, 1e3),
+                      TrajectoryType::AttitudeType(Eigen::AngleAxisd(
+                          0.01 * t, Eigen::Vector3d::UnitZ())));
+  }
+  return trajectory;
+}
+
+/// Exposure times at 2 Hz, sorted or shuffled
+std::vector<double> CreateExposureTimes(const bool isSorted) {
+  std::vector<double> times;
+  for (double t = 0.0123; t < 3599.0; t += 0.5) {
+    times.push_back(4e5 + t);
+  }
+  if (!isSorted) {
+    std::shuffle(times.begin(), times.end(), std::mt19937(42));
+  }
+  return times;
+}
+} // namespace
+
+/// Batch interpolation; Arg: 1 = sorted exposure times, 0 = shuffled ones
+/// (i.e., binary searches)
+static void BM_TrajectoryInterpolation(benchmark::State &state) {
+  const TrajectoryType trajectory = CreateTrajectory();
+  const std::vector<double> times = CreateExposureTimes(state.range(0) != 0);
+  std::vector<double> positions(3 * times.size());
+  std::vector<double> attitudes(4 * times.size());
+  for (auto _ : state) {
+    trajectory.interpolate(times.size(), times.data(), positions.data(),
+                           attitudes.data());
+    benchmark::DoNotOptimize(positions.data());
+    benchmark::DoNotOptimize(attitudes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * times.size());
+}
+BENCHMARK(BM_TrajectoryInterpolation)->Arg(0)->Arg(1);
+
+/// Streaming append of one hour of records
+static void BM_TrajectoryAppend(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CreateTrajectory().size());
+  }
+  state.SetItemsProcessed(state.iterations() * 200 * 3600);
+}
+BENCHMARK(BM_TrajectoryAppend)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,202 @@
+#include "BalImporter.h"
+#include "ImageBlock.h"
+#include "NumberParser.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 4, Core::RadialDistortion>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+
+namespace {
+const std::string ProblemPath =
+    std::string(CORE_TEST_DATA_DIR) + "/problem-3-5-pre.txt";
+
+Core::BalImporter::Problem Parse(const std::string &text,
+                                 const unsigned int numberOfThreads = 1) {
+  return Core::BalImporter::Parse(text.data(), text.data() + text.size(),
+                                  numberOfThreads);
+}
+
+/// BAL text of a problem with 2 cameras, 2000 points and 4000 observations
+std::string CreateLargeProblem() {
+  std::ostringstream text;
+  text.precision(17);
+  text << "2 2000 4000\n";
+  for (unsigned int point = 0; point < 2000; ++point) {
+    for (unsigned int camera = 0; camera < 2; ++camera) {
+      text << camera << ' ' << point << "\t" << 0.001 * point + camera
+           << ' ' << -1e-5 * point << '\n';
+    }
+  }
+  for (unsigned int i = 0; i < 18; ++i) {
+    text << 0.1 * i << '\n';
+  }
+  for (unsigned int i = 0; i < 6000; ++i) {
+    text << 1.5e-3 * i - 3.0 << "\r\n";
+  }
+  return text.str();
+}
+} // namespace
+
+TEST(BalImporter, ParseNumbers) {
+  const char *numbers[] = {"0",
+                           "-12.5",
+                           "+3e2",
+                           "1.5E-3",
+                           ".25",
+                           "7.",
+                           "-0.0",
+                           "1e-300",
+                           "123456789012345678901234",
+                           "2.2250738585072014e-308",
+                           "0.1",
+                           "9007199254740993"};
+  const double expected[] = {0.0,
+                             -12.5,
+                             300.0,
+                             1.5e-3,
+                             0.25,
+                             7.0,
+                             -0.0,
+                             1e-300,
+                             1.2345678901234568e23,
+                             2.2250738585072014e-308,
+                             0.1,
+                             9007199254740992.0};
+  for (unsigned int i = 0; i < 12; ++i) {
+    const char *first = numbers[i];
+    const char *last = first + std::strlen(first);
+    double value;
+    ASSERT_TRUE(Core::ParseDouble(first, last, value)) << numbers[i];
+    EXPECT_EQ(first, last) << numbers[i];
+    EXPECT_NEAR(value, expected[i], std::abs(expected[i]) * 1e-15)
+        << numbers[i];
+  }
+  const char negativeZero[] = "-0.0";
+  const char *position = negativeZero;
+  double zero;
+  ASSERT_TRUE(Core::ParseDouble(position, negativeZero + 4, zero));
+  EXPECT_TRUE(std::signbit(zero));
+
+  for (const char *invalid : {"", "-", ".", "e5", "abc", "+.e1"}) {
+    const char *first = invalid;
+    double value;
+    EXPECT_FALSE(Core::ParseDouble(first, first + std::strlen(first), value))
+        << invalid;
+  }
+
+  // Trailing characters are left for the caller
+  const char text[] = "42 17x";
+  const char *first = text;
+  std::int64_t integer;
+  ASSERT_TRUE(Core::ParseInteger(first, text + 6, integer));
+  EXPECT_EQ(integer, 42);
+  Core::SkipWhitespaces(first, text + 6);
+  ASSERT_TRUE(Core::ParseInteger(first, text + 6, integer));
+  EXPECT_EQ(integer, 17);
+  EXPECT_EQ(*first, 'x');
+  const char overflow[] = "9223372036854775808";
+  first = overflow;
+  EXPECT_FALSE(Core::ParseInteger(first, overflow + 19, integer));
+}
+
+TEST(BalImporter, ParseFile) {
+  const auto problem = Core::BalImporter::Parse(ProblemPath);
+  ASSERT_EQ(problem.getNumberOfCameras(), 3u);
+  ASSERT_EQ(problem.getNumberOfPoints(), 5u);
+  ASSERT_EQ(problem.getNumberOfObservations(), 15u);
+  EXPECT_EQ(problem.cameraIndices[4], 1u);
+  EXPECT_EQ(problem.pointIndices[4], 1u);
+  EXPECT_DOUBLE_EQ(problem.x[0], 9.999700080);
+  EXPECT_DOUBLE_EQ(problem.y[0], -19.99940016);
+  EXPECT_DOUBLE_EQ(problem.cameras[9 + 6], 520.5);
+  EXPECT_DOUBLE_EQ(problem.cameras[9 + 8], -1e-3);
+  EXPECT_DOUBLE_EQ(problem.points[3 * 4 + 2], 0.6);
+}
+
+TEST(BalImporter, ParallelParsingIsDeterministic) {
+  const std::string text = CreateLargeProblem();
+  const auto expected = Parse(text);
+  ASSERT_EQ(expected.getNumberOfObservations(), 4000u);
+  EXPECT_EQ(expected.pointIndices[3999], 1999u);
+  EXPECT_DOUBLE_EQ(expected.points[5999], 1.5e-3 * 5999 - 3.0);
+  for (unsigned int numberOfThreads : {2u, 3u, 8u, 64u}) {
+    const auto problem = Parse(text, numberOfThreads);
+    EXPECT_EQ(problem.cameraIndices, expected.cameraIndices);
+    EXPECT_EQ(problem.pointIndices, expected.pointIndices);
+    EXPECT_EQ(problem.x, expected.x);
+    EXPECT_EQ(problem.y, expected.y);
+    EXPECT_EQ(problem.cameras, expected.cameras);
+    EXPECT_EQ(problem.points, expected.points);
+  }
+}
+
+TEST(BalImporter, MalformedProblems) {
+  const std::string header = "1 1 1\n";
+  const std::string camera = "0 0 0 0 0 -5 500 0 0\n";
+  const std::string point = "0 0 0\n";
+  // Valid
+  EXPECT_NO_THROW(Parse(header + "0 0 1.0 2.0\n" + camera + point));
+  // Invalid header, numbers and indices
+  EXPECT_THROW(Parse(""), std::runtime_error);
+  EXPECT_THROW(Parse("1 -1 1\n"), std::runtime_error);
+  EXPECT_THROW(Parse(header + "0 0 1.0 2,0\n" + camera + point),
+               std::runtime_error);
+  EXPECT_THROW(Parse(header + "0 0.5 1.0 2.0\n" + camera + point),
+               std::runtime_error);
+  EXPECT_THROW(Parse(header + "1 0 1.0 2.0\n" + camera + point),
+               std::runtime_error);
+  // Too few and too many numbers
+  EXPECT_THROW(Parse(header + "0 0 1.0 2.0\n" + camera), std::runtime_error);
+  EXPECT_THROW(Parse(header + "0 0 1.0 2.0\n" + camera + point + "1\n"),
+               std::runtime_error);
+  EXPECT_THROW(Core::BalImporter::Parse("/nonexistent/problem.txt"),
+               std::runtime_error);
+}
+
+TEST(BalImporter, ImportIntoImageBlock) {
+  ImageBlockType imageBlock;
+  Core::BalImporter::Import(ProblemPath, imageBlock);
+  ASSERT_EQ(imageBlock.getNumberOfCameras(), 3u);
+  ASSERT_EQ(imageBlock.getNumberOfImages(), 3u);
+  ASSERT_EQ(imageBlock.getNumberOfObjectPoints(), 5u);
+  EXPECT_EQ(imageBlock.getCameraHandleOfImage(imageBlock.getImageHandle(
+                "image2")),
+            imageBlock.getCameraHandle("camera2"));
+  const auto &observations = imageBlock.getObservations();
+  ASSERT_EQ(observations.size(), 15u);
+
+  // The undistorted image coordinates are the collinearity projections
+  std::vector<DataType> x, y;
+  imageBlock.computeImageCoordinates(x, y, true, 1);
+  for (std::size_t i = 0; i < observations.size(); ++i) {
+    const auto &image = imageBlock.getImage(observations.imageHandles[i]);
+    const auto &camera = imageBlock.getCamera(observations.cameraHandles[i]);
+    const Eigen::Vector3d point =
+        imageBlock.getObjectPoint(observations.pointHandles[i]);
+    const Eigen::Vector3d cameraPoint =
+        image->getRotationMatrix().transpose() *
+        (point - Eigen::Vector3d(image->getTranslation()));
+    const double c = camera->xyc[2];
+    // Up to the O(k^4) approximation and the 10 digits of the observations
+    EXPECT_NEAR(x[i], -c * cameraPoint[0] / cameraPoint[2], 1e-6) << i;
+    EXPECT_NEAR(y[i], -c * cameraPoint[1] / cameraPoint[2], 1e-6) << i;
+  }
+
+  // Only empty image blocks
+  EXPECT_THROW(Core::BalImporter::Import(ProblemPath, imageBlock),
+               std::invalid_argument);
+}
@@ -0,0 +1,384 @@
+#include "ColmapModel.h"
+#include "ImageBlock.h"
+
+#include <fstream>
+
+#include "boost/filesystem.hpp"
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+using CameraModel = Core::ColmapModel::CameraModel;
+
+namespace {
+/// Temporary directory, which is removed by the destructor
+class TemporaryDirectory {
+public:
+  TemporaryDirectory()
+      : mPath(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("%%%%-%%%%-%%%%")) {
+    boost::filesystem::create_directory(mPath);
+  }
+  ~TemporaryDirectory() { boost::filesystem::remove_all(mPath); }
+
+  std::string getPath() const { return mPath.string(); }
+
+private:
+  boost::filesystem::path mPath;
+};
+
+/// Project a point with a COLMAP camera (distortion-free models, RADIAL and
+/// OPENCV)
+Eigen::Vector2d Project(const Core::ColmapModel::Camera &camera,
+                        const Core::ColmapModel::Image &image,
+                        const Eigen::Vector3d &point) {
+  const Eigen::Quaterniond rotation(image.rotation[0], image.rotation[1],
+                                    image.rotation[2], image.rotation[3]);
+  const Eigen::Vector3d cameraPoint =
+      rotation * point + Eigen::Map<const Eigen::Vector3d>(image.translation);
+  const double x = cameraPoint[0] / cameraPoint[2];
+  const double y = cameraPoint[1] / cameraPoint[2];
+  const double *params = camera.parameters.data();
+  double fx, fy, cx, cy, k1 = 0.0, k2 = 0.0, p1 = 0.0, p2 = 0.0;
+  if (camera.model == CameraModel::OpenCV) {
+    fx = params[0];
+    fy = params[1];
+    cx = params[2];
+    cy = params[3];
+    k1 = params[4];
+    k2 = params[5];
+    p1 = params[6];
+    p2 = params[7];
+  } else {
+    fx = fy = params[0];
+    cx = params[1];
+    cy = params[2];
+    if (camera.model == CameraModel::Radial) {
+      k1 = params[3];
+      k2 = params[4];
+    }
+  }
+  const double r2 = x * x + y * y;
+  const double radial = 1.0 + k1 * r2 + k2 * r2 * r2;
+  const double xd = x * radial + 2.0 * p1 * x * y + p2 * (r2 + 2.0 * x * x);
+  const double yd = y * radial + p1 * (r2 + 2.0 * y * y) + 2.0 * p2 * x * y;
+  return Eigen::Vector2d(fx * xd + cx, fy * yd + cy);
+}
+
+/// Model of a RADIAL and an OPENCV camera, 3 images and 20 object points,
+/// which are observed in all images (with an unmatched image point each)
+Core::ColmapModel CreateModel() {
+  Core::ColmapModel model;
+  model.cameras.push_back({3,
+                           CameraModel::Radial,
+                           4000,
+                           3000,
+                           {3200.0, 2010.5, 1490.25, -0.05, 0.02}});
+  model.cameras.push_back({7,
+                           CameraModel::OpenCV,
+                           6000,
+                           4000,
+                           {5000.0, 5010.0, 3020.0, 1985.0, 0.03, -0.01,
+                            2e-4, -1e-4}});
+  for (unsigned int i = 0; i < 3; ++i) {
+    Core::ColmapModel::Image image;
+    image.id = 10 + i;
+    image.cameraIndex = i == 1 ? 1 : 0;
+    const Eigen::Quaterniond rotation(Eigen::AngleAxisd(
+        0.1 * i, Eigen::Vector3d(0.2, 1.0, -0.3).normalized()));
+    image.rotation[0] = rotation.w();
+    image.rotation[1] = rotation.x();
+    image.rotation[2] = rotation.y();
+    image.rotation[3] = rotation.z();
+    image.translation[0] = -0.5 * i;
+    image.translation[1] = 0.2;
+    image.translation[2] = 10.0;
+    image.name = "images/IMG_" + std::to_string(i) + ".jpg";
+    image.firstPoint2D = 21 * i;
+    image.numberOfPoints2D = 21;
+    model.images.push_back(image);
+  }
+  model.points2D.resize(2 * 63);
+  model.point3DIds2D.resize(63);
+  for (unsigned int j = 0; j < 20; ++j) {
+    const Eigen::Vector3d point(-2.0 + 0.2 * j, 1.5 - 0.15 * j, 0.1 * (j % 3));
+    model.point3DIds.push_back(100 + 3 * j);
+    model.points3D.insert(model.points3D.end(), point.data(),
+                          point.data() + 3);
+    model.colors.insert(model.colors.end(), {255, 128, 0});
+    model.errors.push_back(0.5);
+    for (std::uint32_t i = 0; i < 3; ++i) {
+      // Image points in reverse order of the object points
+      const std::uint32_t point2DIndex = 20 - j;
+      const auto &image = model.images[i];
+      const Eigen::Vector2d pixel =
+          Project(model.cameras[image.cameraIndex], image, point);
+      model.points2D[2 * (image.firstPoint2D + point2DIndex)] = pixel[0];
+      model.points2D[2 * (image.firstPoint2D + point2DIndex) + 1] = pixel[1];
+      model.point3DIds2D[image.firstPoint2D + point2DIndex] =
+          model.point3DIds.back();
+      model.trackImageIndices.push_back(i);
+      model.trackPoint2DIndices.push_back(point2DIndex);
+    }
+    model.trackOffsets.push_back(model.trackImageIndices.size());
+  }
+  for (std::uint32_t i = 0; i < 3; ++i) {
+    model.points2D[2 * model.images[i].firstPoint2D] = 10.0;
+    model.points2D[2 * model.images[i].firstPoint2D + 1] = 20.0;
+    model.point3DIds2D[model.images[i].firstPoint2D] =
+        Core::ColmapModel::InvalidPoint3DId;
+  }
+  return model;
+}
+
+/// Check that the undistorted observations are the collinearity projections
+void ExpectCollinearity(const ImageBlockType &imageBlock,
+                        const double tolerance) {
+  const auto &observations = imageBlock.getObservations();
+  std::vector<DataType> x, y;
+  imageBlock.computeImageCoordinates(x, y, true, 1);
+  for (std::size_t i = 0; i < observations.size(); ++i) {
+    const auto &image = imageBlock.getImage(observations.imageHandles[i]);
+    const auto &camera = imageBlock.getCamera(observations.cameraHandles[i]);
+    const Eigen::Vector3d point =
+        imageBlock.getObjectPoint(observations.pointHandles[i]);
+    const Eigen::Vector3d cameraPoint =
+        image->getRotationMatrix().transpose() *
+        (point - Eigen::Vector3d(image->getTranslation()));
+    const double c = camera->xyc[2];
+    EXPECT_NEAR(x[i], camera->xyc[0] - c * cameraPoint[0] / cameraPoint[2],
+                tolerance)
+        << i;
+    EXPECT_NEAR(y[i], camera->xyc[1] - c * cameraPoint[1] / cameraPoint[2],
+                tolerance)
+        << i;
+  }
+}
+} // namespace
+
+TEST(ColmapModel, WriteAndRead) {
+  const Core::ColmapModel model = CreateModel();
+  TemporaryDirectory directory;
+  model.write(directory.getPath());
+  const Core::ColmapModel read = Core::ColmapModel::Read(directory.getPath());
+
+  ASSERT_EQ(read.cameras.size(), 2u);
+  EXPECT_EQ(read.cameras[1].id, 7u);
+  EXPECT_EQ(read.cameras[1].model, CameraModel::OpenCV);
+  EXPECT_EQ(read.cameras[1].height, 4000u);
+  EXPECT_EQ(read.cameras[1].parameters, model.cameras[1].parameters);
+  ASSERT_EQ(read.images.size(), 3u);
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(read.images[i].id, model.images[i].id);
+    EXPECT_EQ(read.images[i].cameraIndex, model.images[i].cameraIndex);
+    EXPECT_EQ(read.images[i].name, model.images[i].name);
+    EXPECT_EQ(read.images[i].translation[0], model.images[i].translation[0]);
+    EXPECT_EQ(read.images[i].rotation[3], model.images[i].rotation[3]);
+    EXPECT_EQ(read.images[i].firstPoint2D, model.images[i].firstPoint2D);
+  }
+  EXPECT_EQ(read.points2D, model.points2D);
+  EXPECT_EQ(read.point3DIds2D, model.point3DIds2D);
+  EXPECT_EQ(read.point3DIds, model.point3DIds);
+  EXPECT_EQ(read.points3D, model.points3D);
+  EXPECT_EQ(read.colors, model.colors);
+  EXPECT_EQ(read.errors, model.errors);
+  EXPECT_EQ(read.trackOffsets, model.trackOffsets);
+  EXPECT_EQ(read.trackImageIndices, model.trackImageIndices);
+  EXPECT_EQ(read.trackPoint2DIndices, model.trackPoint2DIndices);
+}
+
+TEST(ColmapModel, ImportIntoImageBlock) {
+  TemporaryDirectory directory;
+  CreateModel().write(directory.getPath());
+  ImageBlockType imageBlock;
+  Core::ColmapModel::Import(directory.getPath(), imageBlock);
+  ASSERT_EQ(imageBlock.getNumberOfCameras(), 2u);
+  ASSERT_EQ(imageBlock.getNumberOfImages(), 3u);
+  ASSERT_EQ(imageBlock.getNumberOfObjectPoints(), 20u);
+  EXPECT_EQ(imageBlock.getCameraHandleOfImage(
+                imageBlock.getImageHandle("images/IMG_1.jpg")),
+            imageBlock.getCameraHandle("camera7"));
+  EXPECT_EQ(imageBlock.getObjectPointHandle("point103"), 1u);
+  const auto &observations = imageBlock.getObservations();
+  ASSERT_EQ(observations.size(), 60u);
+  EXPECT_EQ(observations.getSortOrder(),
+            Core::ObservationTable<DataType>::SortOrder::ByImage);
+  EXPECT_EQ(imageBlock.getTracks().getTrackLength(5), 3u);
+
+  // Up to the approximations of the radial (O(k^4)) and tangential (first
+  // order) distortions
+  ExpectCollinearity(imageBlock, 5e-3);
+
+  // Only empty image blocks
+  EXPECT_THROW(Core::ColmapModel::Import(directory.getPath(), imageBlock),
+               std::invalid_argument);
+}
+
+TEST(ColmapModel, ExportRoundTrip) {
+  TemporaryDirectory directory;
+  const Core::ColmapModel model = CreateModel();
+  model.write(directory.getPath());
+  ImageBlockType imageBlock;
+  Core::ColmapModel::Import(directory.getPath(), imageBlock);
+
+  const Core::ColmapModel exported = Core::ColmapModel::Create(imageBlock);
+  ASSERT_EQ(exported.cameras.size(), 2u);
+  for (std::size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(exported.cameras[i].model, model.cameras[i].model);
+    ASSERT_EQ(exported.cameras[i].parameters.size(),
+              model.cameras[i].parameters.size());
+    for (std::size_t j = 0; j < model.cameras[i].parameters.size(); ++j) {
+      EXPECT_NEAR(exported.cameras[i].parameters[j],
+                  model.cameras[i].parameters[j],
+                  1e-12 * std::abs(model.cameras[i].parameters[j]));
+    }
+  }
+  ASSERT_EQ(exported.images.size(), 3u);
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(exported.images[i].name, model.images[i].name);
+    EXPECT_EQ(exported.images[i].numberOfPoints2D, 20u);
+    const Eigen::Quaterniond expected(
+        model.images[i].rotation[0], model.images[i].rotation[1],
+        model.images[i].rotation[2], model.images[i].rotation[3]);
+    const Eigen::Quaterniond rotation(
+        exported.images[i].rotation[0], exported.images[i].rotation[1],
+        exported.images[i].rotation[2], exported.images[i].rotation[3]);
+    EXPECT_NEAR(rotation.angularDistance(expected), 0.0, 1e-12);
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(exported.images[i].translation[j],
+                  model.images[i].translation[j], 1e-12);
+    }
+  }
+  EXPECT_EQ(exported.points3D, model.points3D);
+  EXPECT_EQ(exported.trackOffsets, model.trackOffsets);
+
+  // The exported model loads into the same image block
+  exported.write(directory.getPath());
+  ImageBlockType reimportedBlock;
+  Core::ColmapModel::Import(directory.getPath(), reimportedBlock);
+  const auto &observations = reimportedBlock.getObservations();
+  const auto &expected = imageBlock.getObservations();
+  EXPECT_EQ(observations.imageHandles, expected.imageHandles);
+  EXPECT_EQ(observations.pointHandles, expected.pointHandles);
+  EXPECT_EQ(observations.x, expected.x);
+  EXPECT_EQ(observations.y, expected.y);
+}
+
+TEST(ColmapModel, ExportComposesMountingParameters) {
+  // Reference camera in mm with a mounting offset, and a non-reference
+  // camera of the rig
+  CameraType iops;
+  iops.width = 6000;
+  iops.height = 4000;
+  iops.xPixelSize = 0.004;
+  iops.yPixelSize = 0.004;
+  iops.xyc[0] = 0.1;
+  iops.xyc[1] = -0.2;
+  iops.xyc[2] = 50.0;
+  iops.distortionParameters.setZero();
+  iops.distortionParameters[1] = 1e-5;
+  iops.distortionParameters[4] = 1e-6;
+  Core::ExteriorOrientation<DataType> mounting;
+  mounting.setTranslation(0.1, 0.2, -0.3);
+  mounting.setRotation(1.0, 2.0, 3.0);
+  ImageBlockType imageBlock;
+  imageBlock.addCamera("reference", std::make_shared<CameraType>(
+                                        "reference", mounting, iops));
+  mounting.setRotation(0.0, 30.0, 0.0);
+  imageBlock.addCamera("oblique", std::make_shared<CameraType>(
+                                      "reference", mounting, iops));
+  for (unsigned int i = 0; i < 2; ++i) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId(i == 0 ? "reference" : "oblique");
+    image->setTranslation(10.0 * i, 5.0, 1000.0);
+    image->setRotation(0.5, -0.5, 10.0);
+    imageBlock.addImage("image" + std::to_string(i), image);
+  }
+  imageBlock.addObjectPoint("point", ObjectPointType(1.0, 2.0, 3.0));
+  Core::ObservationTable<DataType> observations;
+  observations.addObservation(0, 0, 0, 3100.0, 1900.0);
+  observations.addObservation(1, 0, 1, 2900.0, 2050.0);
+  imageBlock.setObservations(std::move(observations));
+
+  const Core::ColmapModel model = Core::ColmapModel::Create(imageBlock);
+  ASSERT_EQ(model.cameras.size(), 2u);
+  EXPECT_EQ(model.cameras[0].model, CameraModel::OpenCV);
+  EXPECT_DOUBLE_EQ(model.cameras[0].parameters[0], 50.0 / 0.004);
+  EXPECT_DOUBLE_EQ(model.cameras[0].parameters[2], 3000.0 + 0.1 / 0.004);
+  EXPECT_DOUBLE_EQ(model.cameras[0].parameters[3], 2000.0 + 0.2 / 0.004);
+  EXPECT_EQ(model.images[1].name, "image1");
+  EXPECT_EQ(model.point3DIds2D[0], 1u);
+  EXPECT_EQ(model.trackImageIndices,
+            std::vector<std::uint32_t>({0, 1}));
+
+  // Camera to mapping transformation of the non-reference camera
+  const auto &image = *imageBlock.getImage(1);
+  const auto &referenceMounting =
+      imageBlock.getCamera(0)->getMountingParameters();
+  const auto &cameraMounting = imageBlock.getCamera(1)->getMountingParameters();
+  const Eigen::Matrix3d rotation = image.getRotationMatrix() *
+                                   referenceMounting.getRotationMatrix() *
+                                   cameraMounting.getRotationMatrix();
+  const Eigen::Vector3d center =
+      Eigen::Vector3d(image.getTranslation()) +
+      image.getRotationMatrix() *
+          (Eigen::Vector3d(referenceMounting.getTranslation()) +
+           referenceMounting.getRotationMatrix() *
+               Eigen::Vector3d(cameraMounting.getTranslation()));
+  const Eigen::Quaterniond worldToCamera(
+      model.images[1].rotation[0], model.images[1].rotation[1],
+      model.images[1].rotation[2], model.images[1].rotation[3]);
+  const Eigen::Matrix3d expected =
+      Eigen::Vector3d(1.0, -1.0, -1.0).asDiagonal() * rotation.transpose();
+  EXPECT_TRUE(worldToCamera.toRotationMatrix().isApprox(expected, 1e-12));
+  EXPECT_TRUE(
+      (-worldToCamera.toRotationMatrix().transpose() *
+       Eigen::Map<const Eigen::Vector3d>(model.images[1].translation))
+          .isApprox(center, 1e-12));
+
+  // Affine distortions cannot be exported
+  imageBlock.getCamera(0)->distortionParameters[7] = 1e-4;
+  EXPECT_THROW(Core::ColmapModel::Create(imageBlock), std::invalid_argument);
+}
+
+TEST(ColmapModel, InvalidModels) {
+  TemporaryDirectory directory;
+  EXPECT_THROW(Core::ColmapModel::Read(directory.getPath()),
+               std::runtime_error);
+
+  // Truncated object points
+  const Core::ColmapModel model = CreateModel();
+  model.write(directory.getPath());
+  const std::string points3DPath = directory.getPath() + "/points3D.bin";
+  const auto size = boost::filesystem::file_size(points3DPath);
+  boost::filesystem::resize_file(points3DPath, size - 4);
+  EXPECT_THROW(Core::ColmapModel::Read(directory.getPath()),
+               std::runtime_error);
+
+  // Duplicate images
+  Core::ColmapModel invalidModel = model;
+  invalidModel.images[2].id = 10;
+  invalidModel.write(directory.getPath());
+  EXPECT_THROW(Core::ColmapModel::Read(directory.getPath()),
+               std::runtime_error);
+
+  // Unsupported camera models
+  Core::ColmapModel fisheyeModel = model;
+  fisheyeModel.cameras[0].model = CameraModel::RadialFisheye;
+  ImageBlockType imageBlock;
+  EXPECT_THROW(fisheyeModel.load(imageBlock), std::invalid_argument);
+  using RadialBlockType = Core::ImageBlock<
+      Core::FrameCamera<DataType, 4, Core::RadialDistortion>, ImageType,
+      ObjectPointType, DataType>;
+  RadialBlockType radialBlock;
+  EXPECT_THROW(model.load(radialBlock), std::invalid_argument);
+}
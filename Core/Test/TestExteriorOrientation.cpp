@@ -55,3 +55,131 @@ TEST(ExteriorOrientation, TransformTo) {
   EXPECT_DOUBLE_EQ(combinedRotation[1], 0.0);
   EXPECT_DOUBLE_EQ(combinedRotation[2], 0.0);
 }
+
+TEST(ExteriorOrientation, RotationMatrixDerivatives) {
+  using DataType = double;
+  using EOP = Core::ExteriorOrientation<DataType>;
+  Eigen::Vector3d angles{0.3, -0.2, 1.1};
+  Eigen::Matrix3d derivatives[3];
+  EOP::CreateRotationMatrixDerivativesFromEulerAnglesInRadians(angles,
+                                                               derivatives);
+  // Compare with central differences
+  const DataType step = 1e-6;
+  for (unsigned int i = 0; i < 3; ++i) {
+    Eigen::Vector3d forward = angles;
+    Eigen::Vector3d backward = angles;
+    forward[i] += step;
+    backward[i] -= step;
+    Eigen::Matrix3d numerical =
+        (EOP::CreateRotationMatrixFromEluerAnglesInRadians(forward) -
+         EOP::CreateRotationMatrixFromEluerAnglesInRadians(backward)) /
+        (2.0 * step);
+    EXPECT_TRUE((numerical - derivatives[i]).cwiseAbs().maxCoeff() < 1e-8);
+  }
+}
+
+TEST(ExteriorOrientation, CachedRotationMatrix) {
+  using DataType = double;
+  using EOP = Core::ExteriorOrientation<DataType>;
+  EOP exterior;
+  exterior.setRotation(30.0, 45.0, 120.0);
+  const Eigen::Matrix3d expected =
+      EOP::CreateRotationMatrixFromEulerAnglesInDegrees(
+          Eigen::Vector3d{30.0, 45.0, 120.0});
+  EXPECT_TRUE(exterior.getRotationMatrix().isApprox(expected, 1e-15));
+
+  // Cached derivatives match the static version
+  Eigen::Matrix3d derivatives[3];
+  Eigen::Matrix3d expectedDerivatives[3];
+  exterior.getRotationMatrixDerivatives(derivatives);
+  EOP::CreateRotationMatrixDerivativesFromEulerAnglesInRadians(
+      exterior.getRotationInRadians(), expectedDerivatives);
+  for (unsigned int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(derivatives[i].isApprox(expectedDerivatives[i], 1e-14));
+  }
+
+  // The cache follows setRotation and assignFromArray
+  EXPECT_EQ(EOP().getRotationMatrix(), Eigen::Matrix3d::Identity());
+  exterior.setRotation(-10.0, 5.0, 60.0);
+  EXPECT_TRUE(exterior.getRotationMatrix().isApprox(
+      EOP::CreateRotationMatrixFromEulerAnglesInDegrees(
+          Eigen::Vector3d{-10.0, 5.0, 60.0}),
+      1e-15));
+  double params[6];
+  exterior.convertToArray(params);
+  params[5] = M_PI / 2.0;
+  exterior.assignFromArray(params);
+  EXPECT_TRUE(exterior.getRotationMatrix().isApprox(
+      EOP::CreateRotationMatrixFromEulerAnglesInDegrees(
+          Eigen::Vector3d{-10.0, 5.0, 90.0}),
+      1e-15));
+
+  // Converting the unit of the angles keeps the rotation
+  EXPECT_TRUE(exterior.convertRotationToRadians());
+  EXPECT_FALSE(exterior.convertRotationToRadians());
+  EXPECT_NEAR(exterior.getRotationInDegrees()[2], 90.0, 1e-12);
+  EXPECT_TRUE(exterior.convertRotationToDegrees());
+  EXPECT_FALSE(exterior.convertRotationToDegrees());
+  EXPECT_NEAR(exterior.getRotation()[2], 90.0, 1e-12);
+}
+
+TEST(ExteriorOrientation, BatchedRotationMatrices) {
+  using DataType = double;
+  using EOP = Core::ExteriorOrientation<DataType>;
+  // Poses laid out as X, Y, Z, omega, phi and kappa
+  const std::size_t numberOfPoses = 1000;
+  std::vector<DataType> poses(6 * numberOfPoses);
+  for (std::size_t i = 0; i < numberOfPoses; ++i) {
+    poses[6 * i + 3] = 0.001 * i;
+    poses[6 * i + 4] = -0.5 + 0.0007 * i;
+    poses[6 * i + 5] = 3.0 - 0.005 * i;
+  }
+  std::vector<DataType> matrices(9 * numberOfPoses);
+  EOP::CreateRotationMatricesFromEulerAnglesInRadians(
+      &poses[3], 6, numberOfPoses, matrices.data());
+  for (std::size_t i = 0; i < numberOfPoses; ++i) {
+    const Eigen::Map<const Eigen::Matrix3d> rotation(&matrices[9 * i]);
+    const Eigen::Matrix3d expected =
+        EOP::CreateRotationMatrixFromEluerAnglesInRadians(
+            Eigen::Vector3d(poses[6 * i + 3], poses[6 * i + 4],
+                            poses[6 * i + 5]));
+    EXPECT_TRUE((rotation - expected).cwiseAbs().maxCoeff() < 1e-14) << i;
+  }
+}
+
+TEST(ExteriorOrientation, GimbalLockAndQuaternion) {
+  using DataType = double;
+  using EO = Core::ExteriorOrientation<DataType>;
+  // Close to and at gimbal lock (i.e., phi = 90 degrees), the recovered
+  // angles have to reproduce the rotation matrix
+  for (const DataType phi : {90.0 - 1e-6, 90.0, -90.0}) {
+    const Eigen::Matrix3d rotationMatrix =
+        EO::CreateRotationMatrixFromEulerAnglesInDegrees(
+            Eigen::Vector3d{20.0, phi, 35.0});
+    const Eigen::Vector3d eulerAngles =
+        EO::GetEulerAnglesInDegreesFromRotationMatrix(rotationMatrix);
+    EXPECT_TRUE(eulerAngles.allFinite());
+    EXPECT_NEAR(phi, eulerAngles[1], 1e-6);
+    EXPECT_TRUE(EO::CreateRotationMatrixFromEulerAnglesInDegrees(eulerAngles)
+                    .isApprox(rotationMatrix, 1e-10));
+  }
+
+  // Quaternion and angle-axis views of the same rotation
+  EO exterior;
+  exterior.setRotation(10.0, -80.0, 150.0);
+  const Eigen::Quaterniond quaternion = exterior.getRotationAsQuaternion();
+  EXPECT_GE(quaternion.w(), 0.0);
+  EXPECT_TRUE(quaternion.toRotationMatrix().isApprox(
+      exterior.getRotationMatrix(), 1e-12));
+  const Eigen::Vector3d angleAxis = exterior.getRotationAsAngleAxis();
+  EXPECT_TRUE(Eigen::AngleAxisd(angleAxis.norm(), angleAxis.normalized())
+                  .toRotationMatrix()
+                  .isApprox(exterior.getRotationMatrix(), 1e-12));
+
+  // Round trip through a rotation matrix
+  EO other;
+  other.setRotationFromMatrix(quaternion.toRotationMatrix());
+  EXPECT_NEAR(10.0, other.getRotation()[0], 1e-9);
+  EXPECT_NEAR(-80.0, other.getRotation()[1], 1e-9);
+  EXPECT_NEAR(150.0, other.getRotation()[2], 1e-9);
+}
@@ -0,0 +1,74 @@
+#include "IdRegistry.h"
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST(IdRegistry, AddAndFindIds) {
+  Core::IdRegistry registry;
+  EXPECT_EQ(registry.add("image1"), 0);
+  EXPECT_EQ(registry.add("image2"), 1);
+  EXPECT_EQ(registry.add("image3"), 2);
+  // Duplicated id
+  EXPECT_EQ(registry.add("image2"), Core::InvalidHandle);
+  EXPECT_EQ(registry.size(), 3);
+
+  EXPECT_EQ(registry.find("image3"), 2);
+  EXPECT_EQ(registry.getId(1), "image2");
+  EXPECT_EQ(registry.find("image4"), Core::InvalidHandle);
+  ASSERT_THROW(registry.getHandle("image4"), std::invalid_argument);
+}
+
+TEST(IdRegistry, EraseKeepsHandlesDense) {
+  Core::IdRegistry registry;
+  registry.add("a");
+  registry.add("b");
+  registry.add("c");
+  Core::Handle erasedHandle;
+  EXPECT_TRUE(registry.erase("a", erasedHandle));
+  EXPECT_EQ(erasedHandle, 0);
+  // The last id is moved to the erased handle
+  EXPECT_EQ(registry.size(), 2);
+  EXPECT_EQ(registry.getId(0), "c");
+  EXPECT_EQ(registry.find("c"), 0);
+  EXPECT_EQ(registry.find("b"), 1);
+  EXPECT_TRUE(!registry.erase("a", erasedHandle));
+}
+
+TEST(IdRegistry, ManyAddsAndErases) {
+  Core::IdRegistry registry;
+  registry.reserve(100);
+  std::vector<std::string> ids;
+  for (unsigned int i = 0; i < 1000; ++i) {
+    ids.push_back("point" + std::to_string(i));
+    ASSERT_EQ(registry.add(ids.back()), i);
+  }
+  // Erase every third id in a scattered order, following the handle moves
+  for (unsigned int i = 0; i < 1000; i += 3) {
+    const std::string id = "point" + std::to_string((i * 7) % 1000);
+    const Core::Handle handle = registry.find(id);
+    if (handle == Core::InvalidHandle) {
+      continue;
+    }
+    Core::Handle erasedHandle;
+    ASSERT_TRUE(registry.erase(id, erasedHandle));
+    EXPECT_EQ(erasedHandle, handle);
+    ids[handle] = ids.back();
+    ids.pop_back();
+  }
+  ASSERT_EQ(registry.size(), ids.size());
+  for (Core::Handle handle = 0; handle < ids.size(); ++handle) {
+    EXPECT_EQ(registry.getId(handle), ids[handle]);
+    EXPECT_EQ(registry.find(ids[handle]), handle);
+  }
+  for (unsigned int i = 0; i < 1000; i += 3) {
+    EXPECT_FALSE(registry.contains("point" + std::to_string((i * 7) % 1000)));
+  }
+  // Erased ids can be added again
+  EXPECT_EQ(registry.add("point0"), ids.size());
+  registry.clear();
+  EXPECT_EQ(registry.find("point1"), Core::InvalidHandle);
+  EXPECT_EQ(registry.add("point1"), 0);
+}
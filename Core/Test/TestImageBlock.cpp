@@ -126,3 +126,90 @@ TEST(ImageBlock, AddNavigationDataToImageBlock) {
       imageBlock.getNavigationMeasurement(numberOfNavigationMeasurements),
       std::invalid_argument);
 }
+
+TEST(ImageBlock, LookupByHandle) {
+  // Handles are assigned in insertion order
+  EXPECT_EQ(imageBlock.getCameraHandle("camera2"), 1);
+  EXPECT_EQ(imageBlock.getCameraId(1), "camera2");
+  EXPECT_EQ(imageBlock.getCamera(1), imageBlock.getCamera("camera2"));
+
+  const Core::Handle imageHandle = imageBlock.getImageHandle("image2");
+  EXPECT_EQ(imageHandle, 1);
+  EXPECT_EQ(imageBlock.getImage(imageHandle), imageBlock.getImage("image2"));
+  ASSERT_THROW(imageBlock.getImageHandle("image3"), std::invalid_argument);
+
+  const Core::Handle pointHandle = imageBlock.getObjectPointHandle("3");
+  const auto &point = imageBlock.getObjectPoint(pointHandle);
+  EXPECT_EQ(point[0], 0.1 * 3.0);
+  EXPECT_EQ(imageBlock.getObjectPointId(pointHandle), "3");
+  EXPECT_EQ(imageBlock.getObjectPoints().size(),
+            imageBlock.getNumberOfObjectPoints());
+}
+
+TEST(ImageBlock, ComputeImageCoordinates) {
+  // Two cameras with different IOPs, and observations sorted by point (i.e.,
+  // alternating cameras)
+  using ImageBlockType =
+      Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+  ImageBlockType block;
+  for (int cameraIndex = 0; cameraIndex < 2; ++cameraIndex) {
+    auto camera = std::make_shared<CameraType>();
+    camera->width = 4000;
+    camera->height = 3000;
+    camera->xPixelSize = 0.004 + 0.001 * cameraIndex;
+    camera->yPixelSize = camera->xPixelSize;
+    camera->xyc << 0.01, -0.02 * cameraIndex, 35.0;
+    camera->distortionParameters << 0.0, 1e-4, -1e-7, 0.0, 1e-5, -1e-5, 0.0,
+        1e-5, 0.0;
+    block.addCamera("camera" + std::to_string(cameraIndex), camera);
+  }
+  const unsigned int numberOfImages = 4;
+  const unsigned int numberOfPoints = 1500;
+  for (unsigned int imageIndex = 0; imageIndex < numberOfImages;
+       ++imageIndex) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId("camera" + std::to_string(imageIndex % 2));
+    block.addImage("image" + std::to_string(imageIndex), image);
+  }
+  Core::ObservationTable<DataType> observations;
+  for (unsigned int pointIndex = 0; pointIndex < numberOfPoints;
+       ++pointIndex) {
+    block.addObjectPoint(std::to_string(pointIndex),
+                         ObjectPointType(0.0, 0.0, 0.0));
+    for (unsigned int imageIndex = 0; imageIndex < numberOfImages;
+         ++imageIndex) {
+      observations.addObservation(imageIndex, pointIndex, imageIndex % 2,
+                                  2.5 * pointIndex + imageIndex,
+                                  1.5 * pointIndex - imageIndex);
+    }
+  }
+  block.setObservations(observations);
+
+  // All observations (in parallel)
+  std::vector<DataType> x;
+  std::vector<DataType> y;
+  block.computeImageCoordinates(x, y, true, 4);
+  ASSERT_EQ(x.size(), observations.size());
+  for (std::size_t i = 0; i < observations.size(); ++i) {
+    const auto &camera = block.getCamera(observations.cameraHandles[i]);
+    const auto imagePoint = camera->ConvertPixelToImageCoordinates(
+        observations.y[i], observations.x[i]);
+    const auto distortions =
+        camera->calculateDistortion(imagePoint[0], imagePoint[1]);
+    EXPECT_DOUBLE_EQ(x[i], imagePoint[0] - distortions[0]);
+    EXPECT_DOUBLE_EQ(y[i], imagePoint[1] - distortions[1]);
+  }
+
+  // Observations of a single image
+  std::vector<DataType> imageX;
+  std::vector<DataType> imageY;
+  block.computeImageCoordinates(1, imageX, imageY, false);
+  const auto indices = block.getTracks().getImageObservations(1);
+  ASSERT_EQ(imageX.size(), indices.size());
+  for (std::size_t i = 0; i < indices.size(); ++i) {
+    const auto imagePoint = block.getCamera(1)->ConvertPixelToImageCoordinates(
+        observations.y[indices[i]], observations.x[indices[i]]);
+    EXPECT_DOUBLE_EQ(imageX[i], imagePoint[0]);
+    EXPECT_DOUBLE_EQ(imageY[i], imagePoint[1]);
+  }
+}
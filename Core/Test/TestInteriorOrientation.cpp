@@ -61,3 +61,222 @@ TEST(InteriorOrientation, ConvertImageCoordinatesAndPixel) {
   EXPECT_DOUBLE_EQ(row, pixelCoords[0]);
   EXPECT_DOUBLE_EQ(col, pixelCoords[1]);
 }
+
+TEST(InteriorOrientation, ConvertToAndFromArray) {
+  auto iops = PrepareIOPs();
+  DataType params[3 + 9];
+  iops.convertToArray(params);
+  EXPECT_EQ(params[0], iops.xyc[0]);
+  EXPECT_EQ(params[2], iops.xyc[2]);
+  EXPECT_EQ(params[3 + 5], 2e-3);
+
+  params[2] = 55.0;
+  params[3 + 1] = 2e-5;
+  Core::InteriorOrientation<DataType, 9> newIops;
+  newIops.assignFromArray(params);
+  EXPECT_EQ(newIops.xyc[1], iops.xyc[1]);
+  EXPECT_EQ(newIops.xyc[2], 55.0);
+  EXPECT_EQ(newIops.distortionParameters[1], 2e-5);
+  EXPECT_EQ(newIops.distortionParameters[4], 1e-3);
+}
+
+TEST(InteriorOrientation, AddDistortionWithNewtonAndGrid) {
+  // Get IOPs with pixel size in mm and strong radial distortion
+  auto iops = PrepareIOPs();
+  iops.xPixelSize = 0.005;
+  iops.yPixelSize = 0.005;
+  iops.distortionParameters << 0.0, -2e-4, 1e-7, 0.0, 1e-5, -2e-5, 0.0, 1e-4,
+      -1e-4;
+  // Analytic distortion Jacobian against central differences
+  const DataType step = 1e-6;
+  const auto jacobian = iops.calculateDistortionJacobian(8.0, -5.0);
+  const Eigen::Matrix<DataType, 2, 1> derivativeX =
+      (iops.calculateDistortion(8.0 + step, -5.0) -
+       iops.calculateDistortion(8.0 - step, -5.0)) /
+      (2.0 * step);
+  const Eigen::Matrix<DataType, 2, 1> derivativeY =
+      (iops.calculateDistortion(8.0, -5.0 + step) -
+       iops.calculateDistortion(8.0, -5.0 - step)) /
+      (2.0 * step);
+  EXPECT_TRUE(jacobian.col(0).isApprox(derivativeX, 1e-6));
+  EXPECT_TRUE(jacobian.col(1).isApprox(derivativeY, 1e-6));
+
+  // Newton's method and fixed-point iterations agree
+  const DataType tolerance = 1e-10;
+  const auto newtonPoint = iops.addDistortion(10.0, 6.0, tolerance);
+  const auto fixedPoint =
+      iops.addDistortionWithFixedPointIterations(10.0, 6.0, tolerance);
+  EXPECT_NEAR(newtonPoint[0], fixedPoint[0], 1e-9);
+  EXPECT_NEAR(newtonPoint[1], fixedPoint[1], 1e-9);
+  const auto distortions =
+      iops.calculateDistortion(newtonPoint[0], newtonPoint[1]);
+  EXPECT_NEAR(newtonPoint[0] - distortions[0] - iops.xyc[0], 10.0, tolerance);
+  EXPECT_NEAR(newtonPoint[1] - distortions[1] - iops.xyc[1], 6.0, tolerance);
+
+  // Grid lookups are within the accuracy, and tighter tolerances are refined
+  const DataType accuracy = 1e-5;
+  Core::InteriorOrientation<DataType, Size> emptyIOPs;
+  EXPECT_THROW(emptyIOPs.buildDistortionInversionGrid(), std::invalid_argument);
+  ASSERT_TRUE(iops.buildDistortionInversionGrid(accuracy));
+  ASSERT_NE(iops.getDistortionInversionGrid(), nullptr);
+  for (const DataType x : {-12.0, -3.3, 0.0, 7.1, 12.4}) {
+    for (const DataType y : {-7.4, -1.2, 5.5, 7.4}) {
+      const auto exact =
+          iops.addDistortionWithFixedPointIterations(x, y, 1e-12);
+      const auto lookup = iops.addDistortion(x, y, accuracy);
+      EXPECT_LT((lookup - exact).norm(), accuracy);
+      const auto refined = iops.addDistortion(x, y, 1e-11);
+      EXPECT_LT((refined - exact).norm(), 1e-10);
+    }
+  }
+  // Points outside of the grid fall back to Newton's method
+  const auto outside = iops.addDistortion(20.0, 0.0, accuracy);
+  EXPECT_LT((outside -
+             iops.addDistortionWithFixedPointIterations(20.0, 0.0, 1e-12))
+                .norm(),
+            accuracy);
+  // Modified IOPs discard the grid
+  DataType params[3 + Size];
+  iops.convertToArray(params);
+  iops.assignFromArray(params);
+  EXPECT_EQ(iops.getDistortionInversionGrid(), nullptr);
+}
+
+// Compare the analytic Jacobians of a distortion model with central
+// differences
+template <typename TDistortionModel>
+void CheckDistortionJacobians(const DataType *const params, const DataType c,
+                              const DataType dx, const DataType dy) {
+  constexpr int NumberOfParameters = TDistortionModel::NumberOfParameters;
+  Eigen::Matrix<DataType, 2, 2> pointJacobian;
+  Eigen::Matrix<DataType, 2, 1 + NumberOfParameters, Eigen::RowMajor>
+      parameterJacobian;
+  TDistortionModel::ComputeJacobians(params, c, dx, dy, pointJacobian,
+                                     &parameterJacobian);
+
+  // Perturb dx, dy, c and the distortion parameters
+  DataType values[3 + NumberOfParameters] = {dx, dy, c};
+  std::copy(params, params + NumberOfParameters, values + 3);
+  for (int i = 0; i < 3 + NumberOfParameters; ++i) {
+    const DataType step = 1e-6 * std::max(1.0, std::abs(values[i]));
+    DataType distortions[2][2];
+    for (int side = 0; side < 2; ++side) {
+      DataType perturbed[3 + NumberOfParameters];
+      std::copy(values, values + 3 + NumberOfParameters, perturbed);
+      perturbed[i] += side == 0 ? step : -step;
+      TDistortionModel::Compute(perturbed + 3, perturbed[2], perturbed[0],
+                                perturbed[1], distortions[side]);
+    }
+    for (int row = 0; row < 2; ++row) {
+      const DataType numeric =
+          (distortions[0][row] - distortions[1][row]) / (2.0 * step);
+      const DataType analytic =
+          i < 2 ? pointJacobian(row, i) : parameterJacobian(row, i - 2);
+      EXPECT_NEAR(analytic, numeric, 1e-6 * std::max(1.0, std::abs(numeric)))
+          << "row " << row << ", column " << i;
+    }
+  }
+}
+
+TEST(InteriorOrientation, DistortionModels) {
+  // The default models follow from the number of distortion parameters
+  static_assert(std::is_same<Core::InteriorOrientation<DataType, 9>::
+                                 DistortionModel,
+                             Core::BrownDistortion>::value,
+                "BrownDistortion is the default for 9 parameters");
+  static_assert(std::is_same<Core::InteriorOrientation<DataType, 4>::
+                                 DistortionModel,
+                             Core::RadialDistortion>::value,
+                "RadialDistortion is the default for 4 parameters");
+
+  // The radial model only reads its 4 parameters, and matches the radial part
+  // of the Brown model
+  auto brownIops = PrepareIOPs();
+  brownIops.distortionParameters.tail<5>().setZero();
+  Core::InteriorOrientation<DataType, 4> radialIops;
+  radialIops.xyc = brownIops.xyc;
+  radialIops.distortionParameters = brownIops.distortionParameters.head<4>();
+  const auto brownDistortions = brownIops.calculateDistortion(30.0, -20.0);
+  const auto radialDistortions = radialIops.calculateDistortion(30.0, -20.0);
+  EXPECT_DOUBLE_EQ(brownDistortions[0], radialDistortions[0]);
+  EXPECT_DOUBLE_EQ(brownDistortions[1], radialDistortions[1]);
+
+  // Without correction terms, the equidistant model maps the distorted radius
+  // c * thetaD to the perspective radius c * tan(thetaD)
+  Core::InteriorOrientation<DataType, 4, Core::EquidistantDistortion>
+      fisheyeIops;
+  fisheyeIops.xyc << 0.1, 0.2, 8.0;
+  fisheyeIops.distortionParameters.setZero();
+  const DataType thetaD = 0.9;
+  const Eigen::Matrix<DataType, 2, 1> direction(0.6, -0.8);
+  const Eigen::Matrix<DataType, 2, 1> measured =
+      fisheyeIops.xyc.head<2>() + fisheyeIops.xyc[2] * thetaD * direction;
+  const auto fisheyeDistortions =
+      fisheyeIops.calculateDistortion(measured[0], measured[1]);
+  const Eigen::Matrix<DataType, 2, 1> perspective =
+      measured - fisheyeIops.xyc.head<2>() - fisheyeDistortions;
+  EXPECT_NEAR((perspective - fisheyeIops.xyc[2] * std::tan(thetaD) * direction)
+                  .norm(),
+              0.0, 1e-12);
+
+  // Adding the fisheye distortion inverts it
+  fisheyeIops.distortionParameters << -0.02, 3e-3, -1e-4, 1e-5;
+  const auto fisheyePoint = fisheyeIops.addDistortion(4.0, -3.0, 1e-10);
+  const auto fisheyeCheck =
+      fisheyeIops.calculateDistortion(fisheyePoint[0], fisheyePoint[1]);
+  EXPECT_NEAR(fisheyePoint[0] - fisheyeIops.xyc[0] - fisheyeCheck[0], 4.0,
+              1e-9);
+  EXPECT_NEAR(fisheyePoint[1] - fisheyeIops.xyc[1] - fisheyeCheck[1], -3.0,
+              1e-9);
+
+  // Analytic Jacobians of all models, also close to the principal point
+  const DataType brownParams[9] = {1e-3, 1e-5, 1e-7,  1e-9, 1e-3,
+                                   2e-3, 1e-5, -2e-4, 3e-4};
+  CheckDistortionJacobians<Core::BrownDistortion>(brownParams, 500.0, 30.0,
+                                                  -20.0);
+  CheckDistortionJacobians<Core::RadialDistortion>(brownParams, 500.0, 30.0,
+                                                   -20.0);
+  const DataType fisheyeParams[4] = {-0.02, 3e-3, -1e-4, 1e-5};
+  CheckDistortionJacobians<Core::EquidistantDistortion>(fisheyeParams, 8.0,
+                                                        4.0, -3.0);
+  CheckDistortionJacobians<Core::EquidistantDistortion>(fisheyeParams, 8.0,
+                                                        1e-4, 2e-4);
+}
+
+TEST(InteriorOrientation, ConvertPixelsToImageCoordinatesInBatch) {
+  auto iops = PrepareIOPs();
+  iops.xPixelSize = 0.004;
+  iops.yPixelSize = 0.005;
+  std::vector<DataType> rows;
+  std::vector<DataType> cols;
+  for (int i = 0; i < 101; ++i) {
+    rows.push_back(29.5 * i);
+    cols.push_back(4999.0 - 49.5 * i);
+  }
+  std::vector<DataType> x(rows.size());
+  std::vector<DataType> y(rows.size());
+
+  // Pixel to image coordinates
+  iops.convertPixelsToImageCoordinates(rows.size(), rows.data(), cols.data(),
+                                       x.data(), y.data(), false);
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    const auto imagePoint =
+        iops.ConvertPixelToImageCoordinates(rows[i], cols[i]);
+    EXPECT_DOUBLE_EQ(x[i], imagePoint[0]);
+    EXPECT_DOUBLE_EQ(y[i], imagePoint[1]);
+  }
+
+  // Pixel to distortion-free image coordinates (in place)
+  x = cols;
+  y = rows;
+  iops.convertPixelsToImageCoordinates(rows.size(), y.data(), x.data(),
+                                       x.data(), y.data(), true);
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    const auto imagePoint =
+        iops.ConvertPixelToImageCoordinates(rows[i], cols[i]);
+    const auto distortions =
+        iops.calculateDistortion(imagePoint[0], imagePoint[1]);
+    EXPECT_DOUBLE_EQ(x[i], imagePoint[0] - distortions[0]);
+    EXPECT_DOUBLE_EQ(y[i], imagePoint[1] - distortions[1]);
+  }
+}
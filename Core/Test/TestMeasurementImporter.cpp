@@ -0,0 +1,254 @@
+#include "ImageBlock.h"
+#include "MeasurementImporter.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#include "boost/filesystem.hpp"
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+using Importer = Core::MeasurementImporter;
+
+namespace {
+/// Temporary directory, which is removed by the destructor
+class TemporaryDirectory {
+public:
+  TemporaryDirectory()
+      : mPath(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("%%%%-%%%%-%%%%")) {
+    boost::filesystem::create_directory(mPath);
+  }
+  ~TemporaryDirectory() { boost::filesystem::remove_all(mPath); }
+
+  /// Write a file, and return its path
+  std::string write(const std::string &fileName,
+                    const std::string &contents) const {
+    const std::string filePath = (mPath / fileName).string();
+    std::ofstream(filePath) << contents;
+    return filePath;
+  }
+
+private:
+  boost::filesystem::path mPath;
+};
+
+/// Image block with a camera of 1000 x 800 pixels of 0.01 x 0.02 mm,
+/// images "image0" to "image<n - 1>" and object points "1" to "3"
+ImageBlockType CreateImageBlock(const unsigned int numberOfImages) {
+  CameraType iops;
+  iops.width = 1000;
+  iops.height = 800;
+  iops.xPixelSize = 0.01;
+  iops.yPixelSize = 0.02;
+  iops.xyc[0] = 0.0;
+  iops.xyc[1] = 0.0;
+  iops.xyc[2] = 10.0;
+  iops.distortionParameters.setZero();
+  ImageBlockType imageBlock;
+  imageBlock.addCamera("camera",
+                       std::make_shared<CameraType>(
+                           "camera", Core::ExteriorOrientation<DataType>(),
+                           iops));
+  for (unsigned int i = 0; i < numberOfImages; ++i) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId("camera");
+    imageBlock.addImage("image" + std::to_string(i), image);
+  }
+  for (int i = 1; i <= 3; ++i) {
+    imageBlock.addObjectPoint(std::to_string(i),
+                              ObjectPointType(1.0 * i, 2.0 * i, 3.0 * i));
+  }
+  return imageBlock;
+}
+} // namespace
+
+TEST(MeasurementImporter, ImportBlockFiles) {
+  const TemporaryDirectory directory;
+  const std::vector<std::string> filePaths = {
+      directory.write("first.txt", "image1 camera\n"
+                                   "  1  1.0  -2.0\n"
+                                   "  2  0.0   0.0\n"
+                                   "-99\n"
+                                   "\n"
+                                   "image0\n"
+                                   "  3  -5.0  4.0\n"
+                                   "-99\n"),
+      directory.write("second.txt", "image2\r\n"
+                                    "  1  2.5  1e-1\r\n"
+                                    "-99\r\n")};
+  ImageBlockType imageBlock = CreateImageBlock(3);
+  Importer::Options options;
+  options.sigma = 0.005;
+  const Importer::Statistics statistics =
+      Importer::ImportBlockFiles(filePaths, imageBlock, options);
+  EXPECT_EQ(statistics.numberOfFiles, 2u);
+  EXPECT_EQ(statistics.numberOfObservations, 4u);
+  EXPECT_EQ(statistics.numberOfAddedObjectPoints, 0u);
+  EXPECT_GE(statistics.seconds, 0.0);
+
+  // Sorted by image, in the order of the files otherwise
+  const auto &observations = imageBlock.getObservations();
+  ASSERT_EQ(observations.size(), 4u);
+  EXPECT_EQ(observations.imageHandles,
+            (std::vector<Core::Handle>{0, 1, 1, 2}));
+  EXPECT_EQ(observations.pointHandles,
+            (std::vector<Core::Handle>{2, 0, 1, 0}));
+  EXPECT_EQ(observations.cameraHandles,
+            (std::vector<Core::Handle>{0, 0, 0, 0}));
+  // col = x / px + w / 2 and row = h / 2 - y / py
+  const std::vector<DataType> x = {0.0, 600.0, 500.0, 750.0};
+  const std::vector<DataType> y = {200.0, 500.0, 400.0, 395.0};
+  for (std::size_t i = 0; i < observations.size(); ++i) {
+    EXPECT_NEAR(observations.x[i], x[i], 1e-9);
+    EXPECT_NEAR(observations.y[i], y[i], 1e-9);
+    // Standard deviations of 0.5 and 0.25 pixels
+    EXPECT_NEAR(observations.sqrtInformation[3 * i], 2.0, 1e-12);
+    EXPECT_EQ(observations.sqrtInformation[3 * i + 1], 0.0);
+    EXPECT_NEAR(observations.sqrtInformation[3 * i + 2], 4.0, 1e-12);
+  }
+  EXPECT_EQ(imageBlock.getTracks().getPointObservations(0).size(), 2u);
+}
+
+TEST(MeasurementImporter, ImportImageFilesInPixels) {
+  const TemporaryDirectory directory;
+  const std::vector<std::string> filePaths = {
+      directory.write("a.txt", "1 10.5 20.25\n2 30 40\n-99\n"),
+      directory.write("b.txt", "3 -1 7")};
+  ImageBlockType imageBlock = CreateImageBlock(2);
+  Importer::Options options;
+  options.coordinateSystem = Importer::CoordinateSystem::Pixels;
+  options.sigma = 0.5;
+  const Importer::Statistics statistics = Importer::ImportImageFiles(
+      filePaths, {"image1", "image0"}, imageBlock, options);
+  EXPECT_EQ(statistics.numberOfObservations, 3u);
+
+  const auto &observations = imageBlock.getObservations();
+  EXPECT_EQ(observations.imageHandles, (std::vector<Core::Handle>{0, 1, 1}));
+  EXPECT_EQ(observations.pointHandles, (std::vector<Core::Handle>{2, 0, 1}));
+  EXPECT_EQ(observations.x, (std::vector<DataType>{-1.0, 10.5, 30.0}));
+  EXPECT_EQ(observations.y, (std::vector<DataType>{7.0, 20.25, 40.0}));
+  EXPECT_EQ(observations.sqrtInformation,
+            (std::vector<DataType>{2.0, 0.0, 2.0, 2.0, 0.0, 2.0, 2.0, 0.0,
+                                   2.0}));
+}
+
+TEST(MeasurementImporter, MissingObjectPoints) {
+  const TemporaryDirectory directory;
+  const std::vector<std::string> filePaths = {directory.write(
+      "block.txt", "image0\nnew 0 0\n1 0 0\n-99\nimage1\nnew 1 1\n-99\n")};
+
+  // Missing object points throw without modifying the image block
+  ImageBlockType imageBlock = CreateImageBlock(2);
+  Importer::Options options;
+  options.addMissingObjectPoints = false;
+  EXPECT_THROW(Importer::ImportBlockFiles(filePaths, imageBlock, options),
+               std::invalid_argument);
+  EXPECT_EQ(imageBlock.getNumberOfObjectPoints(), 3u);
+  EXPECT_EQ(imageBlock.getObservations().size(), 0u);
+
+  // or are added once (at the origin)
+  const Importer::Statistics statistics =
+      Importer::ImportBlockFiles(filePaths, imageBlock);
+  EXPECT_EQ(statistics.numberOfAddedObjectPoints, 1u);
+  ASSERT_EQ(imageBlock.getNumberOfObjectPoints(), 4u);
+  const Core::Handle handle = imageBlock.getObjectPointHandle("new");
+  EXPECT_EQ(handle, 3u);
+  EXPECT_EQ(imageBlock.getObjectPoint(handle)[0], 0.0);
+  EXPECT_EQ(imageBlock.getObservations().pointHandles,
+            (std::vector<Core::Handle>{3, 0, 3}));
+}
+
+TEST(MeasurementImporter, InvalidFiles) {
+  const TemporaryDirectory directory;
+  ImageBlockType imageBlock = CreateImageBlock(1);
+  EXPECT_THROW(Importer::ImportBlockFiles(
+                   {directory.write("a.txt", "unknown\n1 0 0\n-99\n")},
+                   imageBlock),
+               std::invalid_argument);
+  EXPECT_THROW(Importer::ImportBlockFiles(
+                   {directory.write("b.txt", "image0\n1 0 0.5x\n-99\n")},
+                   imageBlock),
+               std::runtime_error);
+  EXPECT_THROW(Importer::ImportBlockFiles(
+                   {directory.write("c.txt", "image0\n1 0\n-99\n")},
+                   imageBlock),
+               std::runtime_error);
+  EXPECT_THROW(Importer::ImportBlockFiles(
+                   {(boost::filesystem::temp_directory_path() / "missing.txt")
+                        .string()},
+                   imageBlock),
+               std::runtime_error);
+  EXPECT_THROW(Importer::ImportImageFiles({directory.write("d.txt", "")},
+                                          {"image0", "image1"}, imageBlock),
+               std::invalid_argument);
+  EXPECT_EQ(imageBlock.getObservations().size(), 0u);
+}
+
+TEST(MeasurementImporter, AppendsToObservations) {
+  const TemporaryDirectory directory;
+  ImageBlockType imageBlock = CreateImageBlock(2);
+  Core::ObservationTable<DataType> observations;
+  observations.addObservation(1, 0, 0, 1.0, 2.0);
+  imageBlock.setObservations(std::move(observations));
+  Importer::Options options;
+  options.coordinateSystem = Importer::CoordinateSystem::Pixels;
+  Importer::ImportImageFiles({directory.write("a.txt", "2 3 4\n")},
+                             {"image0"}, imageBlock, options);
+  const auto &result = imageBlock.getObservations();
+  EXPECT_EQ(result.imageHandles, (std::vector<Core::Handle>{0, 1}));
+  EXPECT_EQ(result.x, (std::vector<DataType>{3.0, 1.0}));
+  EXPECT_EQ(imageBlock.getTracks().getImageObservations(1).size(), 1u);
+}
+
+TEST(MeasurementImporter, LargeFileIsIndependentOfThreads) {
+  // More than 1 MB, i.e., several pieces
+  const unsigned int numberOfImages = 50;
+  std::string contents;
+  for (unsigned int i = 0; i < numberOfImages; ++i) {
+    contents += "image" + std::to_string(i) + "\n";
+    for (unsigned int j = 0; j < 2000; ++j) {
+      contents += "p" + std::to_string(j) + " " + std::to_string(0.001 * j) +
+                  " " + std::to_string(-0.002 * i) + "\n";
+    }
+    contents += "-99\n";
+  }
+  ASSERT_GT(contents.size(), 2u << 20);
+  const TemporaryDirectory directory;
+  const std::vector<std::string> filePaths = {
+      directory.write("block.txt", contents)};
+
+  ImageBlockType serialBlock = CreateImageBlock(numberOfImages);
+  Importer::Options options;
+  options.numberOfThreads = 1;
+  Importer::ImportBlockFiles(filePaths, serialBlock, options);
+  ImageBlockType parallelBlock = CreateImageBlock(numberOfImages);
+  options.numberOfThreads = 8;
+  const Importer::Statistics statistics =
+      Importer::ImportBlockFiles(filePaths, parallelBlock, options);
+  EXPECT_EQ(statistics.numberOfObservations, numberOfImages * 2000u);
+  EXPECT_EQ(statistics.numberOfAddedObjectPoints, 2000u);
+
+  const auto &serial = serialBlock.getObservations();
+  const auto &parallel = parallelBlock.getObservations();
+  EXPECT_EQ(parallel.imageHandles, serial.imageHandles);
+  EXPECT_EQ(parallel.pointHandles, serial.pointHandles);
+  EXPECT_EQ(parallel.x, serial.x);
+  EXPECT_EQ(parallel.y, serial.y);
+  for (unsigned int i = 0; i < 2000; ++i) {
+    EXPECT_EQ(parallelBlock.getObjectPointHandle("p" + std::to_string(i)),
+              3u + i);
+  }
+  EXPECT_EQ(parallel.imageHandles[2000 * 7], 7u);
+  EXPECT_EQ(parallel.pointHandles[2000 * 7 + 5], 8u);
+}
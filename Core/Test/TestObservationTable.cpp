@@ -0,0 +1,110 @@
+#include "ImageBlock.h"
+#include "ObservationTable.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+
+/**
+ * Prepare an image block with the given number of images and object points.
+ * Every object point is observed in every image at (pointIndex, imageIndex).
+ */
+void PrepareImageBlock(ImageBlockType &imageBlock,
+                       const unsigned int numberOfImages,
+                       const unsigned int numberOfPoints) {
+  imageBlock.addCamera("camera", std::make_shared<CameraType>());
+  for (unsigned int imageIndex = 0; imageIndex < numberOfImages; ++imageIndex) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId("camera");
+    for (unsigned int pointIndex = 0; pointIndex < numberOfPoints;
+         ++pointIndex) {
+      Eigen::Matrix2d covariance;
+      covariance << 4.0, 0.0, 0.0, 0.25;
+      image->addPoint(std::to_string(pointIndex),
+                      Core::ImagePoint(pointIndex, imageIndex, covariance));
+    }
+    imageBlock.addImage("image" + std::to_string(imageIndex), image);
+  }
+  for (unsigned int pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex) {
+    ObjectPointType point(0.0, 0.0, 0.0);
+    for (unsigned int imageIndex = 0; imageIndex < numberOfImages;
+         ++imageIndex) {
+      point.mTiePointIds["image" + std::to_string(imageIndex)] =
+          std::to_string(pointIndex);
+    }
+    imageBlock.addObjectPoint(std::to_string(pointIndex), point);
+  }
+}
+
+TEST(ObservationTable, BuildFromImageBlock) {
+  ImageBlockType imageBlock;
+  PrepareImageBlock(imageBlock, 3, 5);
+  auto table = Core::ObservationTable<DataType>::Build(imageBlock);
+
+  ASSERT_EQ(table.size(), 15);
+  EXPECT_TRUE(table.getSortOrder() ==
+              Core::ObservationTable<DataType>::SortOrder::ByPoint);
+  for (std::size_t i = 0; i < table.size(); ++i) {
+    // Sorted by point, then by image
+    EXPECT_EQ(table.pointHandles[i], i / 3);
+    EXPECT_EQ(table.imageHandles[i], i % 3);
+    EXPECT_EQ(table.cameraHandles[i], 0);
+    EXPECT_EQ(table.x[i], static_cast<double>(table.pointHandles[i]));
+    EXPECT_EQ(table.y[i], static_cast<double>(table.imageHandles[i]));
+    // Square root of the information matrix: diag(1 / 2, 1 / 0.5)
+    auto sqrtInformation = table.getSquareRootInformation(i);
+    EXPECT_DOUBLE_EQ(sqrtInformation(0, 0), 0.5);
+    EXPECT_DOUBLE_EQ(sqrtInformation(0, 1), 0.0);
+    EXPECT_DOUBLE_EQ(sqrtInformation(1, 1), 2.0);
+  }
+
+  // Sort by image
+  table.sortByImage();
+  for (std::size_t i = 0; i < table.size(); ++i) {
+    EXPECT_EQ(table.imageHandles[i], i / 5);
+    EXPECT_EQ(table.pointHandles[i], i % 5);
+    EXPECT_EQ(table.x[i], static_cast<double>(table.pointHandles[i]));
+  }
+}
+
+TEST(ObservationTable, ParallelBuildMatchesSerialBuild) {
+  ImageBlockType imageBlock;
+  PrepareImageBlock(imageBlock, 4, 3000);
+  auto serialTable = Core::ObservationTable<DataType>::Build(imageBlock, 1);
+  auto parallelTable = Core::ObservationTable<DataType>::Build(imageBlock, 4);
+  ASSERT_EQ(serialTable.size(), parallelTable.size());
+  EXPECT_EQ(serialTable.imageHandles, parallelTable.imageHandles);
+  EXPECT_EQ(serialTable.pointHandles, parallelTable.pointHandles);
+  EXPECT_EQ(serialTable.x, parallelTable.x);
+  EXPECT_EQ(serialTable.y, parallelTable.y);
+}
+
+TEST(ObservationTable, PackSquareRootInformation) {
+  Eigen::Matrix2d covariance;
+  covariance << 0.25, 0.05, 0.05, 0.16;
+  double packed[3];
+  Core::ObservationTable<DataType>::PackSquareRootInformation(covariance,
+                                                              packed);
+  Eigen::Matrix2d sqrtInformation;
+  sqrtInformation << packed[0], packed[1], 0.0, packed[2];
+  Eigen::Matrix2d information = sqrtInformation.transpose() * sqrtInformation;
+  EXPECT_TRUE((information - covariance.inverse()).cwiseAbs().maxCoeff() <
+              1e-12);
+
+  // Unknown image in the tie points
+  ImageBlockType imageBlock;
+  PrepareImageBlock(imageBlock, 1, 1);
+  imageBlock.getObjectPoint("0").mTiePointIds["image9"] = "0";
+  ASSERT_THROW(Core::ObservationTable<DataType>::Build(imageBlock),
+               std::invalid_argument);
+}
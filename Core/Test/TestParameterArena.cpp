@@ -0,0 +1,80 @@
+#include "ImageBlock.h"
+#include "ParameterArena.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST(ParameterArena, SectionsAndViews) {
+  Core::ParameterArena<double> arena;
+  EXPECT_EQ(arena.addSection(2, 12), 0);
+  EXPECT_EQ(arena.addSection(5, 3), 1);
+  // Blocks cannot be accessed before the arena is frozen
+  ASSERT_THROW(arena.getBlock(0, 0), std::logic_error);
+
+  arena.freeze();
+  EXPECT_TRUE(arena.isFrozen());
+  EXPECT_EQ(arena.size(), 2 * 12 + 5 * 3);
+  ASSERT_THROW(arena.addSection(1, 6), std::logic_error);
+
+  // Blocks are laid out contiguously, section by section
+  EXPECT_EQ(arena.getBlock(0, 1), arena.data() + 12);
+  EXPECT_EQ(arena.getBlock(1, 0), arena.data() + 24);
+  EXPECT_EQ(arena.getBlock(1, 4), arena.data() + 36);
+  ASSERT_THROW(arena.getBlock(1, 5), std::out_of_range);
+  ASSERT_THROW(arena.getBlock(2, 0), std::out_of_range);
+
+  // Views write straight into the arena
+  auto view = arena.getView(1, 2);
+  EXPECT_EQ(view.size(), 3);
+  view << 1.0, 2.0, 3.0;
+  EXPECT_EQ(arena.data()[30], 1.0);
+  EXPECT_EQ(arena.data()[32], 3.0);
+
+  arena.clear();
+  EXPECT_FALSE(arena.isFrozen());
+  EXPECT_EQ(arena.getNumberOfSections(), 0);
+}
+
+TEST(ParameterArena, ImageBlockRoundTrip) {
+  using CameraType = Core::FrameCamera<double, 9>;
+  using ImageType = Core::Image<Core::ImagePoint, double>;
+  Core::ImageBlock<CameraType, ImageType, Core::ObjectPoint, double>
+      imageBlock;
+  auto camera = std::make_shared<CameraType>();
+  camera->xyc = Core::Point<double, 3>(Eigen::Vector3d(0.1, -0.2, 50.0));
+  camera->distortionParameters =
+      Core::Point<double, 9>(Eigen::Matrix<double, 9, 1>::Constant(1e-5));
+  camera->getMountingParameters().setTranslation(0.1, 0.2, 0.3);
+  imageBlock.addCamera("camera", camera);
+  auto image = std::make_shared<ImageType>();
+  image->setTranslation(100.0, 200.0, 500.0);
+  image->setRotation(90.0, 0.0, 180.0);
+  imageBlock.addImage("image", image);
+  imageBlock.addObjectPoint("point", Core::ObjectPoint(1.0, 2.0, 3.0));
+
+  imageBlock.buildParameterArena();
+  auto &arena = imageBlock.getParameterArena();
+  EXPECT_EQ(arena.size(), 12 + 6 + 6 + 3);
+  auto cameraView = arena.getView(decltype(imageBlock)::CameraSection, 0);
+  EXPECT_EQ(cameraView[2], 50.0);
+  EXPECT_EQ(cameraView[11], 1e-5);
+  // EOPs are stored with rotation angles in radians
+  auto imageView = arena.getView(decltype(imageBlock)::BodyFrameSection, 0);
+  EXPECT_EQ(imageView[2], 500.0);
+  EXPECT_NEAR(imageView[3], M_PI / 2.0, 1e-15);
+  EXPECT_NEAR(imageView[5], M_PI, 1e-15);
+  EXPECT_EQ(arena.getView(decltype(imageBlock)::MountingSection, 0)[1], 0.2);
+
+  // Modify the arena, and copy it back
+  cameraView[2] = 55.0;
+  imageView[5] = M_PI / 4.0;
+  arena.getView(decltype(imageBlock)::ObjectPointSection, 0)[2] = 4.0;
+  imageBlock.updateFromParameterArena();
+  EXPECT_EQ(camera->xyc[2], 55.0);
+  EXPECT_NEAR(image->getRotationInDegrees()[2], 45.0, 1e-12);
+  EXPECT_EQ(imageBlock.getObjectPoint("point")[2], 4.0);
+}
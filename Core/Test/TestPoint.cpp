@@ -1,3 +1,6 @@
+#include <thread>
+#include <vector>
+
 #include "Point.h"
 #include "gtest/gtest.h"
 
@@ -32,3 +35,104 @@ TEST(Point, PointInitialization) {
   EXPECT_EQ(objPt.covariance(2, 1), 0.2);
   EXPECT_EQ(objPt.covariance(2, 2), 0.3);
 }
+
+TEST(Point, CompactCovariancePolicies) {
+  Eigen::Matrix2d variance;
+  variance << 0.25, 0.05, 0.05, 0.16;
+
+  // No covariance: identity is returned, and only the coordinates are stored
+  Core::BasicImagePoint<Core::NoCovariance<double, 2>> noCovPt(1.0, 2.0,
+                                                               variance);
+  EXPECT_EQ(sizeof(noCovPt), 2 * sizeof(double));
+  EXPECT_TRUE(noCovPt.getCovariance().isIdentity());
+
+  // Isotropic covariance keeps the mean variance
+  Core::IsotropicImagePoint isoPt(1.0, 2.0, variance);
+  EXPECT_EQ(sizeof(isoPt), 3 * sizeof(double));
+  EXPECT_DOUBLE_EQ(isoPt.getCovariance()(0, 0), 0.205);
+  EXPECT_DOUBLE_EQ(isoPt.getCovariance()(1, 1), 0.205);
+  EXPECT_EQ(isoPt.getCovariance()(0, 1), 0.0);
+
+  // Diagonal covariance drops the correlations
+  Core::BasicImagePoint<Core::DiagonalCovariance<double, 2>> diagPt(1.0, 2.0,
+                                                                    variance);
+  EXPECT_EQ(sizeof(diagPt), 4 * sizeof(double));
+  EXPECT_EQ(diagPt.getCovariance()(0, 0), 0.25);
+  EXPECT_EQ(diagPt.getCovariance()(1, 1), 0.16);
+  EXPECT_EQ(diagPt.getCovariance()(1, 0), 0.0);
+
+  // Packed covariance is lossless for symmetric matrices
+  Eigen::Matrix3d objVariance;
+  objVariance << 0.4, 0.1, 0.2, 0.1, 0.5, 0.3, 0.2, 0.3, 0.6;
+  Core::BasicObjectPoint<Core::PackedCovariance<double, 3>> packedPt(
+      1.0, 2.0, 3.0, objVariance);
+  EXPECT_EQ(sizeof(packedPt) - sizeof(packedPt.mTiePointIds),
+            9 * sizeof(double));
+  EXPECT_EQ(packedPt.getCovariance(), objVariance);
+  EXPECT_EQ(packedPt[2], 3.0);
+}
+
+TEST(Point, PooledCovariance) {
+  auto &pool = Core::CovariancePool<double, 2>::GetInstance();
+  Eigen::Matrix2d variance;
+  variance << 0.25, 0.05, 0.05, 0.16;
+
+  // Identity matrices share the default entry of the pool
+  Core::PooledImagePoint pt1(1.0, 2.0);
+  EXPECT_EQ(pt1.getCovarianceIndex(), 0u);
+  EXPECT_EQ(pool.get(0), Eigen::Matrix2d::Identity());
+
+  // Equal matrices are added to the pool only once
+  const auto size = pool.size();
+  Core::PooledImagePoint pt2(3.0, 4.0, variance);
+  EXPECT_EQ(pool.size(), size + 1);
+  EXPECT_EQ(pt2.getCovariance(), variance);
+  Core::PooledImagePoint pt3(5.0, 6.0, variance);
+  EXPECT_EQ(pt3.getCovarianceIndex(), pt2.getCovarianceIndex());
+  EXPECT_EQ(pool.add(variance), pt2.getCovarianceIndex());
+  EXPECT_EQ(pool.size(), size + 1);
+
+  // Share an existing matrix without growing the pool
+  pt1.setCovarianceIndex(pt2.getCovarianceIndex());
+  EXPECT_EQ(pt1.getCovariance(), variance);
+  EXPECT_EQ(pool.size(), size + 1);
+  EXPECT_LE(sizeof(pt1), 3 * sizeof(double));
+  EXPECT_THROW(pool.get(pool.size()), std::out_of_range);
+}
+
+TEST(Point, PooledCovarianceFromThreads) {
+  auto &pool = Core::CovariancePool<double, 3>::GetInstance();
+  const auto size = pool.size();
+
+  // Every thread adds the same matrices, which have to get the same indices,
+  // and reads them back while the other threads keep adding
+  const int numberOfThreads = 4;
+  const int numberOfMatrices = 100;
+  std::vector<std::vector<std::uint32_t>> indices(numberOfThreads);
+  std::vector<int> mismatches(numberOfThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numberOfThreads; ++t) {
+    threads.emplace_back([&indices, &mismatches, &pool, t]() {
+      for (int i = 0; i < numberOfMatrices; ++i) {
+        const Eigen::Matrix3d var =
+            static_cast<double>(i + 2) * Eigen::Matrix3d::Identity();
+        indices[t].push_back(pool.add(var));
+        for (const auto index : indices[t]) {
+          mismatches[t] += (pool.get(index)(0, 0) < 2.0);
+        }
+        mismatches[t] += (pool.get(indices[t].back()) != var);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(pool.size(), size + numberOfMatrices);
+  for (int t = 1; t < numberOfThreads; ++t) {
+    EXPECT_EQ(indices[t], indices[0]);
+  }
+  for (int t = 0; t < numberOfThreads; ++t) {
+    EXPECT_EQ(mismatches[t], 0);
+  }
+  EXPECT_EQ(pool.get(indices[0][3]), 5.0 * Eigen::Matrix3d::Identity());
+}
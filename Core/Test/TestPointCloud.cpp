@@ -43,3 +43,19 @@ TEST(PointCloud, BasicPointCloudOperation) {
   // pointId3 cannot be found in pointCloud
   EXPECT_TRUE(!pointCloud.deletePoint(pointId3));
 }
+
+TEST(PointCloud, LookupByHandle) {
+  using PointType = Core::PointXYZd;
+  Core::PointCloud<PointType> pointCloud;
+  pointCloud.addPoint("a", PointType(1.0, 0.0, 0.0));
+  pointCloud.addPoint("b", PointType(2.0, 0.0, 0.0));
+  pointCloud.addPoint("c", PointType(3.0, 0.0, 0.0));
+  EXPECT_EQ(pointCloud.getPointHandle("b"), 1);
+  EXPECT_EQ(pointCloud.getPoint(1)[0], 2.0);
+
+  // Deleting a point moves the last point to its handle
+  EXPECT_TRUE(pointCloud.deletePoint("a"));
+  EXPECT_EQ(pointCloud.getPointHandle("c"), 0);
+  EXPECT_EQ(pointCloud.getPoint(0)[0], 3.0);
+  EXPECT_EQ(pointCloud.getPointId(0), "c");
+}
@@ -0,0 +1,279 @@
+#include "ImageBlock.h"
+#include "ProjectFile.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "boost/filesystem.hpp"
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+
+namespace {
+/// Temporary file path, which is removed by the destructor
+class TemporaryFile {
+public:
+  TemporaryFile()
+      : mPath(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("%%%%-%%%%-%%%%.baproj")) {}
+  ~TemporaryFile() { boost::filesystem::remove(mPath); }
+
+  std::string getPath() const { return mPath.string(); }
+
+private:
+  boost::filesystem::path mPath;
+};
+
+/// Modify the entry and the data of the first section of the given type in
+/// the project file
+template <typename TModifier>
+void ModifySection(const std::string &filePath,
+                   const Core::ProjectFile::SectionType type,
+                   const TModifier &modifier) {
+  std::vector<char> bytes;
+  {
+    std::ifstream stream(filePath, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(stream),
+                 std::istreambuf_iterator<char>());
+  }
+  const auto *header =
+      reinterpret_cast<const Core::ProjectFile::FileHeader *>(bytes.data());
+  auto *sections = reinterpret_cast<Core::ProjectFile::SectionEntry *>(
+      bytes.data() + sizeof(Core::ProjectFile::FileHeader));
+  for (std::uint32_t i = 0; i < header->numberOfSections; ++i) {
+    if (sections[i].type == static_cast<std::uint32_t>(type)) {
+      modifier(sections[i], bytes.data() + sections[i].offset);
+      break;
+    }
+  }
+  std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+  stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/// Image block of a two-camera rig with 3 images and 4 object points
+void CreateImageBlock(ImageBlockType &imageBlock) {
+  CameraType iops;
+  iops.width = 6000;
+  iops.height = 4000;
+  iops.xPixelSize = 0.004;
+  iops.yPixelSize = 0.0041;
+  iops.xyc[0] = 0.1;
+  iops.xyc[1] = -0.2;
+  iops.xyc[2] = 50.0;
+  iops.distortionParameters[1] = 1e-5;
+  iops.distortionParameters[8] = 2e-4;
+  Core::ExteriorOrientation<DataType> mounting;
+  mounting.setTranslation(0.1, 0.2, -0.3);
+  mounting.setRotation(1.0, 2.0, 3.0);
+  imageBlock.addCamera("reference", std::make_shared<CameraType>(
+                                        "reference", mounting, iops));
+  mounting.setRotation(0.0, 30.0, 0.0);
+  imageBlock.addCamera("oblique", std::make_shared<CameraType>(
+                                      "reference", mounting, iops));
+  for (unsigned int i = 0; i < 3; ++i) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId(i == 1 ? "oblique" : "reference");
+    image->setTranslation(100.0 * i, 5.0, 1000.0);
+    image->setRotation(0.5, -0.5, 10.0 * i);
+    if (i != 2) {
+      image->setImageFilePath("/data/images/" + std::to_string(i) + ".tif");
+    }
+    imageBlock.addImage("image" + std::to_string(i), image);
+  }
+  for (unsigned int i = 0; i < 4; ++i) {
+    imageBlock.addObjectPoint("point" + std::to_string(i),
+                              ObjectPointType(1.0 * i, 2.0 * i, 3.0 * i));
+  }
+  Core::ObservationTable<DataType> observations;
+  for (unsigned int point = 0; point < 4; ++point) {
+    for (unsigned int image = 0; image < 3; ++image) {
+      observations.addObservation(
+          image, point, image == 1 ? 1 : 0, 10.0 * point + image,
+          20.0 * point - image,
+          Eigen::Matrix2d::Identity() * (1.0 + image));
+    }
+  }
+  observations.sortByImage();
+  imageBlock.setObservations(std::move(observations));
+}
+} // namespace
+
+TEST(ProjectFile, WriteAndMap) {
+  ImageBlockType imageBlock;
+  CreateImageBlock(imageBlock);
+  const TemporaryFile file;
+  Core::ProjectFile::Write(file.getPath(), imageBlock);
+
+  const Core::ProjectFile project(file.getPath());
+  EXPECT_EQ(project.getVersion(), Core::ProjectFile::Version);
+  ASSERT_EQ(project.getNumberOfCameras(), 2);
+  ASSERT_EQ(project.getNumberOfImages(), 3);
+  ASSERT_EQ(project.getNumberOfObjectPoints(), 4);
+  ASSERT_EQ(project.getNumberOfObservations(), 12);
+
+  // Cameras
+  const auto *cameras = project.getCameraRecords();
+  EXPECT_EQ(cameras[1].referenceCameraHandle, 0);
+  EXPECT_EQ(cameras[1].numberOfParameters, 12);
+  EXPECT_EQ(cameras[1].height, 4000);
+  EXPECT_DOUBLE_EQ(cameras[1].yPixelSize, 0.0041);
+  EXPECT_DOUBLE_EQ(cameras[1].mountingParameters[4], M_PI / 6.0);
+  EXPECT_DOUBLE_EQ(project.getCameraParameters(1)[2], 50.0);
+  EXPECT_DOUBLE_EQ(project.getCameraParameters(1)[11], 2e-4);
+  EXPECT_EQ(project.getCameraIds()[1], "oblique");
+  EXPECT_THROW(project.getCameraParameters(2), std::out_of_range);
+
+  // Images
+  const auto *images = project.getImageRecords();
+  EXPECT_EQ(images[1].cameraHandle, 1);
+  EXPECT_DOUBLE_EQ(images[2].eops[0], 200.0);
+  EXPECT_DOUBLE_EQ(images[2].eops[5], 20.0 * M_PI / 180.0);
+  EXPECT_EQ(project.getImageIds()[2], "image2");
+  EXPECT_EQ(project.getImageFilePaths()[1], "/data/images/1.tif");
+  EXPECT_EQ(project.getImageFilePaths().length(2), 0);
+
+  // Object points and observations in place
+  EXPECT_DOUBLE_EQ(project.getObjectPoints()[3 * 3 + 2], 9.0);
+  EXPECT_EQ(project.getObjectPointIds()[3], "point3");
+  const auto observations = project.getObservations();
+  const auto &expected = imageBlock.getObservations();
+  for (std::size_t i = 0; i < observations.size; ++i) {
+    EXPECT_EQ(observations.imageHandles[i], expected.imageHandles[i]);
+    EXPECT_EQ(observations.pointHandles[i], expected.pointHandles[i]);
+    EXPECT_EQ(observations.cameraHandles[i], expected.cameraHandles[i]);
+    EXPECT_EQ(observations.x[i], expected.x[i]);
+    EXPECT_EQ(observations.y[i], expected.y[i]);
+    EXPECT_EQ(observations.sqrtInformation[3 * i + 2],
+              expected.sqrtInformation[3 * i + 2]);
+  }
+  EXPECT_EQ(project.getObservationSortOrder(),
+            static_cast<std::uint32_t>(
+                Core::ObservationTable<DataType>::SortOrder::ByImage));
+}
+
+TEST(ProjectFile, LoadImageBlock) {
+  ImageBlockType imageBlock;
+  CreateImageBlock(imageBlock);
+  const TemporaryFile file;
+  Core::ProjectFile::Write(file.getPath(), imageBlock);
+  const Core::ProjectFile project(file.getPath());
+
+  ImageBlockType loadedBlock;
+  project.load(loadedBlock);
+  EXPECT_THROW(project.load(loadedBlock), std::invalid_argument);
+
+  // Cameras
+  ASSERT_EQ(loadedBlock.getNumberOfCameras(), 2);
+  const auto camera = loadedBlock.getCamera("oblique");
+  EXPECT_EQ(camera->getReferenceCameraId(), "reference");
+  EXPECT_EQ(camera->width, 6000);
+  EXPECT_DOUBLE_EQ(camera->xPixelSize, 0.004);
+  EXPECT_DOUBLE_EQ(camera->xyc[1], -0.2);
+  EXPECT_DOUBLE_EQ(camera->distortionParameters[8], 2e-4);
+  EXPECT_NEAR(camera->getMountingParameters().getRotationInDegrees()[1], 30.0,
+              1e-12);
+  EXPECT_DOUBLE_EQ(camera->getMountingParameters().getTranslation()[2], -0.3);
+
+  // Images
+  ASSERT_EQ(loadedBlock.getNumberOfImages(), 3);
+  for (Core::Handle handle = 0; handle < 3; ++handle) {
+    const auto &image = *loadedBlock.getImage(handle);
+    const auto &expected = *imageBlock.getImage(handle);
+    EXPECT_EQ(loadedBlock.getImageId(handle), imageBlock.getImageId(handle));
+    EXPECT_EQ(image.cameraId(), expected.cameraId());
+    EXPECT_TRUE(image.getTranslation().isApprox(expected.getTranslation()));
+    EXPECT_TRUE(image.getRotationInDegrees().isApprox(
+        expected.getRotationInDegrees(), 1e-12));
+    EXPECT_EQ(static_cast<bool>(image.getImageFilePath()), handle != 2);
+  }
+  EXPECT_EQ(loadedBlock.getImage("image0")->getImageFilePath()->string(),
+            "/data/images/0.tif");
+
+  // Object points and observations
+  ASSERT_EQ(loadedBlock.getNumberOfObjectPoints(), 4);
+  EXPECT_DOUBLE_EQ(loadedBlock.getObjectPoint("point2")[1], 4.0);
+  const auto &observations = loadedBlock.getObservations();
+  const auto &expected = imageBlock.getObservations();
+  EXPECT_EQ(observations.getSortOrder(),
+            Core::ObservationTable<DataType>::SortOrder::ByImage);
+  EXPECT_EQ(observations.imageHandles, expected.imageHandles);
+  EXPECT_EQ(observations.pointHandles, expected.pointHandles);
+  EXPECT_EQ(observations.cameraHandles, expected.cameraHandles);
+  EXPECT_EQ(observations.x, expected.x);
+  EXPECT_EQ(observations.y, expected.y);
+  EXPECT_EQ(observations.sqrtInformation, expected.sqrtInformation);
+  EXPECT_EQ(loadedBlock.getTracks().getTrackLength(3), 3);
+}
+
+TEST(ProjectFile, EmptyImageBlock) {
+  const ImageBlockType imageBlock;
+  const TemporaryFile file;
+  Core::ProjectFile::Write(file.getPath(), imageBlock);
+  const Core::ProjectFile project(file.getPath());
+  EXPECT_EQ(project.getNumberOfCameras(), 0);
+  EXPECT_EQ(project.getNumberOfObservations(), 0);
+  EXPECT_EQ(project.getObjectPoints(), nullptr);
+  ImageBlockType loadedBlock;
+  project.load(loadedBlock);
+  EXPECT_EQ(loadedBlock.getNumberOfImages(), 0);
+}
+
+TEST(ProjectFile, InvalidFiles) {
+  const TemporaryFile file;
+  EXPECT_THROW(Core::ProjectFile(file.getPath()), std::runtime_error);
+  {
+    std::ofstream stream(file.getPath(), std::ios::binary);
+    stream << "This is not a project file";
+  }
+  EXPECT_THROW(Core::ProjectFile(file.getPath()), std::runtime_error);
+
+  // Truncated sections
+  ImageBlockType imageBlock;
+  CreateImageBlock(imageBlock);
+  Core::ProjectFile::Write(file.getPath(), imageBlock);
+  boost::filesystem::resize_file(
+      file.getPath(), boost::filesystem::file_size(file.getPath()) - 8);
+  EXPECT_THROW(Core::ProjectFile(file.getPath()), std::runtime_error);
+}
+
+TEST(ProjectFile, CorruptSections) {
+  const TemporaryFile file;
+  ImageBlockType imageBlock;
+  CreateImageBlock(imageBlock);
+  using SectionEntry = Core::ProjectFile::SectionEntry;
+  using SectionType = Core::ProjectFile::SectionType;
+
+  // Non-monotonic offsets in the middle of a string table
+  Core::ProjectFile::Write(file.getPath(), imageBlock);
+  ModifySection(file.getPath(), SectionType::ImageIds,
+                [](SectionEntry &, char *data) {
+                  reinterpret_cast<std::uint64_t *>(data)[1] = 1u << 30;
+                });
+  EXPECT_THROW(Core::ProjectFile(file.getPath()), std::runtime_error);
+
+  // Number of elements, whose size overflows to the size of the section
+  Core::ProjectFile::Write(file.getPath(), imageBlock);
+  ModifySection(file.getPath(), SectionType::ObservationX,
+                [](SectionEntry &section, char *) {
+                  section.count += std::uint64_t(1) << 61;
+                });
+  EXPECT_THROW(Core::ProjectFile(file.getPath()), std::runtime_error);
+
+  // Number of strings, whose offsets overflow
+  Core::ProjectFile::Write(file.getPath(), imageBlock);
+  ModifySection(file.getPath(), SectionType::ObjectPointIds,
+                [](SectionEntry &section, char *) {
+                  section.count = ~std::uint64_t(0);
+                });
+  EXPECT_THROW(Core::ProjectFile(file.getPath()), std::runtime_error);
+}
@@ -1,4 +1,10 @@
 #include "RandomNumber.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 int main(int argc, char **argv) {
@@ -20,3 +26,65 @@ TEST(RandomNumber, GenerateRandomNumber) {
     EXPECT_TRUE(randomNumber1 != randomNumber2);
   }
 }
+
+TEST(RandomNumber, Types) {
+  static_assert(
+      std::is_same<Core::RandomFloatGenerator::DataType, float>::value,
+      "RandomFloatGenerator returns float");
+  static_assert(
+      std::is_same<Core::RandomDoubleGenerator::DataType, double>::value,
+      "RandomDoubleGenerator returns double");
+}
+
+TEST(RandomNumber, SeedsAndStreams) {
+  // The same seed and stream give the same numbers, and different seeds or
+  // streams give different ones
+  Core::RandomDoubleGenerator generator(0.0, 1.0, 42);
+  Core::RandomDoubleGenerator sameGenerator(0.0, 1.0, 42, 0);
+  Core::RandomDoubleGenerator otherSeed(0.0, 1.0, 43);
+  Core::RandomDoubleGenerator otherStream(0.0, 1.0, 42, 1);
+  for (unsigned int i = 0; i < 10; ++i) {
+    const double number = generator.getRandomNumber();
+    EXPECT_GE(number, 0.0);
+    EXPECT_LT(number, 1.0);
+    EXPECT_EQ(number, sameGenerator.getRandomNumber());
+    EXPECT_NE(number, otherSeed.getRandomNumber());
+    EXPECT_NE(number, otherStream.getRandomNumber());
+  }
+
+  // Batches continue the stream
+  Core::RandomIntegerGenerator integers(-5, 5, 7);
+  Core::RandomIntegerGenerator sameIntegers(-5, 5, 7);
+  std::vector<int> values(100);
+  integers.fill(values.data(), 50);
+  integers.fill(values.data() + 50, 50);
+  for (const int value : values) {
+    EXPECT_EQ(value, sameIntegers.getRandomNumber());
+  }
+}
+
+TEST(RandomNumber, ParallelFill) {
+  using Generator = Core::RandomNormalGenerator;
+  const std::size_t size = 5 * Generator::FillBlockSize / 2;
+  std::vector<double> serial(size), parallel(size);
+  Generator::ParallelFill(serial.data(), size, 1.0, 2.0, 42, 1);
+  Generator::ParallelFill(parallel.data(), size, 1.0, 2.0, 42, 4);
+  EXPECT_EQ(serial, parallel);
+
+  // The blocks are the streams of the seed
+  Generator generator(1.0, 2.0, 42, 2);
+  std::vector<double> block(size - 2 * Generator::FillBlockSize);
+  generator.fill(block.data(), block.size());
+  EXPECT_TRUE(std::equal(block.begin(), block.end(),
+                         serial.begin() + 2 * Generator::FillBlockSize));
+
+  // Mean and standard deviation of the normal distribution
+  double sum = 0.0, squaredSum = 0.0;
+  for (const double value : serial) {
+    sum += value;
+    squaredSum += value * value;
+  }
+  const double mean = sum / size;
+  EXPECT_NEAR(mean, 1.0, 0.02);
+  EXPECT_NEAR(std::sqrt(squaredSum / size - mean * mean), 2.0, 0.02);
+}
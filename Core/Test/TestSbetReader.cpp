@@ -0,0 +1,156 @@
+#include "SbetReader.h"
+
+#include <cmath>
+#include <fstream>
+
+#include "boost/filesystem.hpp"
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using Record = Core::SbetReader::Record;
+
+namespace {
+/// Origin of the flight (in radians and meters)
+constexpr double Latitude = 0.9;
+constexpr double Longitude = -1.98;
+constexpr double Altitude = 1200.0;
+
+/// Write a 200 Hz SBET file of the given number of records to a temporary
+/// path, which is removed by the destructor
+class SbetFile {
+public:
+  explicit SbetFile(const std::size_t size)
+      : mPath(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("%%%%-%%%%-%%%%.sbet")) {
+    std::ofstream file(mPath.string(), std::ios::binary);
+    for (std::size_t i = 0; i < size; ++i) {
+      Record record = {};
+      record.time = 4e5 + 0.005 * static_cast<double>(i);
+      record.latitude = Latitude + 1e-7 * static_cast<double>(i);
+      record.longitude = Longitude;
+      record.altitude = Altitude;
+      record.heading = 0.001 * static_cast<double>(i);
+      file.write(reinterpret_cast<const char *>(&record), sizeof(Record));
+    }
+  }
+  ~SbetFile() { boost::filesystem::remove(mPath); }
+
+  std::string getPath() const { return mPath.string(); }
+
+private:
+  boost::filesystem::path mPath;
+};
+} // namespace
+
+TEST(SbetReader, MapRecords) {
+  const SbetFile file(1000);
+  const Core::SbetReader reader(file.getPath());
+  ASSERT_EQ(reader.size(), 1000);
+  EXPECT_DOUBLE_EQ(reader.getStartTime(), 4e5);
+  EXPECT_DOUBLE_EQ(reader.getEndTime(), 4e5 + 0.005 * 999.0);
+  EXPECT_DOUBLE_EQ(reader[10].heading, 0.01);
+  EXPECT_DOUBLE_EQ(reader.getRecords()[10].latitude, Latitude + 1e-6);
+  EXPECT_THROW(reader[1000], std::out_of_range);
+
+  // First record at or after the time
+  EXPECT_EQ(reader.findRecord(0.0), 0);
+  EXPECT_EQ(reader.findRecord(4e5 + 0.05), 10);
+  EXPECT_EQ(reader.findRecord(4e5 + 0.0501), 11);
+  EXPECT_EQ(reader.findRecord(4e5 + 10.0), 1000);
+}
+
+TEST(SbetReader, InvalidFiles) {
+  EXPECT_THROW(Core::SbetReader("/nonexistent/file.sbet"),
+               std::runtime_error);
+  const SbetFile file(3);
+  boost::filesystem::resize_file(file.getPath(), 2 * sizeof(Record) + 8);
+  EXPECT_THROW(Core::SbetReader reader(file.getPath()), std::invalid_argument);
+  boost::filesystem::resize_file(file.getPath(), 0);
+  const Core::SbetReader reader(file.getPath());
+  EXPECT_EQ(reader.size(), 0);
+  EXPECT_THROW(reader.getStartTime(), std::out_of_range);
+}
+
+TEST(SbetReader, DecodeTimeWindows) {
+  const SbetFile file(1000);
+  const Core::SbetReader reader(file.getPath());
+  const Core::SbetReader::LocalTangentPlaneConverter converter(
+      Latitude, Longitude, Altitude);
+
+  Core::Trajectory<double> trajectory;
+  EXPECT_EQ(reader.decode(4e5 + 0.1, 4e5 + 0.2, trajectory, converter), 21);
+  EXPECT_DOUBLE_EQ(trajectory.getStartTime(), 4e5 + 0.1);
+  // Overlapping windows skip the decoded records
+  EXPECT_EQ(reader.decode(4e5 + 0.15, 4e5 + 0.25, trajectory, converter), 10);
+  EXPECT_EQ(trajectory.size(), 31);
+
+  // Windows around exposure times, where the first two are merged
+  const std::vector<double> times = {4e5 + 1.0, 4e5 + 1.01, 4e5 + 3.0};
+  trajectory.clear();
+  EXPECT_EQ(reader.decodeWindows(times.size(), times.data(), 0.0125,
+                                 trajectory, converter),
+            7 + 5);
+  EXPECT_DOUBLE_EQ(trajectory.getStartTime(), 4e5 + 0.99);
+  for (const double time : times) {
+    EXPECT_NO_THROW(trajectory.interpolate(time));
+  }
+}
+
+TEST(SbetReader, ConvertToLocalTangentPlane) {
+  const Core::SbetReader::LocalTangentPlaneConverter converter(
+      Latitude, Longitude, Altitude);
+  Core::Trajectory<double>::PositionType position;
+  Core::Trajectory<double>::AttitudeType attitude;
+
+  // Origin heading north, i.e., body x (forward) to north and z (down) to down
+  Record record = {};
+  record.latitude = Latitude;
+  record.longitude = Longitude;
+  record.altitude = Altitude;
+  converter(record, position, attitude);
+  EXPECT_LT(position.norm(), 1e-8);
+  EXPECT_TRUE((attitude * Eigen::Vector3d::UnitX())
+                  .isApprox(Eigen::Vector3d::UnitY(), 1e-12));
+  EXPECT_TRUE((attitude * Eigen::Vector3d::UnitZ())
+                  .isApprox(-Eigen::Vector3d::UnitZ(), 1e-12));
+
+  // About 100 m north and 10 m up, heading east with a 10 degree roll
+  record.latitude += 100.0 / 6.37e6;
+  record.altitude += 10.0;
+  record.heading = M_PI / 2.0;
+  record.roll = 10.0 * M_PI / 180.0;
+  converter(record, position, attitude);
+  EXPECT_NEAR(position[0], 0.0, 1e-6);
+  EXPECT_NEAR(position[1], 100.0, 0.5);
+  EXPECT_NEAR(position[2], 10.0, 0.01);
+  // Body x to east, and body y (right wing) to south and down
+  EXPECT_TRUE((attitude * Eigen::Vector3d::UnitX())
+                  .isApprox(Eigen::Vector3d::UnitX(), 1e-4));
+  const Eigen::Vector3d rightWing = attitude * Eigen::Vector3d::UnitY();
+  EXPECT_NEAR(rightWing[1], -std::cos(record.roll), 1e-4);
+  EXPECT_NEAR(rightWing[2], -std::sin(record.roll), 1e-4);
+}
+
+TEST(SbetReader, ConvertWanderAzimuthHeading) {
+  const Core::SbetReader::LocalTangentPlaneConverter converter(
+      Latitude, Longitude, Altitude);
+  Core::Trajectory<double>::PositionType position;
+  Core::Trajectory<double>::AttitudeType attitude;
+
+  // Heading east in a wander frame rotated by 30 degrees
+  Record record = {};
+  record.latitude = Latitude;
+  record.longitude = Longitude;
+  record.altitude = Altitude;
+  record.wanderAngle = 30.0 * M_PI / 180.0;
+  record.heading = M_PI / 2.0 + record.wanderAngle;
+  converter(record, position, attitude);
+  EXPECT_TRUE((attitude * Eigen::Vector3d::UnitX())
+                  .isApprox(Eigen::Vector3d::UnitX(), 1e-12));
+  EXPECT_TRUE((attitude * Eigen::Vector3d::UnitZ())
+                  .isApprox(-Eigen::Vector3d::UnitZ(), 1e-12));
+}
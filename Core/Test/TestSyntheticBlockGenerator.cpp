@@ -0,0 +1,173 @@
+#include "ImageBlock.h"
+#include "SyntheticBlockGenerator.h"
+
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+using ObjectPointType = Core::ObjectPoint;
+using ImageBlockType =
+    Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+using Generator = Core::SyntheticBlockGenerator;
+
+namespace {
+/// Check that two blocks are the same
+void ExpectEqual(const Generator::Block &block,
+                 const Generator::Block &other) {
+  ASSERT_EQ(block.images.size(), other.images.size());
+  for (std::size_t i = 0; i < block.images.size(); ++i) {
+    EXPECT_EQ(block.images[i].id, other.images[i].id);
+    EXPECT_EQ(block.images[i].position, other.images[i].position);
+  }
+  EXPECT_EQ(block.trajectoryPositions, other.trajectoryPositions);
+  EXPECT_EQ(block.points, other.points);
+  EXPECT_EQ(block.imageIndices, other.imageIndices);
+  EXPECT_EQ(block.pointIndices, other.pointIndices);
+  EXPECT_EQ(block.x, other.x);
+  EXPECT_EQ(block.y, other.y);
+}
+} // namespace
+
+TEST(SyntheticBlockGenerator, Deterministic) {
+  Generator::Options options;
+  options.numberOfStrips = 3;
+  options.numberOfExposuresPerStrip = 8;
+  options.hasObliqueCameras = true;
+  options.numberOfThreads = 1;
+  const Generator::Block block = Generator::Create(options);
+  EXPECT_EQ(block.cameras.size(), 5u);
+  EXPECT_EQ(block.images.size(), 3u * 8u * 5u);
+  EXPECT_GT(block.getNumberOfObservations(), 0u);
+
+  // Independent of the number of threads
+  options.numberOfThreads = 4;
+  ExpectEqual(block, Generator::Create(options));
+
+  // but not of the seed
+  options.seed = 2;
+  const Generator::Block other = Generator::Create(options);
+  EXPECT_NE(block.points, other.points);
+  EXPECT_NE(block.trajectoryPositions, other.trajectoryPositions);
+}
+
+TEST(SyntheticBlockGenerator, ObservationsReprojectIntoImageBlock) {
+  Generator::Options options;
+  options.numberOfStrips = 2;
+  options.numberOfExposuresPerStrip = 6;
+  options.hasObliqueCameras = true;
+  options.imageSigma = 0.0;
+  ImageBlockType imageBlock;
+  Generator::Generate(options, imageBlock);
+  ASSERT_EQ(imageBlock.getNumberOfCameras(), 5u);
+  ASSERT_EQ(imageBlock.getNumberOfImages(), 2u * 6u * 5u);
+  EXPECT_EQ(imageBlock.getCamera(imageBlock.getCameraHandle("left"))
+                ->getReferenceCameraId(),
+            "nadir");
+
+  // Every object point is observed at least twice, and every camera observes
+  // object points
+  const auto &observations = imageBlock.getObservations();
+  const auto &tracks = imageBlock.getTracks();
+  for (Core::Handle point = 0; point < imageBlock.getNumberOfObjectPoints();
+       ++point) {
+    EXPECT_GE(tracks.getPointObservations(point).size(), 2u);
+  }
+  std::vector<std::size_t> counts(5, 0);
+  for (std::size_t i = 0; i < observations.size(); ++i) {
+    ++counts[observations.cameraHandles[i]];
+  }
+  for (const std::size_t count : counts) {
+    EXPECT_GT(count, 0u);
+  }
+
+  // Noise-free observations are the projections of their object points with
+  // the EOPs, mounting parameters and IOPs of the image block
+  const auto &nadir = *imageBlock.getCamera(0);
+  double maximumError = 0.0;
+  for (std::size_t i = 0; i < observations.size(); ++i) {
+    const auto &image = *imageBlock.getImage(observations.imageHandles[i]);
+    const auto &camera = *imageBlock.getCamera(observations.cameraHandles[i]);
+    Eigen::Matrix3d rotation = image.getRotationMatrix();
+    Eigen::Vector3d center = image.getTranslation();
+    center += rotation * nadir.getMountingParameters().getTranslation();
+    rotation *= nadir.getMountingParameters().getRotationMatrix();
+    if (observations.cameraHandles[i] != 0) {
+      center += rotation * camera.getMountingParameters().getTranslation();
+      rotation *= camera.getMountingParameters().getRotationMatrix();
+    }
+    const auto &objectPoint =
+        imageBlock.getObjectPoint(observations.pointHandles[i]);
+    const Eigen::Vector3d point =
+        rotation.transpose() *
+        (Eigen::Vector3d(objectPoint[0], objectPoint[1], objectPoint[2]) -
+         center);
+    const Eigen::Vector2d measured = camera.ConvertPixelToImageCoordinates(
+        observations.y[i], observations.x[i]);
+    const double c = camera.xyc[2];
+    maximumError = std::max(
+        maximumError,
+        (measured - Eigen::Vector2d(camera.xyc[0] - c * point[0] / point[2],
+                                    camera.xyc[1] - c * point[1] / point[2]))
+                .norm() /
+            camera.xPixelSize);
+    EXPECT_GE(observations.x[i], 0.0);
+    EXPECT_LT(observations.x[i], camera.width);
+    EXPECT_GE(observations.y[i], 0.0);
+    EXPECT_LT(observations.y[i], camera.height);
+  }
+  EXPECT_LT(maximumError, 1e-6);
+}
+
+TEST(SyntheticBlockGenerator, Trajectory) {
+  Generator::Options options;
+  options.numberOfStrips = 2;
+  options.numberOfExposuresPerStrip = 5;
+  options.positionSigma = 0.0;
+  options.attitudeSigma = 0.0;
+  ImageBlockType imageBlock;
+  Generator::Generate(options, imageBlock);
+  const Generator::Block block = Generator::Create(options);
+
+  // The trajectory interpolates the EOPs of the images (up to the
+  // interpolation error of the oscillations)
+  const auto &trajectory = imageBlock.getTrajectory();
+  ASSERT_GT(trajectory.size(), 2u);
+  for (const Generator::Image &image : block.images) {
+    Core::Trajectory<DataType>::PositionType position;
+    Core::Trajectory<DataType>::AttitudeType attitude;
+    trajectory.interpolate(image.time, position, attitude);
+    EXPECT_LT((position - image.position).norm(), 1e-3);
+    EXPECT_LT(Eigen::AngleAxisd(attitude.toRotationMatrix().transpose() *
+                                image.rotation)
+                  .angle(),
+              1e-5);
+  }
+  // Images of the second strip are taken in the opposite direction
+  const auto &forward = block.images.front();
+  const auto &backward = block.images.back();
+  EXPECT_GT(forward.rotation(0, 0), 0.99);
+  EXPECT_LT(backward.rotation(0, 0), -0.99);
+  EXPECT_GT(backward.time, forward.time);
+}
+
+TEST(SyntheticBlockGenerator, InvalidOptions) {
+  Generator::Options options;
+  options.numberOfStrips = 0;
+  EXPECT_THROW(Generator::Create(options), std::invalid_argument);
+  options = Generator::Options();
+  options.forwardOverlap = 1.0;
+  EXPECT_THROW(Generator::Create(options), std::invalid_argument);
+
+  ImageBlockType imageBlock;
+  imageBlock.addObjectPoint("point", ObjectPointType(0.0, 0.0, 0.0));
+  EXPECT_THROW(Generator::Generate(Generator::Options(), imageBlock),
+               std::invalid_argument);
+}
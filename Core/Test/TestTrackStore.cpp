@@ -0,0 +1,144 @@
+#include "ImageBlock.h"
+#include "TrackStore.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using DataType = double;
+using CameraType = Core::FrameCamera<DataType, 9>;
+using ImageType = Core::Image<Core::ImagePoint, DataType>;
+
+TEST(TrackStore, BuildAndIterate) {
+  // Observations: (point, image)
+  const std::vector<Core::Handle> pointHandles = {2, 0, 1, 0, 2, 2};
+  const std::vector<Core::Handle> imageHandles = {0, 0, 1, 1, 1, 2};
+  Core::TrackStore tracks;
+  tracks.build(pointHandles, imageHandles, 4, 3);
+
+  EXPECT_EQ(tracks.getNumberOfPoints(), 4);
+  EXPECT_EQ(tracks.getNumberOfImages(), 3);
+  EXPECT_EQ(tracks.getNumberOfObservations(), 6);
+
+  // Point -> observations, in ascending order
+  std::vector<Core::TrackStore::Index> track;
+  for (auto index : tracks.getPointObservations(2)) {
+    track.push_back(index);
+  }
+  EXPECT_EQ(track, (std::vector<Core::TrackStore::Index>{0, 4, 5}));
+  EXPECT_EQ(tracks.getTrackLength(0), 2);
+  EXPECT_EQ(tracks.getTrackLength(1), 1);
+  EXPECT_TRUE(tracks.getPointObservations(3).empty());
+
+  // Image -> observations
+  auto imageObservations = tracks.getImageObservations(1);
+  ASSERT_EQ(imageObservations.size(), 3);
+  EXPECT_EQ(imageObservations[0], 2);
+  EXPECT_EQ(imageObservations[1], 3);
+  EXPECT_EQ(imageObservations[2], 4);
+  for (Core::Handle image = 0; image < 3; ++image) {
+    for (auto index : tracks.getImageObservations(image)) {
+      EXPECT_EQ(imageHandles[index], image);
+    }
+  }
+
+  // Unknown handles
+  ASSERT_THROW(tracks.getPointObservations(4), std::out_of_range);
+  ASSERT_THROW(tracks.getImageObservations(3), std::out_of_range);
+  Core::TrackStore invalidTracks;
+  ASSERT_THROW(invalidTracks.build(pointHandles, imageHandles, 2, 3),
+               std::invalid_argument);
+}
+
+TEST(TrackStore, BuildObservationsOfImageBlock) {
+  using ImageBlockType =
+      Core::ImageBlock<CameraType, ImageType, Core::ObjectPoint, DataType>;
+  ImageBlockType imageBlock;
+  imageBlock.addCamera("camera", std::make_shared<CameraType>());
+  for (unsigned int imageIndex = 0; imageIndex < 4; ++imageIndex) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId("camera");
+    for (unsigned int pointIndex = 0; pointIndex < 6; ++pointIndex) {
+      image->addPoint(std::to_string(pointIndex),
+                      Core::ImagePoint(pointIndex, imageIndex));
+    }
+    imageBlock.addImage("image" + std::to_string(imageIndex), image);
+  }
+  // The i-th point is observed in the first (i % 4) + 1 images
+  for (unsigned int pointIndex = 0; pointIndex < 6; ++pointIndex) {
+    Core::ObjectPoint point(0.0, 0.0, 0.0);
+    for (unsigned int imageIndex = 0; imageIndex <= pointIndex % 4;
+         ++imageIndex) {
+      point.mTiePointIds["image" + std::to_string(imageIndex)] =
+          std::to_string(pointIndex);
+    }
+    imageBlock.addObjectPoint(std::to_string(pointIndex), point);
+  }
+
+  imageBlock.buildObservations(2, true);
+  const auto &observations = imageBlock.getObservations();
+  const auto &tracks = imageBlock.getTracks();
+  EXPECT_EQ(observations.size(), 1 + 2 + 3 + 4 + 1 + 2);
+  for (Core::Handle pointHandle = 0; pointHandle < 6; ++pointHandle) {
+    EXPECT_EQ(tracks.getTrackLength(pointHandle), pointHandle % 4 + 1);
+    EXPECT_TRUE(imageBlock.getObjectPoint(pointHandle).mTiePointIds.empty());
+    for (auto index : tracks.getPointObservations(pointHandle)) {
+      EXPECT_EQ(observations.pointHandles[index], pointHandle);
+      EXPECT_EQ(observations.x[index], pointHandle);
+    }
+  }
+  EXPECT_EQ(tracks.getImageObservations(0).size(), 6);
+  EXPECT_EQ(tracks.getImageObservations(3).size(), 1);
+}
+
+TEST(TrackStore, SetObservationsWithoutTiePointMaps) {
+  // Object points without per-point tie point maps
+  using ObjectPointType = Core::Point<DataType, 3>;
+  using ImageBlockType =
+      Core::ImageBlock<CameraType, ImageType, ObjectPointType, DataType>;
+  ImageBlockType imageBlock;
+  imageBlock.addCamera("camera", std::make_shared<CameraType>());
+  for (const std::string imageId : {"image0", "image1"}) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId("camera");
+    imageBlock.addImage(imageId, image);
+  }
+  imageBlock.addObjectPoint("0", ObjectPointType(Eigen::Vector3d::Zero()));
+  imageBlock.addObjectPoint("1", ObjectPointType(Eigen::Vector3d::Ones()));
+
+  Core::ObservationTable<DataType> observations;
+  observations.addObservation(1, 0, 0, 10.0, 20.0);
+  observations.addObservation(0, 1, 0, 30.0, 40.0);
+  observations.addObservation(0, 0, 0, 50.0, 60.0);
+  imageBlock.setObservations(observations);
+
+  const auto &tracks = imageBlock.getTracks();
+  ASSERT_EQ(tracks.getTrackLength(0), 2);
+  EXPECT_EQ(tracks.getPointObservations(0)[0], 0);
+  EXPECT_EQ(tracks.getPointObservations(0)[1], 2);
+  EXPECT_EQ(tracks.getImageObservations(0).size(), 2);
+  EXPECT_EQ(imageBlock.getObservations().x[tracks.getPointObservations(1)[0]],
+            30.0);
+
+  // Invalid observations leave the observations and tracks unchanged
+  auto unknownPoint = observations;
+  unknownPoint.addObservation(0, 2, 0, 0.0, 0.0);
+  auto unknownImage = observations;
+  unknownImage.pointHandles[0] = 1;
+  unknownImage.addObservation(2, 0, 0, 0.0, 0.0);
+  auto wrongCamera = observations;
+  wrongCamera.cameraHandles[1] = 1;
+  auto missingColumn = observations;
+  missingColumn.sqrtInformation.pop_back();
+  for (const auto *invalid :
+       {&unknownPoint, &unknownImage, &wrongCamera, &missingColumn}) {
+    ASSERT_THROW(imageBlock.setObservations(*invalid), std::invalid_argument);
+    EXPECT_EQ(imageBlock.getObservations().size(), 3);
+    EXPECT_EQ(tracks.getNumberOfObservations(), 3);
+    EXPECT_EQ(tracks.getTrackLength(0), 2);
+    EXPECT_EQ(tracks.getImageObservations(0).size(), 2);
+  }
+}
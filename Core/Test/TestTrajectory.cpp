@@ -0,0 +1,156 @@
+#include "ImageBlock.h"
+#include "Trajectory.h"
+
+#include "gtest/gtest.h"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+using TrajectoryType = Core::Trajectory<double>;
+
+namespace {
+/// Attitude rotated around the z-axis by the given angle in radians
+TrajectoryType::AttitudeType Heading(const double angle) {
+  return TrajectoryType::AttitudeType(
+      Eigen::AngleAxisd(angle, Eigen::Vector3d::UnitZ()));
+}
+
+/// 200 Hz trajectory (in GPS seconds of week) of a platform moving along x
+/// while turning around z
+TrajectoryType CreateTrajectory(const std::size_t size) {
+  TrajectoryType trajectory;
+  trajectory.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    const double time = 4e5 + 0.005 * static_cast<double>(i);
+    trajectory.append(time,
+                      TrajectoryType::PositionType(
+                          10.0 * static_cast<double>(i), 5.0, 1000.0),
+                      Heading(0.01 * static_cast<double>(i)));
+  }
+  return trajectory;
+}
+} // namespace
+
+TEST(Trajectory, AppendRecords) {
+  TrajectoryType trajectory = CreateTrajectory(10);
+  EXPECT_EQ(trajectory.size(), 10);
+  EXPECT_DOUBLE_EQ(trajectory.getStartTime(), 4e5);
+  EXPECT_DOUBLE_EQ(trajectory.getEndTime(), 4e5 + 0.045);
+  EXPECT_DOUBLE_EQ(trajectory.getPosition(3)[0], 30.0);
+  // Records have to be appended in increasing time order
+  EXPECT_THROW(trajectory.append(4e5 + 0.045, trajectory.getPosition(0),
+                                 trajectory.getAttitude(0)),
+               std::invalid_argument);
+  EXPECT_EQ(trajectory.size(), 10);
+
+  // Attitudes are normalized
+  trajectory.append(4e5 + 0.05, trajectory.getPosition(0),
+                    TrajectoryType::AttitudeType(2.0, 0.0, 0.0, 0.0));
+  EXPECT_DOUBLE_EQ(trajectory.getAttitude(10).w(), 1.0);
+
+  // EOPs (rotation in degrees)
+  Core::ExteriorOrientation<double> pose;
+  pose.setTranslation(1.0, 2.0, 3.0);
+  pose.setRotation(0.0, 0.0, 90.0);
+  trajectory.append(4e5 + 0.06, pose);
+  EXPECT_TRUE(trajectory.getAttitude(11).isApprox(Heading(M_PI / 2.0)));
+  EXPECT_DOUBLE_EQ(trajectory.getPosition(11)[2], 3.0);
+}
+
+TEST(Trajectory, FindInterval) {
+  const TrajectoryType trajectory = CreateTrajectory(100);
+  EXPECT_EQ(trajectory.findInterval(4e5), 0);
+  EXPECT_EQ(trajectory.findInterval(4e5 + 0.0051), 1);
+  // Record times belong to the interval starting at them, except for the last
+  EXPECT_EQ(trajectory.findInterval(trajectory.getTime(42)), 42);
+  EXPECT_EQ(trajectory.findInterval(trajectory.getEndTime()), 98);
+  EXPECT_THROW(trajectory.findInterval(4e5 - 0.001), std::out_of_range);
+  EXPECT_THROW(trajectory.findInterval(trajectory.getEndTime() + 0.001),
+               std::out_of_range);
+  EXPECT_THROW(CreateTrajectory(1).findInterval(4e5), std::out_of_range);
+
+  // Hinted search for increasing and decreasing times
+  std::size_t hint = 0;
+  for (std::size_t i = 0; i < 99; i += 3) {
+    const double time =
+        0.5 * (trajectory.getTime(i) + trajectory.getTime(i + 1));
+    EXPECT_EQ(trajectory.findInterval(time, hint), i);
+    EXPECT_EQ(hint, i);
+  }
+  EXPECT_EQ(trajectory.findInterval(4e5 + 0.0501, hint), 10);
+  hint = 1000;
+  EXPECT_EQ(trajectory.findInterval(4e5 + 0.0501, hint), 10);
+  // Record times and distant intervals
+  for (std::size_t step = 1; step < 99; ++step) {
+    for (std::size_t i = 0; i < 99; i += step) {
+      hint = 0;
+      EXPECT_EQ(trajectory.findInterval(trajectory.getTime(i), hint), i);
+    }
+  }
+  hint = 0;
+  EXPECT_EQ(trajectory.findInterval(trajectory.getEndTime(), hint), 98);
+}
+
+TEST(Trajectory, InterpolatePoses) {
+  const TrajectoryType trajectory = CreateTrajectory(100);
+  // A quarter of the way between records 20 and 21
+  const double time = 4e5 + 0.005 * 20.25;
+  TrajectoryType::PositionType position;
+  TrajectoryType::AttitudeType attitude;
+  trajectory.interpolate(time, position, attitude);
+  EXPECT_NEAR(position[0], 202.5, 1e-5);
+  EXPECT_DOUBLE_EQ(position[1], 5.0);
+  EXPECT_TRUE(attitude.isApprox(Heading(0.2025), 1e-6));
+  // Records are reproduced
+  trajectory.interpolate(trajectory.getTime(50), position, attitude);
+  EXPECT_DOUBLE_EQ(position[0], 500.0);
+  EXPECT_TRUE(attitude.isApprox(trajectory.getAttitude(50)));
+
+  // As EOPs
+  const auto pose = trajectory.interpolate(time);
+  EXPECT_NEAR(pose.getTranslation()[0], 202.5, 1e-5);
+  EXPECT_NEAR(pose.getRotationInRadians()[2], 0.2025, 1e-6);
+
+  // Batch interpolation of sorted and unsorted times
+  const std::vector<double> times = {4e5 + 0.0101, 4e5 + 0.3, 4e5 + 0.4949,
+                                     4e5 + 0.1};
+  std::vector<double> positions(3 * times.size());
+  std::vector<double> attitudes(4 * times.size());
+  trajectory.interpolate(times.size(), times.data(), positions.data(),
+                         attitudes.data());
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    trajectory.interpolate(times[i], position, attitude);
+    EXPECT_DOUBLE_EQ(positions[3 * i], position[0]);
+    EXPECT_DOUBLE_EQ(positions[3 * i + 2], position[2]);
+    EXPECT_DOUBLE_EQ(attitudes[4 * i + 2], attitude.z());
+    EXPECT_DOUBLE_EQ(attitudes[4 * i + 3], attitude.w());
+  }
+  const double outside = trajectory.getEndTime() + 1.0;
+  EXPECT_THROW(trajectory.interpolate(1, &outside, positions.data(),
+                                      attitudes.data()),
+               std::out_of_range);
+}
+
+TEST(Trajectory, SlerpTakesShorterArc) {
+  TrajectoryType trajectory;
+  const TrajectoryType::PositionType origin(0.0, 0.0, 0.0);
+  trajectory.append(0.0, origin, Heading(0.1));
+  // -q is the same attitude as q
+  TrajectoryType::AttitudeType attitude = Heading(0.3);
+  attitude.coeffs() *= -1.0;
+  trajectory.append(1.0, origin, attitude);
+  TrajectoryType::PositionType position;
+  trajectory.interpolate(0.5, position, attitude);
+  EXPECT_NEAR(Eigen::AngleAxisd(attitude).angle(), 0.2, 1e-12);
+}
+
+TEST(Trajectory, TrajectoryOfImageBlock) {
+  Core::ImageBlock<Core::FrameCamera<double, 9>,
+                   Core::Image<Core::ImagePoint, double>, Core::ObjectPoint,
+                   double>
+      imageBlock;
+  imageBlock.getTrajectory() = CreateTrajectory(10);
+  EXPECT_EQ(imageBlock.getTrajectory().size(), 10);
+}
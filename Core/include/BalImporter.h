@@ -0,0 +1,89 @@
+#ifndef CORE_BALIMPORTER_H
+#define CORE_BALIMPORTER_H
+
+#include <string>
+#include <vector>
+
+#include "IdRegistry.h"
+
+namespace Core {
+/**
+ * This is the class to import "Bundle Adjustment in the Large" (BAL) problem
+ * files (see grail.cs.washington.edu/projects/bal), i.e., a header with the
+ * numbers of cameras, points and observations, followed by the observations
+ * (camera index, point index, x and y), the cameras (Rodrigues rotation,
+ * translation, focal length, k1 and k2) and the points.
+ * The file is split into chunks, which are tokenized and parsed in parallel
+ * with a locale-free number parser (see ParseDouble), and every number is
+ * written to its final place in one pass.
+ *
+ * BAL projects a point X with P = R * X + t, p = -P / P.z and
+ * x = f * (1 + k1 * |p|^2 + k2 * |p|^4) * p, in image-centered coordinates
+ * with y up. The cameras are mapped onto FrameCamera as follows:
+ * - every BAL camera is a reference camera ("camera<i>") with identity
+ * mounting parameters, used by one image ("image<i>") whose EOPs are the
+ * camera to mapping frame transformation (i.e., R^T and -R^T * t);
+ * - c = f, xp = yp = 0, and the observations are pixels with col = x and
+ * row = -y at width = height = 0 and unit pixel size, so that the image
+ * coordinates are the BAL ones;
+ * - the radial distortion, which this library evaluates at the measured
+ * point, is the series inversion of the BAL one up to r^6, i.e.,
+ * k0 = 0, k1' = k1 / f^2, k2' = (k2 - 3 * k1^2) / f^4 and
+ * k3' = (12 * k1^3 - 8 * k1 * k2) / f^6, which is accurate to O(k^4).
+ */
+class BalImporter {
+public:
+  /// Raw content of a BAL file
+  struct Problem {
+    /// Camera and point index, and x and y of every observation
+    std::vector<Handle> cameraIndices;
+    std::vector<Handle> pointIndices;
+    std::vector<double> x;
+    std::vector<double> y;
+    /// 9 parameters of every camera (i.e., Rodrigues rotation, translation,
+    /// f, k1 and k2)
+    std::vector<double> cameras;
+    /// X, Y and Z of every point
+    std::vector<double> points;
+
+    std::size_t getNumberOfCameras() const { return cameras.size() / 9; }
+    std::size_t getNumberOfPoints() const { return points.size() / 3; }
+    std::size_t getNumberOfObservations() const { return x.size(); }
+  };
+
+  /**
+   * Parse a BAL file
+   * Note: This function throws std::runtime_error if the file cannot be read,
+   * or if it is malformed (e.g., invalid numbers, too few or too many numbers
+   * and indices out of range).
+   * @param[in] filePath The path of the file
+   * @param[in] numberOfThreads The number of threads (default = 0, i.e., the
+   * number of hardware threads)
+   */
+  static Problem Parse(const std::string &filePath,
+                       const unsigned int numberOfThreads = 0);
+  /// Parse the content of a BAL file (see above)
+  static Problem Parse(const char *first, const char *last,
+                       const unsigned int numberOfThreads = 0);
+
+  /**
+   * Add the cameras, images, object points and observations of a BAL problem
+   * to an empty image block (see the class description for the mapping)
+   * Note: The camera type has to use RadialDistortion or BrownDistortion.
+   * This function throws std::invalid_argument if the image block is not
+   * empty.
+   */
+  template <typename TImageBlockType>
+  static void Load(const Problem &problem, TImageBlockType &imageBlock);
+
+  /// Parse a BAL file, and load it into an empty image block
+  template <typename TImageBlockType>
+  static void Import(const std::string &filePath,
+                     TImageBlockType &imageBlock,
+                     const unsigned int numberOfThreads = 0);
+};
+} // namespace Core
+
+#include "BalImporter.hpp"
+
+#endif // CORE_BALIMPORTER_H
@@ -0,0 +1,108 @@
+#include "BalImporter.h"
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "eigen3/Eigen/Geometry"
+
+#include "DistortionModel.h"
+#include "ExteriorOrientation.h"
+#include "ObservationTable.h"
+
+namespace Core {
+template <typename TImageBlockType>
+void BalImporter::Load(const Problem &problem, TImageBlockType &imageBlock) {
+  using CameraType = typename TImageBlockType::CameraType;
+  using ImageType = typename TImageBlockType::ImageType;
+  using ObjectPointType = typename TImageBlockType::ObjectPointType;
+  using DataType = typename TImageBlockType::DataType;
+  static_assert(
+      std::is_same<typename CameraType::DistortionModel,
+                   RadialDistortion>::value ||
+          std::is_same<typename CameraType::DistortionModel,
+                       BrownDistortion>::value,
+      "BAL cameras can only be mapped onto radial or Brown distortions");
+  if (imageBlock.getNumberOfCameras() != 0 ||
+      imageBlock.getNumberOfImages() != 0 ||
+      imageBlock.getNumberOfObjectPoints() != 0) {
+    throw std::invalid_argument(
+        "BAL problems can only be loaded into an empty image block!");
+  }
+  const std::size_t numberOfCameras = problem.getNumberOfCameras();
+  const std::size_t numberOfPoints = problem.getNumberOfPoints();
+  const std::size_t numberOfObservations = problem.getNumberOfObservations();
+  imageBlock.reserve(numberOfCameras, numberOfCameras, numberOfPoints);
+
+  // One camera and image per BAL camera
+  const ExteriorOrientation<DataType> mountingParameters;
+  for (std::size_t i = 0; i < numberOfCameras; ++i) {
+    const double *params = problem.cameras.data() + 9 * i;
+    const double f = params[6];
+    const double k1 = params[7];
+    const double k2 = params[8];
+    const double f2 = f * f;
+    CameraType iops;
+    iops.xyc[0] = static_cast<DataType>(0);
+    iops.xyc[1] = static_cast<DataType>(0);
+    iops.xyc[2] = static_cast<DataType>(f);
+    iops.distortionParameters.setZero();
+    iops.distortionParameters[1] = static_cast<DataType>(k1 / f2);
+    iops.distortionParameters[2] =
+        static_cast<DataType>((k2 - 3.0 * k1 * k1) / (f2 * f2));
+    iops.distortionParameters[3] = static_cast<DataType>(
+        (12.0 * k1 * k1 * k1 - 8.0 * k1 * k2) / (f2 * f2 * f2));
+    const std::string cameraId = "camera" + std::to_string(i);
+    imageBlock.addCamera(cameraId, std::make_shared<CameraType>(
+                                       cameraId, mountingParameters, iops));
+
+    // Rotation from the mapping to the camera frame
+    const Eigen::Vector3d rodrigues(params[0], params[1], params[2]);
+    const double angle = rodrigues.norm();
+    const Eigen::Matrix3d rotation =
+        angle > 0.0
+            ? Eigen::AngleAxisd(angle, rodrigues / angle).toRotationMatrix()
+            : Eigen::Matrix3d::Identity();
+    const Eigen::Vector3d center =
+        -rotation.transpose() *
+        Eigen::Vector3d(params[3], params[4], params[5]);
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId(cameraId);
+    image->setTranslation(static_cast<DataType>(center[0]),
+                          static_cast<DataType>(center[1]),
+                          static_cast<DataType>(center[2]));
+    image->setRotationFromMatrix(
+        rotation.transpose().template cast<DataType>());
+    imageBlock.addImage("image" + std::to_string(i), image);
+  }
+
+  for (std::size_t i = 0; i < numberOfPoints; ++i) {
+    const double *point = problem.points.data() + 3 * i;
+    imageBlock.addObjectPoint("point" + std::to_string(i),
+                              ObjectPointType(point[0], point[1], point[2]));
+  }
+
+  // Observations (col = x and row = -y) with unit weights, in bulk
+  ObservationTable<DataType> observations;
+  observations.imageHandles = problem.cameraIndices;
+  observations.pointHandles = problem.pointIndices;
+  observations.cameraHandles = problem.cameraIndices;
+  observations.x.assign(problem.x.begin(), problem.x.end());
+  observations.y.resize(numberOfObservations);
+  observations.sqrtInformation.resize(3 * numberOfObservations);
+  for (std::size_t i = 0; i < numberOfObservations; ++i) {
+    observations.y[i] = static_cast<DataType>(-problem.y[i]);
+    observations.sqrtInformation[3 * i] = static_cast<DataType>(1);
+    observations.sqrtInformation[3 * i + 1] = static_cast<DataType>(0);
+    observations.sqrtInformation[3 * i + 2] = static_cast<DataType>(1);
+  }
+  imageBlock.setObservations(std::move(observations));
+}
+
+template <typename TImageBlockType>
+void BalImporter::Import(const std::string &filePath,
+                         TImageBlockType &imageBlock,
+                         const unsigned int numberOfThreads) {
+  Load(Parse(filePath, numberOfThreads), imageBlock);
+}
+} // namespace Core
@@ -7,18 +7,23 @@
 namespace Core {
 /**
  * This is the class for frame camera
+ * Note: See InteriorOrientation for Size and TDistortionModel.
  */
-template <typename TDataType = double, int Size = 9>
-class FrameCamera : public InteriorOrientation<TDataType, Size> {
+template <typename TDataType = double, int Size = 9,
+          typename TDistortionModel =
+              typename DefaultDistortionModel<Size>::Type>
+class FrameCamera
+    : public InteriorOrientation<TDataType, Size, TDistortionModel> {
 public:
   /// Defalut constructor
   FrameCamera() = default;
   ~FrameCamera() = default;
 
   /// Constructor
-  FrameCamera(const std::string &referenceCameraId,
-              const ExteriorOrientation<TDataType> &mountingParams,
-              const InteriorOrientation<TDataType, Size> &iops);
+  FrameCamera(
+      const std::string &referenceCameraId,
+      const ExteriorOrientation<TDataType> &mountingParams,
+      const InteriorOrientation<TDataType, Size, TDistortionModel> &iops);
 
   /// Accessor of mReferenceId
   const std::string &getReferenceCameraId() const;
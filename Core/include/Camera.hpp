@@ -1,29 +1,30 @@
 #include "Camera.h"
 
 namespace Core {
-template <typename TDataType, int Size>
-FrameCamera<TDataType, Size>::FrameCamera(
+template <typename TDataType, int Size, typename TDistortionModel>
+FrameCamera<TDataType, Size, TDistortionModel>::FrameCamera(
     const std::string &referenceCameraId,
     const ExteriorOrientation<TDataType> &mountingParams,
-    const InteriorOrientation<TDataType, Size> &iops)
-    : mMountingParameters(mountingParams), InteriorOrientation<TDataType, Size>(
-                                               iops),
+    const InteriorOrientation<TDataType, Size, TDistortionModel> &iops)
+    : mMountingParameters(mountingParams),
+      InteriorOrientation<TDataType, Size, TDistortionModel>(iops),
       mReferenceCameraId(referenceCameraId) {}
 
-template <typename TDataType, int Size>
-const std::string &FrameCamera<TDataType, Size>::getReferenceCameraId() const {
+template <typename TDataType, int Size, typename TDistortionModel>
+const std::string &
+FrameCamera<TDataType, Size, TDistortionModel>::getReferenceCameraId() const {
   return mReferenceCameraId;
 }
 
-template <typename TDataType, int Size>
+template <typename TDataType, int Size, typename TDistortionModel>
 const ExteriorOrientation<TDataType> &
-FrameCamera<TDataType, Size>::getMountingParameters() const {
+FrameCamera<TDataType, Size, TDistortionModel>::getMountingParameters() const {
   return mMountingParameters;
 }
 
-template <typename TDataType, int Size>
+template <typename TDataType, int Size, typename TDistortionModel>
 ExteriorOrientation<TDataType> &
-FrameCamera<TDataType, Size>::getMountingParameters() {
+FrameCamera<TDataType, Size, TDistortionModel>::getMountingParameters() {
   return mMountingParameters;
 }
 
@@ -0,0 +1,178 @@
+#ifndef CORE_COLMAPMODEL_H
+#define CORE_COLMAPMODEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IdRegistry.h"
+
+namespace Core {
+/**
+ * This is the class for sparse models in the COLMAP binary format (i.e.,
+ * cameras.bin, images.bin and points3D.bin in a directory). The model is kept
+ * as read, with flat arrays for the image points and tracks, and the
+ * references between cameras, images and image points are resolved to
+ * indices once when the files are read.
+ *
+ * COLMAP projects a point X with P = R * X + t (camera looking along +z, y
+ * down) and u = fx * P.x / P.z + cx, v = fy * P.y / P.z + cy in pixels, whose
+ * origin is the upper-left corner of the image. The cameras are mapped onto
+ * FrameCamera as follows:
+ * - every COLMAP camera is a reference camera ("camera<id>") with identity
+ * mounting parameters, and every image (its id is the image name) has the
+ * EOPs R^T * diag(1, -1, -1) and -R^T * t;
+ * - the image points are pixels with col = u and row = v, at a pixel size of
+ * 1 (x) and fx / fy (y), so that c = fx, xp = cx - width / 2 and
+ * yp = (height / 2 - cy) * fx / fy;
+ * - the radial distortion is converted as in BalImporter (i.e., accurate to
+ * O(k^4)), and the tangential distortion of OPENCV cameras to first order
+ * (i.e., p1' = p2 / fx and p2' = -p1 / fx of BrownDistortion).
+ * Only the SIMPLE_PINHOLE, PINHOLE, SIMPLE_RADIAL, RADIAL and OPENCV models
+ * can be loaded into an image block.
+ */
+class ColmapModel {
+public:
+  /// COLMAP camera models
+  enum class CameraModel : std::int32_t {
+    SimplePinhole = 0,
+    Pinhole = 1,
+    SimpleRadial = 2,
+    Radial = 3,
+    OpenCV = 4,
+    OpenCVFisheye = 5,
+    FullOpenCV = 6,
+    FOV = 7,
+    SimpleRadialFisheye = 8,
+    RadialFisheye = 9,
+    ThinPrismFisheye = 10
+  };
+
+  /// Point3D id of image points without object point
+  static constexpr std::uint64_t InvalidPoint3DId =
+      static_cast<std::uint64_t>(-1);
+
+  struct Camera {
+    std::uint32_t id;
+    CameraModel model;
+    std::uint64_t width;
+    std::uint64_t height;
+    /// Parameters in the order of the camera model
+    std::vector<double> parameters;
+  };
+
+  struct Image {
+    std::uint32_t id;
+    /// Index of the camera in cameras
+    std::uint32_t cameraIndex;
+    /// Rotation (w, x, y, z) and translation from the world to the camera
+    double rotation[4];
+    double translation[3];
+    std::string name;
+    /// Index of the first image point in points2D, and the number of points
+    std::uint64_t firstPoint2D;
+    std::uint64_t numberOfPoints2D;
+  };
+
+  /// Get the number of parameters of a camera model
+  /// Note: This function throws std::runtime_error for unknown models.
+  static std::size_t GetNumberOfParameters(const CameraModel model);
+
+  /**
+   * Read the model in a directory
+   * Note: This function throws std::runtime_error if a file cannot be read,
+   * is truncated, or refers to unknown cameras, images or image points.
+   */
+  static ColmapModel Read(const std::string &directory);
+
+  /**
+   * Write the model to a directory (which has to exist)
+   * Note: This function throws std::runtime_error if a file cannot be
+   * written.
+   */
+  void write(const std::string &directory) const;
+
+  /**
+   * Create a model from the cameras, images, object points and observations
+   * of an image block (with ids = handles + 1). Mounting parameters are
+   * composed into the poses of the images, the image names are their file
+   * paths (or ids if they have none), and the image points of every image are
+   * its observations in the order of ImageBlock::getTracks.
+   * Note: This function throws std::invalid_argument if the distortions of a
+   * camera cannot be represented in COLMAP (i.e., k0, p3 or affine
+   * distortions).
+   */
+  template <typename TImageBlockType>
+  static ColmapModel Create(const TImageBlockType &imageBlock);
+
+  /**
+   * Add the cameras, images, object points and observations (with unit
+   * weights, sorted by image) to an empty image block, in bulk
+   * Note: The camera type has to use RadialDistortion or BrownDistortion.
+   * This function throws std::invalid_argument if the image block is not
+   * empty, or if a camera model cannot be loaded.
+   */
+  template <typename TImageBlockType>
+  void load(TImageBlockType &imageBlock) const;
+
+  /// Read a model and load it into an empty image block
+  template <typename TImageBlockType>
+  static void Import(const std::string &directory,
+                     TImageBlockType &imageBlock);
+
+  /// Create a model from an image block, and write it to a directory
+  template <typename TImageBlockType>
+  static void Export(const std::string &directory,
+                     const TImageBlockType &imageBlock);
+
+  std::vector<Camera> cameras;
+  std::vector<Image> images;
+
+  /// u and v of every image point (n x 2), and the id of its object point
+  /// (or InvalidPoint3DId)
+  std::vector<double> points2D;
+  std::vector<std::uint64_t> point3DIds2D;
+
+  /// Id, X, Y, Z, RGB and mean reprojection error of every object point
+  std::vector<std::uint64_t> point3DIds;
+  std::vector<double> points3D;
+  std::vector<std::uint8_t> colors;
+  std::vector<double> errors;
+  /// Tracks in CSR format, i.e., the elements of the i-th point are
+  /// [trackOffsets[i], trackOffsets[i + 1]), with the image index (in images)
+  /// and the index of the image point in that image
+  std::vector<std::uint64_t> trackOffsets{0};
+  std::vector<std::uint32_t> trackImageIndices;
+  std::vector<std::uint32_t> trackPoint2DIndices;
+
+private:
+  /// Interior orientation of a camera in the conventions of FrameCamera
+  struct CameraIops {
+    double xyc[3];
+    double yPixelSize;
+    /// k1, k2, k3, p1 and p2 (see BrownDistortion)
+    double distortion[5];
+  };
+
+  /// Convert a camera to IOPs (see the class description)
+  /// Note: This function throws std::invalid_argument for unsupported models.
+  static CameraIops ConvertToIops(const Camera &camera);
+
+  /**
+   * Convert IOPs to a camera (i.e., SIMPLE_PINHOLE or RADIAL for square
+   * pixels without tangential distortion, and OPENCV otherwise)
+   * @param[in] distortion The distortion parameters of RadialDistortion or
+   * BrownDistortion
+   */
+  static Camera ConvertFromIops(const std::uint32_t id,
+                                const std::uint64_t width,
+                                const std::uint64_t height,
+                                const double xPixelSize,
+                                const double yPixelSize, const double *xyc,
+                                const std::vector<double> &distortion);
+};
+} // namespace Core
+
+#include "ColmapModel.hpp"
+
+#endif // CORE_COLMAPMODEL_H
@@ -0,0 +1,267 @@
+#include "ColmapModel.h"
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "eigen3/Eigen/Geometry"
+
+#include "DistortionModel.h"
+#include "ExteriorOrientation.h"
+#include "ObservationTable.h"
+#include "TrackStore.h"
+
+namespace Core {
+template <typename TImageBlockType>
+ColmapModel ColmapModel::Create(const TImageBlockType &imageBlock) {
+  ColmapModel model;
+
+  // Cameras
+  const std::size_t numberOfCameras = imageBlock.getNumberOfCameras();
+  model.cameras.reserve(numberOfCameras);
+  for (Handle handle = 0; handle < numberOfCameras; ++handle) {
+    const auto &camera = *imageBlock.getCamera(handle);
+    const double xyc[3] = {static_cast<double>(camera.xyc[0]),
+                           static_cast<double>(camera.xyc[1]),
+                           static_cast<double>(camera.xyc[2])};
+    const auto &parameters = camera.distortionParameters;
+    const std::vector<double> distortion(
+        parameters.data(), parameters.data() + parameters.size());
+    model.cameras.push_back(ConvertFromIops(
+        handle + 1, camera.width, camera.height,
+        static_cast<double>(camera.xPixelSize),
+        static_cast<double>(camera.yPixelSize), xyc, distortion));
+  }
+
+  // Images, with their observations as image points
+  const auto &observations = imageBlock.getObservations();
+  const TrackStore &tracks = imageBlock.getTracks();
+  const std::size_t numberOfImages = imageBlock.getNumberOfImages();
+  // Index of the image point of every observation
+  std::vector<std::uint32_t> point2DIndices(observations.size());
+  model.images.resize(numberOfImages);
+  model.points2D.reserve(2 * observations.size());
+  model.point3DIds2D.reserve(observations.size());
+  const Eigen::Matrix3d flip = Eigen::Vector3d(1.0, -1.0, -1.0).asDiagonal();
+  for (Handle handle = 0; handle < numberOfImages; ++handle) {
+    const auto &image = *imageBlock.getImage(handle);
+    const Handle cameraHandle = imageBlock.getCameraHandleOfImage(handle);
+    if (cameraHandle == InvalidHandle) {
+      throw std::invalid_argument("Cannot find the camera of the image " +
+                                  imageBlock.getImageId(handle) + "!");
+    }
+
+    // Camera to mapping transformation, i.e., with the mounting parameters
+    // of the camera (and of its reference camera)
+    const auto &camera = *imageBlock.getCamera(cameraHandle);
+    Eigen::Matrix3d rotation =
+        image.getRotationMatrix().template cast<double>();
+    Eigen::Vector3d center = image.getTranslation().template cast<double>();
+    if (camera.getReferenceCameraId() != imageBlock.getCameraId(cameraHandle)) {
+      const auto &mounting =
+          imageBlock
+              .getCamera(
+                  imageBlock.getCameraHandle(camera.getReferenceCameraId()))
+              ->getMountingParameters();
+      center += rotation * mounting.getTranslation().template cast<double>();
+      rotation *= mounting.getRotationMatrix().template cast<double>();
+    }
+    const auto &mounting = camera.getMountingParameters();
+    center += rotation * mounting.getTranslation().template cast<double>();
+    rotation *= mounting.getRotationMatrix().template cast<double>();
+
+    // World to COLMAP camera transformation
+    Image &record = model.images[handle];
+    record.id = handle + 1;
+    record.cameraIndex = cameraHandle;
+    const Eigen::Matrix3d worldToCamera = flip * rotation.transpose();
+    const Eigen::Quaterniond quaternion(worldToCamera);
+    record.rotation[0] = quaternion.w();
+    record.rotation[1] = quaternion.x();
+    record.rotation[2] = quaternion.y();
+    record.rotation[3] = quaternion.z();
+    Eigen::Map<Eigen::Vector3d> translation(record.translation);
+    translation = -worldToCamera * center;
+    const auto &filePath = image.getImageFilePath();
+    record.name =
+        filePath ? filePath->string() : imageBlock.getImageId(handle);
+
+    const TrackStore::Range range = tracks.getImageObservations(handle);
+    record.firstPoint2D = model.point3DIds2D.size();
+    record.numberOfPoints2D = range.size();
+    for (std::size_t i = 0; i < range.size(); ++i) {
+      const TrackStore::Index index = range[i];
+      point2DIndices[index] = static_cast<std::uint32_t>(i);
+      model.points2D.push_back(static_cast<double>(observations.x[index]));
+      model.points2D.push_back(static_cast<double>(observations.y[index]));
+      model.point3DIds2D.push_back(observations.pointHandles[index] + 1);
+    }
+  }
+
+  // Object points and their tracks
+  const std::size_t numberOfPoints = imageBlock.getNumberOfObjectPoints();
+  model.point3DIds.resize(numberOfPoints);
+  model.points3D.resize(3 * numberOfPoints);
+  model.colors.assign(3 * numberOfPoints, 0);
+  model.errors.assign(numberOfPoints, -1.0);
+  model.trackOffsets.resize(numberOfPoints + 1);
+  model.trackImageIndices.reserve(observations.size());
+  model.trackPoint2DIndices.reserve(observations.size());
+  for (Handle handle = 0; handle < numberOfPoints; ++handle) {
+    const auto &point = imageBlock.getObjectPoint(handle);
+    model.point3DIds[handle] = handle + 1;
+    for (int i = 0; i < 3; ++i) {
+      model.points3D[3 * handle + i] = static_cast<double>(point[i]);
+    }
+    for (const TrackStore::Index index : tracks.getPointObservations(handle)) {
+      model.trackImageIndices.push_back(observations.imageHandles[index]);
+      model.trackPoint2DIndices.push_back(point2DIndices[index]);
+    }
+    model.trackOffsets[handle + 1] = model.trackImageIndices.size();
+  }
+  return model;
+}
+
+template <typename TImageBlockType>
+void ColmapModel::load(TImageBlockType &imageBlock) const {
+  using CameraType = typename TImageBlockType::CameraType;
+  using ImageType = typename TImageBlockType::ImageType;
+  using ObjectPointType = typename TImageBlockType::ObjectPointType;
+  using DataType = typename TImageBlockType::DataType;
+  static_assert(
+      std::is_same<typename CameraType::DistortionModel,
+                   RadialDistortion>::value ||
+          std::is_same<typename CameraType::DistortionModel,
+                       BrownDistortion>::value,
+      "COLMAP cameras can only be mapped onto radial or Brown distortions");
+  constexpr bool HasTangentialDistortion =
+      std::is_same<typename CameraType::DistortionModel,
+                   BrownDistortion>::value;
+  if (imageBlock.getNumberOfCameras() != 0 ||
+      imageBlock.getNumberOfImages() != 0 ||
+      imageBlock.getNumberOfObjectPoints() != 0) {
+    throw std::invalid_argument(
+        "COLMAP models can only be loaded into an empty image block!");
+  }
+  const std::size_t numberOfPoints = point3DIds.size();
+  imageBlock.reserve(cameras.size(), images.size(), numberOfPoints);
+
+  // Cameras
+  const ExteriorOrientation<DataType> mountingParameters;
+  for (const Camera &camera : cameras) {
+    const CameraIops converted = ConvertToIops(camera);
+    if (!HasTangentialDistortion &&
+        (converted.distortion[3] != 0.0 || converted.distortion[4] != 0.0)) {
+      throw std::invalid_argument(
+          "Tangential distortions require BrownDistortion!");
+    }
+    CameraType iops;
+    iops.width = static_cast<unsigned int>(camera.width);
+    iops.height = static_cast<unsigned int>(camera.height);
+    iops.xPixelSize = static_cast<DataType>(1);
+    iops.yPixelSize = static_cast<DataType>(converted.yPixelSize);
+    for (int i = 0; i < 3; ++i) {
+      iops.xyc[i] = static_cast<DataType>(converted.xyc[i]);
+    }
+    iops.distortionParameters.setZero();
+    for (int i = 0; i < (HasTangentialDistortion ? 5 : 3); ++i) {
+      iops.distortionParameters[i + 1] =
+          static_cast<DataType>(converted.distortion[i]);
+    }
+    const std::string cameraId = "camera" + std::to_string(camera.id);
+    if (!imageBlock.addCamera(cameraId, std::make_shared<CameraType>(
+                                            cameraId, mountingParameters,
+                                            iops))) {
+      throw std::invalid_argument("Duplicate camera " + cameraId + "!");
+    }
+  }
+
+  // Images
+  for (const Image &record : images) {
+    const Eigen::Matrix3d worldToCamera =
+        Eigen::Quaterniond(record.rotation[0], record.rotation[1],
+                           record.rotation[2], record.rotation[3])
+            .normalized()
+            .toRotationMatrix();
+    const Eigen::Vector3d center =
+        -worldToCamera.transpose() *
+        Eigen::Vector3d(record.translation[0], record.translation[1],
+                        record.translation[2]);
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId(imageBlock.getCameraId(record.cameraIndex));
+    image->setImageFilePath(record.name);
+    image->setTranslation(static_cast<DataType>(center[0]),
+                          static_cast<DataType>(center[1]),
+                          static_cast<DataType>(center[2]));
+    image->setRotationFromMatrix(
+        (worldToCamera.transpose() *
+         Eigen::Vector3d(1.0, -1.0, -1.0).asDiagonal())
+            .template cast<DataType>());
+    if (!imageBlock.addImage(record.name, image)) {
+      throw std::invalid_argument("Duplicate image " + record.name + "!");
+    }
+  }
+
+  // Object points
+  for (std::size_t i = 0; i < numberOfPoints; ++i) {
+    const double *point = points3D.data() + 3 * i;
+    if (!imageBlock.addObjectPoint("point" + std::to_string(point3DIds[i]),
+                                   ObjectPointType(point[0], point[1],
+                                                   point[2]))) {
+      throw std::invalid_argument("Duplicate object point " +
+                                  std::to_string(point3DIds[i]) + "!");
+    }
+  }
+
+  // Object point of every image point (from the tracks), so that the
+  // observations are added in the order of the image points, i.e., sorted by
+  // image
+  std::vector<Handle> pointHandles(point3DIds2D.size(), InvalidHandle);
+  for (std::size_t point = 0; point < numberOfPoints; ++point) {
+    for (std::uint64_t i = trackOffsets[point]; i < trackOffsets[point + 1];
+         ++i) {
+      pointHandles[images[trackImageIndices[i]].firstPoint2D +
+                   trackPoint2DIndices[i]] = static_cast<Handle>(point);
+    }
+  }
+
+  // Observations with unit weights, in bulk
+  ObservationTable<DataType> observations;
+  observations.resize(trackImageIndices.size());
+  std::size_t index = 0;
+  for (std::size_t imageIndex = 0; imageIndex < images.size(); ++imageIndex) {
+    const Image &image = images[imageIndex];
+    for (std::uint64_t i = image.firstPoint2D;
+         i < image.firstPoint2D + image.numberOfPoints2D; ++i) {
+      if (pointHandles[i] == InvalidHandle) {
+        continue;
+      }
+      observations.imageHandles[index] = static_cast<Handle>(imageIndex);
+      observations.pointHandles[index] = pointHandles[i];
+      observations.cameraHandles[index] = image.cameraIndex;
+      observations.x[index] = static_cast<DataType>(points2D[2 * i]);
+      observations.y[index] = static_cast<DataType>(points2D[2 * i + 1]);
+      observations.sqrtInformation[3 * index] = static_cast<DataType>(1);
+      observations.sqrtInformation[3 * index + 1] = static_cast<DataType>(0);
+      observations.sqrtInformation[3 * index + 2] = static_cast<DataType>(1);
+      ++index;
+    }
+  }
+  // Image points in more than one track are observed once
+  observations.resize(index);
+  observations.sortByImage();
+  imageBlock.setObservations(std::move(observations));
+}
+
+template <typename TImageBlockType>
+void ColmapModel::Import(const std::string &directory,
+                         TImageBlockType &imageBlock) {
+  Read(directory).load(imageBlock);
+}
+
+template <typename TImageBlockType>
+void ColmapModel::Export(const std::string &directory,
+                         const TImageBlockType &imageBlock) {
+  Create(imageBlock).write(directory);
+}
+} // namespace Core
@@ -0,0 +1,177 @@
+#ifndef CORE_COVARIANCEPOLICY_H
+#define CORE_COVARIANCEPOLICY_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "eigen3/Eigen/Eigen"
+#include "eigen3/Eigen/StdVector"
+
+namespace Core {
+/**
+ * Covariance storage policies of Core::Point.
+ * Every policy provides getCovariance() and setCovariance(), so that generic
+ * code does not depend on how the variance-covariance matrix is stored.
+ */
+
+/**
+ * Dense Dim x Dim variance-covariance matrix (default)
+ */
+template <typename TDataType, int Dim> class DenseCovariance {
+public:
+  DenseCovariance() = default;
+  explicit DenseCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  /// Get a copy of the variance-covariance matrix
+  Eigen::Matrix<TDataType, Dim, Dim> getCovariance() const;
+  /// Set the variance-covariance matrix
+  void setCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  /// N x N varaiance-covariance matrix
+  Eigen::Matrix<TDataType, Dim, Dim> covariance;
+};
+
+/**
+ * No variance-covariance matrix is stored. getCovariance() returns an
+ * identity matrix, and setCovariance() is a no-op.
+ */
+template <typename TDataType, int Dim> class NoCovariance {
+public:
+  NoCovariance() = default;
+  explicit NoCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  Eigen::Matrix<TDataType, Dim, Dim> getCovariance() const;
+  void setCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+};
+
+/**
+ * Isotropic variance-covariance matrix (i.e., sigma^2 * I)
+ * Note: setCovariance() keeps the mean of the diagonal elements.
+ */
+template <typename TDataType, int Dim> class IsotropicCovariance {
+public:
+  IsotropicCovariance() = default;
+  explicit IsotropicCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  Eigen::Matrix<TDataType, Dim, Dim> getCovariance() const;
+  void setCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  /// Variance shared by all components
+  TDataType variance = static_cast<TDataType>(1);
+};
+
+/**
+ * Diagonal variance-covariance matrix
+ * Note: setCovariance() drops the off-diagonal elements.
+ */
+template <typename TDataType, int Dim> class DiagonalCovariance {
+public:
+  DiagonalCovariance();
+  explicit DiagonalCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  Eigen::Matrix<TDataType, Dim, Dim> getCovariance() const;
+  void setCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  /// Variances of all components
+  Eigen::Matrix<TDataType, Dim, 1, Eigen::DontAlign> variances;
+};
+
+/**
+ * Packed upper-triangular variance-covariance matrix (row by row, i.e.,
+ * s00, s01, ..., s0n, s11, ..., snn)
+ */
+template <typename TDataType, int Dim> class PackedCovariance {
+public:
+  PackedCovariance();
+  explicit PackedCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  Eigen::Matrix<TDataType, Dim, Dim> getCovariance() const;
+  void setCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  /// Upper-triangular elements
+  Eigen::Matrix<TDataType, Dim *(Dim + 1) / 2, 1, Eigen::DontAlign> elements;
+};
+
+/**
+ * This is the pool of variance-covariance matrices shared by many points
+ * (e.g., all observations of a camera share the same sigma).
+ * Matrices are deduplicated on insertion, so that the pool only grows with
+ * the number of distinct matrices, and entries are never removed or moved, so
+ * that indices and references stay valid. add() is serialized by a mutex;
+ * get() and size() take no lock, so that parallel loops over pooled points do
+ * not contend.
+ * Note: There is one pool per (TDataType, Dim).
+ */
+template <typename TDataType, int Dim> class CovariancePool {
+public:
+  /// Get the pool instance
+  static CovariancePool &GetInstance();
+
+  /// Add a variance-covariance matrix to the pool unless it is in the pool
+  /// already, and return its index
+  std::uint32_t add(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+  /// Get the variance-covariance matrix at the given index
+  const Eigen::Matrix<TDataType, Dim, Dim> &get(const std::uint32_t index) const;
+  /// Return the number of matrices in the pool
+  std::uint32_t size() const;
+
+private:
+  using Matrix = Eigen::Matrix<TDataType, Dim, Dim>;
+
+  /// The k-th chunk holds FirstChunkSize * 2^k matrices, so that NumberOfChunks
+  /// chunks cover all 32-bit indices
+  static constexpr std::uint32_t FirstChunkSize = 16;
+  static constexpr unsigned int NumberOfChunks = 28;
+
+  /// Lexicographical order of the coefficients
+  struct MatrixLess {
+    bool operator()(const Matrix &lhs, const Matrix &rhs) const;
+  };
+
+  CovariancePool();
+
+  /// Get the chunk and the position in the chunk of the given index
+  static void Locate(const std::uint32_t index, unsigned int &chunk,
+                     std::size_t &position);
+
+  /// Serializes add()
+  std::mutex mMutex;
+  /// Number of matrices, which is published after a matrix is stored
+  std::atomic<std::uint32_t> mSize;
+  /// Matrices by index in chunks, which are allocated once and never moved
+  std::vector<Matrix, Eigen::aligned_allocator<Matrix>> mChunks[NumberOfChunks];
+  /// Indices by matrix
+  std::map<Matrix, std::uint32_t, MatrixLess,
+           Eigen::aligned_allocator<std::pair<const Matrix, std::uint32_t>>>
+      mIndices;
+};
+
+/**
+ * Index into the shared CovariancePool
+ * Note: The default index 0 refers to the identity matrix. setCovariance()
+ * looks the matrix up in the pool (adding it if needed); when many points
+ * share a matrix, add it to the pool once and use setCovarianceIndex().
+ */
+template <typename TDataType, int Dim> class PooledCovariance {
+public:
+  PooledCovariance() = default;
+  explicit PooledCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  Eigen::Matrix<TDataType, Dim, Dim> getCovariance() const;
+  void setCovariance(const Eigen::Matrix<TDataType, Dim, Dim> &var);
+
+  /// Accessor of the index into the pool
+  std::uint32_t getCovarianceIndex() const;
+  void setCovarianceIndex(const std::uint32_t index);
+
+private:
+  std::uint32_t mCovarianceIndex = 0;
+};
+} // namespace Core
+
+#include "CovariancePolicy.hpp"
+
+#endif // CORE_COVARIANCEPOLICY_H
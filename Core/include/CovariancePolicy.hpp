@@ -0,0 +1,233 @@
+#include "CovariancePolicy.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Core {
+/// DenseCovariance
+template <typename TDataType, int Dim>
+DenseCovariance<TDataType, Dim>::DenseCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var)
+    : covariance(var) {}
+
+template <typename TDataType, int Dim>
+Eigen::Matrix<TDataType, Dim, Dim>
+DenseCovariance<TDataType, Dim>::getCovariance() const {
+  return covariance;
+}
+
+template <typename TDataType, int Dim>
+void DenseCovariance<TDataType, Dim>::setCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  covariance = var;
+}
+
+/// NoCovariance
+template <typename TDataType, int Dim>
+NoCovariance<TDataType, Dim>::NoCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &) {}
+
+template <typename TDataType, int Dim>
+Eigen::Matrix<TDataType, Dim, Dim>
+NoCovariance<TDataType, Dim>::getCovariance() const {
+  return Eigen::Matrix<TDataType, Dim, Dim>::Identity();
+}
+
+template <typename TDataType, int Dim>
+void NoCovariance<TDataType, Dim>::setCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &) {}
+
+/// IsotropicCovariance
+template <typename TDataType, int Dim>
+IsotropicCovariance<TDataType, Dim>::IsotropicCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  setCovariance(var);
+}
+
+template <typename TDataType, int Dim>
+Eigen::Matrix<TDataType, Dim, Dim>
+IsotropicCovariance<TDataType, Dim>::getCovariance() const {
+  return variance * Eigen::Matrix<TDataType, Dim, Dim>::Identity();
+}
+
+template <typename TDataType, int Dim>
+void IsotropicCovariance<TDataType, Dim>::setCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  variance = var.trace() / static_cast<TDataType>(Dim);
+}
+
+/// DiagonalCovariance
+template <typename TDataType, int Dim>
+DiagonalCovariance<TDataType, Dim>::DiagonalCovariance()
+    : variances(Eigen::Matrix<TDataType, Dim, 1>::Ones()) {}
+
+template <typename TDataType, int Dim>
+DiagonalCovariance<TDataType, Dim>::DiagonalCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var)
+    : variances(var.diagonal()) {}
+
+template <typename TDataType, int Dim>
+Eigen::Matrix<TDataType, Dim, Dim>
+DiagonalCovariance<TDataType, Dim>::getCovariance() const {
+  Eigen::Matrix<TDataType, Dim, Dim> var =
+      Eigen::Matrix<TDataType, Dim, Dim>::Zero();
+  var.diagonal() = variances;
+  return var;
+}
+
+template <typename TDataType, int Dim>
+void DiagonalCovariance<TDataType, Dim>::setCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  variances = var.diagonal();
+}
+
+/// PackedCovariance
+template <typename TDataType, int Dim>
+PackedCovariance<TDataType, Dim>::PackedCovariance() {
+  setCovariance(Eigen::Matrix<TDataType, Dim, Dim>::Identity());
+}
+
+template <typename TDataType, int Dim>
+PackedCovariance<TDataType, Dim>::PackedCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  setCovariance(var);
+}
+
+template <typename TDataType, int Dim>
+Eigen::Matrix<TDataType, Dim, Dim>
+PackedCovariance<TDataType, Dim>::getCovariance() const {
+  Eigen::Matrix<TDataType, Dim, Dim> var;
+  int index = 0;
+  for (int row = 0; row < Dim; ++row) {
+    for (int col = row; col < Dim; ++col) {
+      var(row, col) = elements[index];
+      var(col, row) = elements[index];
+      ++index;
+    }
+  }
+  return var;
+}
+
+template <typename TDataType, int Dim>
+void PackedCovariance<TDataType, Dim>::setCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  int index = 0;
+  for (int row = 0; row < Dim; ++row) {
+    for (int col = row; col < Dim; ++col) {
+      elements[index++] = var(row, col);
+    }
+  }
+}
+
+/// CovariancePool
+template <typename TDataType, int Dim>
+CovariancePool<TDataType, Dim> &CovariancePool<TDataType, Dim>::GetInstance() {
+  static CovariancePool pool;
+  return pool;
+}
+
+template <typename TDataType, int Dim>
+bool CovariancePool<TDataType, Dim>::MatrixLess::operator()(
+    const Matrix &lhs, const Matrix &rhs) const {
+  return std::lexicographical_compare(lhs.data(), lhs.data() + lhs.size(),
+                                      rhs.data(), rhs.data() + rhs.size());
+}
+
+template <typename TDataType, int Dim>
+constexpr std::uint32_t CovariancePool<TDataType, Dim>::FirstChunkSize;
+
+template <typename TDataType, int Dim>
+constexpr unsigned int CovariancePool<TDataType, Dim>::NumberOfChunks;
+
+template <typename TDataType, int Dim>
+CovariancePool<TDataType, Dim>::CovariancePool() : mSize(0) {
+  // The identity matrix is the default entry at index 0
+  add(Matrix::Identity());
+}
+
+template <typename TDataType, int Dim>
+void CovariancePool<TDataType, Dim>::Locate(const std::uint32_t index,
+                                            unsigned int &chunk,
+                                            std::size_t &position) {
+  // The k-th chunk starts at FirstChunkSize * (2^k - 1)
+  const std::uint64_t scaledIndex = index / FirstChunkSize + 1;
+  chunk = 0;
+  while ((scaledIndex >> (chunk + 1)) != 0) {
+    ++chunk;
+  }
+  position = static_cast<std::size_t>(
+      index - FirstChunkSize * ((std::uint64_t(1) << chunk) - 1));
+}
+
+template <typename TDataType, int Dim>
+std::uint32_t CovariancePool<TDataType, Dim>::add(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  const auto it = mIndices.find(var);
+  if (it != mIndices.end()) {
+    return it->second;
+  }
+  const std::uint32_t index = mSize.load(std::memory_order_relaxed);
+  unsigned int chunk;
+  std::size_t position;
+  Locate(index, chunk, position);
+  if (chunk >= NumberOfChunks) {
+    throw std::length_error("Too many matrices in the pool!");
+  }
+  if (mChunks[chunk].empty()) {
+    mChunks[chunk].resize(std::size_t(FirstChunkSize) << chunk);
+  }
+  mChunks[chunk][position] = var;
+  mIndices.emplace(var, index);
+  // Publish the matrix (and its chunk) to get() in other threads
+  mSize.store(index + 1, std::memory_order_release);
+  return index;
+}
+
+template <typename TDataType, int Dim>
+const Eigen::Matrix<TDataType, Dim, Dim> &
+CovariancePool<TDataType, Dim>::get(const std::uint32_t index) const {
+  if (index >= mSize.load(std::memory_order_acquire)) {
+    throw std::out_of_range("Cannot find the given index in the pool!");
+  }
+  unsigned int chunk;
+  std::size_t position;
+  Locate(index, chunk, position);
+  return mChunks[chunk][position];
+}
+
+template <typename TDataType, int Dim>
+std::uint32_t CovariancePool<TDataType, Dim>::size() const {
+  return mSize.load(std::memory_order_acquire);
+}
+
+/// PooledCovariance
+template <typename TDataType, int Dim>
+PooledCovariance<TDataType, Dim>::PooledCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  setCovariance(var);
+}
+
+template <typename TDataType, int Dim>
+Eigen::Matrix<TDataType, Dim, Dim>
+PooledCovariance<TDataType, Dim>::getCovariance() const {
+  return CovariancePool<TDataType, Dim>::GetInstance().get(mCovarianceIndex);
+}
+
+template <typename TDataType, int Dim>
+void PooledCovariance<TDataType, Dim>::setCovariance(
+    const Eigen::Matrix<TDataType, Dim, Dim> &var) {
+  mCovarianceIndex = CovariancePool<TDataType, Dim>::GetInstance().add(var);
+}
+
+template <typename TDataType, int Dim>
+std::uint32_t PooledCovariance<TDataType, Dim>::getCovarianceIndex() const {
+  return mCovarianceIndex;
+}
+
+template <typename TDataType, int Dim>
+void PooledCovariance<TDataType, Dim>::setCovarianceIndex(
+    const std::uint32_t index) {
+  mCovarianceIndex = index;
+}
+} // namespace Core
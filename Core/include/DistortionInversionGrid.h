@@ -0,0 +1,90 @@
+#ifndef CORE_DISTORTIONINVERSIONGRID_H
+#define CORE_DISTORTIONINVERSIONGRID_H
+
+#include <vector>
+
+#include "eigen3/Eigen/Core"
+
+namespace Core {
+/**
+ * This is the class for a regular lookup grid of the inverse distortion of a
+ * camera, i.e., the offsets to add to distortion-free image coordinates
+ * (relative to the principal point) to get the distorted ones. Offsets are
+ * sampled at the grid nodes and interpolated in between, either bilinearly
+ * (error of O(h^2) for a cell size h) or bicubically with Catmull-Rom splines
+ * (error of O(h^3), i.e., far fewer nodes for the same accuracy).
+ * Note: The grid is a snapshot of the IOPs it was built with (see
+ * InteriorOrientation::buildDistortionInversionGrid).
+ */
+template <typename TDataType = double> class DistortionInversionGrid {
+public:
+  /// Interpolation between the grid nodes
+  enum class Interpolation { Bilinear, Bicubic };
+
+  /// Default constructor
+  DistortionInversionGrid() = default;
+
+  /**
+   * Sample the offsets at all nodes of a regular grid
+   * @param[in] minimum Lower left corner of the grid
+   * @param[in] maximum Upper right corner of the grid
+   * @param[in] numberOfCellsX The number of cells along x
+   * @param[in] numberOfCellsY The number of cells along y
+   * @param[in] offsetFunction Function returning the 2 x 1 offset at given
+   * distortion-free image coordinates
+   * @param[in] interpolation Interpolation between the grid nodes
+   */
+  template <typename TOffsetFunction>
+  void build(const Eigen::Matrix<TDataType, 2, 1> &minimum,
+             const Eigen::Matrix<TDataType, 2, 1> &maximum,
+             const unsigned int numberOfCellsX,
+             const unsigned int numberOfCellsY, TOffsetFunction offsetFunction,
+             const Interpolation interpolation = Interpolation::Bicubic);
+
+  /**
+   * Interpolate the offset at given distortion-free image coordinates
+   * @param[out] offset The 2 x 1 interpolated offset
+   * @return False if the point is outside of the grid
+   */
+  bool interpolate(const TDataType x, const TDataType y,
+                   Eigen::Matrix<TDataType, 2, 1> &offset) const;
+
+  /// Check if the grid has been built
+  bool empty() const;
+
+  /// Get the interpolation between the grid nodes
+  Interpolation getInterpolation() const;
+
+  /// Get the number of cells along x and y
+  unsigned int getNumberOfCellsX() const;
+  unsigned int getNumberOfCellsY() const;
+
+  /// Get the memory usage of the samples in bytes
+  std::size_t getMemoryUsage() const;
+
+private:
+  /// Catmull-Rom weights of four consecutive nodes at the relative position
+  /// t in [0, 1] between the two middle ones
+  static void CatmullRomWeights(const TDataType t, TDataType *weights);
+
+  /// Lower left corner, spacing and inverse spacing of the grid
+  Eigen::Matrix<TDataType, 2, 1> mMinimum =
+      Eigen::Matrix<TDataType, 2, 1>::Zero();
+  Eigen::Matrix<TDataType, 2, 1> mSpacing =
+      Eigen::Matrix<TDataType, 2, 1>::Ones();
+  Eigen::Matrix<TDataType, 2, 1> mInverseSpacing =
+      Eigen::Matrix<TDataType, 2, 1>::Ones();
+  unsigned int mNumberOfCellsX = 0;
+  unsigned int mNumberOfCellsY = 0;
+  Interpolation mInterpolation = Interpolation::Bicubic;
+  /// Offsets at the nodes and the ring around them (row-major, i.e.,
+  /// index = (iy + 1) * (nx + 3) + ix + 1 for iy in [-1, ny + 1] and ix in
+  /// [-1, nx + 1])
+  std::vector<TDataType> mOffsetsX;
+  std::vector<TDataType> mOffsetsY;
+};
+} // namespace Core
+
+#include "DistortionInversionGrid.hpp"
+
+#endif // CORE_DISTORTIONINVERSIONGRID_H
@@ -0,0 +1,135 @@
+#include "DistortionInversionGrid.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Core {
+template <typename TDataType>
+template <typename TOffsetFunction>
+void DistortionInversionGrid<TDataType>::build(
+    const Eigen::Matrix<TDataType, 2, 1> &minimum,
+    const Eigen::Matrix<TDataType, 2, 1> &maximum,
+    const unsigned int numberOfCellsX, const unsigned int numberOfCellsY,
+    TOffsetFunction offsetFunction, const Interpolation interpolation) {
+  if (numberOfCellsX == 0 || numberOfCellsY == 0 ||
+      !(maximum[0] > minimum[0]) || !(maximum[1] > minimum[1])) {
+    throw std::invalid_argument(
+        "Cannot build a distortion inversion grid with an empty extent!");
+  }
+  mMinimum = minimum;
+  mSpacing[0] = (maximum[0] - minimum[0]) / numberOfCellsX;
+  mSpacing[1] = (maximum[1] - minimum[1]) / numberOfCellsY;
+  mInverseSpacing = mSpacing.cwiseInverse();
+  mNumberOfCellsX = numberOfCellsX;
+  mNumberOfCellsY = numberOfCellsY;
+  mInterpolation = interpolation;
+
+  // Note: A ring of nodes around the grid is sampled as well, so that the
+  // bicubic interpolation needs no special case at the borders.
+  const std::size_t stride = numberOfCellsX + 3;
+  const std::size_t numberOfNodes =
+      stride * static_cast<std::size_t>(numberOfCellsY + 3);
+  mOffsetsX.resize(numberOfNodes);
+  mOffsetsY.resize(numberOfNodes);
+  std::size_t index = 0;
+  for (int iy = -1; iy <= static_cast<int>(numberOfCellsY) + 1; ++iy) {
+    const TDataType y = minimum[1] + iy * mSpacing[1];
+    for (int ix = -1; ix <= static_cast<int>(numberOfCellsX) + 1;
+         ++ix, ++index) {
+      const TDataType x = minimum[0] + ix * mSpacing[0];
+      const Eigen::Matrix<TDataType, 2, 1> offset = offsetFunction(x, y);
+      mOffsetsX[index] = offset[0];
+      mOffsetsY[index] = offset[1];
+    }
+  }
+}
+
+template <typename TDataType>
+bool DistortionInversionGrid<TDataType>::interpolate(
+    const TDataType x, const TDataType y,
+    Eigen::Matrix<TDataType, 2, 1> &offset) const {
+  // Continuous cell coordinates
+  const TDataType u = (x - mMinimum[0]) * mInverseSpacing[0];
+  const TDataType v = (y - mMinimum[1]) * mInverseSpacing[1];
+  if (!(u >= 0 && v >= 0 && u <= mNumberOfCellsX && v <= mNumberOfCellsY)) {
+    return false;
+  }
+  // Clamp the last node into the last cell
+  const unsigned int ix =
+      std::min(static_cast<unsigned int>(u), mNumberOfCellsX - 1);
+  const unsigned int iy =
+      std::min(static_cast<unsigned int>(v), mNumberOfCellsY - 1);
+  const TDataType fx = u - ix;
+  const TDataType fy = v - iy;
+  const std::size_t stride = mNumberOfCellsX + 3;
+  // Index of the lower left node of the cell (skipping the ring of nodes)
+  const std::size_t index00 = (iy + 1) * stride + ix + 1;
+  if (mInterpolation == Interpolation::Bicubic) {
+    // Catmull-Rom weights of the nodes -1, 0, 1 and 2 around the cell
+    TDataType weightsX[4];
+    TDataType weightsY[4];
+    CatmullRomWeights(fx, weightsX);
+    CatmullRomWeights(fy, weightsY);
+    offset.setZero();
+    std::size_t row = index00 - stride - 1;
+    for (int j = 0; j < 4; ++j, row += stride) {
+      TDataType rowOffsetX = 0;
+      TDataType rowOffsetY = 0;
+      for (int i = 0; i < 4; ++i) {
+        rowOffsetX += weightsX[i] * mOffsetsX[row + i];
+        rowOffsetY += weightsX[i] * mOffsetsY[row + i];
+      }
+      offset[0] += weightsY[j] * rowOffsetX;
+      offset[1] += weightsY[j] * rowOffsetY;
+    }
+    return true;
+  }
+  const std::size_t index10 = index00 + stride;
+  const TDataType w00 = (1 - fx) * (1 - fy);
+  const TDataType w01 = fx * (1 - fy);
+  const TDataType w10 = (1 - fx) * fy;
+  const TDataType w11 = fx * fy;
+  offset[0] = w00 * mOffsetsX[index00] + w01 * mOffsetsX[index00 + 1] +
+              w10 * mOffsetsX[index10] + w11 * mOffsetsX[index10 + 1];
+  offset[1] = w00 * mOffsetsY[index00] + w01 * mOffsetsY[index00 + 1] +
+              w10 * mOffsetsY[index10] + w11 * mOffsetsY[index10 + 1];
+  return true;
+}
+
+template <typename TDataType>
+void DistortionInversionGrid<TDataType>::CatmullRomWeights(const TDataType t,
+                                                           TDataType *weights) {
+  const TDataType t2 = t * t;
+  const TDataType t3 = t2 * t;
+  weights[0] = static_cast<TDataType>(0.5) * (-t3 + 2 * t2 - t);
+  weights[1] = static_cast<TDataType>(0.5) * (3 * t3 - 5 * t2 + 2);
+  weights[2] = static_cast<TDataType>(0.5) * (-3 * t3 + 4 * t2 + t);
+  weights[3] = static_cast<TDataType>(0.5) * (t3 - t2);
+}
+
+template <typename TDataType>
+bool DistortionInversionGrid<TDataType>::empty() const {
+  return mOffsetsX.empty();
+}
+
+template <typename TDataType>
+typename DistortionInversionGrid<TDataType>::Interpolation
+DistortionInversionGrid<TDataType>::getInterpolation() const {
+  return mInterpolation;
+}
+
+template <typename TDataType>
+unsigned int DistortionInversionGrid<TDataType>::getNumberOfCellsX() const {
+  return mNumberOfCellsX;
+}
+
+template <typename TDataType>
+unsigned int DistortionInversionGrid<TDataType>::getNumberOfCellsY() const {
+  return mNumberOfCellsY;
+}
+
+template <typename TDataType>
+std::size_t DistortionInversionGrid<TDataType>::getMemoryUsage() const {
+  return (mOffsetsX.capacity() + mOffsetsY.capacity()) * sizeof(TDataType);
+}
+} // namespace Core
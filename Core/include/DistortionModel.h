@@ -0,0 +1,143 @@
+#ifndef CORE_DISTORTIONMODEL_H
+#define CORE_DISTORTIONMODEL_H
+
+#include "eigen3/Eigen/Core"
+
+namespace Core {
+/**
+ * Distortion models of Core::InteriorOrientation.
+ * Every model provides the number of its distortion parameters at compile
+ * time, and evaluates the distortions (and their partial derivatives) at an
+ * image point relative to the principal point (i.e., dx = x - xp and
+ * dy = y - yp). Like the default model, distortions are defined at the
+ * distorted (i.e., measured) image point, so that x - xp - distortion is the
+ * distortion-free (perspective) image point.
+ * Note: All functions are static and templated on the scalar type, so that
+ * they inline into the (automatically differentiated) cost functions. Compute
+ * is force-inlined, so that batch loops over many points (e.g.,
+ * InteriorOrientation::convertPixelsToImageCoordinates) are vectorized.
+ */
+
+/**
+ * Radial distortion only
+ * Parameters: k0, k1, k2 and k3, i.e., distortion = (k0 + k1 * r^2 + k2 * r^4
+ * + k3 * r^6) * (dx, dy)
+ */
+struct RadialDistortion {
+  /// Number of distortion parameters
+  static constexpr int NumberOfParameters = 4;
+
+  /**
+   * Compute the distortions at an image point
+   * @param[in] params Distortion parameters (NumberOfParameters x 1 array)
+   * @param[in] c Principal distance
+   * @param[in] dx x coordinate of the image point relative to xp
+   * @param[in] dy y coordinate of the image point relative to yp
+   * @param[out] distortion The 2 x 1 array of image distortions
+   */
+  template <typename TDataType>
+  static void Compute(const TDataType *const params, const TDataType c,
+                      const TDataType dx, const TDataType dy,
+                      TDataType *distortion);
+
+  /**
+   * Compute the partial derivatives of the distortions
+   * @param[out] pointJacobian d(distortion)/d(dx, dy)
+   * @param[out] parameterJacobian d(distortion)/d(c, params) (skipped if
+   * nullptr)
+   * The other parameters are the same as the ones of Compute.
+   */
+  template <typename TDataType>
+  static void ComputeJacobians(
+      const TDataType *const params, const TDataType c, const TDataType dx,
+      const TDataType dy, Eigen::Matrix<TDataType, 2, 2> &pointJacobian,
+      Eigen::Matrix<TDataType, 2, 1 + NumberOfParameters, Eigen::RowMajor>
+          *parameterJacobian);
+};
+
+/**
+ * Radial, de-centric and affine distortions (i.e., the default model of
+ * Core::InteriorOrientation)
+ * Parameters:
+ * 4 radial distortion parameters: k0, k1, k2 and k3 (see RadialDistortion)
+ * 3 de-centric distortion parameters: p1, p2 and p3
+ * 2 affine distortion parameters: a1 and a2
+ */
+struct BrownDistortion {
+  /// Number of distortion parameters
+  static constexpr int NumberOfParameters = 9;
+
+  /// See RadialDistortion::Compute
+  template <typename TDataType>
+  static void Compute(const TDataType *const params, const TDataType c,
+                      const TDataType dx, const TDataType dy,
+                      TDataType *distortion);
+
+  /// See RadialDistortion::ComputeJacobians
+  template <typename TDataType>
+  static void ComputeJacobians(
+      const TDataType *const params, const TDataType c, const TDataType dx,
+      const TDataType dy, Eigen::Matrix<TDataType, 2, 2> &pointJacobian,
+      Eigen::Matrix<TDataType, 2, 1 + NumberOfParameters, Eigen::RowMajor>
+          *parameterJacobian);
+};
+
+/**
+ * Equidistant fisheye distortion
+ * The distorted radius is proportional to the incidence angle, i.e.,
+ * r = c * thetaD, and the incidence angle is corrected by
+ * theta = thetaD * (1 + k1 * thetaD^2 + k2 * thetaD^4 + k3 * thetaD^6 +
+ * k4 * thetaD^8). The distortion-free image point is at the perspective radius
+ * c * tan(theta), i.e., distortion = (1 - tan(theta) / thetaD) * (dx, dy).
+ * Parameters: k1, k2, k3 and k4
+ * Note: Incidence angles of 90 degrees and more cannot be represented by the
+ * collinearity model.
+ */
+struct EquidistantDistortion {
+  /// Number of distortion parameters
+  static constexpr int NumberOfParameters = 4;
+
+  /// See RadialDistortion::Compute
+  template <typename TDataType>
+  static void Compute(const TDataType *const params, const TDataType c,
+                      const TDataType dx, const TDataType dy,
+                      TDataType *distortion);
+
+  /// See RadialDistortion::ComputeJacobians
+  template <typename TDataType>
+  static void ComputeJacobians(
+      const TDataType *const params, const TDataType c, const TDataType dx,
+      const TDataType dy, Eigen::Matrix<TDataType, 2, 2> &pointJacobian,
+      Eigen::Matrix<TDataType, 2, 1 + NumberOfParameters, Eigen::RowMajor>
+          *parameterJacobian);
+
+private:
+  /**
+   * Compute tan(theta) / thetaD and thetaD^2 (and, optionally, the derivative
+   * of the former w.r.t. thetaD divided by thetaD, and 1 / cos(theta)^2)
+   */
+  template <typename TDataType>
+  static TDataType ComputeRatio(const TDataType *const params,
+                                const TDataType c, const TDataType dx,
+                                const TDataType dy, TDataType &thetaD2,
+                                TDataType *ratioDerivative,
+                                TDataType *secant2);
+};
+
+/**
+ * Default distortion model for a given number of distortion parameters
+ * (i.e., BrownDistortion for 9 and RadialDistortion for 4 parameters)
+ * Note: There is no default for other numbers of parameters.
+ */
+template <int Size> struct DefaultDistortionModel;
+template <> struct DefaultDistortionModel<9> {
+  using Type = BrownDistortion;
+};
+template <> struct DefaultDistortionModel<4> {
+  using Type = RadialDistortion;
+};
+} // namespace Core
+
+#include "DistortionModel.hpp"
+
+#endif // CORE_DISTORTIONMODEL_H
@@ -0,0 +1,244 @@
+#include "DistortionModel.h"
+
+#include <cmath>
+
+namespace Core {
+/// RadialDistortion
+template <typename TDataType>
+EIGEN_STRONG_INLINE void
+RadialDistortion::Compute(const TDataType *const params, const TDataType,
+                          const TDataType dx, const TDataType dy,
+                          TDataType *distortion) {
+  const TDataType r2 = dx * dx + dy * dy;
+  const TDataType radialDistortion = params[0] + params[1] * r2 +
+                                     params[2] * r2 * r2 +
+                                     params[3] * r2 * r2 * r2;
+  distortion[0] = dx * radialDistortion;
+  distortion[1] = dy * radialDistortion;
+}
+
+template <typename TDataType>
+void RadialDistortion::ComputeJacobians(
+    const TDataType *const params, const TDataType, const TDataType dx,
+    const TDataType dy, Eigen::Matrix<TDataType, 2, 2> &pointJacobian,
+    Eigen::Matrix<TDataType, 2, 1 + NumberOfParameters, Eigen::RowMajor>
+        *parameterJacobian) {
+  const TDataType dxy = dx * dy;
+  const TDataType dx2 = dx * dx;
+  const TDataType dy2 = dy * dy;
+  const TDataType r2 = dx2 + dy2;
+  const TDataType r4 = r2 * r2;
+  const TDataType &k0 = params[0];
+  const TDataType &k1 = params[1];
+  const TDataType &k2 = params[2];
+  const TDataType &k3 = params[3];
+  // Radial distortion and its derivative w.r.t. r2
+  const TDataType radialDistortion = k0 + k1 * r2 + k2 * r4 + k3 * r4 * r2;
+  const TDataType radialDerivative = k1 + 2.0 * k2 * r2 + 3.0 * k3 * r4;
+  pointJacobian(0, 0) = radialDistortion + 2.0 * dx2 * radialDerivative;
+  pointJacobian(0, 1) = 2.0 * dxy * radialDerivative;
+  pointJacobian(1, 0) = pointJacobian(0, 1);
+  pointJacobian(1, 1) = radialDistortion + 2.0 * dy2 * radialDerivative;
+  if (parameterJacobian == nullptr) {
+    return;
+  }
+  auto &jacobian = *parameterJacobian;
+  // c
+  jacobian(0, 0) = static_cast<TDataType>(0);
+  jacobian(1, 0) = static_cast<TDataType>(0);
+  // k0, k1, k2 and k3
+  jacobian(0, 1) = dx;
+  jacobian(0, 2) = dx * r2;
+  jacobian(0, 3) = dx * r4;
+  jacobian(0, 4) = dx * r4 * r2;
+  jacobian(1, 1) = dy;
+  jacobian(1, 2) = dy * r2;
+  jacobian(1, 3) = dy * r4;
+  jacobian(1, 4) = dy * r4 * r2;
+}
+
+/// BrownDistortion
+template <typename TDataType>
+EIGEN_STRONG_INLINE void
+BrownDistortion::Compute(const TDataType *const params, const TDataType c,
+                         const TDataType dx, const TDataType dy,
+                         TDataType *distortion) {
+  // Radial distortion
+  RadialDistortion::Compute(params, c, dx, dy, distortion);
+  const TDataType dxy = dx * dy;
+  const TDataType dx2 = dx * dx;
+  const TDataType dy2 = dy * dy;
+  const TDataType r2 = dx2 + dy2;
+  // De-centric distortion
+  const TDataType &p1 = params[4];
+  const TDataType &p2 = params[5];
+  const TDataType &p3 = params[6];
+  const TDataType decentricDistortion = static_cast<TDataType>(1) + p3 * r2;
+  distortion[0] +=
+      decentricDistortion * (p1 * (r2 + 2.0 * dx2) + 2.0 * p2 * dxy);
+  distortion[1] +=
+      decentricDistortion * (2.0 * p1 * dxy + p2 * (r2 + 2.0 * dy2));
+  // Affine distortion
+  const TDataType &a1 = params[7];
+  const TDataType &a2 = params[8];
+  distortion[0] += -a1 * dx + a2 * dy;
+  distortion[1] += a1 * dy;
+}
+
+template <typename TDataType>
+void BrownDistortion::ComputeJacobians(
+    const TDataType *const params, const TDataType c, const TDataType dx,
+    const TDataType dy, Eigen::Matrix<TDataType, 2, 2> &pointJacobian,
+    Eigen::Matrix<TDataType, 2, 1 + NumberOfParameters, Eigen::RowMajor>
+        *parameterJacobian) {
+  // Radial distortion
+  Eigen::Matrix<TDataType, 2, 1 + RadialDistortion::NumberOfParameters,
+                Eigen::RowMajor>
+      radialJacobian;
+  RadialDistortion::ComputeJacobians(
+      params, c, dx, dy, pointJacobian,
+      parameterJacobian == nullptr ? nullptr : &radialJacobian);
+  const TDataType dxy = dx * dy;
+  const TDataType dx2 = dx * dx;
+  const TDataType dy2 = dy * dy;
+  const TDataType r2 = dx2 + dy2;
+  // De-centric distortion
+  const TDataType &p1 = params[4];
+  const TDataType &p2 = params[5];
+  const TDataType &p3 = params[6];
+  const TDataType decentricDistortion = static_cast<TDataType>(1) + p3 * r2;
+  const TDataType decentricX = p1 * (r2 + 2.0 * dx2) + 2.0 * p2 * dxy;
+  const TDataType decentricY = 2.0 * p1 * dxy + p2 * (r2 + 2.0 * dy2);
+  // Affine distortion
+  const TDataType &a1 = params[7];
+  const TDataType &a2 = params[8];
+
+  pointJacobian(0, 0) += 2.0 * p3 * dx * decentricX +
+                         decentricDistortion * (6.0 * p1 * dx + 2.0 * p2 * dy) -
+                         a1;
+  pointJacobian(0, 1) += 2.0 * p3 * dy * decentricX +
+                         decentricDistortion * (2.0 * p1 * dy + 2.0 * p2 * dx) +
+                         a2;
+  pointJacobian(1, 0) += 2.0 * p3 * dx * decentricY +
+                         decentricDistortion * (2.0 * p1 * dy + 2.0 * p2 * dx);
+  pointJacobian(1, 1) += 2.0 * p3 * dy * decentricY +
+                         decentricDistortion * (2.0 * p1 * dx + 6.0 * p2 * dy) +
+                         a1;
+  if (parameterJacobian == nullptr) {
+    return;
+  }
+  auto &jacobian = *parameterJacobian;
+  // c, k0, k1, k2 and k3
+  jacobian.template leftCols<1 + RadialDistortion::NumberOfParameters>() =
+      radialJacobian;
+  // p1, p2 and p3
+  jacobian(0, 5) = decentricDistortion * (r2 + 2.0 * dx2);
+  jacobian(0, 6) = decentricDistortion * 2.0 * dxy;
+  jacobian(0, 7) = r2 * decentricX;
+  jacobian(1, 5) = decentricDistortion * 2.0 * dxy;
+  jacobian(1, 6) = decentricDistortion * (r2 + 2.0 * dy2);
+  jacobian(1, 7) = r2 * decentricY;
+  // a1 and a2
+  jacobian(0, 8) = -dx;
+  jacobian(0, 9) = dy;
+  jacobian(1, 8) = dy;
+  jacobian(1, 9) = static_cast<TDataType>(0);
+}
+
+/// EquidistantDistortion
+template <typename TDataType>
+TDataType EquidistantDistortion::ComputeRatio(
+    const TDataType *const params, const TDataType c, const TDataType dx,
+    const TDataType dy, TDataType &thetaD2, TDataType *ratioDerivative,
+    TDataType *secant2) {
+  using std::sqrt;
+  using std::tan;
+  const TDataType &k1 = params[0];
+  const TDataType &k2 = params[1];
+  const TDataType &k3 = params[2];
+  const TDataType &k4 = params[3];
+  thetaD2 = (dx * dx + dy * dy) / (c * c);
+  // theta = thetaD * g, where g is a polynomial in thetaD^2
+  const TDataType g =
+      1.0 + thetaD2 * (k1 + thetaD2 * (k2 + thetaD2 * (k3 + thetaD2 * k4)));
+  // d(g)/d(thetaD^2)
+  const TDataType gDerivative =
+      k1 + thetaD2 * (2.0 * k2 + thetaD2 * (3.0 * k3 + thetaD2 * 4.0 * k4));
+  const TDataType theta2 = thetaD2 * g * g;
+  TDataType ratio;
+  if (theta2 < 1e-8) {
+    // Taylor series of tan(theta) / theta close to the principal point
+    const TDataType tangentRatio =
+        1.0 + theta2 / 3.0 + 2.0 * theta2 * theta2 / 15.0;
+    ratio = g * tangentRatio;
+    if (ratioDerivative != nullptr) {
+      // d(ratio)/d(thetaD) / thetaD = 2 * d(ratio)/d(thetaD^2)
+      const TDataType tangentRatioDerivative = 1.0 / 3.0 + 4.0 * theta2 / 15.0;
+      *ratioDerivative =
+          2.0 * (gDerivative * tangentRatio +
+                 g * tangentRatioDerivative *
+                     (g * g + 2.0 * thetaD2 * g * gDerivative));
+    }
+  } else {
+    const TDataType thetaD = sqrt(thetaD2);
+    ratio = tan(thetaD * g) / thetaD;
+    if (ratioDerivative != nullptr) {
+      // d(theta)/d(thetaD)
+      const TDataType thetaDerivative = g + 2.0 * thetaD2 * gDerivative;
+      *ratioDerivative =
+          ((1.0 + ratio * ratio * thetaD2) * thetaDerivative - ratio) / thetaD2;
+    }
+  }
+  if (secant2 != nullptr) {
+    // 1 / cos(theta)^2 = 1 + tan(theta)^2
+    *secant2 = 1.0 + ratio * ratio * thetaD2;
+  }
+  return ratio;
+}
+
+template <typename TDataType>
+EIGEN_STRONG_INLINE void
+EquidistantDistortion::Compute(const TDataType *const params, const TDataType c,
+                               const TDataType dx, const TDataType dy,
+                               TDataType *distortion) {
+  TDataType thetaD2;
+  const TDataType ratio =
+      ComputeRatio<TDataType>(params, c, dx, dy, thetaD2, nullptr, nullptr);
+  distortion[0] = dx * (1.0 - ratio);
+  distortion[1] = dy * (1.0 - ratio);
+}
+
+template <typename TDataType>
+void EquidistantDistortion::ComputeJacobians(
+    const TDataType *const params, const TDataType c, const TDataType dx,
+    const TDataType dy, Eigen::Matrix<TDataType, 2, 2> &pointJacobian,
+    Eigen::Matrix<TDataType, 2, 1 + NumberOfParameters, Eigen::RowMajor>
+        *parameterJacobian) {
+  TDataType thetaD2;
+  TDataType ratioDerivative;
+  TDataType secant2;
+  const TDataType ratio = ComputeRatio<TDataType>(
+      params, c, dx, dy, thetaD2, &ratioDerivative, &secant2);
+  // d(ratio)/d(dx, dy) = ratioDerivative * (dx, dy) / c^2
+  const TDataType scale = ratioDerivative / (c * c);
+  pointJacobian(0, 0) = 1.0 - ratio - scale * dx * dx;
+  pointJacobian(0, 1) = -scale * dx * dy;
+  pointJacobian(1, 0) = pointJacobian(0, 1);
+  pointJacobian(1, 1) = 1.0 - ratio - scale * dy * dy;
+  if (parameterJacobian == nullptr) {
+    return;
+  }
+  auto &jacobian = *parameterJacobian;
+  // c (note: d(thetaD^2)/dc = -2 * thetaD^2 / c)
+  const TDataType cDerivative = ratioDerivative * thetaD2 / c;
+  jacobian(0, 0) = dx * cDerivative;
+  jacobian(1, 0) = dy * cDerivative;
+  // k1, k2, k3 and k4 (note: d(ratio)/dki = thetaD^(2 * i) / cos(theta)^2)
+  TDataType power = secant2;
+  for (int i = 1; i <= NumberOfParameters; ++i) {
+    power *= thetaD2;
+    jacobian(0, i) = -dx * power;
+    jacobian(1, i) = -dy * power;
+  }
+}
+} // namespace Core
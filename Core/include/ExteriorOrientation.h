@@ -40,6 +40,23 @@ public:
                    const Eigen::Matrix<TDataType, 3, 3> &var =
                        Eigen::Matrix<TDataType, 3, 3>::Identity(3, 3));
 
+  /**
+   * Set up rotation from a rotation matrix (e.g., from a quaternion or an
+   * angle-axis vector via Eigen)
+   * Note: The rotation is stored as Euler angles, so this function is meant
+   * for import and export only. Near gimbal lock (i.e., phi = +/- 90 degrees),
+   * kappa is set to zero (see GetEulerAnglesInRadiansFromRotationMatrix).
+   * @param[in] rotationMatrix The 3 x 3 rotation matrix
+   * @param[in] inDegreeFlag flag used to indicate whether the rotation is
+   * stored in degrees (True) or radians (False)
+   * @param[in] var variance-covariance matrix of the three rotation angles
+   */
+  void
+  setRotationFromMatrix(const Eigen::Matrix<TDataType, 3, 3> &rotationMatrix,
+                        const bool inDegreeFlag = true,
+                        const Eigen::Matrix<TDataType, 3, 3> &var =
+                            Eigen::Matrix<TDataType, 3, 3>::Identity(3, 3));
+
   /// Get a const reference of translation
   const Point<TDataType, 3> &getTranslation() const;
 
@@ -50,15 +67,34 @@ public:
    */
   Point<TDataType, 3> &getTranslation();
 
-  /// Get a const reference of rotation
+  /**
+   * Get a const reference of rotation
+   * Note: There is no mutable accessor, since the rotation matrix is cached;
+   * use setRotation or assignFromArray to modify the rotation.
+   */
   const Point<TDataType, 3> &getRotation() const;
 
   /**
-   * Get a mutable copy of rotation
-   * Note: This function can be used only when you want to directly modify the
-   * content of rotation
+   * Get the rotation matrix of current rotation angles
+   * Note: The rotation matrix and the sin/cos terms of the angles are
+   * computed whenever the rotation is set, so reading them is thread-safe.
+   */
+  const Eigen::Matrix<TDataType, 3, 3> &getRotationMatrix() const;
+
+  /**
+   * Get the partial derivatives of the rotation matrix w.r.t. the three
+   * rotation angles in radians (using the cached sin/cos terms)
+   * @param[out] derivatives dR/domega, dR/dphi and dR/dkappa
    */
-  Point<TDataType, 3> &getRotation();
+  void getRotationMatrixDerivatives(
+      Eigen::Matrix<TDataType, 3, 3> derivatives[3]) const;
+
+  /// Get the rotation as a unit quaternion (with a non-negative scalar part)
+  Eigen::Quaternion<TDataType> getRotationAsQuaternion() const;
+
+  /// Get the rotation as an angle-axis vector (i.e., the rotation axis scaled
+  /// by the rotation angle in radians)
+  Eigen::Matrix<TDataType, 3, 1> getRotationAsAngleAxis() const;
 
   /// Get a copy of rotation in degrees
   Point<TDataType, 3> getRotationInDegrees() const;
@@ -81,7 +117,7 @@ public:
    * @c transform
    */
   ExteriorOrientation<TDataType>
-  transformTo(const ExteriorOrientation<TDataType> &transform);
+  transformTo(const ExteriorOrientation<TDataType> &transform) const;
 
   /// Static function to convert rotation angles to radians
   static void
@@ -101,6 +137,19 @@ public:
   /// Member function to convert rotation angles to degrees
   bool convertRotationToDegrees();
 
+  /**
+   * This function writes the EOPs to a 6 x 1 array (i.e., X, Y, Z, omega, phi
+   * and kappa in radians), which is the layout used by the solver
+   */
+  void convertToArray(TDataType *params) const;
+
+  /**
+   * This function reads the EOPs from a 6 x 1 array in the layout of
+   * convertToArray. The variance-covariance matrices and the unit of the
+   * stored rotation angles are kept.
+   */
+  void assignFromArray(const TDataType *params);
+
   /**
    * Static function to convert the three rotation angles (in radians) to
    * rotation matrix
@@ -110,6 +159,32 @@ public:
   CreateRotationMatrixFromEluerAnglesInRadians(
       const Eigen::Matrix<TDataType, 3, 1> &rotationAngles);
 
+  /**
+   * Static function to convert the rotation angles (in radians) of n poses to
+   * rotation matrices in one batched pass (e.g., for a whole trajectory)
+   * @param[in] rotationAngles Pointer to omega of the first pose; phi and kappa
+   * follow omega
+   * @param[in] stride Distance between the omega angles of two consecutive
+   * poses (e.g., 3 for packed angles, and 6 for X, Y, Z, omega, phi and kappa)
+   * @param[in] numberOfPoses The number of poses
+   * @param[out] rotationMatrices n consecutive 3 x 3 column-major rotation
+   * matrices (9 x n values)
+   */
+  static void CreateRotationMatricesFromEulerAnglesInRadians(
+      const TDataType *rotationAngles, const std::size_t stride,
+      const std::size_t numberOfPoses, TDataType *rotationMatrices);
+
+  /**
+   * Static function to compute the partial derivatives of the rotation matrix
+   * created by CreateRotationMatrixFromEluerAnglesInRadians w.r.t. the three
+   * Euler angles (in radians)
+   * @param[in] rotationAngles Three Euler angles in radians
+   * @param[out] derivatives dR/domega, dR/dphi and dR/dkappa
+   */
+  static void CreateRotationMatrixDerivativesFromEulerAnglesInRadians(
+      const Eigen::Matrix<TDataType, 3, 1> &rotationAngles,
+      Eigen::Matrix<TDataType, 3, 3> derivatives[3]);
+
   /**
    * Static function to convert the three rotation angles (in degrees) to
    * rotation matrix
@@ -141,13 +216,27 @@ public:
 
 private:
   /// Translation (X, Y, and Z coordinates)
-  Point<TDataType, 3> mTranslation;
+  Point<TDataType, 3> mTranslation =
+      Point<TDataType, 3>(Eigen::Matrix<TDataType, 3, 1>::Zero());
   /// Rotation (Omega, Phi, and Kappa)
   /// Note: The default rotation angles are all in degrees.
-  Point<TDataType, 3> mRotation;
+  Point<TDataType, 3> mRotation =
+      Point<TDataType, 3>(Eigen::Matrix<TDataType, 3, 1>::Zero());
   /// The flag indicates if the rotation angles are in degrees or radians
   /// True: in degrees; False: in radians
   bool isInDegree = true;
+
+  /// Compute the sin/cos terms and rotation matrix of the rotation angles
+  void updateRotationCache();
+
+  /// Cached rotation matrix, and sin/cos of omega, phi and kappa (of the zero
+  /// rotation by default)
+  Eigen::Matrix<TDataType, 3, 3> mRotationMatrix =
+      Eigen::Matrix<TDataType, 3, 3>::Identity();
+  Eigen::Matrix<TDataType, 3, 1> mSines =
+      Eigen::Matrix<TDataType, 3, 1>::Zero();
+  Eigen::Matrix<TDataType, 3, 1> mCosines =
+      Eigen::Matrix<TDataType, 3, 1>::Ones();
 };
 
 } // namespace Core
@@ -1,4 +1,8 @@
 #include "ExteriorOrientation.h"
+
+#include <algorithm>
+#include <limits>
+
 namespace Core {
 template <typename TDataType>
 void ExteriorOrientation<TDataType>::setTranslation(
@@ -15,6 +19,18 @@ void ExteriorOrientation<TDataType>::setRotation(
   isInDegree = inDegreeFlag;
   mRotation = Point<TDataType, 3>(
       Eigen::Matrix<TDataType, 3, 1>{omega, phi, kappa}, var);
+  updateRotationCache();
+}
+
+template <typename TDataType>
+void ExteriorOrientation<TDataType>::setRotationFromMatrix(
+    const Eigen::Matrix<TDataType, 3, 3> &rotationMatrix,
+    const bool inDegreeFlag, const Eigen::Matrix<TDataType, 3, 3> &var) {
+  const Eigen::Matrix<TDataType, 3, 1> eulerAngles =
+      inDegreeFlag ? GetEulerAnglesInDegreesFromRotationMatrix(rotationMatrix)
+                   : GetEulerAnglesInRadiansFromRotationMatrix(rotationMatrix);
+  setRotation(eulerAngles[0], eulerAngles[1], eulerAngles[2], inDegreeFlag,
+              var);
 }
 
 template <typename TDataType>
@@ -34,8 +50,37 @@ const Point<TDataType, 3> &ExteriorOrientation<TDataType>::getRotation() const {
 }
 
 template <typename TDataType>
-Point<TDataType, 3> &ExteriorOrientation<TDataType>::getRotation() {
-  return mRotation;
+const Eigen::Matrix<TDataType, 3, 3> &
+ExteriorOrientation<TDataType>::getRotationMatrix() const {
+  return mRotationMatrix;
+}
+
+template <typename TDataType>
+void ExteriorOrientation<TDataType>::getRotationMatrixDerivatives(
+    Eigen::Matrix<TDataType, 3, 3> derivatives[3]) const {
+  const TDataType cosw = mCosines[0];
+  const TDataType sinw = mSines[0];
+  const TDataType cosp = mCosines[1];
+  const TDataType sinp = mSines[1];
+  const TDataType cosk = mCosines[2];
+  const TDataType sink = mSines[2];
+  const TDataType zero = static_cast<TDataType>(0);
+  // Note: dR/domega and dR/dkappa are rearranged elements of R
+  derivatives[0] << zero, zero, zero,
+      // 2nd row
+      -mRotationMatrix(2, 0), -mRotationMatrix(2, 1), -mRotationMatrix(2, 2),
+      // 3rd row
+      mRotationMatrix(1, 0), mRotationMatrix(1, 1), mRotationMatrix(1, 2);
+  derivatives[1] << -sinp * cosk, sinp * sink, cosp,
+      // 2nd row
+      sinw * cosp * cosk, -sinw * cosp * sink, sinw * sinp,
+      // 3rd row
+      -cosw * cosp * cosk, cosw * cosp * sink, -cosw * sinp;
+  derivatives[2] << mRotationMatrix(0, 1), -mRotationMatrix(0, 0), zero,
+      // 2nd row
+      mRotationMatrix(1, 1), -mRotationMatrix(1, 0), zero,
+      // 3rd row
+      mRotationMatrix(2, 1), -mRotationMatrix(2, 0), zero;
 }
 
 template <typename TDataType>
@@ -58,16 +103,29 @@ ExteriorOrientation<TDataType>::getRotationInRadians() const {
   }
 }
 
+template <typename TDataType>
+Eigen::Quaternion<TDataType>
+ExteriorOrientation<TDataType>::getRotationAsQuaternion() const {
+  Eigen::Quaternion<TDataType> quaternion(getRotationMatrix());
+  if (quaternion.w() < static_cast<TDataType>(0)) {
+    quaternion.coeffs() *= static_cast<TDataType>(-1);
+  }
+  return quaternion;
+}
+
+template <typename TDataType>
+Eigen::Matrix<TDataType, 3, 1>
+ExteriorOrientation<TDataType>::getRotationAsAngleAxis() const {
+  const Eigen::AngleAxis<TDataType> angleAxis(getRotationMatrix());
+  return angleAxis.angle() * angleAxis.axis();
+}
+
 template <typename TDataType>
 ExteriorOrientation<TDataType> ExteriorOrientation<TDataType>::transformTo(
-    const ExteriorOrientation<TDataType> &transform) {
+    const ExteriorOrientation<TDataType> &transform) const {
   // Compute rotation: R_a_c = R_b_c * R_a_b
-  Eigen::Matrix<TDataType, 3, 3> R_a_b =
-      CreateRotationMatrixFromEulerAnglesInDegrees(
-          this->getRotationInDegrees());
-  Eigen::Matrix<TDataType, 3, 3> R_b_c =
-      CreateRotationMatrixFromEulerAnglesInDegrees(
-          transform.getRotationInDegrees());
+  const Eigen::Matrix<TDataType, 3, 3> &R_a_b = this->getRotationMatrix();
+  const Eigen::Matrix<TDataType, 3, 3> &R_b_c = transform.getRotationMatrix();
   Eigen::Matrix<TDataType, 3, 3> R_a_c = R_b_c * R_a_b;
   auto eulerAngles = GetEulerAnglesInDegreesFromRotationMatrix(R_a_c);
 
@@ -128,7 +186,7 @@ bool ExteriorOrientation<TDataType>::convertRotationToDegrees() {
     mRotation[1] = mRotation[1] * conversionFactor;
     mRotation[2] = mRotation[2] * conversionFactor;
     // Reset isInDegree flag
-    isInDegree = false;
+    isInDegree = true;
     return true;
   }
   return false;
@@ -142,12 +200,62 @@ bool ExteriorOrientation<TDataType>::convertRotationToRadians() {
     mRotation[1] = mRotation[1] * conversionFactor;
     mRotation[2] = mRotation[2] * conversionFactor;
     // Reset isInDegree flag
-    isInDegree = true;
+    isInDegree = false;
     return true;
   }
   return false;
 }
 
+template <typename TDataType>
+void ExteriorOrientation<TDataType>::convertToArray(TDataType *params) const {
+  const TDataType conversionFactor =
+      isInDegree ? static_cast<TDataType>(DegreeToRadians)
+                 : static_cast<TDataType>(1);
+  for (unsigned int i = 0; i < 3; ++i) {
+    params[i] = mTranslation[i];
+    params[3 + i] = mRotation[i] * conversionFactor;
+  }
+}
+
+template <typename TDataType>
+void ExteriorOrientation<TDataType>::assignFromArray(const TDataType *params) {
+  const TDataType conversionFactor =
+      isInDegree ? static_cast<TDataType>(RadiansToDegree)
+                 : static_cast<TDataType>(1);
+  for (unsigned int i = 0; i < 3; ++i) {
+    mTranslation[i] = params[i];
+    mRotation[i] = params[3 + i] * conversionFactor;
+  }
+  updateRotationCache();
+}
+
+template <typename TDataType>
+void ExteriorOrientation<TDataType>::updateRotationCache() {
+  const TDataType conversionFactor =
+      isInDegree ? static_cast<TDataType>(DegreeToRadians)
+                 : static_cast<TDataType>(1);
+  using std::cos;
+  using std::sin;
+  for (unsigned int i = 0; i < 3; ++i) {
+    const TDataType angle = mRotation[i] * conversionFactor;
+    mSines[i] = sin(angle);
+    mCosines[i] = cos(angle);
+  }
+  const TDataType cosw = mCosines[0];
+  const TDataType sinw = mSines[0];
+  const TDataType cosp = mCosines[1];
+  const TDataType sinp = mSines[1];
+  const TDataType cosk = mCosines[2];
+  const TDataType sink = mSines[2];
+  mRotationMatrix << cosp * cosk, -cosp * sink, sinp,
+      // 2nd row
+      cosw * sink + sinw * sinp * cosk, cosw * cosk - sinw * sinp * sink,
+      -sinw * cosp,
+      // 3rd row
+      sinw * sink - cosw * sinp * cosk, sinw * cosk + cosw * sinp * sink,
+      cosw * cosp;
+}
+
 template <typename TDataType>
 Eigen::Matrix<TDataType, 3, 3>
 ExteriorOrientation<TDataType>::CreateRotationMatrixFromEluerAnglesInRadians(
@@ -156,12 +264,15 @@ ExteriorOrientation<TDataType>::CreateRotationMatrixFromEluerAnglesInRadians(
   // camera to the mapping coordinate system.If the rotation from the mapping to
   // the camera (i.e., M matrix) is needed, the transpose of this matrix has to
   // be used.
-  const TDataType cosw = std::cos(rotationAngles[0]);
-  const TDataType sinw = std::sin(rotationAngles[0]);
-  const TDataType cosp = std::cos(rotationAngles[1]);
-  const TDataType sinp = std::sin(rotationAngles[1]);
-  const TDataType cosk = std::cos(rotationAngles[2]);
-  const TDataType sink = std::sin(rotationAngles[2]);
+  // Note: Unqualified calls allow ceres::Jet to be used as TDataType.
+  using std::cos;
+  using std::sin;
+  const TDataType cosw = cos(rotationAngles[0]);
+  const TDataType sinw = sin(rotationAngles[0]);
+  const TDataType cosp = cos(rotationAngles[1]);
+  const TDataType sinp = sin(rotationAngles[1]);
+  const TDataType cosk = cos(rotationAngles[2]);
+  const TDataType sink = sin(rotationAngles[2]);
 
   Eigen::Matrix<TDataType, 3, 3> rotationMatrix;
 
@@ -181,6 +292,87 @@ ExteriorOrientation<TDataType>::CreateRotationMatrixFromEluerAnglesInRadians(
   return rotationMatrix;
 }
 
+template <typename TDataType>
+void ExteriorOrientation<TDataType>::
+    CreateRotationMatricesFromEulerAnglesInRadians(
+        const TDataType *rotationAngles, const std::size_t stride,
+        const std::size_t numberOfPoses, TDataType *rotationMatrices) {
+  // Process the poses in chunks: the sin/cos terms of a chunk are computed in
+  // tight loops over contiguous arrays (which can be vectorized by the
+  // compiler), and stay in cache while the matrices are assembled.
+  constexpr std::size_t ChunkSize = 256;
+  TDataType sines[3][ChunkSize];
+  TDataType cosines[3][ChunkSize];
+  for (std::size_t begin = 0; begin < numberOfPoses; begin += ChunkSize) {
+    const std::size_t n = std::min(ChunkSize, numberOfPoses - begin);
+    const TDataType *angles = rotationAngles + begin * stride;
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      for (std::size_t i = 0; i < n; ++i) {
+        sines[axis][i] = std::sin(angles[i * stride + axis]);
+        cosines[axis][i] = std::cos(angles[i * stride + axis]);
+      }
+    }
+
+    // Column-major elements of the rotation matrices
+    TDataType *matrices = rotationMatrices + 9 * begin;
+    for (std::size_t i = 0; i < n; ++i) {
+      const TDataType cosw = cosines[0][i];
+      const TDataType sinw = sines[0][i];
+      const TDataType cosp = cosines[1][i];
+      const TDataType sinp = sines[1][i];
+      const TDataType cosk = cosines[2][i];
+      const TDataType sink = sines[2][i];
+      TDataType *matrix = matrices + 9 * i;
+      matrix[0] = cosp * cosk;
+      matrix[1] = cosw * sink + sinw * sinp * cosk;
+      matrix[2] = sinw * sink - cosw * sinp * cosk;
+      matrix[3] = -cosp * sink;
+      matrix[4] = cosw * cosk - sinw * sinp * sink;
+      matrix[5] = sinw * cosk + cosw * sinp * sink;
+      matrix[6] = sinp;
+      matrix[7] = -sinw * cosp;
+      matrix[8] = cosw * cosp;
+    }
+  }
+}
+
+template <typename TDataType>
+void ExteriorOrientation<TDataType>::
+    CreateRotationMatrixDerivativesFromEulerAnglesInRadians(
+        const Eigen::Matrix<TDataType, 3, 1> &rotationAngles,
+        Eigen::Matrix<TDataType, 3, 3> derivatives[3]) {
+  using std::cos;
+  using std::sin;
+  const TDataType cosw = cos(rotationAngles[0]);
+  const TDataType sinw = sin(rotationAngles[0]);
+  const TDataType cosp = cos(rotationAngles[1]);
+  const TDataType sinp = sin(rotationAngles[1]);
+  const TDataType cosk = cos(rotationAngles[2]);
+  const TDataType sink = sin(rotationAngles[2]);
+  const TDataType zero = static_cast<TDataType>(0);
+
+  // dR/domega
+  derivatives[0] << zero, zero, zero,
+      // 2nd row
+      -sinw * sink + cosw * sinp * cosk, -sinw * cosk - cosw * sinp * sink,
+      -cosw * cosp,
+      // 3rd row
+      cosw * sink + sinw * sinp * cosk, cosw * cosk - sinw * sinp * sink,
+      -sinw * cosp;
+  // dR/dphi
+  derivatives[1] << -sinp * cosk, sinp * sink, cosp,
+      // 2nd row
+      sinw * cosp * cosk, -sinw * cosp * sink, sinw * sinp,
+      // 3rd row
+      -cosw * cosp * cosk, cosw * cosp * sink, -cosw * sinp;
+  // dR/dkappa
+  derivatives[2] << -cosp * sink, -cosp * cosk, zero,
+      // 2nd row
+      cosw * cosk - sinw * sinp * sink, -cosw * sink - sinw * sinp * cosk, zero,
+      // 3rd row
+      sinw * cosk + cosw * sinp * sink, -sinw * sink + cosw * sinp * cosk, zero;
+}
+
 template <typename TDataType>
 Eigen::Matrix<TDataType, 3, 3>
 ExteriorOrientation<TDataType>::CreateRotationMatrixFromEulerAnglesInDegrees(
@@ -194,14 +386,24 @@ template <typename TDataType>
 Eigen::Matrix<TDataType, 3, 1>
 ExteriorOrientation<TDataType>::GetEulerAnglesInRadiansFromRotationMatrix(
     const Eigen::Matrix<TDataType, 3, 3> &rotationMatrix) {
-  // Note: phi has to be in the range of [-pi/2, pi/2].
-  const TDataType phi = std::asin(rotationMatrix(0, 2));
-  // Compute cos(Phi)
-  const TDataType cosp = std::cos(phi);
-  const TDataType omega =
-      std::atan2(-rotationMatrix(1, 2) / cosp, rotationMatrix(2, 2) / cosp);
-  const TDataType kappa =
-      std::atan2(-rotationMatrix(0, 1) / cosp, rotationMatrix(0, 0) / cosp);
+  // Note: phi has to be in the range of [-pi/2, pi/2]. cos(phi) is recovered
+  // from the first row (i.e., without dividing by it), which keeps phi
+  // accurate near +/- pi/2 where asin is ill-conditioned.
+  const TDataType cosp =
+      std::sqrt(rotationMatrix(0, 0) * rotationMatrix(0, 0) +
+                rotationMatrix(0, 1) * rotationMatrix(0, 1));
+  const TDataType phi = std::atan2(rotationMatrix(0, 2), cosp);
+  TDataType omega;
+  TDataType kappa;
+  if (cosp > std::sqrt(std::numeric_limits<TDataType>::epsilon())) {
+    omega = std::atan2(-rotationMatrix(1, 2), rotationMatrix(2, 2));
+    kappa = std::atan2(-rotationMatrix(0, 1), rotationMatrix(0, 0));
+  } else {
+    // Gimbal lock: Only omega +/- kappa is observable, so kappa is set to
+    // zero, i.e., R = Rx(omega) * Ry(phi)
+    omega = std::atan2(rotationMatrix(2, 1), rotationMatrix(1, 1));
+    kappa = static_cast<TDataType>(0);
+  }
 
   return Eigen::Matrix<TDataType, 3, 1>{omega, phi, kappa};
 }
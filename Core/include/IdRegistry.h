@@ -0,0 +1,88 @@
+#ifndef CORE_IDREGISTRY_H
+#define CORE_IDREGISTRY_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Core {
+/// Dense integer handle of an entity (e.g., camera, image and point)
+using Handle = std::uint32_t;
+/// Handle returned when an id cannot be found
+constexpr Handle InvalidHandle = std::numeric_limits<Handle>::max();
+
+/**
+ * This is the class to intern external string ids to dense integer handles.
+ * Handles are assigned in insertion order (i.e., 0, 1, ..., n - 1), so that
+ * they can be directly used as indices of contiguous storage. String lookup
+ * is meant to be used only at the API edge.
+ * Note: Ids are looked up in an open-addressing hash table of handles (with
+ * linear probing), so that adding an id neither copies it twice nor
+ * allocates a node (e.g., for millions of object points).
+ */
+class IdRegistry {
+public:
+  /// Default constructor
+  IdRegistry() = default;
+
+  /**
+   * Intern a new id
+   * @return The handle of the new id, or InvalidHandle if the id is already
+   * in the registry
+   */
+  Handle add(const std::string &id);
+
+  /**
+   * Remove an id from the registry
+   * Note: To keep the handles dense, the last id is moved to the handle of
+   * the removed one. The caller has to move its storage accordingly (i.e.,
+   * storage[erasedHandle] = storage.back(); storage.pop_back()).
+   * @param[out] erasedHandle The handle of the removed id
+   * @return True: if the id is removed; False: if the id cannot be found
+   */
+  bool erase(const std::string &id, Handle &erasedHandle);
+
+  /// Return the handle of the given id, or InvalidHandle if not found
+  Handle find(const std::string &id) const;
+
+  /**
+   * Return the handle of the given id
+   * Note: This function throws std::invalid_argument if not found
+   */
+  Handle getHandle(const std::string &id) const;
+
+  /// Return the id of the given handle
+  const std::string &getId(const Handle handle) const;
+
+  /// Check if the id is in the registry
+  bool contains(const std::string &id) const;
+
+  /// Return all ids ordered by their handles
+  const std::vector<std::string> &getIds() const;
+
+  /// Return the number of ids
+  Handle size() const;
+
+  /// Reserve memory for the given number of ids
+  void reserve(const std::size_t numberOfIds);
+
+  /// Remove all ids
+  void clear();
+
+private:
+  /// Get the slot of the id, or the empty slot where it would be inserted
+  std::size_t findSlot(const std::string &id, const std::size_t hash) const;
+  /// Rebuild the hash table with the given number of slots (a power of 2)
+  void rehash(const std::size_t numberOfSlots);
+
+  /// Ids ordered by their handles, and their hashes
+  std::vector<std::string> mIds;
+  std::vector<std::size_t> mHashes;
+  /// Hash table of handles (InvalidHandle for empty slots), which is at most
+  /// half full
+  std::vector<Handle> mSlots;
+};
+} // namespace Core
+
+#endif // CORE_IDREGISTRY_H
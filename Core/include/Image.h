@@ -23,8 +23,14 @@ public:
 
   /// Accessor of mCameraId
   const std::string &cameraId() const;
-  /// Accessor of image points
-  const std::unordered_map<std::string, ImagePoint> &getImagePoints() const;
+  /// Set the id of the utilized camera
+  void setCameraId(const std::string &cameraId);
+  /// Accessor of image points (ordered by their handles)
+  const typename PointCloud<TPointType>::PointContainer &getImagePoints() const;
+  /// Accessor of the optional image file path
+  const boost::optional<boost::filesystem::path> &getImageFilePath() const;
+  /// Set the image file path
+  void setImageFilePath(const boost::filesystem::path &imageFilePath);
 
 private:
   /// Id for the utilized camera
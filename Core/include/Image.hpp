@@ -7,9 +7,26 @@ const std::string &Image<TPointType, TDataType>::cameraId() const {
 }
 
 template <typename TPointType, typename TDataType>
-const std::unordered_map<std::string, ImagePoint> &
+void Image<TPointType, TDataType>::setCameraId(const std::string &cameraId) {
+  mCameraId = cameraId;
+}
+
+template <typename TPointType, typename TDataType>
+const typename PointCloud<TPointType>::PointContainer &
 Image<TPointType, TDataType>::getImagePoints() const {
   return this->getPoints();
 }
 
+template <typename TPointType, typename TDataType>
+const boost::optional<boost::filesystem::path> &
+Image<TPointType, TDataType>::getImageFilePath() const {
+  return mImageFilePath;
+}
+
+template <typename TPointType, typename TDataType>
+void Image<TPointType, TDataType>::setImageFilePath(
+    const boost::filesystem::path &imageFilePath) {
+  mImageFilePath = imageFilePath;
+}
+
 } // namespace Core
@@ -5,14 +5,51 @@
 #include <unordered_map>
 
 #include "Camera.h"
+#include "IdRegistry.h"
 #include "Image.h"
+#include "ObservationTable.h"
+#include "ParameterArena.h"
 #include "Point.h"
+#include "TrackStore.h"
+#include "Trajectory.h"
 
 namespace Core {
+/**
+ * This is the class for an image block, which contains cameras, images, object
+ * points and navigation data.
+ * Note: Every camera, image and object point is interned to a dense handle
+ * (i.e., 0, 1, ..., n - 1) when it is added. The string ids are only used at
+ * the API edge; internal storage and solver code index by handles.
+ * The image point observations of all object points are kept in an
+ * ObservationTable, and the tracks (point -> observations and image ->
+ * observations) in a TrackStore.
+ */
 template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType = double>
 class ImageBlock {
 public:
+  /// Sections of the parameter arena
+  enum ParameterSection : std::size_t {
+    /// xp, yp, c and distortion parameters of every camera
+    CameraSection = 0,
+    /// Mounting parameters of every camera
+    MountingSection = 1,
+    /// EOPs of every image
+    BodyFrameSection = 2,
+    /// Coordinates of every object point
+    ObjectPointSection = 3
+  };
+
+  /// Types of the cameras, images, object points and parameters
+  using CameraType = TCameraType;
+  using ImageType = TImageType;
+  using ObjectPointType = TObjectPointType;
+  using DataType = TDataType;
+
+  /// Contiguous storage of object points
+  using ObjectPointContainer =
+      std::vector<TObjectPointType, Eigen::aligned_allocator<TObjectPointType>>;
+
   /// Default constructor
   ImageBlock() = default;
   ~ImageBlock() = default;
@@ -21,21 +58,57 @@ public:
   bool addCamera(const std::string &cameraId,
                  const std::shared_ptr<TCameraType> &camera);
   /// Get pointer to the camera with the given cameraId
-  std::shared_ptr<TCameraType> getCamera(const std::string &cameraId);
+  std::shared_ptr<TCameraType> getCamera(const std::string &cameraId) const;
+  /// Get pointer to the camera with the given handle
+  const std::shared_ptr<TCameraType> &getCamera(const Handle handle) const;
+  /// Get the handle of the given cameraId
+  Handle getCameraHandle(const std::string &cameraId) const;
+  /// Get the cameraId of the given handle
+  const std::string &getCameraId(const Handle handle) const;
 
   /// Add an image to current image block
   bool addImage(const std::string &imageId,
                 const std::shared_ptr<TImageType> &image);
   /// Get pointer to the image with the given imageId
-  std::shared_ptr<TImageType> getImage(const std::string &imageId);
+  std::shared_ptr<TImageType> getImage(const std::string &imageId) const;
+  /// Get pointer to the image with the given handle
+  const std::shared_ptr<TImageType> &getImage(const Handle handle) const;
+  /// Get the handle of the given imageId
+  Handle getImageHandle(const std::string &imageId) const;
+  /// Get the imageId of the given handle
+  const std::string &getImageId(const Handle handle) const;
+  /**
+   * Get the handle of the camera utilized by the given image
+   * @return The camera handle, or InvalidHandle if the camera of the image has
+   * not been added to the image block
+   */
+  Handle getCameraHandleOfImage(const Handle imageHandle) const;
 
-  /// Add an object point to current image block
+  /**
+   * Add an object point to current image block
+   * Note: Object points are stored by value in contiguous memory, so the
+   * image block keeps its own copy of the given point.
+   */
   bool addObjectPoint(const std::string &pointId,
                       const std::shared_ptr<TObjectPointType> &point);
+  bool addObjectPoint(const std::string &pointId,
+                      const TObjectPointType &point);
   /// Return a mutable copy of object point with the given pointId
   /// Note: Returning a mutable copy instead of a pointer can be easier to
-  /// access the object coordinates.
+  /// access the object coordinates. The reference is invalidated when more
+  /// object points are added.
   TObjectPointType &getObjectPoint(const std::string &pointId);
+  /// Return object point with the given handle
+  TObjectPointType &getObjectPoint(const Handle handle);
+  const TObjectPointType &getObjectPoint(const Handle handle) const;
+  /// Get the handle of the given pointId
+  Handle getObjectPointHandle(const std::string &pointId) const;
+  /// Find the handle of the given pointId (InvalidHandle if not found)
+  Handle findObjectPointHandle(const std::string &pointId) const;
+  /// Get the pointId of the given handle
+  const std::string &getObjectPointId(const Handle handle) const;
+  /// Return all object points ordered by their handles
+  const ObjectPointContainer &getObjectPoints() const;
 
   /// Add a GNSS/INS measurements with timestamp to current image block
   bool addNavigationData(
@@ -45,6 +118,16 @@ public:
   std::shared_ptr<ExteriorOrientation<TDataType>>
   getNavigationMeasurement(const unsigned int timestamp);
 
+  /**
+   * Get the time-sorted GNSS/INS trajectory of the image block, which
+   * interpolates poses at arbitrary times (e.g., image exposure times)
+   * Note: Unlike the navigation measurements above, which are only looked up
+   * by exact integer timestamps, the trajectory is meant for high-rate
+   * navigation data.
+   */
+  Trajectory<TDataType> &getTrajectory();
+  const Trajectory<TDataType> &getTrajectory() const;
+
   /// Get the number of the utilized cameras
   unsigned int getNumberOfCameras() const;
   /// Get the number of the involved images
@@ -54,18 +137,113 @@ public:
   /// Get the number of navigation measurements
   unsigned int getNumberOfNavigationMeasurements() const;
 
+  /// Reserve memory for the given number of cameras, images and object points
+  void reserve(const std::size_t numberOfCameras,
+               const std::size_t numberOfImages,
+               const std::size_t numberOfObjectPoints);
+
+  /**
+   * Build the observations and tracks from the tie points of all object
+   * points (i.e., ObjectPoint::mTiePointIds)
+   * @param[in] numberOfThreads The number of threads (default = 0, i.e., the
+   * number of hardware threads)
+   * @param[in] releaseTiePointIds Flag to free the tie point maps of all object
+   * points afterwards
+   */
+  void buildObservations(const unsigned int numberOfThreads = 0,
+                         const bool releaseTiePointIds = false);
+  /**
+   * Set all observations at once (e.g., by a project importer), and build the
+   * tracks
+   * Note: Object points do not need tie point maps in this case. This function
+   * throws std::invalid_argument if the columns of the observations have
+   * different sizes, or an observation refers to an unknown image or object
+   * point, or not to the camera of its image (see getCameraHandleOfImage); the
+   * image block is unchanged in these cases.
+   */
+  void setObservations(ObservationTable<TDataType> observations);
+  /// Get the observations of all object points
+  const ObservationTable<TDataType> &getObservations() const;
+  /// Get the tracks of all object points and images
+  const TrackStore &getTracks() const;
+
+  /**
+   * Convert the measured image points of all observations (see
+   * getObservations) from pixels to image coordinates with the IOPs of their
+   * cameras, and optionally remove the distortions (see
+   * InteriorOrientation::convertPixelsToImageCoordinates). The observations
+   * are split into chunks for parallel processing, and every run of
+   * consecutive observations of the same camera is converted in one batch.
+   * Note: The runs are the longest if the observations are sorted by image.
+   * This function throws std::invalid_argument if an observation has no
+   * camera.
+   * @param[out] x x image coordinates of every observation
+   * @param[out] y y image coordinates of every observation
+   * @param[in] removeDistortions Flag to remove the distortions
+   * @param[in] numberOfThreads The number of threads (default = 0, i.e., the
+   * number of hardware threads)
+   */
+  void computeImageCoordinates(std::vector<TDataType> &x,
+                               std::vector<TDataType> &y,
+                               const bool removeDistortions = true,
+                               const unsigned int numberOfThreads = 0) const;
+  /**
+   * Same as above for the observations of a single image (in the order of
+   * TrackStore::getImageObservations)
+   */
+  void computeImageCoordinates(const Handle imageHandle,
+                               std::vector<TDataType> &x,
+                               std::vector<TDataType> &y,
+                               const bool removeDistortions = true) const;
+
+  /**
+   * Lay out the parameter arena (one block per camera, mounting, image and
+   * object point, indexed by handles), and copy the current parameters into
+   * it. EOPs and mounting parameters are stored as X, Y, Z, omega, phi and
+   * kappa (in radians).
+   * Note: Pointers into the arena stay valid until this function is called
+   * again.
+   */
+  void buildParameterArena();
+  /// Copy the parameters in the arena back to cameras, images and points
+  void updateFromParameterArena();
+  /// Accessor of the parameter arena
+  ParameterArena<TDataType> &getParameterArena();
+  const ParameterArena<TDataType> &getParameterArena() const;
+
 private:
-  /// Collection of the utilized cameras
-  std::unordered_map<std::string, std::shared_ptr<TCameraType>> mCameras;
-  /// Collection of the involved images
-  std::unordered_map<std::string, std::shared_ptr<TImageType>> mImages;
-  /// Collection of the object points
-  std::unordered_map<std::string, std::shared_ptr<TObjectPointType>>
-      mObjectPoints;
+  /**
+   * Convert pixel locations to image coordinates in runs of consecutive
+   * points of the same camera (i.e., cameraHandles[i] is the camera of the
+   * i-th point)
+   */
+  void convertPixelsToImageCoordinates(const std::size_t size,
+                                       const Handle *cameraHandles,
+                                       const TDataType *rows,
+                                       const TDataType *cols, TDataType *x,
+                                       TDataType *y,
+                                       const bool removeDistortions) const;
+
+  /// Collection of the utilized cameras (indexed by camera handles)
+  std::vector<std::shared_ptr<TCameraType>> mCameras;
+  IdRegistry mCameraIds;
+  /// Collection of the involved images (indexed by image handles)
+  std::vector<std::shared_ptr<TImageType>> mImages;
+  IdRegistry mImageIds;
+  /// Collection of the object points (indexed by object point handles)
+  ObjectPointContainer mObjectPoints;
+  IdRegistry mObjectPointIds;
   /// Collection of the navigation data (i.e., GNSS/INS measurements)
   std::unordered_map<unsigned int,
                      std::shared_ptr<ExteriorOrientation<TDataType>>>
       mNavigationData;
+  /// Time-sorted GNSS/INS trajectory
+  Trajectory<TDataType> mTrajectory;
+  /// Observations and tracks of all object points
+  ObservationTable<TDataType> mObservations;
+  TrackStore mTracks;
+  /// Contiguous storage of all adjustable parameters
+  ParameterArena<TDataType> mParameterArena;
 };
 } // namespace Core
 
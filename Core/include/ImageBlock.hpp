@@ -1,5 +1,7 @@
 #include "ImageBlock.h"
 
+#include "Parallel.h"
+
 namespace Core {
 template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType>
@@ -7,10 +9,10 @@ bool ImageBlock<TCameraType, TImageType, TObjectPointType,
                 TDataType>::addCamera(const std::string &cameraId,
                                       const std::shared_ptr<TCameraType>
                                           &camera) {
-  if (mCameras.count(cameraId) != 0) {
+  if (mCameraIds.add(cameraId) == InvalidHandle) {
     return false;
   } else {
-    mCameras[cameraId] = camera;
+    mCameras.push_back(camera);
     return true;
   }
 }
@@ -19,24 +21,54 @@ template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType>
 std::shared_ptr<TCameraType>
 ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::getCamera(
-    const std::string &cameraId) {
-  auto search = mCameras.find(cameraId);
-  if (search != mCameras.end()) {
-    return search->second;
+    const std::string &cameraId) const {
+  const Handle handle = mCameraIds.find(cameraId);
+  if (handle != InvalidHandle) {
+    return mCameras[handle];
+  } else {
+    throw std::invalid_argument(
+        "Cannot find the given cameraId in the image block!");
+  }
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const std::shared_ptr<TCameraType> &
+ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::getCamera(
+    const Handle handle) const {
+  return mCameras[handle];
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+Handle ImageBlock<TCameraType, TImageType, TObjectPointType,
+                  TDataType>::getCameraHandle(const std::string &cameraId)
+    const {
+  const Handle handle = mCameraIds.find(cameraId);
+  if (handle != InvalidHandle) {
+    return handle;
   } else {
     throw std::invalid_argument(
         "Cannot find the given cameraId in the image block!");
   }
 }
 
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const std::string &
+ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::getCameraId(
+    const Handle handle) const {
+  return mCameraIds.getId(handle);
+}
+
 template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType>
 bool ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::addImage(
     const std::string &imageId, const std::shared_ptr<TImageType> &image) {
-  if (mImages.count(imageId) != 0) {
+  if (mImageIds.add(imageId) == InvalidHandle) {
     return false;
   }
-  mImages[imageId] = image;
+  mImages.push_back(image);
   return true;
 }
 
@@ -44,25 +76,68 @@ template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType>
 std::shared_ptr<TImageType>
 ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::getImage(
-    const std::string &imageId) {
-  auto search = mImages.find(imageId);
-  if (search != mImages.end()) {
-    return search->second;
+    const std::string &imageId) const {
+  const Handle handle = mImageIds.find(imageId);
+  if (handle != InvalidHandle) {
+    return mImages[handle];
   } else {
     throw std::invalid_argument(
         "Cannot find the given imageId in the image block!");
   }
 }
 
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const std::shared_ptr<TImageType> &
+ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::getImage(
+    const Handle handle) const {
+  return mImages[handle];
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+Handle ImageBlock<TCameraType, TImageType, TObjectPointType,
+                  TDataType>::getImageHandle(const std::string &imageId) const {
+  const Handle handle = mImageIds.find(imageId);
+  if (handle != InvalidHandle) {
+    return handle;
+  } else {
+    throw std::invalid_argument(
+        "Cannot find the given imageId in the image block!");
+  }
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const std::string &
+ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::getImageId(
+    const Handle handle) const {
+  return mImageIds.getId(handle);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+Handle ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    getCameraHandleOfImage(const Handle imageHandle) const {
+  return mCameraIds.find(mImages[imageHandle]->cameraId());
+}
+
 template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType>
 bool ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
     addObjectPoint(const std::string &pointId,
                    const std::shared_ptr<TObjectPointType> &point) {
-  if (mObjectPoints.count(pointId) != 0) {
+  return addObjectPoint(pointId, *point);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+bool ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    addObjectPoint(const std::string &pointId, const TObjectPointType &point) {
+  if (mObjectPointIds.add(pointId) == InvalidHandle) {
     return false;
   } else {
-    mObjectPoints[pointId] = point;
+    mObjectPoints.push_back(point);
     return true;
   }
 }
@@ -72,15 +147,68 @@ template <typename TCameraType, typename TImageType, typename TObjectPointType,
 TObjectPointType &
 ImageBlock<TCameraType, TImageType, TObjectPointType,
            TDataType>::getObjectPoint(const std::string &pointId) {
-  auto search = mObjectPoints.find(pointId);
-  if (search != mObjectPoints.end()) {
-    return *(search->second);
+  const Handle handle = mObjectPointIds.find(pointId);
+  if (handle != InvalidHandle) {
+    return mObjectPoints[handle];
+  } else {
+    throw std::invalid_argument(
+        "Cannot find the given pointId in the image block!");
+  }
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+TObjectPointType &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getObjectPoint(const Handle handle) {
+  return mObjectPoints[handle];
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const TObjectPointType &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getObjectPoint(const Handle handle) const {
+  return mObjectPoints[handle];
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+Handle ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    getObjectPointHandle(const std::string &pointId) const {
+  const Handle handle = mObjectPointIds.find(pointId);
+  if (handle != InvalidHandle) {
+    return handle;
   } else {
     throw std::invalid_argument(
         "Cannot find the given pointId in the image block!");
   }
 }
 
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+Handle ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    findObjectPointHandle(const std::string &pointId) const {
+  return mObjectPointIds.find(pointId);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const std::string &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getObjectPointId(const Handle handle) const {
+  return mObjectPointIds.getId(handle);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const typename ImageBlock<TCameraType, TImageType, TObjectPointType,
+                          TDataType>::ObjectPointContainer &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getObjectPoints() const {
+  return mObjectPoints;
+}
+
 template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType>
 bool ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
@@ -109,6 +237,22 @@ ImageBlock<TCameraType, TImageType, TObjectPointType,
   }
 }
 
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+Trajectory<TDataType> &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getTrajectory() {
+  return mTrajectory;
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const Trajectory<TDataType> &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getTrajectory() const {
+  return mTrajectory;
+}
+
 template <typename TCameraType, typename TImageType, typename TObjectPointType,
           typename TDataType>
 unsigned int ImageBlock<TCameraType, TImageType, TObjectPointType,
@@ -137,4 +281,221 @@ unsigned int ImageBlock<TCameraType, TImageType, TObjectPointType,
   return mNavigationData.size();
 }
 
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::reserve(
+    const std::size_t numberOfCameras, const std::size_t numberOfImages,
+    const std::size_t numberOfObjectPoints) {
+  mCameras.reserve(numberOfCameras);
+  mCameraIds.reserve(numberOfCameras);
+  mImages.reserve(numberOfImages);
+  mImageIds.reserve(numberOfImages);
+  mObjectPoints.reserve(numberOfObjectPoints);
+  mObjectPointIds.reserve(numberOfObjectPoints);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    buildObservations(const unsigned int numberOfThreads,
+                      const bool releaseTiePointIds) {
+  setObservations(
+      ObservationTable<TDataType>::Build(*this, numberOfThreads));
+  if (releaseTiePointIds) {
+    for (auto &point : mObjectPoints) {
+      decltype(point.mTiePointIds)().swap(point.mTiePointIds);
+    }
+  }
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    setObservations(ObservationTable<TDataType> observations) {
+  // Validate all columns before the block is modified
+  const std::size_t size = observations.imageHandles.size();
+  if (observations.pointHandles.size() != size ||
+      observations.cameraHandles.size() != size ||
+      observations.x.size() != size || observations.y.size() != size ||
+      observations.sqrtInformation.size() != 3 * size) {
+    throw std::invalid_argument(
+        "The columns of the observations have different sizes!");
+  }
+  std::vector<Handle> cameraHandlesOfImages(mImages.size());
+  for (Handle imageHandle = 0; imageHandle < mImages.size(); ++imageHandle) {
+    cameraHandlesOfImages[imageHandle] = getCameraHandleOfImage(imageHandle);
+  }
+  for (std::size_t i = 0; i < size; ++i) {
+    const Handle imageHandle = observations.imageHandles[i];
+    if (imageHandle < mImages.size() &&
+        observations.cameraHandles[i] != cameraHandlesOfImages[imageHandle]) {
+      throw std::invalid_argument(
+          "The camera of an observation is not the camera of its image!");
+    }
+  }
+
+  // Image and point handles are validated by the track store
+  TrackStore tracks;
+  tracks.build(observations.pointHandles, observations.imageHandles,
+               mObjectPoints.size(), mImages.size());
+  mTracks = std::move(tracks);
+  mObservations = std::move(observations);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const ObservationTable<TDataType> &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getObservations() const {
+  return mObservations;
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const TrackStore &ImageBlock<TCameraType, TImageType, TObjectPointType,
+                             TDataType>::getTracks() const {
+  return mTracks;
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    computeImageCoordinates(std::vector<TDataType> &x,
+                            std::vector<TDataType> &y,
+                            const bool removeDistortions,
+                            const unsigned int numberOfThreads) const {
+  const std::size_t numberOfObservations = mObservations.size();
+  x.resize(numberOfObservations);
+  y.resize(numberOfObservations);
+  ParallelFor(
+      numberOfObservations,
+      [&](const std::size_t begin, const std::size_t end, const unsigned int) {
+        // Note: x and y of the observations are columns and rows
+        convertPixelsToImageCoordinates(
+            end - begin, mObservations.cameraHandles.data() + begin,
+            mObservations.y.data() + begin, mObservations.x.data() + begin,
+            x.data() + begin, y.data() + begin, removeDistortions);
+      },
+      numberOfThreads);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    computeImageCoordinates(const Handle imageHandle,
+                            std::vector<TDataType> &x,
+                            std::vector<TDataType> &y,
+                            const bool removeDistortions) const {
+  // Gather the columns, rows and cameras of the observations of the image,
+  // and convert them in place
+  const TrackStore::Range indices = mTracks.getImageObservations(imageHandle);
+  x.resize(indices.size());
+  y.resize(indices.size());
+  std::vector<Handle> cameraHandles(indices.size());
+  for (std::size_t i = 0; i < indices.size(); ++i) {
+    x[i] = mObservations.x[indices[i]];
+    y[i] = mObservations.y[indices[i]];
+    cameraHandles[i] = mObservations.cameraHandles[indices[i]];
+  }
+  convertPixelsToImageCoordinates(indices.size(), cameraHandles.data(),
+                                  y.data(), x.data(), x.data(), y.data(),
+                                  removeDistortions);
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType, TDataType>::
+    convertPixelsToImageCoordinates(const std::size_t size,
+                                    const Handle *cameraHandles,
+                                    const TDataType *rows,
+                                    const TDataType *cols, TDataType *x,
+                                    TDataType *y,
+                                    const bool removeDistortions) const {
+  std::size_t begin = 0;
+  while (begin < size) {
+    const Handle cameraHandle = cameraHandles[begin];
+    if (cameraHandle >= mCameras.size()) {
+      throw std::invalid_argument(
+          "Cannot find the camera of the given image in the image block!");
+    }
+    std::size_t end = begin + 1;
+    while (end < size && cameraHandles[end] == cameraHandle) {
+      ++end;
+    }
+    mCameras[cameraHandle]->convertPixelsToImageCoordinates(
+        end - begin, rows + begin, cols + begin, x + begin, y + begin,
+        removeDistortions);
+    begin = end;
+  }
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType,
+                TDataType>::buildParameterArena() {
+  const std::size_t cameraBlockSize =
+      mCameras.empty() ? 0 : 3 + mCameras.front()->distortionParameters.size();
+  mParameterArena.clear();
+  mParameterArena.addSection(mCameras.size(), cameraBlockSize);
+  mParameterArena.addSection(mCameras.size(), 6);
+  mParameterArena.addSection(mImages.size(), 6);
+  mParameterArena.addSection(mObjectPoints.size(), 3);
+  mParameterArena.freeze();
+
+  for (Handle handle = 0; handle < mCameras.size(); ++handle) {
+    mCameras[handle]->convertToArray(
+        mParameterArena.getBlock(CameraSection, handle));
+    mCameras[handle]->getMountingParameters().convertToArray(
+        mParameterArena.getBlock(MountingSection, handle));
+  }
+  for (Handle handle = 0; handle < mImages.size(); ++handle) {
+    mImages[handle]->convertToArray(
+        mParameterArena.getBlock(BodyFrameSection, handle));
+  }
+  for (Handle handle = 0; handle < mObjectPoints.size(); ++handle) {
+    TDataType *point = mParameterArena.getBlock(ObjectPointSection, handle);
+    point[0] = mObjectPoints[handle][0];
+    point[1] = mObjectPoints[handle][1];
+    point[2] = mObjectPoints[handle][2];
+  }
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+void ImageBlock<TCameraType, TImageType, TObjectPointType,
+                TDataType>::updateFromParameterArena() {
+  for (Handle handle = 0; handle < mCameras.size(); ++handle) {
+    mCameras[handle]->assignFromArray(
+        mParameterArena.getBlock(CameraSection, handle));
+    mCameras[handle]->getMountingParameters().assignFromArray(
+        mParameterArena.getBlock(MountingSection, handle));
+  }
+  for (Handle handle = 0; handle < mImages.size(); ++handle) {
+    mImages[handle]->assignFromArray(
+        mParameterArena.getBlock(BodyFrameSection, handle));
+  }
+  for (Handle handle = 0; handle < mObjectPoints.size(); ++handle) {
+    const TDataType *point =
+        mParameterArena.getBlock(ObjectPointSection, handle);
+    mObjectPoints[handle][0] = point[0];
+    mObjectPoints[handle][1] = point[1];
+    mObjectPoints[handle][2] = point[2];
+  }
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+ParameterArena<TDataType> &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getParameterArena() {
+  return mParameterArena;
+}
+
+template <typename TCameraType, typename TImageType, typename TObjectPointType,
+          typename TDataType>
+const ParameterArena<TDataType> &
+ImageBlock<TCameraType, TImageType, TObjectPointType,
+           TDataType>::getParameterArena() const {
+  return mParameterArena;
+}
 } // namespace Core
@@ -1,6 +1,10 @@
 #ifndef CORE_INTERIORORIENTATION_H
 #define CORE_INTERIORORIENTATION_H
 
+#include <memory>
+
+#include "DistortionInversionGrid.h"
+#include "DistortionModel.h"
 #include "Point.h"
 
 namespace Core {
@@ -10,30 +14,58 @@ namespace Core {
  * TDataType: data type of iops
  * Size: the number of distortion parameters associated with iops
  * default = 9:
- * 4 radial distortion parameters: k1, k2, and k3
- * 3 de-centric distortion parameters: p1, and p2
+ * 4 radial distortion parameters: k0, k1, k2, and k3
+ * 3 de-centric distortion parameters: p1, p2, and p3
  * 2 affine distortion parameters: a1, and a2
+ * TDistortionModel: the distortion model (see DistortionModel.h), i.e.,
+ * BrownDistortion for 9 and RadialDistortion for 4 distortion parameters by
+ * default. Size has to match the number of parameters of the model.
  */
-template <typename TDataType = double, int Size = 9> class InteriorOrientation {
+template <typename TDataType = double, int Size = 9,
+          typename TDistortionModel =
+              typename DefaultDistortionModel<Size>::Type>
+class InteriorOrientation {
+  static_assert(Size == TDistortionModel::NumberOfParameters,
+                "Size does not match the number of distortion parameters of "
+                "the distortion model");
+
 public:
+  /// Type of the distortion model
+  using DistortionModel = TDistortionModel;
+
   /// Default constructor
   InteriorOrientation() = default;
 
   /**
-   * This function calculates distortion at a given image point.
-   * Note: It can be overridden in the derived camera class.
+   * This function calculates distortion at a given image point with the
+   * distortion model.
    * @param[in] x x ccordinates of an image point
    * @param[in] y y coordinates of an image point
    * @return A 2 x 1 vector of image distortions
    */
-  virtual Eigen::Matrix<TDataType, 2, 1> calculateDistortion(const TDataType x,
-                                                             const TDataType y);
+  Eigen::Matrix<TDataType, 2, 1> calculateDistortion(const TDataType x,
+                                                     const TDataType y) const;
+
+  /**
+   * This function calculates the partial derivatives of the distortion at a
+   * given image point w.r.t. the image coordinates (i.e., d(distortion)/dx in
+   * the first column and d(distortion)/dy in the second one).
+   * @param[in] x x ccordinates of an image point
+   * @param[in] y y coordinates of an image point
+   * @return A 2 x 2 Jacobian matrix of image distortions
+   */
+  Eigen::Matrix<TDataType, 2, 2>
+  calculateDistortionJacobian(const TDataType x, const TDataType y) const;
 
   /**
    * This function takes distortion-free coordinates of an image point, and
    * returns the same point after adding distortion and correcting principal
    * offset.
-   * Note: It can be overridden in the derived camera class.
+   * The distorted point is looked up in the distortion inversion grid (if it
+   * is built and at least as accurate as the tolerance), or refined with
+   * Newton's method using calculateDistortionJacobian, starting from the grid
+   * (if available) or the distortion-free point. This function throws
+   * std::runtime_error if Newton's method does not converge.
    * @param[in] x x ccordinates of a distortion-free image point
    * @param[in] y y coordinates of a distortion image point
    * @param[in] tolerance Tolerance to stop adding distortion (default = 1e-6)
@@ -42,42 +74,131 @@ public:
    * @return A 2 x 1 vector of image coordinates after adding distortions and
    * principal offset
    */
-  virtual Eigen::Matrix<TDataType, 2, 1>
+  Eigen::Matrix<TDataType, 2, 1>
   addDistortion(const TDataType x, const TDataType y,
                 const TDataType tolerance = 1e-6,
                 const unsigned int maxIteration = 100);
 
+  /**
+   * This function adds distortion with fixed-point iterations (i.e., the
+   * distortion is re-evaluated at the last estimate until it converges).
+   * Note: It converges linearly at best, and is kept as a reference for
+   * addDistortion. The parameters are the same as the ones of addDistortion.
+   */
+  Eigen::Matrix<TDataType, 2, 1>
+  addDistortionWithFixedPointIterations(const TDataType x, const TDataType y,
+                                        const TDataType tolerance = 1e-6,
+                                        const unsigned int maxIteration = 100);
+
+  /**
+   * This function precomputes the distortion inversion grid used by
+   * addDistortion. The grid covers the image (see width, height and pixel
+   * sizes) with a relative margin, and is refined (by halving the cell size)
+   * until the interpolation error at the quarter and center points of all
+   * cells is within the given accuracy. Bicubic interpolation needs far fewer
+   * nodes than bilinear interpolation for tight accuracies, at a higher cost
+   * per lookup.
+   * Note: The grid is a snapshot of the current IOPs. It is discarded by
+   * assignFromArray, and has to be rebuilt if xyc or the distortion
+   * parameters are modified directly. This function throws
+   * std::invalid_argument if the image size is unknown.
+   * @param[in] accuracy Maximum interpolation error in image units
+   * @param[in] interpolation Interpolation between the grid nodes
+   * @param[in] maxNumberOfCells Maximum number of cells along x and y
+   * @param[in] margin Margin around the image relative to its size
+   * @return True if the accuracy is met (otherwise no grid is kept)
+   */
+  bool buildDistortionInversionGrid(
+      const TDataType accuracy = 1e-6,
+      const typename DistortionInversionGrid<TDataType>::Interpolation
+          interpolation =
+              DistortionInversionGrid<TDataType>::Interpolation::Bicubic,
+      const unsigned int maxNumberOfCells = 1024,
+      const TDataType margin = 0.1);
+
+  /// Discard the distortion inversion grid
+  void clearDistortionInversionGrid();
+
+  /// Get the distortion inversion grid (nullptr if there is no grid)
+  const DistortionInversionGrid<TDataType> *
+  getDistortionInversionGrid() const;
+
   /**
    * This function converts pixel location (i.e, row and col) to local image
    * coordinate system (origin is defined at image center; x is pointing to
    * right, and y is pointing up).
    */
   Eigen::Matrix<TDataType, 2, 1>
-  ConvertPixelToImageCoordinates(const TDataType row, const TDataType col);
+  ConvertPixelToImageCoordinates(const TDataType row,
+                                 const TDataType col) const;
 
   /**
    * This function converts image coordinates to corresponding pixel location
    * (i.e., row and col)
    */
   Eigen::Matrix<TDataType, 2, 1>
-  ConvertImageCoordinatesToPixel(const TDataType x, const TDataType y);
+  ConvertImageCoordinatesToPixel(const TDataType x, const TDataType y) const;
+
+  /**
+   * This function is the batch version of ConvertPixelToImageCoordinates for
+   * arrays of pixel locations (e.g., the columns of ObservationTable), which
+   * optionally removes the distortions as well (i.e., x - distortion and
+   * y - distortion, which are xp - c * X / Z and yp - c * Y / Z of the
+   * collinearity model). The points are processed in a single pass without
+   * temporaries, so that the loop is vectorized by the compiler for the
+   * polynomial distortion models.
+   * Note: The output arrays may be the input arrays (i.e., in-place
+   * conversion), but must not overlap them otherwise.
+   * @param[in] size The number of points
+   * @param[in] rows Rows of the pixel locations
+   * @param[in] cols Columns of the pixel locations
+   * @param[out] x x image coordinates
+   * @param[out] y y image coordinates
+   * @param[in] removeDistortions Flag to remove the distortions
+   */
+  void convertPixelsToImageCoordinates(const std::size_t size,
+                                       const TDataType *rows,
+                                       const TDataType *cols, TDataType *x,
+                                       TDataType *y,
+                                       const bool removeDistortions) const;
 
   /**
-   * This function concatenates xp, yp, c and distortion parameters to a single
-   * TDataType array, and returns the pointer of this array.
+   * This function writes xp, yp, c and distortion parameters to a single
+   * (3 + Size) x 1 array provided by the caller (e.g., a block of
+   * ParameterArena).
    */
-  const TDataType *convertToArray();
+  void convertToArray(TDataType *params) const;
+
+  /**
+   * This function reads xp, yp, c and distortion parameters from a
+   * (3 + Size) x 1 array in the layout of convertToArray.
+   */
+  void assignFromArray(const TDataType *params);
 
   /// Width and Height of image
-  unsigned int width;
-  unsigned int height;
+  unsigned int width = 0;
+  unsigned int height = 0;
   /// Pixel size
-  TDataType xPixelSize;
-  TDataType yPixelSize;
+  TDataType xPixelSize = static_cast<TDataType>(1);
+  TDataType yPixelSize = static_cast<TDataType>(1);
   /// Principal offset and Pricipal distance (xp, yp, c)
   Point<TDataType, 3> xyc;
   /// Distortion parameters (Size x 1 vector)
   Point<TDataType, Size> distortionParameters;
+
+private:
+  /// Newton's method for addDistortion starting at the given offset
+  Eigen::Matrix<TDataType, 2, 1>
+  addDistortionWithNewton(const TDataType x, const TDataType y,
+                          Eigen::Matrix<TDataType, 2, 1> offset,
+                          const TDataType tolerance,
+                          const unsigned int maxIteration);
+
+  /// Distortion inversion grid (shared by copies of the IOPs) and its
+  /// verified accuracy
+  std::shared_ptr<const DistortionInversionGrid<TDataType>>
+      mDistortionInversionGrid;
+  TDataType mDistortionInversionGridAccuracy = static_cast<TDataType>(0);
 };
 } // namespace Core
 
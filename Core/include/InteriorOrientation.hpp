@@ -1,58 +1,84 @@
 #include "InteriorOrientation.h"
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 namespace Core {
-template <typename TDataType, int Size>
+template <typename TDataType, int Size, typename TDistortionModel>
 Eigen::Matrix<TDataType, 2, 1>
-InteriorOrientation<TDataType, Size>::calculateDistortion(const TDataType x,
-                                                          const TDataType y) {
-  /**
-   * The default distortion parameters includes:
-   * 3 radial distortion parameters: k1, k2, and k3
-   * 2 de-centric distortion parameters: p1, and p2
-   * 2 affine distortion parameters: a1, and a2
-   */
-  // Compute distance from image point to principal point (xp, yp)
-  TDataType dx = x - xyc[0];
-  TDataType dy = y - xyc[1];
-  TDataType dxy = dx * dy;
-  TDataType dx2 = dx * dx;
-  TDataType dy2 = dy * dy;
-  TDataType r2 = dx2 + dy2;
-  // Compute radial distortion
-  TDataType k0 = distortionParameters[0];
-  TDataType k1 = distortionParameters[1];
-  TDataType k2 = distortionParameters[2];
-  TDataType k3 = distortionParameters[3];
-  TDataType radialDistortion = k0 + k1 * r2 + k2 * r2 * r2 + k3 * r2 * r2 * r2;
-  TDataType radialDistortionX = dx * radialDistortion;
-  TDataType radialDistortionY = dy * radialDistortion;
-  // Compute de-centric distortion
-  TDataType p1 = distortionParameters[4];
-  TDataType p2 = distortionParameters[5];
-  TDataType p3 = distortionParameters[6];
-  TDataType decentricDistortion = static_cast<TDataType>(1) + p3 * r2;
-  TDataType decentricDistortionX =
-      decentricDistortion * (p1 * (r2 + 2 * dx2) + 2 * p2 * dxy);
-  TDataType decentricDistortionY =
-      decentricDistortion * (2 * p1 * dxy + p2 * (r2 + 2 * dy2));
-  // Compute affine distortion
-  TDataType a1 = distortionParameters[7];
-  TDataType a2 = distortionParameters[8];
-  TDataType affineDistortionX = -a1 * dx + a2 * dy;
-  TDataType affineDistortionY = a1 * dy;
-
+InteriorOrientation<TDataType, Size, TDistortionModel>::calculateDistortion(
+    const TDataType x, const TDataType y) const {
+  // Distortions at the image point relative to the principal point (xp, yp)
   Eigen::Matrix<TDataType, 2, 1> distortions;
-  distortions[0] = radialDistortionX + decentricDistortionX + affineDistortionX;
-  distortions[1] = radialDistortionY + decentricDistortionY + affineDistortionY;
-
+  TDistortionModel::template Compute<TDataType>(
+      distortionParameters.data(), xyc[2], x - xyc[0], y - xyc[1],
+      distortions.data());
   return distortions;
 }
 
-template <typename TDataType, int Size>
+template <typename TDataType, int Size, typename TDistortionModel>
+Eigen::Matrix<TDataType, 2, 2>
+InteriorOrientation<TDataType, Size, TDistortionModel>::
+    calculateDistortionJacobian(const TDataType x, const TDataType y) const {
+  // Note: d(dx)/dx = 1 and d(dy)/dy = 1
+  Eigen::Matrix<TDataType, 2, 2> jacobian;
+  TDistortionModel::template ComputeJacobians<TDataType>(
+      distortionParameters.data(), xyc[2], x - xyc[0], y - xyc[1], jacobian,
+      nullptr);
+  return jacobian;
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
 Eigen::Matrix<TDataType, 2, 1>
-InteriorOrientation<TDataType, Size>::addDistortion(
+InteriorOrientation<TDataType, Size, TDistortionModel>::addDistortion(
     const TDataType x, const TDataType y, const TDataType tolerance,
     const unsigned int maxIteration) {
+  Eigen::Matrix<TDataType, 2, 1> offset =
+      Eigen::Matrix<TDataType, 2, 1>::Zero();
+  if (mDistortionInversionGrid &&
+      mDistortionInversionGrid->interpolate(x, y, offset) &&
+      mDistortionInversionGridAccuracy <= tolerance) {
+    return Eigen::Matrix<TDataType, 2, 1>{x + offset[0] + xyc[0],
+                                          y + offset[1] + xyc[1]};
+  }
+  return addDistortionWithNewton(x, y, offset, tolerance, maxIteration);
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
+Eigen::Matrix<TDataType, 2, 1>
+InteriorOrientation<TDataType, Size, TDistortionModel>::addDistortionWithNewton(
+    const TDataType x, const TDataType y,
+    Eigen::Matrix<TDataType, 2, 1> offset, const TDataType tolerance,
+    const unsigned int maxIteration) {
+  TDataType xp = xyc[0];
+  TDataType yp = xyc[1];
+  // Solve f(u) = u - distortion(u + xp) - x = 0 for u = x + offset
+  for (unsigned int iteration = 0; iteration < maxIteration; ++iteration) {
+    TDataType xUpdated = x + offset[0];
+    TDataType yUpdated = y + offset[1];
+    auto distortions = calculateDistortion(xUpdated + xp, yUpdated + yp);
+    Eigen::Matrix<TDataType, 2, 1> error{offset[0] - distortions[0],
+                                         offset[1] - distortions[1]};
+    if (error.norm() < tolerance) {
+      return Eigen::Matrix<TDataType, 2, 1>{xUpdated + xp, yUpdated + yp};
+    }
+    // df/du = I - d(distortion)/du
+    Eigen::Matrix<TDataType, 2, 2> jacobian =
+        Eigen::Matrix<TDataType, 2, 2>::Identity() -
+        calculateDistortionJacobian(xUpdated + xp, yUpdated + yp);
+    offset -= jacobian.inverse() * error;
+  }
+  throw std::runtime_error(
+      "Cannot converge when adding distortion for the given image point!");
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
+Eigen::Matrix<TDataType, 2, 1>
+InteriorOrientation<TDataType, Size, TDistortionModel>::
+    addDistortionWithFixedPointIterations(const TDataType x, const TDataType y,
+                                          const TDataType tolerance,
+                                          const unsigned int maxIteration) {
   TDataType xp = xyc[0];
   TDataType yp = xyc[1];
   TDataType xUpdated = x;
@@ -80,27 +106,153 @@ InteriorOrientation<TDataType, Size>::addDistortion(
   return Eigen::Matrix<TDataType, 2, 1>{xUpdated + xp, yUpdated + yp};
 }
 
-template <typename TDataType, int Size>
+template <typename TDataType, int Size, typename TDistortionModel>
+bool InteriorOrientation<TDataType, Size, TDistortionModel>::
+    buildDistortionInversionGrid(
+        const TDataType accuracy,
+        const typename DistortionInversionGrid<TDataType>::Interpolation
+            interpolation,
+        const unsigned int maxNumberOfCells, const TDataType margin) {
+  clearDistortionInversionGrid();
+  if (width == 0 || height == 0) {
+    throw std::invalid_argument(
+        "Cannot build the distortion inversion grid without the image size!");
+  }
+  // Image extent relative to the principal point, with margin
+  const TDataType halfWidth = (1 + 2 * margin) * width * xPixelSize / 2;
+  const TDataType halfHeight = (1 + 2 * margin) * height * yPixelSize / 2;
+  const Eigen::Matrix<TDataType, 2, 1> minimum{-halfWidth - xyc[0],
+                                               -halfHeight - xyc[1]};
+  const Eigen::Matrix<TDataType, 2, 1> maximum{halfWidth - xyc[0],
+                                               halfHeight - xyc[1]};
+  // Note: Nodes are solved well beyond the requested accuracy.
+  const TDataType nodeTolerance = accuracy * static_cast<TDataType>(1e-3);
+  const Eigen::Matrix<TDataType, 2, 1> zero =
+      Eigen::Matrix<TDataType, 2, 1>::Zero();
+  auto offsetFunction = [&](const TDataType x, const TDataType y) {
+    auto point = addDistortionWithNewton(x, y, zero, nodeTolerance, 100);
+    return Eigen::Matrix<TDataType, 2, 1>{point[0] - xyc[0] - x,
+                                          point[1] - xyc[1] - y};
+  };
+
+  // Start with cells of roughly square shape, and halve them until the
+  // interpolation error at the quarter and center points of all cells is
+  // within the accuracy
+  const TDataType quarter = static_cast<TDataType>(0.25);
+  const TDataType aspectRatio = halfHeight / halfWidth;
+  unsigned int numberOfCellsX = 16;
+  unsigned int numberOfCellsY = std::max(
+      1u, static_cast<unsigned int>(std::ceil(numberOfCellsX * aspectRatio)));
+  while (numberOfCellsX <= maxNumberOfCells &&
+         numberOfCellsY <= maxNumberOfCells) {
+    auto grid = std::make_shared<DistortionInversionGrid<TDataType>>();
+    grid->build(minimum, maximum, numberOfCellsX, numberOfCellsY,
+                offsetFunction, interpolation);
+    const TDataType cellWidth = (maximum[0] - minimum[0]) / numberOfCellsX;
+    const TDataType cellHeight = (maximum[1] - minimum[1]) / numberOfCellsY;
+    TDataType maxError = 0;
+    for (unsigned int iy = 0; iy < numberOfCellsY; ++iy) {
+      for (unsigned int ix = 0; ix < numberOfCellsX; ++ix) {
+        // Quarter, center and three-quarter points of the cell
+        for (unsigned int sample = 0; sample < 9; ++sample) {
+          const TDataType x =
+              minimum[0] + (ix + quarter * (sample % 3 + 1)) * cellWidth;
+          const TDataType y =
+              minimum[1] + (iy + quarter * (sample / 3 + 1)) * cellHeight;
+          Eigen::Matrix<TDataType, 2, 1> offset;
+          grid->interpolate(x, y, offset);
+          maxError =
+              std::max(maxError, (offset - offsetFunction(x, y)).norm());
+        }
+      }
+    }
+    if (maxError <= accuracy) {
+      mDistortionInversionGrid = grid;
+      mDistortionInversionGridAccuracy = accuracy;
+      return true;
+    }
+    numberOfCellsX *= 2;
+    numberOfCellsY *= 2;
+  }
+  return false;
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
+void InteriorOrientation<TDataType, Size,
+                         TDistortionModel>::clearDistortionInversionGrid() {
+  mDistortionInversionGrid.reset();
+  mDistortionInversionGridAccuracy = static_cast<TDataType>(0);
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
+const DistortionInversionGrid<TDataType> *
+InteriorOrientation<TDataType, Size, TDistortionModel>::
+    getDistortionInversionGrid() const {
+  return mDistortionInversionGrid.get();
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
 Eigen::Matrix<TDataType, 2, 1>
-InteriorOrientation<TDataType, Size>::ConvertPixelToImageCoordinates(
-    const TDataType row, const TDataType col) {
+InteriorOrientation<TDataType, Size, TDistortionModel>::
+    ConvertPixelToImageCoordinates(const TDataType row,
+                                   const TDataType col) const {
   TDataType x = (col - width * 0.5) * xPixelSize;
   TDataType y = (height * 0.5 - row) * yPixelSize;
   return Eigen::Matrix<TDataType, 2, 1>{x, y};
 }
 
-template <typename TDataType, int Size>
+template <typename TDataType, int Size, typename TDistortionModel>
 Eigen::Matrix<TDataType, 2, 1>
-InteriorOrientation<TDataType, Size>::ConvertImageCoordinatesToPixel(
-    const TDataType x, const TDataType y) {
+InteriorOrientation<TDataType, Size, TDistortionModel>::
+    ConvertImageCoordinatesToPixel(const TDataType x,
+                                   const TDataType y) const {
   TDataType row = height * 0.5 - y / yPixelSize;
   TDataType col = x / xPixelSize + width * 0.5;
   return Eigen::Matrix<TDataType, 2, 1>(row, col);
 }
 
-template <typename TDataType, int Size>
-const TDataType *InteriorOrientation<TDataType, Size>::convertToArray() {
-  TDataType *params = new TDataType[3 + Size];
+template <typename TDataType, int Size, typename TDistortionModel>
+void InteriorOrientation<TDataType, Size, TDistortionModel>::
+    convertPixelsToImageCoordinates(const std::size_t size,
+                                    const TDataType *rows,
+                                    const TDataType *cols, TDataType *x,
+                                    TDataType *y,
+                                    const bool removeDistortions) const {
+  // Note: Local copies of the IOPs, so that the compiler does not have to
+  // reload them after every store to x and y
+  const TDataType halfWidth = width * 0.5;
+  const TDataType halfHeight = height * 0.5;
+  const TDataType xPixel = xPixelSize;
+  const TDataType yPixel = yPixelSize;
+  if (!removeDistortions) {
+    for (std::size_t i = 0; i < size; ++i) {
+      const TDataType xImage = (cols[i] - halfWidth) * xPixel;
+      const TDataType yImage = (halfHeight - rows[i]) * yPixel;
+      x[i] = xImage;
+      y[i] = yImage;
+    }
+    return;
+  }
+  const TDataType xp = xyc[0];
+  const TDataType yp = xyc[1];
+  const TDataType c = xyc[2];
+  TDataType params[Size];
+  std::copy(distortionParameters.data(), distortionParameters.data() + Size,
+            params);
+  for (std::size_t i = 0; i < size; ++i) {
+    const TDataType xImage = (cols[i] - halfWidth) * xPixel;
+    const TDataType yImage = (halfHeight - rows[i]) * yPixel;
+    TDataType distortions[2];
+    TDistortionModel::template Compute<TDataType>(params, c, xImage - xp,
+                                                  yImage - yp, distortions);
+    x[i] = xImage - distortions[0];
+    y[i] = yImage - distortions[1];
+  }
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
+void InteriorOrientation<TDataType, Size, TDistortionModel>::convertToArray(
+    TDataType *params) const {
   // Assign xp, yp, c
   params[0] = xyc[0];
   params[1] = xyc[1];
@@ -109,6 +261,18 @@ const TDataType *InteriorOrientation<TDataType, Size>::convertToArray() {
   for (unsigned int i = 0; i < Size; ++i) {
     params[3 + i] = distortionParameters[i];
   }
-  return params;
+}
+
+template <typename TDataType, int Size, typename TDistortionModel>
+void InteriorOrientation<TDataType, Size, TDistortionModel>::assignFromArray(
+    const TDataType *params) {
+  xyc[0] = params[0];
+  xyc[1] = params[1];
+  xyc[2] = params[2];
+  for (unsigned int i = 0; i < Size; ++i) {
+    distortionParameters[i] = params[3 + i];
+  }
+  // The grid does not match the new IOPs anymore
+  clearDistortionInversionGrid();
 }
 } // namespace Core
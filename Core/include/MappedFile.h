@@ -0,0 +1,39 @@
+#ifndef CORE_MAPPEDFILE_H
+#define CORE_MAPPEDFILE_H
+
+#include <string>
+
+namespace Core {
+/**
+ * This is the class for a read-only memory-mapped file (e.g., SBET
+ * trajectories and binary projects), whose pages are read from disk only when
+ * they are accessed.
+ * Note: Memory mapping is implemented with POSIX mmap. The mapping starts at
+ * a page boundary, so data of any fundamental type at aligned file offsets
+ * can be accessed in place.
+ */
+class MappedFile {
+public:
+  /**
+   * Constructor, which maps the whole file
+   * Note: This function throws std::runtime_error if the file cannot be
+   * mapped.
+   */
+  explicit MappedFile(const std::string &filePath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /// Get the mapped bytes (nullptr for an empty file)
+  const char *data() const;
+  /// Get the number of mapped bytes
+  std::size_t size() const;
+
+private:
+  void *mData = nullptr;
+  std::size_t mSize = 0;
+};
+} // namespace Core
+
+#endif // CORE_MAPPEDFILE_H
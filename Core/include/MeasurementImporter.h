@@ -0,0 +1,172 @@
+#ifndef CORE_MEASUREMENTIMPORTER_H
+#define CORE_MEASUREMENTIMPORTER_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IdRegistry.h"
+#include "MappedFile.h"
+
+namespace Core {
+/**
+ * This is the class to import image point measurements from text files in
+ * bulk, i.e.,
+ * - image coordinate files in the style of PATB and BINGO, which contain
+ * blocks of measurements, each of them starting with a header line whose
+ * first token is the image id (further tokens, e.g., the camera, are
+ * ignored), followed by "pointId x y" lines and terminated by a "-99" line;
+ * - one file per image with "pointId x y" lines (and an optional "-99"
+ * line at the end).
+ * Files are memory-mapped, split into pieces at the block boundaries, and
+ * the pieces are parsed in parallel into local arrays (i.e., without locks;
+ * the image block is only read). The measurements are then appended to the
+ * observations of the image block in one bulk commit (see
+ * ImageBlock::setObservations), sorted by image.
+ * Note: Unlike adding image points to the images (see PointCloud::addPoint)
+ * and building the observations from the tie points of the object points,
+ * no image point is copied or hashed. The images have to be in the image
+ * block, and duplicated measurements are not detected.
+ */
+class MeasurementImporter {
+public:
+  /// Coordinate systems of the measurements
+  enum class CoordinateSystem {
+    /// Columns and rows (see ImagePoint)
+    Pixels,
+    /// Image coordinates (x right and y up from the image center, in the
+    /// units of the pixel sizes, see
+    /// InteriorOrientation::ConvertImageCoordinatesToPixel)
+    ImageCoordinates
+  };
+
+  struct Options {
+    CoordinateSystem coordinateSystem = CoordinateSystem::ImageCoordinates;
+    /// Standard deviation of the coordinates (in the coordinate system of the
+    /// measurements)
+    double sigma = 1.0;
+    /// Flag to add object points which are not in the image block (at the
+    /// origin, e.g., to be triangulated), or to throw std::invalid_argument
+    bool addMissingObjectPoints = true;
+    /// Number of threads (0 = number of hardware threads)
+    unsigned int numberOfThreads = 0;
+  };
+
+  struct Statistics {
+    std::size_t numberOfFiles = 0;
+    std::size_t numberOfObservations = 0;
+    std::size_t numberOfAddedObjectPoints = 0;
+    /// Wall-clock time of the import in seconds
+    double seconds = 0.0;
+
+    double getObservationsPerSecond() const {
+      return seconds > 0.0 ? numberOfObservations / seconds : 0.0;
+    }
+  };
+
+  /**
+   * Import image coordinate files (i.e., blocks of measurements of images)
+   * into an image block
+   * Note: This function throws std::runtime_error if a file cannot be read
+   * or is malformed, and std::invalid_argument if an image (or an object
+   * point, see Options) is not in the image block. The image block is not
+   * modified in that case.
+   */
+  template <typename TImageBlockType>
+  static Statistics ImportBlockFiles(const std::vector<std::string> &filePaths,
+                                     TImageBlockType &imageBlock,
+                                     const Options &options = Options());
+
+  /**
+   * Import one measurement file per image into an image block (see
+   * ImportBlockFiles)
+   * @param[in] imageIds The image id of every file
+   */
+  template <typename TImageBlockType>
+  static Statistics ImportImageFiles(const std::vector<std::string> &filePaths,
+                                     const std::vector<std::string> &imageIds,
+                                     TImageBlockType &imageBlock,
+                                     const Options &options = Options());
+
+private:
+  /// Range of a file, which is parsed by one task
+  struct Piece {
+    std::size_t fileIndex;
+    const char *first;
+    const char *last;
+    /// Image of the measurements (InvalidHandle for image coordinate files,
+    /// whose pieces start with a header line)
+    Handle imageHandle;
+  };
+
+  /// Token of a line
+  struct Token {
+    const char *first;
+    const char *last;
+
+    std::string toString() const { return std::string(first, last); }
+    bool isTerminator() const;
+  };
+
+  /// Measurements of a piece (see ObservationTable)
+  template <typename TDataType> struct Measurements {
+    std::vector<Handle> imageHandles;
+    /// Object point handles (InvalidHandle for missing object points)
+    std::vector<Handle> pointHandles;
+    std::vector<TDataType> x;
+    std::vector<TDataType> y;
+    std::vector<TDataType> sqrtInformation;
+    /// Index and id of the measurements of missing object points
+    std::vector<std::pair<std::size_t, std::string>> missingObjectPoints;
+  };
+
+  using MappedFiles = std::vector<std::unique_ptr<MappedFile>>;
+
+  /// Map all files
+  /// Note: This function throws std::runtime_error if a file cannot be read.
+  static MappedFiles MapFiles(const std::vector<std::string> &filePaths);
+
+  /**
+   * Split the files into pieces of at least the given size, which end after
+   * a "-99" line (i.e., at block boundaries)
+   */
+  static std::vector<Piece> SplitIntoPieces(const MappedFiles &files,
+                                            const std::size_t pieceSize);
+
+  /**
+   * Read the tokens of the next non-empty line
+   * @param[out] tokens The first (at most maxTokens) tokens
+   * @return The number of tokens of the line (0 at the end)
+   */
+  static std::size_t ReadLine(const char *&position, const char *last,
+                              Token *tokens, const std::size_t maxTokens);
+
+  /// Parse a coordinate token
+  /// Note: This function throws std::runtime_error if it is not a number.
+  static double ParseCoordinate(const Token &token,
+                                const std::string &filePath);
+
+  /// Parse the measurements of a piece
+  template <typename TImageBlockType>
+  static void
+  ParsePiece(const Piece &piece, const std::string &filePath,
+             const TImageBlockType &imageBlock, const Options &options,
+             Measurements<typename TImageBlockType::DataType> &measurements);
+
+  /**
+   * Parse the pieces in parallel, and append their measurements to the
+   * observations of the image block
+   * @return The numbers of observations and added object points
+   */
+  template <typename TImageBlockType>
+  static Statistics Import(const std::vector<std::string> &filePaths,
+                           const std::vector<Piece> &pieces,
+                           TImageBlockType &imageBlock,
+                           const Options &options);
+};
+} // namespace Core
+
+#include "MeasurementImporter.hpp"
+
+#endif // CORE_MEASUREMENTIMPORTER_H
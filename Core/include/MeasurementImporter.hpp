@@ -0,0 +1,211 @@
+#include "MeasurementImporter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "NumberParser.h"
+#include "ObservationTable.h"
+#include "Parallel.h"
+
+namespace Core {
+template <typename TImageBlockType>
+MeasurementImporter::Statistics
+MeasurementImporter::ImportBlockFiles(const std::vector<std::string> &filePaths,
+                                      TImageBlockType &imageBlock,
+                                      const Options &options) {
+  const auto start = std::chrono::steady_clock::now();
+  const MappedFiles files = MapFiles(filePaths);
+  std::size_t totalSize = 0;
+  for (const auto &file : files) {
+    totalSize += file->size();
+  }
+  // About 4 pieces per thread for load balancing, of at least 1 MB
+  const unsigned int numberOfThreads = options.numberOfThreads == 0
+                                           ? GetNumberOfHardwareThreads()
+                                           : options.numberOfThreads;
+  const std::size_t pieceSize =
+      std::max<std::size_t>(1 << 20, totalSize / (4 * numberOfThreads));
+  Statistics statistics = Import(
+      filePaths, SplitIntoPieces(files, pieceSize), imageBlock, options);
+  statistics.numberOfFiles = files.size();
+  statistics.seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  return statistics;
+}
+
+template <typename TImageBlockType>
+MeasurementImporter::Statistics
+MeasurementImporter::ImportImageFiles(const std::vector<std::string> &filePaths,
+                                      const std::vector<std::string> &imageIds,
+                                      TImageBlockType &imageBlock,
+                                      const Options &options) {
+  if (filePaths.size() != imageIds.size()) {
+    throw std::invalid_argument(
+        "The numbers of files and image ids do not match!");
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const MappedFiles files = MapFiles(filePaths);
+  std::vector<Piece> pieces(files.size());
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    pieces[i].fileIndex = i;
+    pieces[i].first = files[i]->data();
+    pieces[i].last = files[i]->data() + files[i]->size();
+    pieces[i].imageHandle = imageBlock.getImageHandle(imageIds[i]);
+  }
+  Statistics statistics = Import(filePaths, pieces, imageBlock, options);
+  statistics.numberOfFiles = files.size();
+  statistics.seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  return statistics;
+}
+
+template <typename TImageBlockType>
+void MeasurementImporter::ParsePiece(
+    const Piece &piece, const std::string &filePath,
+    const TImageBlockType &imageBlock, const Options &options,
+    Measurements<typename TImageBlockType::DataType> &measurements) {
+  using DataType = typename TImageBlockType::DataType;
+  const bool isImageFile = piece.imageHandle != InvalidHandle;
+  const bool inPixels = options.coordinateSystem == CoordinateSystem::Pixels;
+  Handle imageHandle = InvalidHandle;
+  const typename TImageBlockType::CameraType *camera = nullptr;
+  // Square root of the information of the coordinates in pixels
+  DataType sqrtInformation[2];
+  auto setImage = [&](const Handle handle) {
+    imageHandle = handle;
+    sqrtInformation[0] = sqrtInformation[1] =
+        static_cast<DataType>(1.0 / options.sigma);
+    if (!inPixels) {
+      const Handle cameraHandle = imageBlock.getCameraHandleOfImage(handle);
+      if (cameraHandle == InvalidHandle) {
+        throw std::invalid_argument("Cannot find the camera of the image " +
+                                    imageBlock.getImageId(handle) + "!");
+      }
+      camera = imageBlock.getCamera(cameraHandle).get();
+      sqrtInformation[0] *= camera->xPixelSize;
+      sqrtInformation[1] *= camera->yPixelSize;
+    }
+  };
+  if (isImageFile) {
+    setImage(piece.imageHandle);
+  }
+
+  const char *position = piece.first;
+  Token tokens[3];
+  std::size_t numberOfTokens;
+  while ((numberOfTokens = ReadLine(position, piece.last, tokens, 3)) != 0) {
+    if (tokens[0].isTerminator()) {
+      // End of the measurements of the image
+      if (!isImageFile) {
+        imageHandle = InvalidHandle;
+      }
+      continue;
+    }
+    if (imageHandle == InvalidHandle) {
+      setImage(imageBlock.getImageHandle(tokens[0].toString()));
+      continue;
+    }
+    if (numberOfTokens < 3) {
+      throw std::runtime_error("Invalid measurement in the file " + filePath +
+                               "!");
+    }
+
+    const std::string pointId = tokens[0].toString();
+    const Handle pointHandle = imageBlock.findObjectPointHandle(pointId);
+    if (pointHandle == InvalidHandle) {
+      if (!options.addMissingObjectPoints) {
+        throw std::invalid_argument("Cannot find the object point " +
+                                    pointId + " in the image block!");
+      }
+      measurements.missingObjectPoints.emplace_back(measurements.x.size(),
+                                                    pointId);
+    }
+    DataType x = static_cast<DataType>(ParseCoordinate(tokens[1], filePath));
+    DataType y = static_cast<DataType>(ParseCoordinate(tokens[2], filePath));
+    if (!inPixels) {
+      const auto pixel = camera->ConvertImageCoordinatesToPixel(x, y);
+      x = pixel[1];
+      y = pixel[0];
+    }
+    measurements.imageHandles.push_back(imageHandle);
+    measurements.pointHandles.push_back(pointHandle);
+    measurements.x.push_back(x);
+    measurements.y.push_back(y);
+    measurements.sqrtInformation.push_back(sqrtInformation[0]);
+    measurements.sqrtInformation.push_back(static_cast<DataType>(0));
+    measurements.sqrtInformation.push_back(sqrtInformation[1]);
+  }
+}
+
+template <typename TImageBlockType>
+MeasurementImporter::Statistics
+MeasurementImporter::Import(const std::vector<std::string> &filePaths,
+                            const std::vector<Piece> &pieces,
+                            TImageBlockType &imageBlock,
+                            const Options &options) {
+  using DataType = typename TImageBlockType::DataType;
+  using ObjectPointType = typename TImageBlockType::ObjectPointType;
+
+  // Parse the pieces (every task only reads the image block)
+  std::vector<Measurements<DataType>> measurements(pieces.size());
+  ParallelFor(
+      pieces.size(),
+      [&](const std::size_t begin, const std::size_t end, const unsigned int) {
+        for (std::size_t i = begin; i < end; ++i) {
+          ParsePiece(pieces[i], filePaths[pieces[i].fileIndex], imageBlock,
+                     options, measurements[i]);
+        }
+      },
+      options.numberOfThreads, 1);
+
+  // Add the missing object points in the order of the files
+  Statistics statistics;
+  for (auto &piece : measurements) {
+    for (const auto &missingObjectPoint : piece.missingObjectPoints) {
+      Handle handle =
+          imageBlock.findObjectPointHandle(missingObjectPoint.second);
+      if (handle == InvalidHandle) {
+        handle = imageBlock.getNumberOfObjectPoints();
+        imageBlock.addObjectPoint(missingObjectPoint.second,
+                                  ObjectPointType(0.0, 0.0, 0.0));
+        ++statistics.numberOfAddedObjectPoints;
+      }
+      piece.pointHandles[missingObjectPoint.first] = handle;
+    }
+    statistics.numberOfObservations += piece.x.size();
+  }
+
+  // Append all measurements to the observations in one commit
+  const Handle numberOfImages = imageBlock.getNumberOfImages();
+  std::vector<Handle> cameraHandlesOfImages(numberOfImages);
+  for (Handle imageHandle = 0; imageHandle < numberOfImages; ++imageHandle) {
+    cameraHandlesOfImages[imageHandle] =
+        imageBlock.getCameraHandleOfImage(imageHandle);
+  }
+  ObservationTable<DataType> observations = imageBlock.getObservations();
+  std::size_t index = observations.size();
+  observations.resize(index + statistics.numberOfObservations);
+  for (const auto &piece : measurements) {
+    const std::size_t size = piece.x.size();
+    std::copy(piece.imageHandles.begin(), piece.imageHandles.end(),
+              observations.imageHandles.begin() + index);
+    std::copy(piece.pointHandles.begin(), piece.pointHandles.end(),
+              observations.pointHandles.begin() + index);
+    for (std::size_t i = 0; i < size; ++i) {
+      observations.cameraHandles[index + i] =
+          cameraHandlesOfImages[piece.imageHandles[i]];
+    }
+    std::copy(piece.x.begin(), piece.x.end(), observations.x.begin() + index);
+    std::copy(piece.y.begin(), piece.y.end(), observations.y.begin() + index);
+    std::copy(piece.sqrtInformation.begin(), piece.sqrtInformation.end(),
+              observations.sqrtInformation.begin() + 3 * index);
+    index += size;
+  }
+  observations.sortByImage();
+  imageBlock.setObservations(std::move(observations));
+  return statistics;
+}
+} // namespace Core
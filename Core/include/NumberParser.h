@@ -0,0 +1,43 @@
+#ifndef CORE_NUMBERPARSER_H
+#define CORE_NUMBERPARSER_H
+
+#include <cstdint>
+
+namespace Core {
+/**
+ * Parse a decimal floating-point number (i.e., [+-]digits[.digits][(e|E)
+ * [+-]digits]) at the beginning of [first, last), independently of the
+ * locale (unlike strtod and streams)
+ * Note: The result is within one ulp of the correctly rounded value. Digits
+ * beyond the 19th significant digit are ignored.
+ * @param[in,out] first The first character, which is advanced past the number
+ * if it is parsed
+ * @param[in] last The end of the characters
+ * @param[out] value The parsed number
+ * @return True: if a number is parsed; False: otherwise
+ */
+bool ParseDouble(const char *&first, const char *last, double &value);
+
+/**
+ * Parse a decimal integer (i.e., [+-]digits) at the beginning of [first,
+ * last) (see ParseDouble)
+ * @return True: if an integer is parsed, which fits into 64 bits; False:
+ * otherwise
+ */
+bool ParseInteger(const char *&first, const char *last, std::int64_t &value);
+
+/// Check if the character is a whitespace (i.e., space, tab, CR or LF)
+inline bool IsWhitespace(const char character) {
+  return character == ' ' || character == '\n' || character == '\r' ||
+         character == '\t';
+}
+
+/// Skip whitespaces at the beginning of [first, last)
+inline void SkipWhitespaces(const char *&first, const char *last) {
+  while (first != last && IsWhitespace(*first)) {
+    ++first;
+  }
+}
+} // namespace Core
+
+#endif // CORE_NUMBERPARSER_H
@@ -0,0 +1,99 @@
+#ifndef CORE_OBSERVATIONTABLE_H
+#define CORE_OBSERVATIONTABLE_H
+
+#include <vector>
+
+#include "eigen3/Eigen/Core"
+
+#include "IdRegistry.h"
+
+namespace Core {
+/**
+ * This is the class for a flat, structure-of-arrays view of all image point
+ * observations in an image block. The i-th observation is described by
+ * imageHandles[i], pointHandles[i] (object point), cameraHandles[i], the
+ * measured image point (x[i], y[i]) (i.e., column and row as in ImagePoint),
+ * and the packed upper-triangular square root of its information matrix
+ * (sqrtInformation[3 * i + 0..2] = s00, s01 and s11).
+ */
+template <typename TDataType = double> class ObservationTable {
+public:
+  /// Order of the observations
+  enum class SortOrder { Unsorted, ByImage, ByPoint };
+
+  /// Default constructor
+  ObservationTable() = default;
+
+  /**
+   * Build the observation table from all tie points of the object points in
+   * an image block (i.e., ObjectPoint::mTiePointIds) in one parallel pass.
+   * The resulting observations are sorted by object point.
+   * Note: This function throws std::invalid_argument if a tie point refers to
+   * an unknown image or image point.
+   * @param[in] imageBlock The image block
+   * @param[in] numberOfThreads The number of threads (default = 0, i.e., the
+   * number of hardware threads)
+   */
+  template <typename TImageBlockType>
+  static ObservationTable Build(const TImageBlockType &imageBlock,
+                                const unsigned int numberOfThreads = 0);
+
+  /**
+   * Append an observation
+   * @param[in] covariance The variance-covariance matrix of the image point
+   */
+  void addObservation(const Handle imageHandle, const Handle pointHandle,
+                      const Handle cameraHandle, const TDataType x,
+                      const TDataType y,
+                      const Eigen::Matrix<TDataType, 2, 2> &covariance =
+                          Eigen::Matrix<TDataType, 2, 2>::Identity());
+
+  /// Reserve memory for the given number of observations
+  void reserve(const std::size_t numberOfObservations);
+  /// Resize all arrays to the given number of observations
+  void resize(const std::size_t numberOfObservations);
+  /// Remove all observations
+  void clear();
+
+  /// Stable sort of observations by image handle
+  void sortByImage();
+  /// Stable sort of observations by object point handle
+  void sortByPoint();
+  /// Return the current order of the observations
+  SortOrder getSortOrder() const;
+
+  /// Return the number of observations
+  std::size_t size() const;
+
+  /// Get the square root information matrix of the i-th observation
+  Eigen::Matrix<TDataType, 2, 2>
+  getSquareRootInformation(const std::size_t index) const;
+
+  /**
+   * Compute the packed upper-triangular square root of the inverse of a 2 x 2
+   * variance-covariance matrix (i.e., s00, s01 and s11)
+   */
+  static void
+  PackSquareRootInformation(const Eigen::Matrix<TDataType, 2, 2> &covariance,
+                            TDataType *packedSqrtInformation);
+
+  /// Contiguous arrays of the observations
+  std::vector<Handle> imageHandles;
+  std::vector<Handle> pointHandles;
+  std::vector<Handle> cameraHandles;
+  std::vector<TDataType> x;
+  std::vector<TDataType> y;
+  std::vector<TDataType> sqrtInformation;
+
+private:
+  /// Stable counting sort of all arrays by the given keys (skipped if they
+  /// are already sorted, e.g., for bulk imports)
+  void sortByKeys(const std::vector<Handle> &keys);
+
+  SortOrder mSortOrder = SortOrder::Unsorted;
+};
+} // namespace Core
+
+#include "ObservationTable.hpp"
+
+#endif // CORE_OBSERVATIONTABLE_H
@@ -0,0 +1,208 @@
+#include "ObservationTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Parallel.h"
+
+namespace Core {
+template <typename TDataType>
+template <typename TImageBlockType>
+ObservationTable<TDataType>
+ObservationTable<TDataType>::Build(const TImageBlockType &imageBlock,
+                                   const unsigned int numberOfThreads) {
+  // Resolve the camera of every image once
+  const Handle numberOfImages = imageBlock.getNumberOfImages();
+  std::vector<Handle> cameraHandlesOfImages(numberOfImages);
+  for (Handle imageHandle = 0; imageHandle < numberOfImages; ++imageHandle) {
+    cameraHandlesOfImages[imageHandle] =
+        imageBlock.getCameraHandleOfImage(imageHandle);
+  }
+
+  // Offsets of the observations of every object point
+  const auto &objectPoints = imageBlock.getObjectPoints();
+  std::vector<std::size_t> offsets(objectPoints.size() + 1, 0);
+  for (std::size_t i = 0; i < objectPoints.size(); ++i) {
+    offsets[i + 1] = offsets[i] + objectPoints[i].mTiePointIds.size();
+  }
+
+  ObservationTable table;
+  table.resize(offsets.back());
+  ParallelFor(
+      objectPoints.size(),
+      [&](const std::size_t begin, const std::size_t end, const unsigned int) {
+        for (std::size_t pointIndex = begin; pointIndex < end; ++pointIndex) {
+          std::size_t index = offsets[pointIndex];
+          for (const auto &tiePoint : objectPoints[pointIndex].mTiePointIds) {
+            const Handle imageHandle =
+                imageBlock.getImageHandle(tiePoint.first);
+            const auto &imagePoint =
+                imageBlock.getImage(imageHandle)->getPoint(tiePoint.second);
+            table.imageHandles[index] = imageHandle;
+            table.pointHandles[index] = static_cast<Handle>(pointIndex);
+            table.cameraHandles[index] = cameraHandlesOfImages[imageHandle];
+            table.x[index] = imagePoint[0];
+            table.y[index] = imagePoint[1];
+            PackSquareRootInformation(imagePoint.getCovariance(),
+                                      &table.sqrtInformation[3 * index]);
+            ++index;
+          }
+        }
+      },
+      numberOfThreads);
+  // Tie points of a single object point come from an unordered_map, so sort
+  // them by image to make the table deterministic
+  table.sortByImage();
+  table.sortByPoint();
+  return table;
+}
+
+template <typename TDataType>
+void ObservationTable<TDataType>::addObservation(
+    const Handle imageHandle, const Handle pointHandle,
+    const Handle cameraHandle, const TDataType xCoordinate,
+    const TDataType yCoordinate,
+    const Eigen::Matrix<TDataType, 2, 2> &covariance) {
+  imageHandles.push_back(imageHandle);
+  pointHandles.push_back(pointHandle);
+  cameraHandles.push_back(cameraHandle);
+  x.push_back(xCoordinate);
+  y.push_back(yCoordinate);
+  sqrtInformation.resize(sqrtInformation.size() + 3);
+  PackSquareRootInformation(covariance,
+                            &sqrtInformation[sqrtInformation.size() - 3]);
+  mSortOrder = SortOrder::Unsorted;
+}
+
+template <typename TDataType>
+void ObservationTable<TDataType>::reserve(
+    const std::size_t numberOfObservations) {
+  imageHandles.reserve(numberOfObservations);
+  pointHandles.reserve(numberOfObservations);
+  cameraHandles.reserve(numberOfObservations);
+  x.reserve(numberOfObservations);
+  y.reserve(numberOfObservations);
+  sqrtInformation.reserve(3 * numberOfObservations);
+}
+
+template <typename TDataType>
+void ObservationTable<TDataType>::resize(
+    const std::size_t numberOfObservations) {
+  imageHandles.resize(numberOfObservations);
+  pointHandles.resize(numberOfObservations);
+  cameraHandles.resize(numberOfObservations);
+  x.resize(numberOfObservations);
+  y.resize(numberOfObservations);
+  sqrtInformation.resize(3 * numberOfObservations);
+  mSortOrder = SortOrder::Unsorted;
+}
+
+template <typename TDataType> void ObservationTable<TDataType>::clear() {
+  resize(0);
+}
+
+template <typename TDataType> void ObservationTable<TDataType>::sortByImage() {
+  if (mSortOrder != SortOrder::ByImage) {
+    sortByKeys(imageHandles);
+    mSortOrder = SortOrder::ByImage;
+  }
+}
+
+template <typename TDataType> void ObservationTable<TDataType>::sortByPoint() {
+  if (mSortOrder != SortOrder::ByPoint) {
+    sortByKeys(pointHandles);
+    mSortOrder = SortOrder::ByPoint;
+  }
+}
+
+template <typename TDataType>
+typename ObservationTable<TDataType>::SortOrder
+ObservationTable<TDataType>::getSortOrder() const {
+  return mSortOrder;
+}
+
+template <typename TDataType>
+std::size_t ObservationTable<TDataType>::size() const {
+  return imageHandles.size();
+}
+
+template <typename TDataType>
+Eigen::Matrix<TDataType, 2, 2>
+ObservationTable<TDataType>::getSquareRootInformation(
+    const std::size_t index) const {
+  Eigen::Matrix<TDataType, 2, 2> sqrtInfo;
+  sqrtInfo << sqrtInformation[3 * index], sqrtInformation[3 * index + 1],
+      static_cast<TDataType>(0), sqrtInformation[3 * index + 2];
+  return sqrtInfo;
+}
+
+template <typename TDataType>
+void ObservationTable<TDataType>::PackSquareRootInformation(
+    const Eigen::Matrix<TDataType, 2, 2> &covariance,
+    TDataType *packedSqrtInformation) {
+  // Information matrix (i.e., inverse of the variance-covariance matrix)
+  const TDataType determinant = covariance(0, 0) * covariance(1, 1) -
+                                covariance(0, 1) * covariance(1, 0);
+  if (!(determinant > static_cast<TDataType>(0)) ||
+      !(covariance(0, 0) > static_cast<TDataType>(0))) {
+    throw std::invalid_argument(
+        "The variance-covariance matrix of the image point is not positive "
+        "definite!");
+  }
+  const TDataType information00 = covariance(1, 1) / determinant;
+  const TDataType information01 = -covariance(0, 1) / determinant;
+  const TDataType information11 = covariance(0, 0) / determinant;
+  // Upper-triangular Cholesky factor U (i.e., U^T * U = information)
+  const TDataType s00 = std::sqrt(information00);
+  const TDataType s01 = information01 / s00;
+  packedSqrtInformation[0] = s00;
+  packedSqrtInformation[1] = s01;
+  packedSqrtInformation[2] = std::sqrt(information11 - s01 * s01);
+}
+
+template <typename TDataType>
+void ObservationTable<TDataType>::sortByKeys(const std::vector<Handle> &keys) {
+  const std::size_t numberOfObservations = size();
+  if (std::is_sorted(keys.begin(), keys.end())) {
+    return;
+  }
+  // Counting sort, since handles are dense
+  const Handle maximumKey = *std::max_element(keys.begin(), keys.end());
+  std::vector<std::size_t> offsets(static_cast<std::size_t>(maximumKey) + 2, 0);
+  for (const Handle key : keys) {
+    ++offsets[key + 1];
+  }
+  for (std::size_t i = 1; i < offsets.size(); ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+  std::vector<std::size_t> permutation(numberOfObservations);
+  for (std::size_t i = 0; i < numberOfObservations; ++i) {
+    permutation[offsets[keys[i]]++] = i;
+  }
+
+  // Gather every array through the permutation
+  auto gather = [&](std::vector<Handle> &values) {
+    std::vector<Handle> sorted(numberOfObservations);
+    for (std::size_t i = 0; i < numberOfObservations; ++i) {
+      sorted[i] = values[permutation[i]];
+    }
+    values.swap(sorted);
+  };
+  auto gatherData = [&](std::vector<TDataType> &values, const unsigned int n) {
+    std::vector<TDataType> sorted(n * numberOfObservations);
+    for (std::size_t i = 0; i < numberOfObservations; ++i) {
+      for (unsigned int k = 0; k < n; ++k) {
+        sorted[n * i + k] = values[n * permutation[i] + k];
+      }
+    }
+    values.swap(sorted);
+  };
+  gather(imageHandles);
+  gather(pointHandles);
+  gather(cameraHandles);
+  gatherData(x, 1);
+  gatherData(y, 1);
+  gatherData(sqrtInformation, 3);
+}
+} // namespace Core
@@ -0,0 +1,77 @@
+#ifndef CORE_PARALLEL_H
+#define CORE_PARALLEL_H
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace Core {
+/// Return the number of hardware threads (at least 1)
+inline unsigned int GetNumberOfHardwareThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * This function splits [0, size) into contiguous chunks, and calls
+ * func(chunkBegin, chunkEnd, chunkIndex) for every chunk on its own thread.
+ * Note: Exceptions thrown by func are re-thrown on the calling thread.
+ * @param[in] size The number of elements to be processed
+ * @param[in] func The function to process a chunk of elements
+ * @param[in] numberOfThreads The number of threads (default = 0, i.e., the
+ * number of hardware threads)
+ * @param[in] minimumChunkSize The minimum number of elements of a chunk, so
+ * that no threads are spawned for tiny workloads (default = 1024; use a
+ * smaller value for coarse elements, e.g., files)
+ * @return The number of chunks (i.e., utilized threads)
+ */
+template <typename TFunction>
+unsigned int ParallelFor(const std::size_t size, TFunction func,
+                         unsigned int numberOfThreads = 0,
+                         const std::size_t minimumChunkSize = 1024) {
+  if (numberOfThreads == 0) {
+    numberOfThreads = GetNumberOfHardwareThreads();
+  }
+  const std::size_t maximumChunks = std::max<std::size_t>(
+      1, (size + minimumChunkSize - 1) / minimumChunkSize);
+  const unsigned int numberOfChunks = static_cast<unsigned int>(
+      std::min<std::size_t>(numberOfThreads, maximumChunks));
+  if (numberOfChunks <= 1) {
+    func(static_cast<std::size_t>(0), size, 0u);
+    return 1;
+  }
+
+  const std::size_t chunkSize = (size + numberOfChunks - 1) / numberOfChunks;
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> exceptions(numberOfChunks);
+  threads.reserve(numberOfChunks - 1);
+  for (unsigned int chunk = 1; chunk < numberOfChunks; ++chunk) {
+    threads.emplace_back([&, chunk]() {
+      try {
+        const std::size_t begin = std::min(size, chunk * chunkSize);
+        const std::size_t end = std::min(size, begin + chunkSize);
+        func(begin, end, chunk);
+      } catch (...) {
+        exceptions[chunk] = std::current_exception();
+      }
+    });
+  }
+  // The calling thread processes the first chunk
+  try {
+    func(static_cast<std::size_t>(0), std::min(size, chunkSize), 0u);
+  } catch (...) {
+    exceptions[0] = std::current_exception();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &exception : exceptions) {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+  return numberOfChunks;
+}
+} // namespace Core
+
+#endif // CORE_PARALLEL_H
@@ -0,0 +1,92 @@
+#ifndef CORE_PARAMETERARENA_H
+#define CORE_PARAMETERARENA_H
+
+#include <vector>
+
+#include "eigen3/Eigen/Core"
+
+namespace Core {
+/**
+ * This is the class for one contiguous buffer holding the adjustable
+ * parameters of an image block (e.g., IOPs, mounting parameters, body frame
+ * EOPs and object points).
+ * The arena is made of sections, and every section is made of blocks of the
+ * same size (e.g., 3 coordinates per object point). All sections are laid out
+ * first, then the arena is frozen, which allocates the buffer once. Pointers
+ * and views into a frozen arena stay valid until clear() is called, so solver
+ * parameter blocks can point straight into it.
+ */
+template <typename TDataType = double> class ParameterArena {
+public:
+  /// View of a parameter block
+  using BlockView = Eigen::Map<Eigen::Matrix<TDataType, Eigen::Dynamic, 1>>;
+  using ConstBlockView =
+      Eigen::Map<const Eigen::Matrix<TDataType, Eigen::Dynamic, 1>>;
+
+  /// Default constructor
+  ParameterArena() = default;
+
+  /**
+   * Add a section of blocks
+   * Note: This function throws std::logic_error if the arena is frozen.
+   * @param[in] numberOfBlocks The number of blocks in the section
+   * @param[in] blockSize The number of parameters of each block
+   * @return The index of the new section
+   */
+  std::size_t addSection(const std::size_t numberOfBlocks,
+                         const std::size_t blockSize);
+
+  /// Allocate the zero-initialized buffer for all sections
+  void freeze();
+  /// Return true if the buffer has been allocated
+  bool isFrozen() const;
+  /// Remove all sections and free the buffer
+  void clear();
+
+  /**
+   * Get the pointer to the given block
+   * Note: This function throws std::out_of_range if the section or block
+   * cannot be found, and std::logic_error if the arena is not frozen yet.
+   */
+  TDataType *getBlock(const std::size_t section, const std::size_t index);
+  const TDataType *getBlock(const std::size_t section,
+                            const std::size_t index) const;
+  /// Get a view of the given block
+  BlockView getView(const std::size_t section, const std::size_t index);
+  ConstBlockView getView(const std::size_t section,
+                         const std::size_t index) const;
+
+  /// Get the number of blocks of the given section
+  std::size_t getNumberOfBlocks(const std::size_t section) const;
+  /// Get the block size of the given section
+  std::size_t getBlockSize(const std::size_t section) const;
+  /// Get the number of sections
+  std::size_t getNumberOfSections() const;
+
+  /// Get the total number of parameters
+  std::size_t size() const;
+  /// Get the pointer to the whole buffer
+  TDataType *data();
+  const TDataType *data() const;
+
+private:
+  /// Offset into the buffer of the given block
+  std::size_t getOffset(const std::size_t section,
+                        const std::size_t index) const;
+
+  /// Layout of a section
+  struct Section {
+    std::size_t offset;
+    std::size_t numberOfBlocks;
+    std::size_t blockSize;
+  };
+
+  std::vector<Section> mSections;
+  std::vector<TDataType> mParameters;
+  bool mIsFrozen = false;
+};
+} // namespace Core
+
+#include "ParameterArena.hpp"
+
+#endif // CORE_PARAMETERARENA_H
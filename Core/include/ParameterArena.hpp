@@ -0,0 +1,116 @@
+#include "ParameterArena.h"
+
+#include <stdexcept>
+
+namespace Core {
+template <typename TDataType>
+std::size_t
+ParameterArena<TDataType>::addSection(const std::size_t numberOfBlocks,
+                                      const std::size_t blockSize) {
+  if (mIsFrozen) {
+    throw std::logic_error("Cannot add a section to a frozen arena!");
+  }
+  const std::size_t offset =
+      mSections.empty() ? 0
+                        : mSections.back().offset +
+                              mSections.back().numberOfBlocks *
+                                  mSections.back().blockSize;
+  mSections.push_back(Section{offset, numberOfBlocks, blockSize});
+  return mSections.size() - 1;
+}
+
+template <typename TDataType> void ParameterArena<TDataType>::freeze() {
+  if (mIsFrozen) {
+    return;
+  }
+  std::size_t numberOfParameters = 0;
+  for (const auto &section : mSections) {
+    numberOfParameters += section.numberOfBlocks * section.blockSize;
+  }
+  mParameters.assign(numberOfParameters, static_cast<TDataType>(0));
+  mIsFrozen = true;
+}
+
+template <typename TDataType>
+bool ParameterArena<TDataType>::isFrozen() const {
+  return mIsFrozen;
+}
+
+template <typename TDataType> void ParameterArena<TDataType>::clear() {
+  mSections.clear();
+  std::vector<TDataType>().swap(mParameters);
+  mIsFrozen = false;
+}
+
+template <typename TDataType>
+TDataType *ParameterArena<TDataType>::getBlock(const std::size_t section,
+                                               const std::size_t index) {
+  return mParameters.data() + getOffset(section, index);
+}
+
+template <typename TDataType>
+const TDataType *
+ParameterArena<TDataType>::getBlock(const std::size_t section,
+                                    const std::size_t index) const {
+  return mParameters.data() + getOffset(section, index);
+}
+
+template <typename TDataType>
+typename ParameterArena<TDataType>::BlockView
+ParameterArena<TDataType>::getView(const std::size_t section,
+                                   const std::size_t index) {
+  return BlockView(getBlock(section, index), getBlockSize(section));
+}
+
+template <typename TDataType>
+typename ParameterArena<TDataType>::ConstBlockView
+ParameterArena<TDataType>::getView(const std::size_t section,
+                                   const std::size_t index) const {
+  return ConstBlockView(getBlock(section, index), getBlockSize(section));
+}
+
+template <typename TDataType>
+std::size_t
+ParameterArena<TDataType>::getNumberOfBlocks(const std::size_t section) const {
+  return mSections.at(section).numberOfBlocks;
+}
+
+template <typename TDataType>
+std::size_t
+ParameterArena<TDataType>::getBlockSize(const std::size_t section) const {
+  return mSections.at(section).blockSize;
+}
+
+template <typename TDataType>
+std::size_t ParameterArena<TDataType>::getNumberOfSections() const {
+  return mSections.size();
+}
+
+template <typename TDataType>
+std::size_t ParameterArena<TDataType>::size() const {
+  return mParameters.size();
+}
+
+template <typename TDataType> TDataType *ParameterArena<TDataType>::data() {
+  return mParameters.data();
+}
+
+template <typename TDataType>
+const TDataType *ParameterArena<TDataType>::data() const {
+  return mParameters.data();
+}
+
+template <typename TDataType>
+std::size_t
+ParameterArena<TDataType>::getOffset(const std::size_t section,
+                                     const std::size_t index) const {
+  if (!mIsFrozen) {
+    throw std::logic_error("The parameter arena is not frozen yet!");
+  }
+  if (section >= mSections.size() ||
+      index >= mSections[section].numberOfBlocks) {
+    throw std::out_of_range("Cannot find the given block in the arena!");
+  }
+  return mSections[section].offset + index * mSections[section].blockSize;
+}
+} // namespace Core
@@ -6,6 +6,8 @@
 #include "boost/optional.hpp"
 #include "eigen3/Eigen/Eigen"
 
+#include "CovariancePolicy.h"
+
 namespace Core {
 // Define PI
 #define PI 3.1415926535897932384626433832795
@@ -31,24 +33,36 @@ typedef Eigen::Matrix<int, 3, 1> PointXYZi;
 /**
  * This is a general point class for an N x 1 vector with the corresponding
  * variance-covariance matrix
+ * Note: How the variance-covariance matrix is stored is decided by
+ * TCovariancePolicy (see CovariancePolicy.h). The default dense policy stores
+ * a full N x N matrix, which can be inefficient when N is large or when there
+ * are millions of points. The coordinates are stored without SIMD alignment
+ * padding, so that compact policies actually shrink the point.
  */
-template <typename TDataType, int Dim>
-class Point : public Eigen::Matrix<TDataType, Dim, 1> {
+template <typename TDataType, int Dim,
+          typename TCovariancePolicy = DenseCovariance<TDataType, Dim>>
+class Point : public Eigen::Matrix<TDataType, Dim, 1, Eigen::DontAlign>,
+              public TCovariancePolicy {
 public:
+  /// Type of the coordinate vector
+  using VectorType = Eigen::Matrix<TDataType, Dim, 1, Eigen::DontAlign>;
+  /// Type of the covariance storage policy
+  using CovariancePolicyType = TCovariancePolicy;
+
   /// Default constructor
   Point() = default;
 
   /**
    * Constructor, which takes the N x 1 vector and its corresponding
    * variance-covariance matrixs
-   * Note: In current implementation, we use dense matrix for
-   * variance-covaraince of the point. This can be inefficient when N is large.
    */
   Point(const Eigen::Matrix<TDataType, Dim, 1> &vec,
         const Eigen::Matrix<TDataType, Dim, Dim> &var =
             Eigen::Matrix<TDataType, Dim, Dim>::Identity(Dim, Dim));
-  /// N x N varaiance-covariance matrix
-  Eigen::Matrix<TDataType, Dim, Dim> covariance;
+
+  /// Assign coordinates from any Eigen expression
+  template <typename TOtherDerived>
+  Point &operator=(const Eigen::MatrixBase<TOtherDerived> &other);
 };
 
 /**
@@ -57,39 +71,53 @@ public:
  * corner of the image. imagePoint[0]: column coordinate, and imagePoint[1]:
  * row coordinate
  */
-class ImagePoint : public Point<double, 2> {
+template <typename TCovariancePolicy = DenseCovariance<double, 2>>
+class BasicImagePoint : public Point<double, 2, TCovariancePolicy> {
 public:
   /// Default constructor
-  ImagePoint() = default;
+  BasicImagePoint() = default;
 
   /**
    * Constructor, which takes input image coordinates, and variance-covariance
    * matrix of image coordinates
    */
-  ImagePoint(const double col, const double row,
-             const Eigen::Matrix<double, 2, 2> &var =
-                 Eigen::Matrix<double, 2, 2>::Identity(2, 2));
+  BasicImagePoint(const double col, const double row,
+                  const Eigen::Matrix<double, 2, 2> &var =
+                      Eigen::Matrix<double, 2, 2>::Identity(2, 2));
 };
 
 /**
  * This is the class for a 3D object point with variance-covariance matrix
  */
-class ObjectPoint : public Point<double, 3> {
+template <typename TCovariancePolicy = DenseCovariance<double, 3>>
+class BasicObjectPoint : public Point<double, 3, TCovariancePolicy> {
 public:
   /// Default constructor
-  ObjectPoint() = default;
+  BasicObjectPoint() = default;
 
   /**
    * Constructor, which takes the coordinates of input object point, and
    * corresponding variance-covariance matrix
    */
-  ObjectPoint(const double x, const double y, const double z,
-              const Eigen::Matrix<double, 3, 3> &var =
-                  Eigen::Matrix<double, 3, 3>::Identity(3, 3));
+  BasicObjectPoint(const double x, const double y, const double z,
+                   const Eigen::Matrix<double, 3, 3> &var =
+                       Eigen::Matrix<double, 3, 3>::Identity(3, 3));
 
   /// {imageId, pointId} pairs for all tie points
   std::unordered_map<std::string, std::string> mTiePointIds;
 };
+
+/// Image point with a dense variance-covariance matrix
+using ImagePoint = BasicImagePoint<>;
+/// Image point with an isotropic variance (e.g., sigma of the camera)
+using IsotropicImagePoint = BasicImagePoint<IsotropicCovariance<double, 2>>;
+/// Image point sharing its variance-covariance matrix through the pool
+using PooledImagePoint = BasicImagePoint<PooledCovariance<double, 2>>;
+/// Object point with a dense variance-covariance matrix
+using ObjectPoint = BasicObjectPoint<>;
+
+extern template class BasicImagePoint<DenseCovariance<double, 2>>;
+extern template class BasicObjectPoint<DenseCovariance<double, 3>>;
 } // namespace Core
 
 #include "Point.hpp"
@@ -1,8 +1,31 @@
 #include "Point.h"
 
 namespace Core {
-template <typename TDataType, int Dim>
-Point<TDataType, Dim>::Point(const Eigen::Matrix<TDataType, Dim, 1> &vec,
-                             const Eigen::Matrix<TDataType, Dim, Dim> &var)
-    : Eigen::Matrix<TDataType, Dim, 1>(vec), covariance(var) {}
+template <typename TDataType, int Dim, typename TCovariancePolicy>
+Point<TDataType, Dim, TCovariancePolicy>::Point(
+    const Eigen::Matrix<TDataType, Dim, 1> &vec,
+    const Eigen::Matrix<TDataType, Dim, Dim> &var)
+    : VectorType(vec), TCovariancePolicy(var) {}
+
+template <typename TDataType, int Dim, typename TCovariancePolicy>
+template <typename TOtherDerived>
+Point<TDataType, Dim, TCovariancePolicy> &
+Point<TDataType, Dim, TCovariancePolicy>::operator=(
+    const Eigen::MatrixBase<TOtherDerived> &other) {
+  VectorType::operator=(other);
+  return *this;
+}
+
+template <typename TCovariancePolicy>
+BasicImagePoint<TCovariancePolicy>::BasicImagePoint(
+    const double col, const double row, const Eigen::Matrix<double, 2, 2> &var)
+    : Point<double, 2, TCovariancePolicy>(Eigen::Matrix<double, 2, 1>(col, row),
+                                          var) {}
+
+template <typename TCovariancePolicy>
+BasicObjectPoint<TCovariancePolicy>::BasicObjectPoint(
+    const double x, const double y, const double z,
+    const Eigen::Matrix<double, 3, 3> &var)
+    : Point<double, 3, TCovariancePolicy>(
+          Eigen::Matrix<double, 3, 1>(x, y, z), var) {}
 } // namespace Core
@@ -1,14 +1,24 @@
 #ifndef CORE_POINTCLOUD_H
 #define CORE_POINTCLOUD_H
 
-#include <unordered_map>
+#include <vector>
+
+#include "eigen3/Eigen/StdVector"
+
+#include "IdRegistry.h"
 
 namespace Core {
 /**
  * This is the class for a point cloud
+ * Note: Points are stored contiguously and indexed by dense handles. The
+ * string pointIds are only used for lookup at the API edge.
  */
 template <typename TPointType> class PointCloud {
 public:
+  /// Contiguous storage of points
+  using PointContainer =
+      std::vector<TPointType, Eigen::aligned_allocator<TPointType>>;
+
   /// Default constructor
   PointCloud() = default;
 
@@ -21,6 +31,8 @@ public:
 
   /**
    * Delete point at pointId from mPoints
+   * Note: The last point is moved to the handle of the deleted one, so
+   * handles obtained before the deletion may be invalidated.
    * @return True: if point is deleted; False: if no pointId can be found in
    * mPoints
    */
@@ -39,19 +51,40 @@ public:
    */
   TPointType &getPoint(const std::string &pointId);
 
+  /// Get point with the given handle
+  const TPointType &getPoint(const Handle handle) const;
+  TPointType &getPoint(const Handle handle);
+
+  /**
+   * Get the handle of the given pointId
+   * Note: This function throws std::invalid_argument if not found
+   */
+  Handle getPointHandle(const std::string &pointId) const;
+
+  /// Get the pointId of the given handle
+  const std::string &getPointId(const Handle handle) const;
+
   /**
    * Return the number of points in mImagePoints
    */
   unsigned int getNumberOfPoints() const;
 
   /**
-   * Return the set of points
+   * Return the set of points ordered by their handles
    */
-  const std::unordered_map<std::string, TPointType> &getPoints() const;
+  const PointContainer &getPoints() const;
+
+  /// Return the pointIds ordered by their handles
+  const std::vector<std::string> &getPointIds() const;
+
+  /// Reserve memory for the given number of points
+  void reservePoints(const std::size_t numberOfPoints);
 
 private:
-  /// The set of points are stored in an unordered_map
-  std::unordered_map<std::string, TPointType> mPoints;
+  /// The set of points are stored contiguously and indexed by handles
+  PointContainer mPoints;
+  /// Mapping between pointIds and handles
+  IdRegistry mPointIds;
 };
 } // namespace Core
 
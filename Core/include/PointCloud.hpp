@@ -4,19 +4,23 @@ namespace Core {
 template <typename TPointType>
 bool PointCloud<TPointType>::addPoint(const std::string &pointId,
                                       const TPointType &point) {
-  if (mPoints.count(pointId) != 0) {
+  if (mPointIds.add(pointId) == InvalidHandle) {
     return false;
   } else {
-    mPoints[pointId] = point;
+    mPoints.push_back(point);
     return true;
   }
 }
 
 template <typename TPointType>
 bool PointCloud<TPointType>::deletePoint(const std::string &pointId) {
-  auto search = mPoints.find(pointId);
-  if (search != mPoints.end()) {
-    mPoints.erase(search);
+  Handle erasedHandle;
+  if (mPointIds.erase(pointId, erasedHandle)) {
+    // Move the last point to the erased handle
+    if (erasedHandle + 1 != mPoints.size()) {
+      mPoints[erasedHandle] = std::move(mPoints.back());
+    }
+    mPoints.pop_back();
   } else {
     return false;
   }
@@ -26,9 +30,9 @@ bool PointCloud<TPointType>::deletePoint(const std::string &pointId) {
 template <typename TPointType>
 const TPointType &
 PointCloud<TPointType>::getPoint(const std::string &pointId) const {
-  auto search = mPoints.find(pointId);
-  if (search != mPoints.end()) {
-    return search->second;
+  const Handle handle = mPointIds.find(pointId);
+  if (handle != InvalidHandle) {
+    return mPoints[handle];
   } else {
     throw std::invalid_argument("Cannot find the pointId!");
   }
@@ -36,22 +40,53 @@ PointCloud<TPointType>::getPoint(const std::string &pointId) const {
 
 template <typename TPointType>
 TPointType &PointCloud<TPointType>::getPoint(const std::string &pointId) {
-  auto search = mPoints.find(pointId);
-  if (search != mPoints.end()) {
-    return search->second;
+  const Handle handle = mPointIds.find(pointId);
+  if (handle != InvalidHandle) {
+    return mPoints[handle];
   } else {
     throw std::invalid_argument("Cannot find the pointId!");
   }
 }
 
+template <typename TPointType>
+const TPointType &PointCloud<TPointType>::getPoint(const Handle handle) const {
+  return mPoints[handle];
+}
+
+template <typename TPointType>
+TPointType &PointCloud<TPointType>::getPoint(const Handle handle) {
+  return mPoints[handle];
+}
+
+template <typename TPointType>
+Handle PointCloud<TPointType>::getPointHandle(const std::string &pointId) const {
+  return mPointIds.getHandle(pointId);
+}
+
+template <typename TPointType>
+const std::string &PointCloud<TPointType>::getPointId(const Handle handle) const {
+  return mPointIds.getId(handle);
+}
+
 template <typename TPointType>
 unsigned int PointCloud<TPointType>::getNumberOfPoints() const {
   return mPoints.size();
 }
 
 template <typename TPointType>
-const std::unordered_map<std::string, TPointType> &
+const typename PointCloud<TPointType>::PointContainer &
 PointCloud<TPointType>::getPoints() const {
   return mPoints;
 }
+
+template <typename TPointType>
+const std::vector<std::string> &PointCloud<TPointType>::getPointIds() const {
+  return mPointIds.getIds();
+}
+
+template <typename TPointType>
+void PointCloud<TPointType>::reservePoints(const std::size_t numberOfPoints) {
+  mPoints.reserve(numberOfPoints);
+  mPointIds.reserve(numberOfPoints);
+}
 } // namespace Core
@@ -0,0 +1,253 @@
+#ifndef CORE_PROJECTFILE_H
+#define CORE_PROJECTFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ExteriorOrientation.h"
+#include "IdRegistry.h"
+#include "MappedFile.h"
+#include "ObservationTable.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Project files are mapped in place and require a little-endian host!"
+#endif
+
+namespace Core {
+/**
+ * This is the class for the native binary project format of image blocks.
+ * A project file is a versioned, little-endian container of sections, i.e.,
+ * cameras (IOPs and mounting parameters), images (EOPs, camera handles and
+ * file paths), object points, the observations as structure of arrays (see
+ * ObservationTable) and the string ids of all entities.
+ * Layout: a FileHeader, a table of SectionEntry, and the sections at 8-byte
+ * aligned offsets. Entities are referred to by their handles in the image
+ * block, and rotations are stored in radians (see
+ * ExteriorOrientation::convertToArray).
+ * The file is memory-mapped, and every section is exposed in place (e.g.,
+ * getObjectPoints and getObservations), so that a project can be used
+ * without parsing or per-object allocation. load rebuilds an ImageBlock from
+ * the sections.
+ * Since the sections are written and read in host byte order, the class is
+ * only available on little-endian hosts.
+ * Note: Variance-covariance matrices of EOPs and object points, image points
+ * of the images and navigation data are not stored.
+ */
+class ProjectFile {
+public:
+  /// Version of the format written by Write
+  static constexpr std::uint32_t Version = 1;
+
+  /// Types of the sections
+  enum class SectionType : std::uint32_t {
+    CameraRecords = 1,
+    CameraParameters = 2,
+    CameraIds = 3,
+    ImageRecords = 4,
+    ImageIds = 5,
+    ImageFilePaths = 6,
+    ObjectPoints = 7,
+    ObjectPointIds = 8,
+    ObservationImageHandles = 9,
+    ObservationPointHandles = 10,
+    ObservationCameraHandles = 11,
+    ObservationX = 12,
+    ObservationY = 13,
+    ObservationSqrtInformation = 14
+  };
+
+  /// Header at the beginning of the file
+  struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    /// 0x01020304 as written by the host, to detect the byte order
+    std::uint32_t byteOrderMark;
+    std::uint32_t numberOfSections;
+    /// ObservationTable::SortOrder of the observations
+    std::uint32_t observationSortOrder;
+  };
+
+  /// Entry of the section table
+  struct SectionEntry {
+    std::uint32_t type;
+    /// Size of an element in bytes (0 for string tables)
+    std::uint32_t elementSize;
+    /// Number of elements (or strings)
+    std::uint64_t count;
+    /// Offset from the beginning of the file, and size in bytes
+    std::uint64_t offset;
+    std::uint64_t size;
+  };
+
+  /// Record of a camera
+  struct CameraRecord {
+    /// Handle of the reference camera (InvalidHandle if it is not in the
+    /// image block)
+    std::uint32_t referenceCameraHandle;
+    /// Number of IOPs (i.e., xp, yp, c and distortion parameters)
+    std::uint32_t numberOfParameters;
+    std::uint32_t width;
+    std::uint32_t height;
+    double xPixelSize;
+    double yPixelSize;
+    /// Index of the first IOP in the camera parameter section
+    std::uint64_t parameterOffset;
+    /// Mounting parameters (X, Y, Z, omega, phi and kappa in radians)
+    double mountingParameters[6];
+  };
+
+  /// Record of an image
+  struct ImageRecord {
+    /// Handle of the camera (InvalidHandle if it is not in the image block)
+    std::uint32_t cameraHandle;
+    std::uint32_t reserved;
+    /// EOPs (X, Y, Z, omega, phi and kappa in radians)
+    double eops[6];
+  };
+
+  /**
+   * This is the class for a string table section, i.e., (n + 1) offsets
+   * followed by the characters of n strings
+   */
+  class StringTable {
+  public:
+    StringTable() = default;
+    StringTable(const std::uint64_t *offsets, const char *characters,
+                const std::size_t size)
+        : mOffsets(offsets), mCharacters(characters), mSize(size) {}
+
+    /// Get the number of strings
+    std::size_t size() const { return mSize; }
+    /// Get the i-th string (in place, without a terminating null character)
+    const char *data(const std::size_t index) const {
+      return mCharacters + mOffsets[index];
+    }
+    std::size_t length(const std::size_t index) const {
+      return static_cast<std::size_t>(mOffsets[index + 1] - mOffsets[index]);
+    }
+    /// Get a copy of the i-th string
+    std::string operator[](const std::size_t index) const {
+      return std::string(data(index), length(index));
+    }
+
+  private:
+    const std::uint64_t *mOffsets = nullptr;
+    const char *mCharacters = nullptr;
+    std::size_t mSize = 0;
+  };
+
+  /// In-place view of the observations (see ObservationTable)
+  struct ObservationView {
+    std::size_t size = 0;
+    const Handle *imageHandles = nullptr;
+    const Handle *pointHandles = nullptr;
+    const Handle *cameraHandles = nullptr;
+    const double *x = nullptr;
+    const double *y = nullptr;
+    const double *sqrtInformation = nullptr;
+  };
+
+  /**
+   * Constructor, which maps the given project file and validates its header
+   * and section table
+   * Note: This function throws std::runtime_error if the file cannot be
+   * mapped, or is not a valid project file of a supported version.
+   */
+  explicit ProjectFile(const std::string &filePath);
+
+  /**
+   * Write an image block to a project file
+   * Note: The observations are written as built (see
+   * ImageBlock::buildObservations). This function throws std::runtime_error
+   * if the file cannot be written.
+   */
+  template <typename TImageBlockType>
+  static void Write(const std::string &filePath,
+                    const TImageBlockType &imageBlock);
+
+  /**
+   * Add the cameras, images, object points and observations of the project
+   * to an empty image block (i.e., with the same handles)
+   * Note: This function throws std::invalid_argument if the image block is
+   * not empty, or if the number of IOPs does not match the camera type.
+   */
+  template <typename TImageBlockType>
+  void load(TImageBlockType &imageBlock) const;
+
+  /// Get the version of the file
+  std::uint32_t getVersion() const;
+
+  std::size_t getNumberOfCameras() const;
+  std::size_t getNumberOfImages() const;
+  std::size_t getNumberOfObjectPoints() const;
+  std::size_t getNumberOfObservations() const;
+
+  /// Get the camera records, and the IOPs of the camera with the given handle
+  const CameraRecord *getCameraRecords() const;
+  const double *getCameraParameters(const Handle cameraHandle) const;
+  StringTable getCameraIds() const;
+
+  /// Get the image records, ids and file paths (empty if none)
+  const ImageRecord *getImageRecords() const;
+  StringTable getImageIds() const;
+  StringTable getImageFilePaths() const;
+
+  /// Get the coordinates of the object points (n x 3, i.e., X, Y and Z of
+  /// each point), and their ids
+  const double *getObjectPoints() const;
+  StringTable getObjectPointIds() const;
+
+  /// Get the observations, and their ObservationTable::SortOrder
+  ObservationView getObservations() const;
+  std::uint32_t getObservationSortOrder() const;
+
+private:
+  /// Section data to be written
+  struct SectionData {
+    SectionType type;
+    std::uint32_t elementSize;
+    std::uint64_t count;
+    const void *data;
+    std::uint64_t size;
+  };
+
+  /// Pack strings into a string table section
+  static std::vector<char>
+  PackStrings(const std::vector<std::string> &strings);
+
+  /// Write the header, the section table and the sections
+  static void WriteSections(const std::string &filePath,
+                            const std::uint32_t observationSortOrder,
+                            const std::vector<SectionData> &sections);
+
+  /// Get the section of the given type (nullptr if the file has none)
+  const SectionEntry *findSection(const SectionType type) const;
+  /// Get the data of the section of the given type, and check its element
+  /// size and number of elements
+  const void *getSection(const SectionType type,
+                         const std::uint32_t elementSize,
+                         const std::size_t count) const;
+  StringTable getStringTable(const SectionType type,
+                             const std::size_t count) const;
+  /// Check the size and the offsets of a string table section
+  bool isValidStringTable(const SectionEntry &section) const;
+
+  MappedFile mFile;
+  const FileHeader *mHeader = nullptr;
+  const SectionEntry *mSections = nullptr;
+};
+
+static_assert(sizeof(ProjectFile::FileHeader) == 24,
+              "The file header has to be packed!");
+static_assert(sizeof(ProjectFile::SectionEntry) == 32,
+              "Section entries have to be packed!");
+static_assert(sizeof(ProjectFile::CameraRecord) == 88,
+              "Camera records have to be packed!");
+static_assert(sizeof(ProjectFile::ImageRecord) == 56,
+              "Image records have to be packed!");
+} // namespace Core
+
+#include "ProjectFile.hpp"
+
+#endif // CORE_PROJECTFILE_H
@@ -0,0 +1,240 @@
+#include "ProjectFile.h"
+
+#include <memory>
+#include <stdexcept>
+
+namespace Core {
+namespace Internal {
+/// Get the values as doubles, converting them into the buffer if necessary
+inline const double *GetDoubles(const std::vector<double> &values,
+                                std::vector<double> &) {
+  return values.data();
+}
+
+template <typename TDataType>
+const double *GetDoubles(const std::vector<TDataType> &values,
+                         std::vector<double> &buffer) {
+  buffer.assign(values.begin(), values.end());
+  return buffer.data();
+}
+} // namespace Internal
+
+template <typename TImageBlockType>
+void ProjectFile::Write(const std::string &filePath,
+                        const TImageBlockType &imageBlock) {
+  // Cameras
+  const std::size_t numberOfCameras = imageBlock.getNumberOfCameras();
+  std::vector<CameraRecord> cameraRecords(numberOfCameras);
+  std::vector<double> cameraParameters;
+  std::vector<std::string> cameraIds(numberOfCameras);
+  for (Handle handle = 0; handle < numberOfCameras; ++handle) {
+    cameraIds[handle] = imageBlock.getCameraId(handle);
+  }
+  for (Handle handle = 0; handle < numberOfCameras; ++handle) {
+    const auto &camera = *imageBlock.getCamera(handle);
+    CameraRecord &record = cameraRecords[handle];
+    record.referenceCameraHandle = InvalidHandle;
+    for (Handle other = 0; other < numberOfCameras; ++other) {
+      if (cameraIds[other] == camera.getReferenceCameraId()) {
+        record.referenceCameraHandle = other;
+      }
+    }
+    record.numberOfParameters =
+        static_cast<std::uint32_t>(3 + camera.distortionParameters.size());
+    record.width = camera.width;
+    record.height = camera.height;
+    record.xPixelSize = static_cast<double>(camera.xPixelSize);
+    record.yPixelSize = static_cast<double>(camera.yPixelSize);
+    record.parameterOffset = cameraParameters.size();
+    std::vector<typename TImageBlockType::DataType> params(
+        record.numberOfParameters);
+    camera.convertToArray(params.data());
+    cameraParameters.insert(cameraParameters.end(), params.begin(),
+                            params.end());
+    double mountingParameters[6];
+    camera.getMountingParameters().convertToArray(mountingParameters);
+    std::copy(mountingParameters, mountingParameters + 6,
+              record.mountingParameters);
+  }
+
+  // Images
+  const std::size_t numberOfImages = imageBlock.getNumberOfImages();
+  std::vector<ImageRecord> imageRecords(numberOfImages);
+  std::vector<std::string> imageIds(numberOfImages);
+  std::vector<std::string> imageFilePaths(numberOfImages);
+  for (Handle handle = 0; handle < numberOfImages; ++handle) {
+    const auto &image = *imageBlock.getImage(handle);
+    ImageRecord &record = imageRecords[handle];
+    record.cameraHandle = imageBlock.getCameraHandleOfImage(handle);
+    record.reserved = 0;
+    image.convertToArray(record.eops);
+    imageIds[handle] = imageBlock.getImageId(handle);
+    if (image.getImageFilePath()) {
+      imageFilePaths[handle] = image.getImageFilePath()->string();
+    }
+  }
+
+  // Object points
+  const std::size_t numberOfObjectPoints =
+      imageBlock.getNumberOfObjectPoints();
+  std::vector<double> objectPoints(3 * numberOfObjectPoints);
+  std::vector<std::string> objectPointIds(numberOfObjectPoints);
+  const auto &points = imageBlock.getObjectPoints();
+  for (Handle handle = 0; handle < numberOfObjectPoints; ++handle) {
+    for (unsigned int i = 0; i < 3; ++i) {
+      objectPoints[3 * handle + i] = static_cast<double>(points[handle][i]);
+    }
+    objectPointIds[handle] = imageBlock.getObjectPointId(handle);
+  }
+
+  // Observations
+  const auto &observations = imageBlock.getObservations();
+  const std::uint64_t numberOfObservations = observations.size();
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> sqrtInformation;
+  const double *xData = Internal::GetDoubles(observations.x, x);
+  const double *yData = Internal::GetDoubles(observations.y, y);
+  const double *sqrtInformationData =
+      Internal::GetDoubles(observations.sqrtInformation, sqrtInformation);
+
+  const std::vector<char> packedCameraIds = PackStrings(cameraIds);
+  const std::vector<char> packedImageIds = PackStrings(imageIds);
+  const std::vector<char> packedImageFilePaths = PackStrings(imageFilePaths);
+  const std::vector<char> packedObjectPointIds = PackStrings(objectPointIds);
+  const std::uint32_t handleSize = sizeof(Handle);
+  const std::vector<SectionData> sections = {
+      {SectionType::CameraRecords, sizeof(CameraRecord), numberOfCameras,
+       cameraRecords.data(), numberOfCameras * sizeof(CameraRecord)},
+      {SectionType::CameraParameters, sizeof(double), cameraParameters.size(),
+       cameraParameters.data(), cameraParameters.size() * sizeof(double)},
+      {SectionType::CameraIds, 0, numberOfCameras, packedCameraIds.data(),
+       packedCameraIds.size()},
+      {SectionType::ImageRecords, sizeof(ImageRecord), numberOfImages,
+       imageRecords.data(), numberOfImages * sizeof(ImageRecord)},
+      {SectionType::ImageIds, 0, numberOfImages, packedImageIds.data(),
+       packedImageIds.size()},
+      {SectionType::ImageFilePaths, 0, numberOfImages,
+       packedImageFilePaths.data(), packedImageFilePaths.size()},
+      {SectionType::ObjectPoints, 3 * sizeof(double), numberOfObjectPoints,
+       objectPoints.data(), objectPoints.size() * sizeof(double)},
+      {SectionType::ObjectPointIds, 0, numberOfObjectPoints,
+       packedObjectPointIds.data(), packedObjectPointIds.size()},
+      {SectionType::ObservationImageHandles, handleSize, numberOfObservations,
+       observations.imageHandles.data(), numberOfObservations * handleSize},
+      {SectionType::ObservationPointHandles, handleSize, numberOfObservations,
+       observations.pointHandles.data(), numberOfObservations * handleSize},
+      {SectionType::ObservationCameraHandles, handleSize, numberOfObservations,
+       observations.cameraHandles.data(), numberOfObservations * handleSize},
+      {SectionType::ObservationX, sizeof(double), numberOfObservations, xData,
+       numberOfObservations * sizeof(double)},
+      {SectionType::ObservationY, sizeof(double), numberOfObservations, yData,
+       numberOfObservations * sizeof(double)},
+      {SectionType::ObservationSqrtInformation, 3 * sizeof(double),
+       numberOfObservations, sqrtInformationData,
+       3 * numberOfObservations * sizeof(double)}};
+  WriteSections(filePath,
+                static_cast<std::uint32_t>(observations.getSortOrder()),
+                sections);
+}
+
+template <typename TImageBlockType>
+void ProjectFile::load(TImageBlockType &imageBlock) const {
+  using CameraType = typename TImageBlockType::CameraType;
+  using ImageType = typename TImageBlockType::ImageType;
+  using ObjectPointType = typename TImageBlockType::ObjectPointType;
+  using DataType = typename TImageBlockType::DataType;
+  if (imageBlock.getNumberOfCameras() != 0 ||
+      imageBlock.getNumberOfImages() != 0 ||
+      imageBlock.getNumberOfObjectPoints() != 0) {
+    throw std::invalid_argument(
+        "Projects can only be loaded into an empty image block!");
+  }
+  const std::size_t numberOfCameras = getNumberOfCameras();
+  const std::size_t numberOfImages = getNumberOfImages();
+  const std::size_t numberOfObjectPoints = getNumberOfObjectPoints();
+  imageBlock.reserve(numberOfCameras, numberOfImages, numberOfObjectPoints);
+
+  // Cameras
+  const CameraRecord *cameraRecords = getCameraRecords();
+  const StringTable cameraIds = getCameraIds();
+  for (Handle handle = 0; handle < numberOfCameras; ++handle) {
+    const CameraRecord &record = cameraRecords[handle];
+    CameraType iops;
+    if (record.numberOfParameters != 3 + iops.distortionParameters.size()) {
+      throw std::invalid_argument(
+          "The number of IOPs does not match the camera type!");
+    }
+    const double *params = getCameraParameters(handle);
+    const std::vector<DataType> iopParams(params,
+                                          params + record.numberOfParameters);
+    iops.assignFromArray(iopParams.data());
+    iops.width = record.width;
+    iops.height = record.height;
+    iops.xPixelSize = static_cast<DataType>(record.xPixelSize);
+    iops.yPixelSize = static_cast<DataType>(record.yPixelSize);
+    ExteriorOrientation<DataType> mountingParameters;
+    const std::vector<DataType> mountingParams(
+        record.mountingParameters, record.mountingParameters + 6);
+    mountingParameters.assignFromArray(mountingParams.data());
+    const std::string referenceCameraId =
+        record.referenceCameraHandle < numberOfCameras
+            ? cameraIds[record.referenceCameraHandle]
+            : std::string();
+    imageBlock.addCamera(cameraIds[handle],
+                         std::make_shared<CameraType>(
+                             referenceCameraId, mountingParameters, iops));
+  }
+
+  // Images
+  const ImageRecord *imageRecords = getImageRecords();
+  const StringTable imageIds = getImageIds();
+  const StringTable imageFilePaths = getImageFilePaths();
+  for (Handle handle = 0; handle < numberOfImages; ++handle) {
+    const ImageRecord &record = imageRecords[handle];
+    auto image = std::make_shared<ImageType>();
+    if (record.cameraHandle < numberOfCameras) {
+      image->setCameraId(cameraIds[record.cameraHandle]);
+    }
+    const std::vector<DataType> eops(record.eops, record.eops + 6);
+    image->assignFromArray(eops.data());
+    if (imageFilePaths.length(handle) != 0) {
+      image->setImageFilePath(imageFilePaths[handle]);
+    }
+    imageBlock.addImage(imageIds[handle], image);
+  }
+
+  // Object points
+  const double *objectPoints = getObjectPoints();
+  const StringTable objectPointIds = getObjectPointIds();
+  for (Handle handle = 0; handle < numberOfObjectPoints; ++handle) {
+    const double *point = objectPoints + 3 * handle;
+    imageBlock.addObjectPoint(objectPointIds[handle],
+                              ObjectPointType(point[0], point[1], point[2]));
+  }
+
+  // Observations
+  const ObservationView view = getObservations();
+  ObservationTable<DataType> observations;
+  observations.imageHandles.assign(view.imageHandles,
+                                   view.imageHandles + view.size);
+  observations.pointHandles.assign(view.pointHandles,
+                                   view.pointHandles + view.size);
+  observations.cameraHandles.assign(view.cameraHandles,
+                                    view.cameraHandles + view.size);
+  observations.x.assign(view.x, view.x + view.size);
+  observations.y.assign(view.y, view.y + view.size);
+  observations.sqrtInformation.assign(view.sqrtInformation,
+                                      view.sqrtInformation + 3 * view.size);
+  // Restore the order (i.e., a single pass over sorted observations)
+  using SortOrder = typename ObservationTable<DataType>::SortOrder;
+  if (getObservationSortOrder() ==
+      static_cast<std::uint32_t>(SortOrder::ByImage)) {
+    observations.sortByImage();
+  } else if (getObservationSortOrder() ==
+             static_cast<std::uint32_t>(SortOrder::ByPoint)) {
+    observations.sortByPoint();
+  }
+  imageBlock.setObservations(std::move(observations));
+}
+} // namespace Core
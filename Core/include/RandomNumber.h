@@ -1,44 +1,95 @@
 #ifndef CORE_RANDOMNUMBER_H
 #define CORE_RANDOMNUMBER_H
 
-#include <time.h>
+#include <atomic>
+#include <cstdint>
+#include <random>
 
 #include "boost/random.hpp"
 
 namespace Core {
+/**
+ * Get a seed, which is unique within the process (i.e., a random number from
+ * std::random_device plus a counter), for generators without explicit seed
+ */
+inline std::uint64_t GetUniqueSeed() {
+  static const std::uint64_t base =
+      (static_cast<std::uint64_t>(std::random_device()()) << 32) ^
+      std::random_device()();
+  static std::atomic<std::uint64_t> counter(0);
+  return base + counter++;
+}
+
 /**
  * This is a wrapper class of boost::random for generating random numbers with
  * different types of distributions
+ *
+ * Every generator draws from the stream of a (seed, stream) pair, i.e., the
+ * Mersenne Twister is seeded with both through a seed sequence, so that
+ * generators of different streams are independent. For parallel loops, use
+ * one generator per task with its task index as stream (see ParallelFill),
+ * instead of sharing a generator between threads.
  */
 template <typename TDistributionType> class RandomNumber {
 public:
   using DataType = typename TDistributionType::result_type;
 
+  /// Number of values of a stream in ParallelFill
+  static constexpr std::size_t FillBlockSize = 1 << 16;
+
   /**
    * Constructor to initialize the random number generator for the range of
-   * [minValue, maxValue)
-   * Note: This constructor automatically use current clock time to seed the
-   * random number generator.
+   * [minValue, maxValue) (or the parameters of other distributions, e.g., the
+   * mean and standard deviation of normal distributions)
+   * Note: This constructor uses a unique seed (see GetUniqueSeed), i.e.,
+   * every generator returns different numbers, which are not reproducible.
    * @param[in] minValue Minimum value for the generated random numbers
    * @param[in] maxValue Maximum value for the generated random numbers
    */
   RandomNumber(const DataType minValue, const DataType maxValue);
 
-  /// Get a random number from mRandomNumberGenerator
+  /**
+   * Constructor to initialize the random number generator with a seed, for
+   * reproducible numbers
+   * @param[in] seed The seed
+   * @param[in] stream The index of the stream (e.g., of a thread)
+   */
+  RandomNumber(const DataType minValue, const DataType maxValue,
+               const std::uint64_t seed, const std::uint64_t stream = 0);
+
+  /// Get the next random number of the stream
   DataType getRandomNumber();
 
+  /// Fill an array with the next random numbers of the generator
+  void fill(DataType *values, const std::size_t size);
+
+  /**
+   * Fill an array with random numbers in parallel, i.e., the i-th block of
+   * FillBlockSize values is filled by the generator of (seed, i), so that the
+   * numbers do not depend on the number of threads
+   * @param[in] numberOfThreads The number of threads (default = 0, i.e., the
+   * number of hardware threads)
+   */
+  static void ParallelFill(DataType *values, const std::size_t size,
+                           const DataType minValue, const DataType maxValue,
+                           const std::uint64_t seed,
+                           const unsigned int numberOfThreads = 0);
+
 private:
   boost::random::mt19937 mGenerator;
-  boost::random::variate_generator<boost::mt19937 &, TDistributionType>
-      mRandomNumberGenerator;
+  TDistributionType mDistribution;
 };
-// Double random number generator with uniform distribution
-using RandomFloatGenerator = RandomNumber<boost::uniform_real<double>>;
 // Float random number generator with uniform distribution
-using RandomDoubleGenerator = RandomNumber<boost::uniform_real<float>>;
+using RandomFloatGenerator = RandomNumber<boost::uniform_real<float>>;
+// Double random number generator with uniform distribution
+using RandomDoubleGenerator = RandomNumber<boost::uniform_real<double>>;
 // Integer random number generator with uniform distribution
 using RandomIntegerGenerator =
     RandomNumber<boost::random::uniform_int_distribution<int>>;
+// Double random number generator with normal distribution (mean and standard
+// deviation)
+using RandomNormalGenerator =
+    RandomNumber<boost::random::normal_distribution<double>>;
 } // namespace Core
 
 #include "RandomNumber.hpp"
@@ -1,17 +1,62 @@
 #include "RandomNumber.h"
 
+#include <algorithm>
+
+#include "Parallel.h"
+
 namespace Core {
+template <typename TDistributionType>
+constexpr std::size_t RandomNumber<TDistributionType>::FillBlockSize;
+
 template <typename TDistributionType>
 RandomNumber<TDistributionType>::RandomNumber(const DataType minValue,
                                               const DataType maxValue)
-    : mGenerator(clock()),
-      mRandomNumberGenerator(
-          boost::variate_generator<boost::mt19937 &, TDistributionType>(
-              mGenerator, TDistributionType(minValue, maxValue))) {}
+    : RandomNumber(minValue, maxValue, GetUniqueSeed()) {}
+
+template <typename TDistributionType>
+RandomNumber<TDistributionType>::RandomNumber(const DataType minValue,
+                                              const DataType maxValue,
+                                              const std::uint64_t seed,
+                                              const std::uint64_t stream)
+    : mDistribution(minValue, maxValue) {
+  boost::random::seed_seq sequence{
+      static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+      static_cast<std::uint32_t>(stream),
+      static_cast<std::uint32_t>(stream >> 32)};
+  mGenerator.seed(sequence);
+}
 
 template <typename TDistributionType>
 typename RandomNumber<TDistributionType>::DataType
 RandomNumber<TDistributionType>::getRandomNumber() {
-  return mRandomNumberGenerator();
+  return mDistribution(mGenerator);
+}
+
+template <typename TDistributionType>
+void RandomNumber<TDistributionType>::fill(DataType *values,
+                                           const std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    values[i] = mDistribution(mGenerator);
+  }
+}
+
+template <typename TDistributionType>
+void RandomNumber<TDistributionType>::ParallelFill(
+    DataType *values, const std::size_t size, const DataType minValue,
+    const DataType maxValue, const std::uint64_t seed,
+    const unsigned int numberOfThreads) {
+  const std::size_t numberOfBlocks =
+      (size + FillBlockSize - 1) / FillBlockSize;
+  ParallelFor(
+      numberOfBlocks,
+      [&](const std::size_t begin, const std::size_t end, const unsigned int) {
+        for (std::size_t block = begin; block < end; ++block) {
+          RandomNumber generator(minValue, maxValue, seed, block);
+          const std::size_t first = block * FillBlockSize;
+          generator.fill(values + first,
+                         std::min(FillBlockSize, size - first));
+        }
+      },
+      numberOfThreads, 1);
 }
 } // namespace Core
@@ -0,0 +1,155 @@
+#ifndef CORE_SBETREADER_H
+#define CORE_SBETREADER_H
+
+#include <string>
+
+#include "MappedFile.h"
+#include "Trajectory.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "SBET records are mapped in place and require a little-endian host!"
+#endif
+
+namespace Core {
+/**
+ * This is the class to read binary SBET (Smoothed Best Estimate of
+ * Trajectory) files, i.e., Applanix-style trajectories of 17 little-endian
+ * doubles per record.
+ * The file is memory-mapped, and its records are exposed zero-copy, so that
+ * opening a multi-GB file costs neither time nor memory. Only the records in
+ * the requested time windows (e.g., around image exposure times) are decoded
+ * into a Trajectory, and only their pages are read from disk.
+ * Note: The records have to be sorted by time, as written by the
+ * post-processing software. Since the records are not byte-swapped, the class
+ * is only available on little-endian hosts.
+ */
+class SbetReader {
+public:
+  /// A record of an SBET file
+  struct Record {
+    /// GPS seconds of week
+    double time;
+    /// Latitude and longitude in radians, and ellipsoidal height in meters
+    double latitude;
+    double longitude;
+    double altitude;
+    /// Velocities in the wander frame in m/s
+    double xVelocity;
+    double yVelocity;
+    double zVelocity;
+    /// Roll, pitch and platform heading (relative to the wander frame) in
+    /// radians
+    double roll;
+    double pitch;
+    double heading;
+    /// Wander angle in radians (i.e., the true heading is heading -
+    /// wanderAngle)
+    double wanderAngle;
+    /// Accelerations in the body frame in m/s^2
+    double xAcceleration;
+    double yAcceleration;
+    double zAcceleration;
+    /// Angular rates in the body frame in rad/s
+    double xAngularRate;
+    double yAngularRate;
+    double zAngularRate;
+  };
+
+  /**
+   * This is the converter of records to the local tangent plane (i.e., east,
+   * north and up) at the given origin on the WGS84 ellipsoid, which is a
+   * mapping frame for Trajectory
+   */
+  class LocalTangentPlaneConverter {
+  public:
+    /// Constructor, which takes the origin in radians and meters
+    LocalTangentPlaneConverter(const double latitude, const double longitude,
+                               const double altitude);
+
+    /**
+     * Convert the record to the position and the attitude (i.e., rotation
+     * from the body frame, x forward, y right and z down, to the local
+     * tangent plane at the origin)
+     */
+    void operator()(const Record &record,
+                    Trajectory<double>::PositionType &position,
+                    Trajectory<double>::AttitudeType &attitude) const;
+
+  private:
+    /// Origin in ECEF coordinates, and rotation from ECEF to the local frame
+    Eigen::Vector3d mOrigin;
+    Eigen::Matrix3d mRotation;
+  };
+
+  /**
+   * Constructor, which maps the given file
+   * Note: This function throws std::runtime_error if the file cannot be
+   * mapped, and std::invalid_argument if its size is not a multiple of the
+   * record size.
+   */
+  explicit SbetReader(const std::string &filePath);
+
+  /// Get the number of records
+  std::size_t size() const;
+  /// Get the mapped records (size x 1)
+  const Record *getRecords() const;
+  /// Get the i-th record
+  const Record &operator[](const std::size_t index) const;
+
+  /// Get the times of the first and the last record
+  double getStartTime() const;
+  double getEndTime() const;
+
+  /// Get the index of the first record at or after the given time (binary
+  /// search, which touches only O(log(n)) pages)
+  std::size_t findRecord(const double time) const;
+
+  /**
+   * Decode the records in [startTime, endTime] into the trajectory
+   * Note: Records at or before the last record of the trajectory are skipped,
+   * so that windows can be decoded one after another.
+   * @param[in] startTime Start of the time window
+   * @param[in] endTime End of the time window
+   * @param[in,out] trajectory The trajectory, which the records are appended
+   * to
+   * @param[in] converter The converter of records to the mapping frame (e.g.,
+   * LocalTangentPlaneConverter), which is called as converter(record,
+   * position, attitude)
+   * @return The number of appended records
+   */
+  template <typename TConverter>
+  std::size_t decode(const double startTime, const double endTime,
+                     Trajectory<double> &trajectory,
+                     const TConverter &converter) const;
+
+  /**
+   * Decode the records in windows around the given times (e.g., image
+   * exposure times), merging overlapping windows
+   * Note: The margin has to be at least the record interval, so that every
+   * time is bracketed by decoded records.
+   * @param[in] size The number of times
+   * @param[in] times Sorted times (size x 1)
+   * @param[in] margin Half of the window size
+   * @param[in,out] trajectory The trajectory (see decode)
+   * @param[in] converter The converter (see decode)
+   * @return The number of appended records
+   */
+  template <typename TConverter>
+  std::size_t decodeWindows(const std::size_t size, const double *times,
+                            const double margin,
+                            Trajectory<double> &trajectory,
+                            const TConverter &converter) const;
+
+private:
+  MappedFile mFile;
+  const Record *mRecords = nullptr;
+  std::size_t mSize = 0;
+};
+
+static_assert(sizeof(SbetReader::Record) == 17 * sizeof(double),
+              "SBET records have to be 17 packed doubles!");
+} // namespace Core
+
+#include "SbetReader.hpp"
+
+#endif // CORE_SBETREADER_H
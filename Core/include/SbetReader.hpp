@@ -0,0 +1,46 @@
+#include "SbetReader.h"
+
+#include <algorithm>
+
+namespace Core {
+template <typename TConverter>
+std::size_t SbetReader::decode(const double startTime, const double endTime,
+                               Trajectory<double> &trajectory,
+                               const TConverter &converter) const {
+  std::size_t index = findRecord(startTime);
+  if (!trajectory.empty()) {
+    // Skip the records decoded by a previous window
+    while (index < mSize && mRecords[index].time <= trajectory.getEndTime()) {
+      ++index;
+    }
+  }
+  Trajectory<double>::PositionType position;
+  Trajectory<double>::AttitudeType attitude;
+  std::size_t numberOfRecords = 0;
+  for (; index < mSize && mRecords[index].time <= endTime; ++index) {
+    converter(mRecords[index], position, attitude);
+    trajectory.append(mRecords[index].time, position, attitude);
+    ++numberOfRecords;
+  }
+  return numberOfRecords;
+}
+
+template <typename TConverter>
+std::size_t SbetReader::decodeWindows(const std::size_t size,
+                                      const double *times, const double margin,
+                                      Trajectory<double> &trajectory,
+                                      const TConverter &converter) const {
+  std::size_t numberOfRecords = 0;
+  std::size_t i = 0;
+  while (i < size) {
+    // Merge the windows of the following times, which overlap
+    const double startTime = times[i] - margin;
+    double endTime = times[i] + margin;
+    for (++i; i < size && times[i] - margin <= endTime; ++i) {
+      endTime = std::max(endTime, times[i] + margin);
+    }
+    numberOfRecords += decode(startTime, endTime, trajectory, converter);
+  }
+  return numberOfRecords;
+}
+} // namespace Core
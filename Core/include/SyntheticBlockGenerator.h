@@ -0,0 +1,193 @@
+#ifndef CORE_SYNTHETICBLOCKGENERATOR_H
+#define CORE_SYNTHETICBLOCKGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "eigen3/Eigen/Core"
+
+#include "IdRegistry.h"
+
+namespace Core {
+/**
+ * This is the class to generate synthetic image blocks at arbitrary scale
+ * (e.g., to profile memory and solver scaling), deterministically from a
+ * seed (see RandomNumber), and independently of the number of threads.
+ *
+ * The block is flown in parallel strips along the X axis of the mapping frame
+ * (alternating in direction), with the exposures spaced for the forward and
+ * side overlaps of the nadir camera over the mean terrain. The body frame
+ * (x forward, z up) oscillates by a few tenths of a degree in roll, pitch and
+ * heading around level flight. Every exposure is taken by a rig of a nadir
+ * reference camera (mounting parameters to the body frame with a lever arm
+ * and boresight angles) and, optionally, four oblique cameras (forward,
+ * backward, left and right, with mounting parameters to the nadir camera).
+ * The images have the true body poses as EOPs, i.e., the cameras are the
+ * composition of the body pose and the mounting parameters (see
+ * ColmapModel::Create), and the GNSS/INS trajectory records the body poses
+ * along the strips with noise.
+ *
+ * The object points are uniformly distributed in the XY plane of the block
+ * (with the density for the given number of points in a nadir image), and lie
+ * on a terrain of superposed sine waves (see GetTerrainHeight). The image
+ * points are projected with distortion-free cameras (i.e., x = xp - c * X / Z
+ * and y = yp - c * Y / Z in the camera frame, see
+ * InteriorOrientation::ConvertImageCoordinatesToPixel), with normal noise in
+ * pixels. Points which are farther from a camera than the maximum distance
+ * are not observed by it, and points which are observed in less than two
+ * images are dropped.
+ */
+class SyntheticBlockGenerator {
+public:
+  struct Options {
+    /// Seed of all random numbers
+    std::uint64_t seed = 1;
+    unsigned int numberOfStrips = 4;
+    unsigned int numberOfExposuresPerStrip = 20;
+    /// Flag to add four oblique cameras to the nadir camera
+    bool hasObliqueCameras = false;
+    /// Tilt of the oblique cameras in degrees
+    double obliqueAngle = 45.0;
+
+    /// Interior orientation of all cameras (in pixels and mm)
+    unsigned int width = 8000;
+    unsigned int height = 6000;
+    double pixelSize = 0.004;
+    double focalLength = 50.0;
+    double principalPoint[2] = {0.02, -0.01};
+
+    /// Flight parameters (in m and s)
+    double flyingHeight = 1000.0;
+    double forwardOverlap = 0.8;
+    double sideOverlap = 0.6;
+    double speed = 60.0;
+    double turnDuration = 90.0;
+    /// Rate of the trajectory records (in Hz)
+    double trajectoryRate = 10.0;
+
+    /// Terrain (amplitude and wavelength of the sine waves, in m)
+    double terrainAmplitude = 50.0;
+    double terrainWavelength = 3000.0;
+    /// Approximate number of object points in the footprint of a nadir image
+    double numberOfPointsPerImage = 500.0;
+    /// Maximum distance of observed object points (in flying heights)
+    double maximumDistance = 2.0;
+
+    /// Standard deviations of the image points (in pixels), and of the
+    /// trajectory positions (in m) and attitudes (in degrees); 0 = no noise
+    double imageSigma = 0.5;
+    double positionSigma = 0.05;
+    double attitudeSigma = 0.005;
+
+    /// Number of threads (0 = number of hardware threads)
+    unsigned int numberOfThreads = 0;
+  };
+
+  /// Camera of the rig
+  struct Camera {
+    std::string id;
+    /// Id of the reference camera (see FrameCamera), i.e., the nadir camera
+    std::string referenceCameraId;
+    /// Mounting parameters, i.e., the camera to body (reference camera) or
+    /// camera to reference camera rotation and translation
+    Eigen::Matrix3d rotation;
+    Eigen::Vector3d translation;
+  };
+
+  /// Image of an exposure and a camera of the rig
+  struct Image {
+    std::string id;
+    std::uint32_t cameraIndex;
+    double time;
+    /// Body to mapping frame rotation and position, i.e., the EOPs
+    Eigen::Matrix3d rotation;
+    Eigen::Vector3d position;
+  };
+
+  /// Content of a synthetic block
+  struct Block {
+    Options options;
+    std::vector<Camera> cameras;
+    std::vector<Image> images;
+
+    /// Times, positions (n x 3) and attitudes (n x 4, i.e., x, y, z and w of
+    /// the body to mapping frame rotation) of the trajectory records
+    std::vector<double> trajectoryTimes;
+    std::vector<double> trajectoryPositions;
+    std::vector<double> trajectoryAttitudes;
+
+    /// X, Y and Z of every object point
+    std::vector<double> points;
+
+    /// Image and point index, and col and row of every observation (sorted by
+    /// image)
+    std::vector<Handle> imageIndices;
+    std::vector<Handle> pointIndices;
+    std::vector<double> x;
+    std::vector<double> y;
+
+    std::size_t getNumberOfPoints() const { return points.size() / 3; }
+    std::size_t getNumberOfObservations() const { return x.size(); }
+  };
+
+  /**
+   * Create a synthetic block
+   * Note: This function throws std::invalid_argument for invalid options
+   * (e.g., no strips, or overlaps outside of [0, 1)).
+   */
+  static Block Create(const Options &options);
+
+  /**
+   * Add the cameras, images, object points, trajectory and observations
+   * (with the image sigma as weights, sorted by image) of a synthetic block
+   * to an empty image block
+   * Note: This function throws std::invalid_argument if the image block is not
+   * empty.
+   */
+  template <typename TImageBlockType>
+  static void Load(const Block &block, TImageBlockType &imageBlock);
+
+  /// Create a synthetic block, and load it into an empty image block
+  template <typename TImageBlockType>
+  static void Generate(const Options &options, TImageBlockType &imageBlock);
+
+  /// Get the height of the terrain at (x, y)
+  static double GetTerrainHeight(const Options &options, const double x,
+                                 const double y);
+
+private:
+  /// Flight geometry derived from the options (in m and s)
+  struct Geometry {
+    /// Footprint of a nadir image along and across the strips
+    double footprint[2];
+    double base;
+    double stripSpacing;
+    double stripLength;
+    /// Distance which is flown before the first and after the last exposure
+    /// of a strip
+    double leadIn;
+    /// Time between the starts of consecutive strips
+    double stripInterval;
+  };
+
+  static Geometry GetGeometry(const Options &options);
+
+  /**
+   * Get the pose of the body frame on a strip
+   * @param[in] distance The distance from the first exposure of the strip
+   * (in the direction of flight)
+   * @param[out] time The time of the pose
+   * @param[out] rotation The body to mapping frame rotation
+   * @param[out] position The position of the body frame
+   */
+  static void GetBodyPose(const Options &options, const Geometry &geometry,
+                          const unsigned int strip, const double distance,
+                          double &time, Eigen::Matrix3d &rotation,
+                          Eigen::Vector3d &position);
+};
+} // namespace Core
+
+#include "SyntheticBlockGenerator.hpp"
+
+#endif // CORE_SYNTHETICBLOCKGENERATOR_H
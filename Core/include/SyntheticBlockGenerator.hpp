@@ -0,0 +1,117 @@
+#include "SyntheticBlockGenerator.h"
+
+#include <memory>
+#include <stdexcept>
+
+#include "ExteriorOrientation.h"
+#include "ObservationTable.h"
+#include "Trajectory.h"
+
+namespace Core {
+template <typename TImageBlockType>
+void SyntheticBlockGenerator::Load(const Block &block,
+                                   TImageBlockType &imageBlock) {
+  using CameraType = typename TImageBlockType::CameraType;
+  using ImageType = typename TImageBlockType::ImageType;
+  using ObjectPointType = typename TImageBlockType::ObjectPointType;
+  using DataType = typename TImageBlockType::DataType;
+  if (imageBlock.getNumberOfCameras() != 0 ||
+      imageBlock.getNumberOfImages() != 0 ||
+      imageBlock.getNumberOfObjectPoints() != 0) {
+    throw std::invalid_argument(
+        "Synthetic blocks can only be loaded into an empty image block!");
+  }
+  const Options &options = block.options;
+  const std::size_t numberOfPoints = block.getNumberOfPoints();
+  imageBlock.reserve(block.cameras.size(), block.images.size(),
+                     numberOfPoints);
+
+  // Cameras
+  CameraType iops;
+  iops.width = options.width;
+  iops.height = options.height;
+  iops.xPixelSize = static_cast<DataType>(options.pixelSize);
+  iops.yPixelSize = static_cast<DataType>(options.pixelSize);
+  iops.xyc[0] = static_cast<DataType>(options.principalPoint[0]);
+  iops.xyc[1] = static_cast<DataType>(options.principalPoint[1]);
+  iops.xyc[2] = static_cast<DataType>(options.focalLength);
+  iops.distortionParameters.setZero();
+  for (const Camera &camera : block.cameras) {
+    ExteriorOrientation<DataType> mountingParameters;
+    mountingParameters.setTranslation(
+        static_cast<DataType>(camera.translation[0]),
+        static_cast<DataType>(camera.translation[1]),
+        static_cast<DataType>(camera.translation[2]));
+    mountingParameters.setRotationFromMatrix(
+        camera.rotation.template cast<DataType>());
+    imageBlock.addCamera(camera.id, std::make_shared<CameraType>(
+                                        camera.referenceCameraId,
+                                        mountingParameters, iops));
+  }
+
+  // Images
+  for (const Image &record : block.images) {
+    auto image = std::make_shared<ImageType>();
+    image->setCameraId(block.cameras[record.cameraIndex].id);
+    image->setTranslation(static_cast<DataType>(record.position[0]),
+                          static_cast<DataType>(record.position[1]),
+                          static_cast<DataType>(record.position[2]));
+    image->setRotationFromMatrix(record.rotation.template cast<DataType>());
+    imageBlock.addImage(record.id, image);
+  }
+
+  // Object points
+  for (std::size_t i = 0; i < numberOfPoints; ++i) {
+    const double *point = block.points.data() + 3 * i;
+    imageBlock.addObjectPoint("point" + std::to_string(i),
+                              ObjectPointType(point[0], point[1], point[2]));
+  }
+
+  // Trajectory
+  using TrajectoryType = Trajectory<DataType>;
+  TrajectoryType &trajectory = imageBlock.getTrajectory();
+  trajectory.clear();
+  trajectory.reserve(block.trajectoryTimes.size());
+  for (std::size_t i = 0; i < block.trajectoryTimes.size(); ++i) {
+    const double *position = block.trajectoryPositions.data() + 3 * i;
+    const double *attitude = block.trajectoryAttitudes.data() + 4 * i;
+    trajectory.append(
+        static_cast<DataType>(block.trajectoryTimes[i]),
+        typename TrajectoryType::PositionType(
+            static_cast<DataType>(position[0]),
+            static_cast<DataType>(position[1]),
+            static_cast<DataType>(position[2])),
+        typename TrajectoryType::AttitudeType(
+            static_cast<DataType>(attitude[3]),
+            static_cast<DataType>(attitude[0]),
+            static_cast<DataType>(attitude[1]),
+            static_cast<DataType>(attitude[2])));
+  }
+
+  // Observations, in bulk
+  const DataType sqrtInformation = static_cast<DataType>(
+      options.imageSigma > 0.0 ? 1.0 / options.imageSigma : 1.0);
+  const std::size_t numberOfObservations = block.getNumberOfObservations();
+  ObservationTable<DataType> observations;
+  observations.resize(numberOfObservations);
+  for (std::size_t i = 0; i < numberOfObservations; ++i) {
+    const Handle imageIndex = block.imageIndices[i];
+    observations.imageHandles[i] = imageIndex;
+    observations.pointHandles[i] = block.pointIndices[i];
+    observations.cameraHandles[i] = block.images[imageIndex].cameraIndex;
+    observations.x[i] = static_cast<DataType>(block.x[i]);
+    observations.y[i] = static_cast<DataType>(block.y[i]);
+    observations.sqrtInformation[3 * i] = sqrtInformation;
+    observations.sqrtInformation[3 * i + 1] = static_cast<DataType>(0);
+    observations.sqrtInformation[3 * i + 2] = sqrtInformation;
+  }
+  observations.sortByImage();
+  imageBlock.setObservations(std::move(observations));
+}
+
+template <typename TImageBlockType>
+void SyntheticBlockGenerator::Generate(const Options &options,
+                                       TImageBlockType &imageBlock) {
+  Load(Create(options), imageBlock);
+}
+} // namespace Core
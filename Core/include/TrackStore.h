@@ -0,0 +1,95 @@
+#ifndef CORE_TRACKSTORE_H
+#define CORE_TRACKSTORE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "IdRegistry.h"
+
+namespace Core {
+/**
+ * This is the class for the tracks of an image block stored in compressed
+ * sparse row (CSR) format. For every object point it keeps the indices of its
+ * observations (i.e., the track), and for every image the indices of the
+ * observations measured in it. Observation indices refer to the rows of an
+ * ObservationTable.
+ * Note: The store is built in bulk (two counting passes over the
+ * observations), and replaces the per-point ObjectPoint::mTiePointIds maps for
+ * large image blocks.
+ */
+class TrackStore {
+public:
+  /// Index of an observation
+  using Index = std::uint32_t;
+
+  /// Contiguous range of observation indices
+  class Range {
+  public:
+    Range(const Index *first, const Index *last) : mFirst(first), mLast(last) {}
+
+    const Index *begin() const { return mFirst; }
+    const Index *end() const { return mLast; }
+    std::size_t size() const { return static_cast<std::size_t>(mLast - mFirst); }
+    bool empty() const { return mFirst == mLast; }
+    Index operator[](const std::size_t i) const { return mFirst[i]; }
+
+  private:
+    const Index *mFirst;
+    const Index *mLast;
+  };
+
+  /// Default constructor
+  TrackStore() = default;
+
+  /**
+   * Build the store from the point and image handles of all observations
+   * Note: Within every track (or image), observation indices are in ascending
+   * order. This function throws std::invalid_argument if a handle is out of
+   * range, and std::length_error if there are too many observations; the
+   * store is unchanged in both cases.
+   * @param[in] pointHandles The object point handle of every observation
+   * @param[in] imageHandles The image handle of every observation
+   * @param[in] numberOfPoints The number of object points in the image block
+   * @param[in] numberOfImages The number of images in the image block
+   */
+  void build(const std::vector<Handle> &pointHandles,
+             const std::vector<Handle> &imageHandles,
+             const std::size_t numberOfPoints,
+             const std::size_t numberOfImages);
+
+  /// Remove all tracks
+  void clear();
+
+  /// Get the observation indices of the object point with the given handle
+  Range getPointObservations(const Handle pointHandle) const;
+  /// Get the observation indices of the image with the given handle
+  Range getImageObservations(const Handle imageHandle) const;
+  /// Get the number of observations of the object point with the given handle
+  std::size_t getTrackLength(const Handle pointHandle) const;
+
+  /// Get the number of object points
+  std::size_t getNumberOfPoints() const;
+  /// Get the number of images
+  std::size_t getNumberOfImages() const;
+  /// Get the number of observations
+  std::size_t getNumberOfObservations() const;
+  /// Get the number of bytes used by the store
+  std::size_t getMemoryUsage() const;
+
+private:
+  /// Fill CSR offsets and indices for the given keys (counting sort)
+  static void BuildRows(const std::vector<Handle> &keys,
+                        const std::size_t numberOfRows,
+                        std::vector<Index> &offsets,
+                        std::vector<Index> &indices);
+
+  /// Offsets (size = number of points + 1) and observations of every point
+  std::vector<Index> mPointOffsets;
+  std::vector<Index> mPointObservations;
+  /// Offsets (size = number of images + 1) and observations of every image
+  std::vector<Index> mImageOffsets;
+  std::vector<Index> mImageObservations;
+};
+} // namespace Core
+
+#endif // CORE_TRACKSTORE_H
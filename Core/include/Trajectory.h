@@ -0,0 +1,126 @@
+#ifndef CORE_TRAJECTORY_H
+#define CORE_TRAJECTORY_H
+
+#include <vector>
+
+#include "eigen3/Eigen/Geometry"
+
+#include "ExteriorOrientation.h"
+
+namespace Core {
+/**
+ * This is the class for a time-sorted trajectory of GNSS/INS poses (i.e.,
+ * positions and attitudes of the body frame in the mapping frame), stored
+ * contiguously as times, positions and unit quaternions.
+ * Poses at arbitrary times (e.g., image exposure times) are interpolated
+ * between the two bracketing records, linearly for positions and by
+ * spherical linear interpolation (slerp) for attitudes.
+ * Note: Times are in seconds as double (e.g., GPS seconds of week, or seconds
+ * since an epoch), which keeps sub-microsecond resolution for any practical
+ * time span. Records have to be appended in strictly increasing time order
+ * (i.e., streaming append), so that the store stays sorted without re-sorting.
+ */
+template <typename TDataType = double> class Trajectory {
+public:
+  /// Type of positions
+  using PositionType = Eigen::Matrix<TDataType, 3, 1, Eigen::DontAlign>;
+  /// Type of attitudes (i.e., rotation from the body to the mapping frame)
+  using AttitudeType = Eigen::Quaternion<TDataType, Eigen::DontAlign>;
+
+  /// Default constructor
+  Trajectory() = default;
+
+  /**
+   * Append a record
+   * Note: This function throws std::invalid_argument if the time is not
+   * greater than the time of the last record.
+   * @param[in] time Time of the record
+   * @param[in] position Position of the body frame in the mapping frame
+   * @param[in] attitude Rotation from the body to the mapping frame, which is
+   * normalized before it is stored
+   */
+  void append(const TDataType time, const PositionType &position,
+              const AttitudeType &attitude);
+  /// Append a record given as EOPs (e.g., a navigation measurement)
+  void append(const TDataType time,
+              const ExteriorOrientation<TDataType> &pose);
+
+  /// Reserve memory for the given number of records
+  void reserve(const std::size_t size);
+  /// Remove all records
+  void clear();
+
+  /// Get the number of records
+  std::size_t size() const;
+  bool empty() const;
+  /// Get the times of the first and the last record
+  TDataType getStartTime() const;
+  TDataType getEndTime() const;
+
+  /// Get the time, position and attitude of the i-th record
+  TDataType getTime(const std::size_t index) const;
+  const PositionType &getPosition(const std::size_t index) const;
+  const AttitudeType &getAttitude(const std::size_t index) const;
+
+  /**
+   * Find the interval [t_i, t_i+1] containing the given time (binary search)
+   * Note: This function throws std::out_of_range if the time is outside of
+   * the trajectory, or if there are less than two records.
+   * @return The index i of the first record of the interval
+   */
+  std::size_t findInterval(const TDataType time) const;
+
+  /**
+   * Find the interval containing the given time, searching forward from the
+   * interval found by the last call (i.e., O(1) for consecutive intervals,
+   * and O(log(d)) for intervals d records apart)
+   * @param[in] time Time
+   * @param[in,out] hint The index of the last interval, which is updated
+   */
+  std::size_t findInterval(const TDataType time, std::size_t &hint) const;
+
+  /**
+   * Interpolate the pose at the given time
+   * Note: This function throws std::out_of_range if the time is outside of
+   * the trajectory.
+   * @param[in] time Time
+   * @param[out] position Interpolated position (lerp)
+   * @param[out] attitude Interpolated attitude (slerp)
+   */
+  void interpolate(const TDataType time, PositionType &position,
+                   AttitudeType &attitude) const;
+
+  /// Interpolate the pose at the given time as EOPs (rotation in degrees)
+  ExteriorOrientation<TDataType> interpolate(const TDataType time) const;
+
+  /**
+   * Interpolate the poses at many times (e.g., all image exposure times).
+   * Sorted times are bracketed by searching forward from the last interval;
+   * unsorted ones fall back to binary searches.
+   * Note: This function throws std::out_of_range if a time is outside of the
+   * trajectory.
+   * @param[in] size The number of times
+   * @param[in] times Times (size x 1)
+   * @param[out] positions Interpolated positions (size x 3, i.e., X, Y and Z
+   * of each pose)
+   * @param[out] attitudes Interpolated attitudes (size x 4, i.e., x, y, z and
+   * w of each unit quaternion, as Eigen::Quaternion::coeffs)
+   */
+  void interpolate(const std::size_t size, const TDataType *times,
+                   TDataType *positions, TDataType *attitudes) const;
+
+private:
+  /// Interpolate the pose in the interval [t_i, t_i+1]
+  void interpolateInInterval(const std::size_t index, const TDataType time,
+                             TDataType *position, TDataType *attitude) const;
+
+  /// Times, positions and attitudes of the records
+  std::vector<TDataType> mTimes;
+  std::vector<PositionType> mPositions;
+  std::vector<AttitudeType> mAttitudes;
+};
+} // namespace Core
+
+#include "Trajectory.hpp"
+
+#endif // CORE_TRAJECTORY_H
@@ -0,0 +1,166 @@
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Core {
+template <typename TDataType>
+void Trajectory<TDataType>::append(const TDataType time,
+                                   const PositionType &position,
+                                   const AttitudeType &attitude) {
+  if (!mTimes.empty() && !(time > mTimes.back())) {
+    throw std::invalid_argument(
+        "Records have to be appended in increasing time order!");
+  }
+  mTimes.push_back(time);
+  mPositions.push_back(position);
+  mAttitudes.push_back(attitude.normalized());
+}
+
+template <typename TDataType>
+void Trajectory<TDataType>::append(
+    const TDataType time, const ExteriorOrientation<TDataType> &pose) {
+  append(time, PositionType(pose.getTranslation()),
+         AttitudeType(pose.getRotationAsQuaternion()));
+}
+
+template <typename TDataType>
+void Trajectory<TDataType>::reserve(const std::size_t size) {
+  mTimes.reserve(size);
+  mPositions.reserve(size);
+  mAttitudes.reserve(size);
+}
+
+template <typename TDataType> void Trajectory<TDataType>::clear() {
+  mTimes.clear();
+  mPositions.clear();
+  mAttitudes.clear();
+}
+
+template <typename TDataType>
+std::size_t Trajectory<TDataType>::size() const {
+  return mTimes.size();
+}
+
+template <typename TDataType> bool Trajectory<TDataType>::empty() const {
+  return mTimes.empty();
+}
+
+template <typename TDataType>
+TDataType Trajectory<TDataType>::getStartTime() const {
+  if (mTimes.empty()) {
+    throw std::out_of_range("The trajectory is empty!");
+  }
+  return mTimes.front();
+}
+
+template <typename TDataType>
+TDataType Trajectory<TDataType>::getEndTime() const {
+  if (mTimes.empty()) {
+    throw std::out_of_range("The trajectory is empty!");
+  }
+  return mTimes.back();
+}
+
+template <typename TDataType>
+TDataType Trajectory<TDataType>::getTime(const std::size_t index) const {
+  return mTimes.at(index);
+}
+
+template <typename TDataType>
+const typename Trajectory<TDataType>::PositionType &
+Trajectory<TDataType>::getPosition(const std::size_t index) const {
+  return mPositions.at(index);
+}
+
+template <typename TDataType>
+const typename Trajectory<TDataType>::AttitudeType &
+Trajectory<TDataType>::getAttitude(const std::size_t index) const {
+  return mAttitudes.at(index);
+}
+
+template <typename TDataType>
+std::size_t Trajectory<TDataType>::findInterval(const TDataType time) const {
+  if (mTimes.size() < 2 || time < mTimes.front() || time > mTimes.back()) {
+    throw std::out_of_range("The given time is outside of the trajectory!");
+  }
+  // The first record after the time, where the end time belongs to the last
+  // interval
+  const auto upper =
+      std::upper_bound(mTimes.begin() + 1, mTimes.end() - 1, time);
+  return static_cast<std::size_t>(upper - mTimes.begin()) - 1;
+}
+
+template <typename TDataType>
+std::size_t Trajectory<TDataType>::findInterval(const TDataType time,
+                                                std::size_t &hint) const {
+  if (hint + 1 >= mTimes.size() || time < mTimes[hint] ||
+      time > mTimes.back()) {
+    hint = findInterval(time);
+    return hint;
+  }
+  // Exponential search forward from the hint (i.e., O(log(d)) for a distance
+  // of d records, which is O(1) for consecutive intervals), followed by a
+  // binary search within the last step
+  const std::size_t last = mTimes.size() - 1;
+  std::size_t first = hint + 1;
+  std::size_t step = 1;
+  while (first + step < last && mTimes[first + step] <= time) {
+    first += step;
+    step *= 2;
+  }
+  const auto upper = std::upper_bound(mTimes.begin() + first,
+                                      mTimes.begin() + std::min(first + step,
+                                                                last),
+                                      time);
+  hint = static_cast<std::size_t>(upper - mTimes.begin()) - 1;
+  return hint;
+}
+
+template <typename TDataType>
+void Trajectory<TDataType>::interpolate(const TDataType time,
+                                        PositionType &position,
+                                        AttitudeType &attitude) const {
+  interpolateInInterval(findInterval(time), time, position.data(),
+                        attitude.coeffs().data());
+}
+
+template <typename TDataType>
+ExteriorOrientation<TDataType>
+Trajectory<TDataType>::interpolate(const TDataType time) const {
+  PositionType position;
+  AttitudeType attitude;
+  interpolate(time, position, attitude);
+  ExteriorOrientation<TDataType> pose;
+  pose.setTranslation(position[0], position[1], position[2]);
+  pose.setRotationFromMatrix(attitude.toRotationMatrix());
+  return pose;
+}
+
+template <typename TDataType>
+void Trajectory<TDataType>::interpolate(const std::size_t size,
+                                        const TDataType *times,
+                                        TDataType *positions,
+                                        TDataType *attitudes) const {
+  std::size_t hint = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    interpolateInInterval(findInterval(times[i], hint), times[i],
+                          positions + 3 * i, attitudes + 4 * i);
+  }
+}
+
+template <typename TDataType>
+void Trajectory<TDataType>::interpolateInInterval(const std::size_t index,
+                                                  const TDataType time,
+                                                  TDataType *position,
+                                                  TDataType *attitude) const {
+  const TDataType ratio =
+      (time - mTimes[index]) / (mTimes[index + 1] - mTimes[index]);
+  Eigen::Map<Eigen::Matrix<TDataType, 3, 1>> interpolatedPosition(position);
+  interpolatedPosition =
+      mPositions[index] + ratio * (mPositions[index + 1] - mPositions[index]);
+  // Note: slerp takes the shorter arc (i.e., q and -q are the same attitude)
+  Eigen::Map<Eigen::Quaternion<TDataType>> interpolatedAttitude(attitude);
+  interpolatedAttitude = mAttitudes[index].slerp(ratio, mAttitudes[index + 1]);
+}
+} // namespace Core
@@ -0,0 +1,155 @@
+#include "BalImporter.h"
+
+#include <stdexcept>
+
+#include "MappedFile.h"
+#include "NumberParser.h"
+#include "Parallel.h"
+
+namespace Core {
+namespace {
+/// Get the first token starting in [begin, end) of the given characters
+/// (i.e., a token overlapping begin belongs to the previous chunk)
+const char *GetFirstToken(const char *characters, const std::size_t begin,
+                          const char *last) {
+  const char *position = characters + begin;
+  if (begin > 0 && !IsWhitespace(characters[begin - 1])) {
+    while (position != last && !IsWhitespace(*position)) {
+      ++position;
+    }
+  }
+  SkipWhitespaces(position, last);
+  return position;
+}
+
+/// Parse an index in [0, size) followed by a whitespace or the end
+Handle ParseIndex(const char *&position, const char *last,
+                  const std::size_t size) {
+  std::int64_t index;
+  if (!ParseInteger(position, last, index) ||
+      (position != last && !IsWhitespace(*position))) {
+    throw std::runtime_error("Invalid index in the BAL file!");
+  }
+  if (index < 0 || static_cast<std::uint64_t>(index) >= size) {
+    throw std::runtime_error("Index out of range in the BAL file!");
+  }
+  return static_cast<Handle>(index);
+}
+
+/// Parse a number followed by a whitespace or the end
+double ParseNumber(const char *&position, const char *last) {
+  double value;
+  if (!ParseDouble(position, last, value) ||
+      (position != last && !IsWhitespace(*position))) {
+    throw std::runtime_error("Invalid number in the BAL file!");
+  }
+  return value;
+}
+} // namespace
+
+BalImporter::Problem BalImporter::Parse(const std::string &filePath,
+                                        const unsigned int numberOfThreads) {
+  const MappedFile file(filePath);
+  return Parse(file.data(), file.data() + file.size(), numberOfThreads);
+}
+
+BalImporter::Problem BalImporter::Parse(const char *first, const char *last,
+                                        unsigned int numberOfThreads) {
+  // Header
+  std::uint64_t sizes[3];
+  for (auto &size : sizes) {
+    std::int64_t value;
+    SkipWhitespaces(first, last);
+    if (!ParseInteger(first, last, value) || value < 0 ||
+        value >= static_cast<std::int64_t>(InvalidHandle)) {
+      throw std::runtime_error("Invalid header of the BAL file!");
+    }
+    size = static_cast<std::uint64_t>(value);
+  }
+  const std::size_t numberOfCameras = sizes[0];
+  const std::size_t numberOfPoints = sizes[1];
+  const std::size_t numberOfObservations = sizes[2];
+  Problem problem;
+  problem.cameraIndices.resize(numberOfObservations);
+  problem.pointIndices.resize(numberOfObservations);
+  problem.x.resize(numberOfObservations);
+  problem.y.resize(numberOfObservations);
+  problem.cameras.resize(9 * numberOfCameras);
+  problem.points.resize(3 * numberOfPoints);
+  const std::size_t numberOfObservationNumbers = 4 * numberOfObservations;
+  const std::size_t numberOfCameraNumbers = 9 * numberOfCameras;
+  const std::size_t numberOfNumbers =
+      numberOfObservationNumbers + numberOfCameraNumbers + 3 * numberOfPoints;
+
+  // Count the tokens of every chunk, so that every chunk knows the index of
+  // its first number
+  if (numberOfThreads == 0) {
+    numberOfThreads = GetNumberOfHardwareThreads();
+  }
+  const std::size_t size = static_cast<std::size_t>(last - first);
+  std::vector<std::size_t> offsets(numberOfThreads + 1, 0);
+  ParallelFor(
+      size,
+      [&](const std::size_t begin, const std::size_t end,
+          const unsigned int chunk) {
+        const char *chunkEnd = first + end;
+        std::size_t count = 0;
+        for (const char *position = GetFirstToken(first, begin, last);
+             position < chunkEnd; SkipWhitespaces(position, last)) {
+          ++count;
+          while (position != last && !IsWhitespace(*position)) {
+            ++position;
+          }
+        }
+        offsets[chunk + 1] = count;
+      },
+      numberOfThreads);
+  for (unsigned int chunk = 0; chunk < numberOfThreads; ++chunk) {
+    offsets[chunk + 1] += offsets[chunk];
+  }
+  if (offsets.back() != numberOfNumbers) {
+    throw std::runtime_error(
+        "The number of values does not match the header of the BAL file!");
+  }
+
+  // Parse every number into its place
+  ParallelFor(
+      size,
+      [&](const std::size_t begin, const std::size_t end,
+          const unsigned int chunk) {
+        const char *chunkEnd = first + end;
+        std::size_t index = offsets[chunk];
+        for (const char *position = GetFirstToken(first, begin, last);
+             position < chunkEnd; SkipWhitespaces(position, last), ++index) {
+          if (index < numberOfObservationNumbers) {
+            const std::size_t observation = index / 4;
+            switch (index % 4) {
+            case 0:
+              problem.cameraIndices[observation] =
+                  ParseIndex(position, last, numberOfCameras);
+              break;
+            case 1:
+              problem.pointIndices[observation] =
+                  ParseIndex(position, last, numberOfPoints);
+              break;
+            case 2:
+              problem.x[observation] = ParseNumber(position, last);
+              break;
+            default:
+              problem.y[observation] = ParseNumber(position, last);
+            }
+          } else if (index < numberOfObservationNumbers +
+                                 numberOfCameraNumbers) {
+            problem.cameras[index - numberOfObservationNumbers] =
+                ParseNumber(position, last);
+          } else {
+            problem.points[index - numberOfObservationNumbers -
+                           numberOfCameraNumbers] =
+                ParseNumber(position, last);
+          }
+        }
+      },
+      numberOfThreads);
+  return problem;
+}
+} // namespace Core
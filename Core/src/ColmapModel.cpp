@@ -0,0 +1,455 @@
+#include "ColmapModel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "boost/filesystem.hpp"
+
+#include "MappedFile.h"
+
+namespace Core {
+namespace {
+/// Sequential reader of a mapped file, which checks the end of the file
+class FileReader {
+public:
+  explicit FileReader(const std::string &filePath)
+      : mFilePath(filePath), mFile(filePath), mPosition(mFile.data()),
+        mLast(mFile.data() + mFile.size()) {}
+
+  template <typename T> T read() {
+    T value;
+    readArray(&value, 1);
+    return value;
+  }
+
+  template <typename T> void readArray(T *values, const std::size_t size) {
+    if (static_cast<std::size_t>(mLast - mPosition) / sizeof(T) < size) {
+      throw std::runtime_error("The file " + mFilePath + " is truncated!");
+    }
+    std::memcpy(values, mPosition, size * sizeof(T));
+    mPosition += size * sizeof(T);
+  }
+
+  /// Read a null-terminated string
+  std::string readString() {
+    const char *end = std::find(mPosition, mLast, '\0');
+    if (end == mLast) {
+      throw std::runtime_error("The file " + mFilePath + " is truncated!");
+    }
+    std::string string(mPosition, end);
+    mPosition = end + 1;
+    return string;
+  }
+
+  /// Get the number of unread bytes
+  std::size_t remaining() const {
+    return static_cast<std::size_t>(mLast - mPosition);
+  }
+
+  const std::string &getFilePath() const { return mFilePath; }
+
+private:
+  std::string mFilePath;
+  MappedFile mFile;
+  const char *mPosition;
+  const char *mLast;
+};
+
+/// Sequential writer of a binary file
+class FileWriter {
+public:
+  explicit FileWriter(const std::string &filePath)
+      : mFilePath(filePath),
+        mFile(filePath, std::ios::binary | std::ios::trunc) {
+    if (!mFile) {
+      throw std::runtime_error("Cannot open the file " + filePath + "!");
+    }
+  }
+
+  template <typename T> void write(const T value) { writeArray(&value, 1); }
+
+  template <typename T>
+  void writeArray(const T *values, const std::size_t size) {
+    mFile.write(reinterpret_cast<const char *>(values),
+                static_cast<std::streamsize>(size * sizeof(T)));
+  }
+
+  /// Write a null-terminated string
+  void writeString(const std::string &string) {
+    mFile.write(string.c_str(),
+                static_cast<std::streamsize>(string.size() + 1));
+  }
+
+  void close() {
+    mFile.close();
+    if (!mFile) {
+      throw std::runtime_error("Cannot write the file " + mFilePath + "!");
+    }
+  }
+
+private:
+  std::string mFilePath;
+  std::ofstream mFile;
+};
+
+/**
+ * Lookup of the indices of ids, with a dense table if the ids are compact
+ * (as they are in COLMAP models), and with binary search otherwise
+ * Note: The constructor throws std::runtime_error for duplicate ids.
+ */
+class IndexLookup {
+public:
+  template <typename TRecord>
+  IndexLookup(const std::vector<TRecord> &records, const std::string &file) {
+    std::uint32_t maxId = 0;
+    for (const TRecord &record : records) {
+      maxId = std::max(maxId, record.id);
+    }
+    if (maxId <= 4 * records.size() + 1024) {
+      mTable.assign(static_cast<std::size_t>(maxId) + 1, InvalidIndex);
+      for (std::size_t i = 0; i < records.size(); ++i) {
+        if (mTable[records[i].id] != InvalidIndex) {
+          ThrowDuplicateId(records[i].id, file);
+        }
+        mTable[records[i].id] = static_cast<std::uint32_t>(i);
+      }
+    } else {
+      mSortedIds.reserve(records.size());
+      for (std::size_t i = 0; i < records.size(); ++i) {
+        mSortedIds.emplace_back(records[i].id, static_cast<std::uint32_t>(i));
+      }
+      std::sort(mSortedIds.begin(), mSortedIds.end());
+      for (std::size_t i = 1; i < mSortedIds.size(); ++i) {
+        if (mSortedIds[i].first == mSortedIds[i - 1].first) {
+          ThrowDuplicateId(mSortedIds[i].first, file);
+        }
+      }
+    }
+  }
+
+  /// Get the index of an id
+  /// Note: This function throws std::runtime_error if it cannot be found.
+  std::uint32_t find(const std::uint32_t id, const std::string &file) const {
+    std::uint32_t index = InvalidIndex;
+    if (!mTable.empty()) {
+      index = id < mTable.size() ? mTable[id] : InvalidIndex;
+    } else {
+      const auto it = std::lower_bound(
+          mSortedIds.begin(), mSortedIds.end(),
+          std::make_pair(id, std::uint32_t(0)));
+      if (it != mSortedIds.end() && it->first == id) {
+        index = it->second;
+      }
+    }
+    if (index == InvalidIndex) {
+      throw std::runtime_error("Unknown id " + std::to_string(id) + " in " +
+                               file + "!");
+    }
+    return index;
+  }
+
+private:
+  static constexpr std::uint32_t InvalidIndex = static_cast<std::uint32_t>(-1);
+
+  static void ThrowDuplicateId(const std::uint32_t id,
+                               const std::string &file) {
+    throw std::runtime_error("Duplicate id " + std::to_string(id) + " in " +
+                             file + "!");
+  }
+
+  std::vector<std::uint32_t> mTable;
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> mSortedIds;
+};
+
+constexpr std::uint32_t IndexLookup::InvalidIndex;
+
+std::string GetFilePath(const std::string &directory, const char *fileName) {
+  return (boost::filesystem::path(directory) / fileName).string();
+}
+} // namespace
+
+constexpr std::uint64_t ColmapModel::InvalidPoint3DId;
+
+std::size_t ColmapModel::GetNumberOfParameters(const CameraModel model) {
+  switch (model) {
+  case CameraModel::SimplePinhole:
+    return 3;
+  case CameraModel::Pinhole:
+  case CameraModel::SimpleRadial:
+  case CameraModel::SimpleRadialFisheye:
+    return 4;
+  case CameraModel::Radial:
+  case CameraModel::FOV:
+  case CameraModel::RadialFisheye:
+    return 5;
+  case CameraModel::OpenCV:
+  case CameraModel::OpenCVFisheye:
+    return 8;
+  case CameraModel::FullOpenCV:
+  case CameraModel::ThinPrismFisheye:
+    return 12;
+  }
+  throw std::runtime_error("Unknown COLMAP camera model " +
+                           std::to_string(static_cast<int>(model)) + "!");
+}
+
+ColmapModel ColmapModel::Read(const std::string &directory) {
+  ColmapModel model;
+
+  // Cameras
+  {
+    FileReader file(GetFilePath(directory, "cameras.bin"));
+    const std::uint64_t numberOfCameras = file.read<std::uint64_t>();
+    // Cameras take at least 48 bytes each
+    if (numberOfCameras > file.remaining() / 48) {
+      throw std::runtime_error("The file " + file.getFilePath() +
+                               " is truncated!");
+    }
+    model.cameras.resize(numberOfCameras);
+    for (Camera &camera : model.cameras) {
+      camera.id = file.read<std::uint32_t>();
+      camera.model = static_cast<CameraModel>(file.read<std::int32_t>());
+      camera.width = file.read<std::uint64_t>();
+      camera.height = file.read<std::uint64_t>();
+      camera.parameters.resize(GetNumberOfParameters(camera.model));
+      file.readArray(camera.parameters.data(), camera.parameters.size());
+    }
+  }
+  const IndexLookup cameraLookup(model.cameras,
+                                 GetFilePath(directory, "cameras.bin"));
+
+  // Images and their image points
+  {
+    FileReader file(GetFilePath(directory, "images.bin"));
+    const std::uint64_t numberOfImages = file.read<std::uint64_t>();
+    // Images take at least 73 bytes each
+    if (numberOfImages > file.remaining() / 73) {
+      throw std::runtime_error("The file " + file.getFilePath() +
+                               " is truncated!");
+    }
+    model.images.resize(numberOfImages);
+    // Image points take at least 24 bytes each
+    model.points2D.reserve(file.remaining() / 12);
+    model.point3DIds2D.reserve(file.remaining() / 24);
+    for (Image &image : model.images) {
+      image.id = file.read<std::uint32_t>();
+      file.readArray(image.rotation, 4);
+      file.readArray(image.translation, 3);
+      image.cameraIndex =
+          cameraLookup.find(file.read<std::uint32_t>(), file.getFilePath());
+      image.name = file.readString();
+      image.numberOfPoints2D = file.read<std::uint64_t>();
+      if (image.numberOfPoints2D > file.remaining() / 24) {
+        throw std::runtime_error("The file " + file.getFilePath() +
+                                 " is truncated!");
+      }
+      image.firstPoint2D = model.point3DIds2D.size();
+      for (std::uint64_t i = 0; i < image.numberOfPoints2D; ++i) {
+        double point[2];
+        file.readArray(point, 2);
+        model.points2D.push_back(point[0]);
+        model.points2D.push_back(point[1]);
+        model.point3DIds2D.push_back(file.read<std::uint64_t>());
+      }
+    }
+  }
+  const IndexLookup imageLookup(model.images,
+                                GetFilePath(directory, "images.bin"));
+
+  // Object points and their tracks
+  {
+    FileReader file(GetFilePath(directory, "points3D.bin"));
+    const std::uint64_t numberOfPoints = file.read<std::uint64_t>();
+    // Object points take at least 43 bytes each
+    if (numberOfPoints > file.remaining() / 43) {
+      throw std::runtime_error("The file " + file.getFilePath() +
+                               " is truncated!");
+    }
+    model.point3DIds.resize(numberOfPoints);
+    model.points3D.resize(3 * numberOfPoints);
+    model.colors.resize(3 * numberOfPoints);
+    model.errors.resize(numberOfPoints);
+    model.trackOffsets.resize(numberOfPoints + 1);
+    model.trackImageIndices.reserve(model.point3DIds2D.size());
+    model.trackPoint2DIndices.reserve(model.point3DIds2D.size());
+    for (std::uint64_t i = 0; i < numberOfPoints; ++i) {
+      model.point3DIds[i] = file.read<std::uint64_t>();
+      file.readArray(model.points3D.data() + 3 * i, 3);
+      file.readArray(model.colors.data() + 3 * i, 3);
+      model.errors[i] = file.read<double>();
+      const std::uint64_t trackLength = file.read<std::uint64_t>();
+      if (trackLength > file.remaining() / 8) {
+        throw std::runtime_error("The file " + file.getFilePath() +
+                                 " is truncated!");
+      }
+      for (std::uint64_t j = 0; j < trackLength; ++j) {
+        const std::uint32_t imageIndex =
+            imageLookup.find(file.read<std::uint32_t>(), file.getFilePath());
+        const std::uint32_t point2DIndex = file.read<std::uint32_t>();
+        if (point2DIndex >= model.images[imageIndex].numberOfPoints2D) {
+          throw std::runtime_error("Unknown image point " +
+                                   std::to_string(point2DIndex) + " in " +
+                                   file.getFilePath() + "!");
+        }
+        model.trackImageIndices.push_back(imageIndex);
+        model.trackPoint2DIndices.push_back(point2DIndex);
+      }
+      model.trackOffsets[i + 1] = model.trackImageIndices.size();
+    }
+  }
+  return model;
+}
+
+void ColmapModel::write(const std::string &directory) const {
+  {
+    FileWriter file(GetFilePath(directory, "cameras.bin"));
+    file.write<std::uint64_t>(cameras.size());
+    for (const Camera &camera : cameras) {
+      file.write(camera.id);
+      file.write(static_cast<std::int32_t>(camera.model));
+      file.write(camera.width);
+      file.write(camera.height);
+      file.writeArray(camera.parameters.data(), camera.parameters.size());
+    }
+    file.close();
+  }
+
+  {
+    FileWriter file(GetFilePath(directory, "images.bin"));
+    file.write<std::uint64_t>(images.size());
+    for (const Image &image : images) {
+      file.write(image.id);
+      file.writeArray(image.rotation, 4);
+      file.writeArray(image.translation, 3);
+      file.write(cameras[image.cameraIndex].id);
+      file.writeString(image.name);
+      file.write(image.numberOfPoints2D);
+      for (std::uint64_t i = image.firstPoint2D;
+           i < image.firstPoint2D + image.numberOfPoints2D; ++i) {
+        file.writeArray(points2D.data() + 2 * i, 2);
+        file.write(point3DIds2D[i]);
+      }
+    }
+    file.close();
+  }
+
+  {
+    FileWriter file(GetFilePath(directory, "points3D.bin"));
+    file.write<std::uint64_t>(point3DIds.size());
+    for (std::size_t i = 0; i < point3DIds.size(); ++i) {
+      file.write(point3DIds[i]);
+      file.writeArray(points3D.data() + 3 * i, 3);
+      file.writeArray(colors.data() + 3 * i, 3);
+      file.write(errors[i]);
+      file.write<std::uint64_t>(trackOffsets[i + 1] - trackOffsets[i]);
+      for (std::uint64_t j = trackOffsets[i]; j < trackOffsets[i + 1]; ++j) {
+        file.write(images[trackImageIndices[j]].id);
+        file.write(trackPoint2DIndices[j]);
+      }
+    }
+    file.close();
+  }
+}
+
+ColmapModel::CameraIops ColmapModel::ConvertToIops(const Camera &camera) {
+  const double *params = camera.parameters.data();
+  double fx, fy, cx, cy;
+  double k1 = 0.0, k2 = 0.0, p1 = 0.0, p2 = 0.0;
+  switch (camera.model) {
+  case CameraModel::SimplePinhole:
+  case CameraModel::SimpleRadial:
+  case CameraModel::Radial:
+    fx = fy = params[0];
+    cx = params[1];
+    cy = params[2];
+    if (camera.model != CameraModel::SimplePinhole) {
+      k1 = params[3];
+    }
+    if (camera.model == CameraModel::Radial) {
+      k2 = params[4];
+    }
+    break;
+  case CameraModel::Pinhole:
+  case CameraModel::OpenCV:
+    fx = params[0];
+    fy = params[1];
+    cx = params[2];
+    cy = params[3];
+    if (camera.model == CameraModel::OpenCV) {
+      k1 = params[4];
+      k2 = params[5];
+      p1 = params[6];
+      p2 = params[7];
+    }
+    break;
+  default:
+    throw std::invalid_argument(
+        "Unsupported COLMAP camera model " +
+        std::to_string(static_cast<int>(camera.model)) + "!");
+  }
+
+  CameraIops iops;
+  iops.yPixelSize = fx / fy;
+  iops.xyc[0] = cx - 0.5 * static_cast<double>(camera.width);
+  iops.xyc[1] = (0.5 * static_cast<double>(camera.height) - cy) * fx / fy;
+  iops.xyc[2] = fx;
+  // Series inversion of the radial distortion (see BalImporter)
+  const double f2 = fx * fx;
+  iops.distortion[0] = k1 / f2;
+  iops.distortion[1] = (k2 - 3.0 * k1 * k1) / (f2 * f2);
+  iops.distortion[2] = (12.0 * k1 * k1 * k1 - 8.0 * k1 * k2) / (f2 * f2 * f2);
+  // Tangential distortion with y up
+  iops.distortion[3] = p2 / fx;
+  iops.distortion[4] = -p1 / fx;
+  return iops;
+}
+
+ColmapModel::Camera ColmapModel::ConvertFromIops(
+    const std::uint32_t id, const std::uint64_t width,
+    const std::uint64_t height, const double xPixelSize,
+    const double yPixelSize, const double *xyc,
+    const std::vector<double> &distortion) {
+  // k0, k1, k2 and k3 of RadialDistortion, followed by p1, p2, p3, a1 and a2
+  // of BrownDistortion
+  for (std::size_t i = 0; i < distortion.size(); ++i) {
+    if ((i == 0 || i > 5) && distortion[i] != 0.0) {
+      throw std::invalid_argument(
+          "k0, p3 and affine distortions cannot be exported to COLMAP!");
+    }
+  }
+  const double c = xyc[2];
+  const double c2 = c * c;
+  const double k1 = distortion.size() > 1 ? distortion[1] * c2 : 0.0;
+  const double k2 =
+      distortion.size() > 2
+          ? (distortion[2] + 3.0 * distortion[1] * distortion[1]) * c2 * c2
+          : 0.0;
+  const double p1 = distortion.size() > 5 ? -distortion[5] * c : 0.0;
+  const double p2 = distortion.size() > 4 ? distortion[4] * c : 0.0;
+
+  Camera camera;
+  camera.id = id;
+  camera.width = width;
+  camera.height = height;
+  const double fx = c / xPixelSize;
+  const double fy = c / yPixelSize;
+  const double cx = 0.5 * static_cast<double>(width) + xyc[0] / xPixelSize;
+  const double cy = 0.5 * static_cast<double>(height) - xyc[1] / yPixelSize;
+  if (xPixelSize == yPixelSize && p1 == 0.0 && p2 == 0.0) {
+    if (k1 == 0.0 && k2 == 0.0) {
+      camera.model = CameraModel::SimplePinhole;
+      camera.parameters = {fx, cx, cy};
+    } else {
+      camera.model = CameraModel::Radial;
+      camera.parameters = {fx, cx, cy, k1, k2};
+    }
+  } else {
+    camera.model = CameraModel::OpenCV;
+    camera.parameters = {fx, fy, cx, cy, k1, k2, p1, p2};
+  }
+  return camera;
+}
+} // namespace Core
@@ -0,0 +1,142 @@
+#include "IdRegistry.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace Core {
+namespace {
+/// Minimum number of slots of the hash table
+constexpr std::size_t MinimumNumberOfSlots = 16;
+} // namespace
+
+Handle IdRegistry::add(const std::string &id) {
+  if (mIds.size() >= static_cast<std::size_t>(InvalidHandle)) {
+    throw std::length_error("Too many ids in the registry!");
+  }
+  if (2 * (mIds.size() + 1) > mSlots.size()) {
+    rehash(std::max(2 * mSlots.size(), MinimumNumberOfSlots));
+  }
+  const std::size_t hash = std::hash<std::string>()(id);
+  const std::size_t slot = findSlot(id, hash);
+  if (mSlots[slot] != InvalidHandle) {
+    return InvalidHandle;
+  }
+  const Handle handle = static_cast<Handle>(mIds.size());
+  mSlots[slot] = handle;
+  mIds.push_back(id);
+  mHashes.push_back(hash);
+  return handle;
+}
+
+bool IdRegistry::erase(const std::string &id, Handle &erasedHandle) {
+  if (mSlots.empty()) {
+    return false;
+  }
+  const std::size_t mask = mSlots.size() - 1;
+  std::size_t slot = findSlot(id, std::hash<std::string>()(id));
+  if (mSlots[slot] == InvalidHandle) {
+    return false;
+  }
+  erasedHandle = mSlots[slot];
+
+  // Shift the following handles of the probe sequence back (unless they are
+  // at their home slots, or they would move before them)
+  for (std::size_t next = (slot + 1) & mask; mSlots[next] != InvalidHandle;
+       next = (next + 1) & mask) {
+    const std::size_t home = mHashes[mSlots[next]] & mask;
+    if (((next - home) & mask) >= ((next - slot) & mask)) {
+      mSlots[slot] = mSlots[next];
+      slot = next;
+    }
+  }
+  mSlots[slot] = InvalidHandle;
+
+  // Move the last id to the erased handle
+  const Handle lastHandle = static_cast<Handle>(mIds.size() - 1);
+  if (erasedHandle != lastHandle) {
+    std::size_t lastSlot = mHashes[lastHandle] & mask;
+    while (mSlots[lastSlot] != lastHandle) {
+      lastSlot = (lastSlot + 1) & mask;
+    }
+    mSlots[lastSlot] = erasedHandle;
+    mIds[erasedHandle] = std::move(mIds[lastHandle]);
+    mHashes[erasedHandle] = mHashes[lastHandle];
+  }
+  mIds.pop_back();
+  mHashes.pop_back();
+  return true;
+}
+
+Handle IdRegistry::find(const std::string &id) const {
+  if (mSlots.empty()) {
+    return InvalidHandle;
+  }
+  return mSlots[findSlot(id, std::hash<std::string>()(id))];
+}
+
+Handle IdRegistry::getHandle(const std::string &id) const {
+  const Handle handle = find(id);
+  if (handle != InvalidHandle) {
+    return handle;
+  } else {
+    throw std::invalid_argument("Cannot find the given id in the registry!");
+  }
+}
+
+const std::string &IdRegistry::getId(const Handle handle) const {
+  if (handle >= mIds.size()) {
+    throw std::out_of_range("The given handle is out of range!");
+  }
+  return mIds[handle];
+}
+
+bool IdRegistry::contains(const std::string &id) const {
+  return find(id) != InvalidHandle;
+}
+
+const std::vector<std::string> &IdRegistry::getIds() const { return mIds; }
+
+Handle IdRegistry::size() const { return static_cast<Handle>(mIds.size()); }
+
+void IdRegistry::reserve(const std::size_t numberOfIds) {
+  mIds.reserve(numberOfIds);
+  mHashes.reserve(numberOfIds);
+  std::size_t numberOfSlots = MinimumNumberOfSlots;
+  while (numberOfSlots < 2 * numberOfIds) {
+    numberOfSlots *= 2;
+  }
+  if (numberOfSlots > mSlots.size()) {
+    rehash(numberOfSlots);
+  }
+}
+
+void IdRegistry::clear() {
+  mIds.clear();
+  mHashes.clear();
+  mSlots.clear();
+}
+
+std::size_t IdRegistry::findSlot(const std::string &id,
+                                 const std::size_t hash) const {
+  const std::size_t mask = mSlots.size() - 1;
+  std::size_t slot = hash & mask;
+  while (mSlots[slot] != InvalidHandle &&
+         (mHashes[mSlots[slot]] != hash || mIds[mSlots[slot]] != id)) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+void IdRegistry::rehash(const std::size_t numberOfSlots) {
+  mSlots.assign(numberOfSlots, InvalidHandle);
+  const std::size_t mask = numberOfSlots - 1;
+  for (std::size_t handle = 0; handle < mIds.size(); ++handle) {
+    std::size_t slot = mHashes[handle] & mask;
+    while (mSlots[slot] != InvalidHandle) {
+      slot = (slot + 1) & mask;
+    }
+    mSlots[slot] = static_cast<Handle>(handle);
+  }
+}
+} // namespace Core
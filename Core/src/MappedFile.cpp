@@ -0,0 +1,45 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+namespace Core {
+MappedFile::MappedFile(const std::string &filePath) {
+  const int file = open(filePath.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw std::runtime_error("Cannot open the file " + filePath + "!");
+  }
+  struct stat status;
+  if (fstat(file, &status) != 0) {
+    close(file);
+    throw std::runtime_error("Cannot read the size of the file " + filePath +
+                             "!");
+  }
+  mSize = static_cast<std::size_t>(status.st_size);
+  if (mSize > 0) {
+    mData = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+  }
+  // The mapping stays valid after the file is closed
+  close(file);
+  if (mData == MAP_FAILED) {
+    mData = nullptr;
+    throw std::runtime_error("Cannot map the file " + filePath + "!");
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (mData != nullptr) {
+    munmap(mData, mSize);
+  }
+}
+
+const char *MappedFile::data() const {
+  return static_cast<const char *>(mData);
+}
+
+std::size_t MappedFile::size() const { return mSize; }
+} // namespace Core
@@ -0,0 +1,89 @@
+#include "MeasurementImporter.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "NumberParser.h"
+
+namespace Core {
+bool MeasurementImporter::Token::isTerminator() const {
+  return last - first == 3 && std::memcmp(first, "-99", 3) == 0;
+}
+
+MeasurementImporter::MappedFiles
+MeasurementImporter::MapFiles(const std::vector<std::string> &filePaths) {
+  MappedFiles files;
+  files.reserve(filePaths.size());
+  for (const auto &filePath : filePaths) {
+    files.emplace_back(new MappedFile(filePath));
+  }
+  return files;
+}
+
+std::vector<MeasurementImporter::Piece>
+MeasurementImporter::SplitIntoPieces(const MappedFiles &files,
+                                     const std::size_t pieceSize) {
+  std::vector<Piece> pieces;
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    const char *first = files[i]->data();
+    const char *last = first + files[i]->size();
+    while (first != last) {
+      const char *position = first;
+      if (static_cast<std::size_t>(last - first) > pieceSize) {
+        // Skip to the next line after the minimum size, and end the piece
+        // after the next terminator line
+        position = static_cast<const char *>(
+            std::memchr(first + pieceSize, '\n',
+                        static_cast<std::size_t>(last - first) - pieceSize));
+        position = position == nullptr ? last : position + 1;
+        Token token;
+        while (ReadLine(position, last, &token, 1) != 0 &&
+               !token.isTerminator()) {
+        }
+      } else {
+        position = last;
+      }
+      pieces.push_back({i, first, position, InvalidHandle});
+      first = position;
+    }
+  }
+  return pieces;
+}
+
+std::size_t MeasurementImporter::ReadLine(const char *&position,
+                                          const char *last, Token *tokens,
+                                          const std::size_t maxTokens) {
+  std::size_t numberOfTokens = 0;
+  while (position != last && numberOfTokens == 0) {
+    while (position != last && *position != '\n') {
+      if (IsWhitespace(*position)) {
+        ++position;
+        continue;
+      }
+      const char *first = position;
+      while (position != last && !IsWhitespace(*position)) {
+        ++position;
+      }
+      if (numberOfTokens < maxTokens) {
+        tokens[numberOfTokens] = {first, position};
+      }
+      ++numberOfTokens;
+    }
+    if (position != last) {
+      ++position;
+    }
+  }
+  return numberOfTokens;
+}
+
+double MeasurementImporter::ParseCoordinate(const Token &token,
+                                            const std::string &filePath) {
+  const char *position = token.first;
+  double value;
+  if (!ParseDouble(position, token.last, value) || position != token.last) {
+    throw std::runtime_error("Invalid coordinate " + token.toString() +
+                             " in the file " + filePath + "!");
+  }
+  return value;
+}
+} // namespace Core
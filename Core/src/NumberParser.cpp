@@ -0,0 +1,140 @@
+#include "NumberParser.h"
+
+#include <cmath>
+#include <limits>
+
+namespace Core {
+namespace {
+/// Maximum number of significant digits kept in the mantissa
+constexpr int MaximumDigits = 19;
+
+/// Check if the character is a decimal digit
+bool IsDigit(const char character) {
+  return static_cast<unsigned int>(character - '0') < 10u;
+}
+
+/// Compute 10^exponent in extended precision (exact up to 10^27)
+long double Pow10(const int exponent) {
+  static const long double powers[] = {
+      1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,  1e9L,
+      1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+      1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L};
+  if (exponent >= 0 && exponent <= 27) {
+    return powers[exponent];
+  }
+  return std::pow(10.0L, static_cast<long double>(exponent));
+}
+} // namespace
+
+bool ParseDouble(const char *&first, const char *last, double &value) {
+  const char *position = first;
+  bool isNegative = false;
+  if (position != last && (*position == '-' || *position == '+')) {
+    isNegative = *position == '-';
+    ++position;
+  }
+  std::uint64_t mantissa = 0;
+  int numberOfDigits = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  // Integer part
+  for (; position != last && IsDigit(*position); ++position) {
+    hasDigits = true;
+    if (numberOfDigits < MaximumDigits) {
+      mantissa = 10 * mantissa + static_cast<unsigned int>(*position - '0');
+      numberOfDigits += mantissa != 0 ? 1 : 0;
+    } else {
+      ++exponent;
+    }
+  }
+  // Fractional part
+  if (position != last && *position == '.') {
+    ++position;
+    for (; position != last && IsDigit(*position); ++position) {
+      hasDigits = true;
+      if (numberOfDigits < MaximumDigits) {
+        mantissa = 10 * mantissa + static_cast<unsigned int>(*position - '0');
+        numberOfDigits += mantissa != 0 ? 1 : 0;
+        --exponent;
+      }
+    }
+  }
+  if (!hasDigits) {
+    return false;
+  }
+  // Exponent, which is only consumed if it has digits
+  if (position != last && (*position == 'e' || *position == 'E')) {
+    const char *exponentPosition = position + 1;
+    bool isNegativeExponent = false;
+    if (exponentPosition != last &&
+        (*exponentPosition == '-' || *exponentPosition == '+')) {
+      isNegativeExponent = *exponentPosition == '-';
+      ++exponentPosition;
+    }
+    if (exponentPosition != last && IsDigit(*exponentPosition)) {
+      int explicitExponent = 0;
+      for (; exponentPosition != last && IsDigit(*exponentPosition);
+           ++exponentPosition) {
+        // Saturate far beyond the range of double
+        if (explicitExponent < 100000) {
+          explicitExponent =
+              10 * explicitExponent + (*exponentPosition - '0');
+        }
+      }
+      exponent += isNegativeExponent ? -explicitExponent : explicitExponent;
+      position = exponentPosition;
+    }
+  }
+
+  double magnitude;
+  if (mantissa == 0) {
+    magnitude = 0.0;
+  } else if (mantissa < (std::uint64_t(1) << 53) && exponent >= -22 &&
+             exponent <= 22) {
+    // Both operands are exact, so the result is correctly rounded
+    const double scale = static_cast<double>(Pow10(std::abs(exponent)));
+    magnitude = exponent < 0 ? static_cast<double>(mantissa) / scale
+                             : static_cast<double>(mantissa) * scale;
+  } else if (exponent < -4950) {
+    magnitude = 0.0;
+  } else if (exponent > 4950) {
+    magnitude = std::numeric_limits<double>::infinity();
+  } else {
+    // Extended precision keeps the 64-bit mantissa exact
+    const long double scale = Pow10(std::abs(exponent));
+    magnitude = static_cast<double>(
+        exponent < 0 ? static_cast<long double>(mantissa) / scale
+                     : static_cast<long double>(mantissa) * scale);
+  }
+  value = isNegative ? -magnitude : magnitude;
+  first = position;
+  return true;
+}
+
+bool ParseInteger(const char *&first, const char *last, std::int64_t &value) {
+  const char *position = first;
+  bool isNegative = false;
+  if (position != last && (*position == '-' || *position == '+')) {
+    isNegative = *position == '-';
+    ++position;
+  }
+  if (position == last || !IsDigit(*position)) {
+    return false;
+  }
+  std::uint64_t magnitude = 0;
+  const std::uint64_t limit =
+      static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) +
+      (isNegative ? 1 : 0);
+  for (; position != last && IsDigit(*position); ++position) {
+    const unsigned int digit = static_cast<unsigned int>(*position - '0');
+    if (magnitude > (limit - digit) / 10) {
+      return false;
+    }
+    magnitude = 10 * magnitude + digit;
+  }
+  value = isNegative ? static_cast<std::int64_t>(0 - magnitude)
+                     : static_cast<std::int64_t>(magnitude);
+  first = position;
+  return true;
+}
+} // namespace Core
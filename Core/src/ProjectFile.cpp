@@ -0,0 +1,290 @@
+#include "ProjectFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace Core {
+namespace {
+/// Magic number of project files
+constexpr char Magic[8] = {'B', 'A', 'P', 'R', 'O', 'J', '\0', '\0'};
+constexpr std::uint32_t ByteOrderMark = 0x01020304;
+/// Alignment of the sections
+constexpr std::uint64_t Alignment = 8;
+
+std::uint64_t Align(const std::uint64_t offset) {
+  return (offset + Alignment - 1) / Alignment * Alignment;
+}
+} // namespace
+
+constexpr std::uint32_t ProjectFile::Version;
+
+ProjectFile::ProjectFile(const std::string &filePath) : mFile(filePath) {
+  const std::size_t fileSize = mFile.size();
+  if (fileSize < sizeof(FileHeader)) {
+    throw std::runtime_error(filePath + " is not a project file!");
+  }
+  mHeader = reinterpret_cast<const FileHeader *>(mFile.data());
+  if (std::memcmp(mHeader->magic, Magic, sizeof(Magic)) != 0) {
+    throw std::runtime_error(filePath + " is not a project file!");
+  }
+  if (mHeader->byteOrderMark != ByteOrderMark) {
+    throw std::runtime_error("The byte order of the project file " +
+                             filePath + " is not supported!");
+  }
+  if (mHeader->version != Version) {
+    throw std::runtime_error("The version of the project file " + filePath +
+                             " is not supported!");
+  }
+  const std::uint64_t tableSize =
+      static_cast<std::uint64_t>(mHeader->numberOfSections) *
+      sizeof(SectionEntry);
+  if (fileSize - sizeof(FileHeader) < tableSize) {
+    throw std::runtime_error("The section table of the project file " +
+                             filePath + " is truncated!");
+  }
+  mSections =
+      reinterpret_cast<const SectionEntry *>(mFile.data() + sizeof(FileHeader));
+  for (std::uint32_t i = 0; i < mHeader->numberOfSections; ++i) {
+    // Note: The sizes are checked by divisions, which cannot overflow
+    const SectionEntry &section = mSections[i];
+    if (section.offset % Alignment != 0 || section.offset > fileSize ||
+        section.size > fileSize - section.offset ||
+        (section.elementSize != 0 &&
+         (section.count > section.size / section.elementSize ||
+          section.size != section.count * section.elementSize))) {
+      throw std::runtime_error("The project file " + filePath +
+                               " has an invalid section!");
+    }
+    if (section.elementSize == 0 && !isValidStringTable(section)) {
+      throw std::runtime_error("The project file " + filePath +
+                               " has an invalid string table!");
+    }
+  }
+}
+
+std::uint32_t ProjectFile::getVersion() const { return mHeader->version; }
+
+std::size_t ProjectFile::getNumberOfCameras() const {
+  const SectionEntry *section = findSection(SectionType::CameraRecords);
+  return section == nullptr ? 0 : static_cast<std::size_t>(section->count);
+}
+
+std::size_t ProjectFile::getNumberOfImages() const {
+  const SectionEntry *section = findSection(SectionType::ImageRecords);
+  return section == nullptr ? 0 : static_cast<std::size_t>(section->count);
+}
+
+std::size_t ProjectFile::getNumberOfObjectPoints() const {
+  const SectionEntry *section = findSection(SectionType::ObjectPoints);
+  return section == nullptr ? 0 : static_cast<std::size_t>(section->count);
+}
+
+std::size_t ProjectFile::getNumberOfObservations() const {
+  const SectionEntry *section =
+      findSection(SectionType::ObservationImageHandles);
+  return section == nullptr ? 0 : static_cast<std::size_t>(section->count);
+}
+
+const ProjectFile::CameraRecord *ProjectFile::getCameraRecords() const {
+  return static_cast<const CameraRecord *>(
+      getSection(SectionType::CameraRecords, sizeof(CameraRecord),
+                 getNumberOfCameras()));
+}
+
+const double *
+ProjectFile::getCameraParameters(const Handle cameraHandle) const {
+  if (cameraHandle >= getNumberOfCameras()) {
+    throw std::out_of_range("Cannot find the given camera in the project!");
+  }
+  const CameraRecord &record = getCameraRecords()[cameraHandle];
+  const SectionEntry *section = findSection(SectionType::CameraParameters);
+  if (section == nullptr || section->elementSize != sizeof(double) ||
+      record.parameterOffset > section->count ||
+      record.numberOfParameters > section->count - record.parameterOffset) {
+    throw std::runtime_error("The project has invalid camera parameters!");
+  }
+  return reinterpret_cast<const double *>(mFile.data() + section->offset) +
+         record.parameterOffset;
+}
+
+ProjectFile::StringTable ProjectFile::getCameraIds() const {
+  return getStringTable(SectionType::CameraIds, getNumberOfCameras());
+}
+
+const ProjectFile::ImageRecord *ProjectFile::getImageRecords() const {
+  return static_cast<const ImageRecord *>(getSection(
+      SectionType::ImageRecords, sizeof(ImageRecord), getNumberOfImages()));
+}
+
+ProjectFile::StringTable ProjectFile::getImageIds() const {
+  return getStringTable(SectionType::ImageIds, getNumberOfImages());
+}
+
+ProjectFile::StringTable ProjectFile::getImageFilePaths() const {
+  return getStringTable(SectionType::ImageFilePaths, getNumberOfImages());
+}
+
+const double *ProjectFile::getObjectPoints() const {
+  return static_cast<const double *>(
+      getSection(SectionType::ObjectPoints, 3 * sizeof(double),
+                 getNumberOfObjectPoints()));
+}
+
+ProjectFile::StringTable ProjectFile::getObjectPointIds() const {
+  return getStringTable(SectionType::ObjectPointIds,
+                        getNumberOfObjectPoints());
+}
+
+ProjectFile::ObservationView ProjectFile::getObservations() const {
+  ObservationView view;
+  view.size = getNumberOfObservations();
+  view.imageHandles = static_cast<const Handle *>(getSection(
+      SectionType::ObservationImageHandles, sizeof(Handle), view.size));
+  view.pointHandles = static_cast<const Handle *>(getSection(
+      SectionType::ObservationPointHandles, sizeof(Handle), view.size));
+  view.cameraHandles = static_cast<const Handle *>(getSection(
+      SectionType::ObservationCameraHandles, sizeof(Handle), view.size));
+  view.x = static_cast<const double *>(
+      getSection(SectionType::ObservationX, sizeof(double), view.size));
+  view.y = static_cast<const double *>(
+      getSection(SectionType::ObservationY, sizeof(double), view.size));
+  view.sqrtInformation = static_cast<const double *>(
+      getSection(SectionType::ObservationSqrtInformation, 3 * sizeof(double),
+                 view.size));
+  return view;
+}
+
+std::uint32_t ProjectFile::getObservationSortOrder() const {
+  return mHeader->observationSortOrder;
+}
+
+std::vector<char>
+ProjectFile::PackStrings(const std::vector<std::string> &strings) {
+  std::vector<std::uint64_t> offsets(strings.size() + 1, 0);
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    offsets[i + 1] = offsets[i] + strings[i].size();
+  }
+  const std::size_t offsetSize = offsets.size() * sizeof(std::uint64_t);
+  std::vector<char> packedStrings(offsetSize + offsets.back());
+  std::memcpy(packedStrings.data(), offsets.data(), offsetSize);
+  char *characters = packedStrings.data() + offsetSize;
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    std::memcpy(characters + offsets[i], strings[i].data(),
+                strings[i].size());
+  }
+  return packedStrings;
+}
+
+void ProjectFile::WriteSections(const std::string &filePath,
+                                const std::uint32_t observationSortOrder,
+                                const std::vector<SectionData> &sections) {
+  FileHeader header;
+  std::memcpy(header.magic, Magic, sizeof(Magic));
+  header.version = Version;
+  header.byteOrderMark = ByteOrderMark;
+  header.numberOfSections = static_cast<std::uint32_t>(sections.size());
+  header.observationSortOrder = observationSortOrder;
+
+  // Lay out the sections after the section table
+  std::vector<SectionEntry> table(sections.size());
+  std::uint64_t offset =
+      Align(sizeof(FileHeader) + sections.size() * sizeof(SectionEntry));
+  for (std::size_t i = 0; i < sections.size(); ++i) {
+    table[i].type = static_cast<std::uint32_t>(sections[i].type);
+    table[i].elementSize = sections[i].elementSize;
+    table[i].count = sections[i].count;
+    table[i].offset = offset;
+    table[i].size = sections[i].size;
+    offset = Align(offset + sections[i].size);
+  }
+
+  std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Cannot open the project file " + filePath +
+                             "!");
+  }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(FileHeader));
+  file.write(reinterpret_cast<const char *>(table.data()),
+             static_cast<std::streamsize>(table.size() *
+                                          sizeof(SectionEntry)));
+  const char padding[Alignment] = {};
+  std::uint64_t position =
+      sizeof(FileHeader) + sections.size() * sizeof(SectionEntry);
+  for (std::size_t i = 0; i < sections.size(); ++i) {
+    file.write(padding, static_cast<std::streamsize>(table[i].offset -
+                                                     position));
+    file.write(static_cast<const char *>(sections[i].data),
+               static_cast<std::streamsize>(sections[i].size));
+    position = table[i].offset + sections[i].size;
+  }
+  if (!file) {
+    throw std::runtime_error("Cannot write the project file " + filePath +
+                             "!");
+  }
+}
+
+bool ProjectFile::isValidStringTable(const SectionEntry &section) const {
+  // (count + 1) offsets, which start at 0, never decrease, and end at the
+  // number of characters
+  if (section.count >= section.size / sizeof(std::uint64_t)) {
+    return false;
+  }
+  const auto *offsets = reinterpret_cast<const std::uint64_t *>(
+      mFile.data() + section.offset);
+  const std::uint64_t numberOfCharacters =
+      section.size - (section.count + 1) * sizeof(std::uint64_t);
+  if (offsets[0] != 0 || offsets[section.count] != numberOfCharacters) {
+    return false;
+  }
+  for (std::uint64_t i = 0; i < section.count; ++i) {
+    if (offsets[i] > offsets[i + 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const ProjectFile::SectionEntry *
+ProjectFile::findSection(const SectionType type) const {
+  for (std::uint32_t i = 0; i < mHeader->numberOfSections; ++i) {
+    if (mSections[i].type == static_cast<std::uint32_t>(type)) {
+      return &mSections[i];
+    }
+  }
+  return nullptr;
+}
+
+const void *ProjectFile::getSection(const SectionType type,
+                                    const std::uint32_t elementSize,
+                                    const std::size_t count) const {
+  const SectionEntry *section = findSection(type);
+  if (count == 0 && (section == nullptr || section->count == 0)) {
+    return nullptr;
+  }
+  if (section == nullptr || section->elementSize != elementSize ||
+      section->count != count) {
+    throw std::runtime_error("The project has an invalid section!");
+  }
+  return mFile.data() + section->offset;
+}
+
+ProjectFile::StringTable
+ProjectFile::getStringTable(const SectionType type,
+                            const std::size_t count) const {
+  const SectionEntry *section = findSection(type);
+  if (count == 0 && (section == nullptr || section->count == 0)) {
+    return StringTable();
+  }
+  if (section == nullptr || section->elementSize != 0 ||
+      section->count != count) {
+    throw std::runtime_error("The project has an invalid string table!");
+  }
+  // Note: The offsets have been validated by the constructor
+  const auto *offsets = reinterpret_cast<const std::uint64_t *>(
+      mFile.data() + section->offset);
+  const std::uint64_t offsetSize = (count + 1) * sizeof(std::uint64_t);
+  return StringTable(offsets, mFile.data() + section->offset + offsetSize,
+                     count);
+}
+} // namespace Core
@@ -0,0 +1,110 @@
+#include "SbetReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Core {
+namespace {
+/// Semi-major axis and squared first eccentricity of the WGS84 ellipsoid
+constexpr double SemiMajorAxis = 6378137.0;
+constexpr double Eccentricity2 = 6.69437999014e-3;
+
+/// Convert geodetic coordinates (in radians and meters) to ECEF coordinates
+Eigen::Vector3d ConvertGeodeticToECEF(const double latitude,
+                                      const double longitude,
+                                      const double altitude) {
+  const double sinLatitude = std::sin(latitude);
+  const double cosLatitude = std::cos(latitude);
+  // Prime vertical radius of curvature
+  const double radius = SemiMajorAxis / std::sqrt(1.0 - Eccentricity2 *
+                                                            sinLatitude *
+                                                            sinLatitude);
+  return Eigen::Vector3d(
+      (radius + altitude) * cosLatitude * std::cos(longitude),
+      (radius + altitude) * cosLatitude * std::sin(longitude),
+      (radius * (1.0 - Eccentricity2) + altitude) * sinLatitude);
+}
+
+/// Rotation from the local tangent plane (i.e., east, north and up) at the
+/// given latitude and longitude to ECEF
+Eigen::Matrix3d CreateLocalToECEFRotation(const double latitude,
+                                          const double longitude) {
+  const double sinLatitude = std::sin(latitude);
+  const double cosLatitude = std::cos(latitude);
+  const double sinLongitude = std::sin(longitude);
+  const double cosLongitude = std::cos(longitude);
+  Eigen::Matrix3d rotation;
+  rotation << -sinLongitude, -sinLatitude * cosLongitude,
+      cosLatitude * cosLongitude,
+      // 2nd row
+      cosLongitude, -sinLatitude * sinLongitude, cosLatitude * sinLongitude,
+      // 3rd row
+      0.0, cosLatitude, sinLatitude;
+  return rotation;
+}
+} // namespace
+
+/// LocalTangentPlaneConverter
+SbetReader::LocalTangentPlaneConverter::LocalTangentPlaneConverter(
+    const double latitude, const double longitude, const double altitude)
+    : mOrigin(ConvertGeodeticToECEF(latitude, longitude, altitude)),
+      mRotation(CreateLocalToECEFRotation(latitude, longitude).transpose()) {}
+
+void SbetReader::LocalTangentPlaneConverter::operator()(
+    const Record &record, Trajectory<double>::PositionType &position,
+    Trajectory<double>::AttitudeType &attitude) const {
+  position = mRotation * (ConvertGeodeticToECEF(record.latitude,
+                                                record.longitude,
+                                                record.altitude) -
+                          mOrigin);
+  // Body frame -> north, east and down -> east, north and up at the record
+  // -> ECEF -> east, north and up at the origin
+  // Note: The platform heading is relative to the wander frame, i.e., the
+  // true heading is heading - wanderAngle.
+  const double trueHeading = record.heading - record.wanderAngle;
+  const Eigen::Matrix3d bodyToNED =
+      (Eigen::AngleAxisd(trueHeading, Eigen::Vector3d::UnitZ()) *
+       Eigen::AngleAxisd(record.pitch, Eigen::Vector3d::UnitY()) *
+       Eigen::AngleAxisd(record.roll, Eigen::Vector3d::UnitX()))
+          .toRotationMatrix();
+  Eigen::Matrix3d nedToENU;
+  nedToENU << 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, -1.0;
+  attitude = Trajectory<double>::AttitudeType(
+      mRotation * CreateLocalToECEFRotation(record.latitude, record.longitude) *
+      nedToENU * bodyToNED);
+}
+
+/// SbetReader
+SbetReader::SbetReader(const std::string &filePath) : mFile(filePath) {
+  if (mFile.size() % sizeof(Record) != 0) {
+    throw std::invalid_argument("The size of the SBET file " + filePath +
+                                " is not a multiple of the record size!");
+  }
+  mRecords = reinterpret_cast<const Record *>(mFile.data());
+  mSize = mFile.size() / sizeof(Record);
+}
+
+std::size_t SbetReader::size() const { return mSize; }
+
+const SbetReader::Record *SbetReader::getRecords() const { return mRecords; }
+
+const SbetReader::Record &
+SbetReader::operator[](const std::size_t index) const {
+  if (index >= mSize) {
+    throw std::out_of_range("Cannot find the given record in the SBET file!");
+  }
+  return mRecords[index];
+}
+
+double SbetReader::getStartTime() const { return (*this)[0].time; }
+
+double SbetReader::getEndTime() const { return (*this)[mSize - 1].time; }
+
+std::size_t SbetReader::findRecord(const double time) const {
+  const Record *record = std::lower_bound(
+      mRecords, mRecords + mSize, time,
+      [](const Record &lhs, const double rhs) { return lhs.time < rhs; });
+  return static_cast<std::size_t>(record - mRecords);
+}
+} // namespace Core
@@ -0,0 +1,406 @@
+#include "SyntheticBlockGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "eigen3/Eigen/Geometry"
+
+#include "Parallel.h"
+#include "RandomNumber.h"
+
+namespace Core {
+namespace {
+constexpr double Pi = 3.14159265358979323846;
+
+double ToRadians(const double degrees) { return degrees * Pi / 180.0; }
+
+/// Observations of an image
+struct ImageObservations {
+  std::vector<Handle> pointIndices;
+  std::vector<double> x;
+  std::vector<double> y;
+};
+
+/// Uniform grid of the object points in the XY plane, with the points of
+/// every cell in CSR format
+struct PointGrid {
+  double origin[2];
+  double cellSize;
+  std::size_t size[2];
+  std::vector<std::size_t> cellOffsets;
+  std::vector<Handle> pointIndices;
+
+  PointGrid(const std::vector<double> &points, const double *minimum,
+            const double *maximum, const double gridCellSize)
+      : origin{minimum[0], minimum[1]}, cellSize(gridCellSize) {
+    for (int i = 0; i < 2; ++i) {
+      size[i] = static_cast<std::size_t>(
+                    std::ceil((maximum[i] - minimum[i]) / cellSize)) +
+                1;
+    }
+    const std::size_t numberOfPoints = points.size() / 3;
+    std::vector<std::size_t> cells(numberOfPoints);
+    cellOffsets.assign(size[0] * size[1] + 1, 0);
+    for (std::size_t i = 0; i < numberOfPoints; ++i) {
+      cells[i] = getIndex(getCell(points[3 * i], 0),
+                          getCell(points[3 * i + 1], 1));
+      ++cellOffsets[cells[i] + 1];
+    }
+    for (std::size_t i = 1; i < cellOffsets.size(); ++i) {
+      cellOffsets[i] += cellOffsets[i - 1];
+    }
+    pointIndices.resize(numberOfPoints);
+    std::vector<std::size_t> positions(cellOffsets.begin(),
+                                       cellOffsets.end() - 1);
+    for (std::size_t i = 0; i < numberOfPoints; ++i) {
+      pointIndices[positions[cells[i]]++] = static_cast<Handle>(i);
+    }
+  }
+
+  /// Get the cell of a coordinate (clamped to the grid)
+  std::size_t getCell(const double value, const int axis) const {
+    const double cell = std::floor((value - origin[axis]) / cellSize);
+    return static_cast<std::size_t>(
+        std::min(std::max(cell, 0.0), static_cast<double>(size[axis] - 1)));
+  }
+
+  std::size_t getIndex(const std::size_t column, const std::size_t row) const {
+    return row * size[0] + column;
+  }
+};
+} // namespace
+
+double SyntheticBlockGenerator::GetTerrainHeight(const Options &options,
+                                                 const double x,
+                                                 const double y) {
+  const double frequency = 2.0 * Pi / options.terrainWavelength;
+  return options.terrainAmplitude *
+         (0.7 * std::sin(frequency * x) * std::cos(0.8 * frequency * y) +
+          0.3 * std::sin(2.7 * frequency * (x + 2.0 * y) + 1.0));
+}
+
+SyntheticBlockGenerator::Geometry
+SyntheticBlockGenerator::GetGeometry(const Options &options) {
+  if (options.numberOfStrips == 0 || options.numberOfExposuresPerStrip == 0) {
+    throw std::invalid_argument("The block has no exposures!");
+  }
+  if (options.forwardOverlap < 0.0 || options.forwardOverlap >= 1.0 ||
+      options.sideOverlap < 0.0 || options.sideOverlap >= 1.0) {
+    throw std::invalid_argument("Overlaps have to be in [0, 1)!");
+  }
+  if (options.width == 0 || options.height == 0 || options.pixelSize <= 0.0 ||
+      options.focalLength <= 0.0 || options.flyingHeight <= 0.0 ||
+      options.speed <= 0.0 || options.trajectoryRate <= 0.0 ||
+      options.terrainWavelength <= 0.0 || options.maximumDistance <= 1.0) {
+    throw std::invalid_argument("Invalid camera or flight parameters!");
+  }
+  Geometry geometry;
+  const double groundSampleDistance =
+      options.pixelSize * options.flyingHeight / options.focalLength;
+  geometry.footprint[0] = options.width * groundSampleDistance;
+  geometry.footprint[1] = options.height * groundSampleDistance;
+  geometry.base = (1.0 - options.forwardOverlap) * geometry.footprint[0];
+  geometry.stripSpacing = (1.0 - options.sideOverlap) * geometry.footprint[1];
+  geometry.stripLength =
+      (options.numberOfExposuresPerStrip - 1) * geometry.base;
+  geometry.leadIn = geometry.base + options.speed;
+  geometry.stripInterval =
+      (geometry.stripLength + 2.0 * geometry.leadIn) / options.speed +
+      options.turnDuration;
+  return geometry;
+}
+
+void SyntheticBlockGenerator::GetBodyPose(
+    const Options &options, const Geometry &geometry, const unsigned int strip,
+    const double distance, double &time, Eigen::Matrix3d &rotation,
+    Eigen::Vector3d &position) {
+  time = strip * geometry.stripInterval +
+         (geometry.leadIn + distance) / options.speed;
+  const bool isForward = strip % 2 == 0;
+  position[0] = isForward ? distance : geometry.stripLength - distance;
+  position[1] = strip * geometry.stripSpacing;
+  position[2] = options.flyingHeight + 3.0 * std::sin(2.0 * Pi * time / 40.0);
+  const double roll = ToRadians(0.5) * std::sin(2.0 * Pi * time / 17.0);
+  const double pitch = ToRadians(0.3) * std::sin(2.0 * Pi * time / 23.0 + 1.0);
+  const double heading = (isForward ? 0.0 : Pi) +
+                         ToRadians(0.2) * std::sin(2.0 * Pi * time / 31.0);
+  rotation = (Eigen::AngleAxisd(heading, Eigen::Vector3d::UnitZ()) *
+              Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) *
+              Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX()))
+                 .toRotationMatrix();
+}
+
+SyntheticBlockGenerator::Block
+SyntheticBlockGenerator::Create(const Options &options) {
+  const Geometry geometry = GetGeometry(options);
+  Block block;
+  block.options = options;
+
+  // Rig of a nadir camera and four oblique cameras, which look forward
+  // (i.e., along x of the body frame), backward, left (y) and right
+  Camera nadir;
+  nadir.id = nadir.referenceCameraId = "nadir";
+  // Boresight angles of a few hundredths of a degree
+  nadir.rotation =
+      (Eigen::AngleAxisd(ToRadians(0.05), Eigen::Vector3d::UnitZ()) *
+       Eigen::AngleAxisd(ToRadians(-0.03), Eigen::Vector3d::UnitY()) *
+       Eigen::AngleAxisd(ToRadians(0.02), Eigen::Vector3d::UnitX()))
+          .toRotationMatrix();
+  nadir.translation = Eigen::Vector3d(0.05, -0.1, -0.3);
+  block.cameras.push_back(nadir);
+  if (options.hasObliqueCameras) {
+    const double angle = ToRadians(options.obliqueAngle);
+    const char *ids[4] = {"forward", "backward", "left", "right"};
+    const Eigen::AngleAxisd rotations[4] = {
+        Eigen::AngleAxisd(-angle, Eigen::Vector3d::UnitY()),
+        Eigen::AngleAxisd(angle, Eigen::Vector3d::UnitY()),
+        Eigen::AngleAxisd(angle, Eigen::Vector3d::UnitX()),
+        Eigen::AngleAxisd(-angle, Eigen::Vector3d::UnitX())};
+    const Eigen::Vector3d translations[4] = {
+        Eigen::Vector3d(0.15, 0.0, 0.0), Eigen::Vector3d(-0.15, 0.0, 0.0),
+        Eigen::Vector3d(0.0, 0.15, 0.0), Eigen::Vector3d(0.0, -0.15, 0.0)};
+    for (int i = 0; i < 4; ++i) {
+      Camera oblique;
+      oblique.id = ids[i];
+      oblique.referenceCameraId = nadir.id;
+      oblique.rotation = rotations[i].toRotationMatrix();
+      oblique.translation = translations[i];
+      block.cameras.push_back(oblique);
+    }
+  }
+
+  // Images of all exposures and cameras
+  const std::size_t numberOfCameras = block.cameras.size();
+  block.images.reserve(static_cast<std::size_t>(options.numberOfStrips) *
+                       options.numberOfExposuresPerStrip * numberOfCameras);
+  for (unsigned int strip = 0; strip < options.numberOfStrips; ++strip) {
+    for (unsigned int exposure = 0;
+         exposure < options.numberOfExposuresPerStrip; ++exposure) {
+      Image image;
+      GetBodyPose(options, geometry, strip, exposure * geometry.base,
+                  image.time, image.rotation, image.position);
+      for (std::size_t camera = 0; camera < numberOfCameras; ++camera) {
+        image.id = std::to_string(strip) + "_" + std::to_string(exposure) +
+                   "_" + block.cameras[camera].id;
+        image.cameraIndex = static_cast<std::uint32_t>(camera);
+        block.images.push_back(image);
+      }
+    }
+  }
+
+  // Trajectory along the strips (random stream 1)
+  RandomNormalGenerator navigationNoise(0.0, 1.0, options.seed, 1);
+  const std::size_t recordsPerStrip =
+      static_cast<std::size_t>(
+          (geometry.stripLength + 2.0 * geometry.leadIn) / options.speed *
+          options.trajectoryRate) +
+      1;
+  for (unsigned int strip = 0; strip < options.numberOfStrips; ++strip) {
+    for (std::size_t i = 0; i < recordsPerStrip; ++i) {
+      double time;
+      Eigen::Matrix3d rotation;
+      Eigen::Vector3d position;
+      GetBodyPose(options, geometry, strip,
+                  i * options.speed / options.trajectoryRate - geometry.leadIn,
+                  time, rotation, position);
+      Eigen::Vector3d angles;
+      for (int j = 0; j < 3; ++j) {
+        position[j] +=
+            options.positionSigma * navigationNoise.getRandomNumber();
+        angles[j] = ToRadians(options.attitudeSigma) *
+                    navigationNoise.getRandomNumber();
+      }
+      Eigen::Quaterniond attitude(rotation);
+      if (angles.norm() > 0.0) {
+        attitude *= Eigen::Quaterniond(
+            Eigen::AngleAxisd(angles.norm(), angles.normalized()));
+      }
+      block.trajectoryTimes.push_back(time);
+      block.trajectoryPositions.insert(block.trajectoryPositions.end(),
+                                       position.data(), position.data() + 3);
+      block.trajectoryAttitudes.insert(block.trajectoryAttitudes.end(),
+                                       attitude.coeffs().data(),
+                                       attitude.coeffs().data() + 4);
+    }
+  }
+
+  // Object points on the terrain (random stream 0), in the area of the strips
+  // with a margin of the footprints of all cameras
+  double margin = 0.5 * std::max(geometry.footprint[0], geometry.footprint[1]);
+  if (options.hasObliqueCameras) {
+    margin += options.flyingHeight * std::tan(ToRadians(options.obliqueAngle));
+  }
+  margin = std::min(margin, options.maximumDistance * options.flyingHeight);
+  const double minimum[2] = {-margin, -margin};
+  const double maximum[2] = {
+      geometry.stripLength + margin,
+      (options.numberOfStrips - 1) * geometry.stripSpacing + margin};
+  const double density = options.numberOfPointsPerImage /
+                         (geometry.footprint[0] * geometry.footprint[1]);
+  const std::size_t numberOfPoints = static_cast<std::size_t>(
+      density * (maximum[0] - minimum[0]) * (maximum[1] - minimum[1]));
+  std::vector<double> points(3 * numberOfPoints);
+  RandomDoubleGenerator pointGenerator(0.0, 1.0, options.seed, 0);
+  for (std::size_t i = 0; i < numberOfPoints; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      points[3 * i + j] = minimum[j] + (maximum[j] - minimum[j]) *
+                                           pointGenerator.getRandomNumber();
+    }
+    points[3 * i + 2] =
+        GetTerrainHeight(options, points[3 * i], points[3 * i + 1]);
+  }
+  const PointGrid grid(
+      points, minimum, maximum,
+      0.25 * std::min(geometry.footprint[0], geometry.footprint[1]));
+
+  // Project the points into every image (random stream 2 + image index)
+  const double c = options.focalLength;
+  const double xp = options.principalPoint[0];
+  const double yp = options.principalPoint[1];
+  const double halfWidth = 0.5 * options.width;
+  const double halfHeight = 0.5 * options.height;
+  const double maximumDistance =
+      options.maximumDistance * options.flyingHeight;
+  std::vector<ImageObservations> observations(block.images.size());
+  ParallelFor(
+      block.images.size(),
+      [&](const std::size_t begin, const std::size_t end, const unsigned int) {
+        for (std::size_t index = begin; index < end; ++index) {
+          const Image &image = block.images[index];
+          const Camera &camera = block.cameras[image.cameraIndex];
+          // Camera to mapping frame transformation (see the class
+          // description)
+          Eigen::Vector3d center =
+              image.position + image.rotation * nadir.translation;
+          Eigen::Matrix3d rotation = image.rotation * nadir.rotation;
+          if (image.cameraIndex != 0) {
+            center += rotation * camera.translation;
+            rotation *= camera.rotation;
+          }
+
+          // Bounding box of the footprint on the terrain, i.e., of the
+          // intersections of the corner rays with the lowest and highest
+          // terrain, within the maximum distance
+          double box[4] = {center[0] - maximumDistance,
+                           center[1] - maximumDistance,
+                           center[0] + maximumDistance,
+                           center[1] + maximumDistance};
+          double footprint[4] = {box[2], box[3], box[0], box[1]};
+          bool isBounded = true;
+          for (int corner = 0; corner < 4 && isBounded; ++corner) {
+            const double cornerX =
+                (corner % 2 == 0 ? -halfWidth : halfWidth) *
+                    options.pixelSize -
+                xp;
+            const double cornerY =
+                (corner / 2 == 0 ? -halfHeight : halfHeight) *
+                    options.pixelSize -
+                yp;
+            const Eigen::Vector3d ray =
+                rotation * Eigen::Vector3d(cornerX, cornerY, -c);
+            // Rays above the horizon do not bound the footprint
+            isBounded = ray[2] < -1e-9 * ray.norm();
+            for (int i = 0; i < 2 && isBounded; ++i) {
+              const double height = (i == 0 ? -1.0 : 1.0) *
+                                    options.terrainAmplitude;
+              const Eigen::Vector3d point =
+                  center + (height - center[2]) / ray[2] * ray;
+              for (int j = 0; j < 2; ++j) {
+                footprint[j] = std::min(footprint[j], point[j]);
+                footprint[j + 2] = std::max(footprint[j + 2], point[j]);
+              }
+            }
+          }
+          if (isBounded) {
+            for (int j = 0; j < 2; ++j) {
+              box[j] = std::max(box[j], footprint[j]);
+              box[j + 2] = std::min(box[j + 2], footprint[j + 2]);
+            }
+          }
+          if (box[0] > box[2] || box[1] > box[3]) {
+            continue;
+          }
+
+          RandomNormalGenerator noise(0.0, 1.0, options.seed, 2 + index);
+          ImageObservations &result = observations[index];
+          const std::size_t lastColumn = grid.getCell(box[2], 0);
+          const std::size_t lastRow = grid.getCell(box[3], 1);
+          for (std::size_t row = grid.getCell(box[1], 1); row <= lastRow;
+               ++row) {
+            for (std::size_t column = grid.getCell(box[0], 0);
+                 column <= lastColumn; ++column) {
+              const std::size_t cell = grid.getIndex(column, row);
+              for (std::size_t i = grid.cellOffsets[cell];
+                   i < grid.cellOffsets[cell + 1]; ++i) {
+                const Handle pointIndex = grid.pointIndices[i];
+                const Eigen::Vector3d difference =
+                    Eigen::Map<const Eigen::Vector3d>(
+                        &points[3 * pointIndex]) -
+                    center;
+                const Eigen::Vector3d cameraPoint =
+                    rotation.transpose() * difference;
+                if (cameraPoint[2] >= 0.0 ||
+                    difference.squaredNorm() >
+                        maximumDistance * maximumDistance) {
+                  continue;
+                }
+                const double x = xp - c * cameraPoint[0] / cameraPoint[2];
+                const double y = yp - c * cameraPoint[1] / cameraPoint[2];
+                const double col =
+                    x / options.pixelSize + halfWidth +
+                    options.imageSigma * noise.getRandomNumber();
+                const double imageRow =
+                    halfHeight - y / options.pixelSize +
+                    options.imageSigma * noise.getRandomNumber();
+                if (col < 0.0 || col >= options.width || imageRow < 0.0 ||
+                    imageRow >= options.height) {
+                  continue;
+                }
+                result.pointIndices.push_back(pointIndex);
+                result.x.push_back(col);
+                result.y.push_back(imageRow);
+              }
+            }
+          }
+        }
+      },
+      options.numberOfThreads, 16);
+
+  // Keep the points which are observed in at least two images, in the order
+  // of the grid cells (i.e., with spatially coherent indices)
+  std::vector<Handle> counts(numberOfPoints, 0);
+  std::size_t numberOfObservations = 0;
+  for (const ImageObservations &result : observations) {
+    for (const Handle pointIndex : result.pointIndices) {
+      ++counts[pointIndex];
+    }
+    numberOfObservations += result.pointIndices.size();
+  }
+  std::vector<Handle> indices(numberOfPoints, InvalidHandle);
+  for (const Handle pointIndex : grid.pointIndices) {
+    if (counts[pointIndex] >= 2) {
+      indices[pointIndex] = static_cast<Handle>(block.getNumberOfPoints());
+      block.points.insert(block.points.end(), &points[3 * pointIndex],
+                          &points[3 * pointIndex] + 3);
+    }
+  }
+  block.imageIndices.reserve(numberOfObservations);
+  block.pointIndices.reserve(numberOfObservations);
+  block.x.reserve(numberOfObservations);
+  block.y.reserve(numberOfObservations);
+  for (std::size_t image = 0; image < observations.size(); ++image) {
+    const ImageObservations &result = observations[image];
+    for (std::size_t i = 0; i < result.pointIndices.size(); ++i) {
+      const Handle pointIndex = indices[result.pointIndices[i]];
+      if (pointIndex != InvalidHandle) {
+        block.imageIndices.push_back(static_cast<Handle>(image));
+        block.pointIndices.push_back(pointIndex);
+        block.x.push_back(result.x[i]);
+        block.y.push_back(result.y[i]);
+      }
+    }
+  }
+  return block;
+}
+} // namespace Core
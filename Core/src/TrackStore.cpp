@@ -0,0 +1,103 @@
+#include "TrackStore.h"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace Core {
+void TrackStore::build(const std::vector<Handle> &pointHandles,
+                       const std::vector<Handle> &imageHandles,
+                       const std::size_t numberOfPoints,
+                       const std::size_t numberOfImages) {
+  if (pointHandles.size() != imageHandles.size()) {
+    throw std::invalid_argument(
+        "The numbers of point and image handles are different!");
+  }
+  if (pointHandles.size() >=
+      static_cast<std::size_t>(std::numeric_limits<Index>::max())) {
+    throw std::length_error("Too many observations in the track store!");
+  }
+  // Build the rows aside, so that the store is unchanged if a handle is
+  // invalid
+  TrackStore tracks;
+  BuildRows(pointHandles, numberOfPoints, tracks.mPointOffsets,
+            tracks.mPointObservations);
+  BuildRows(imageHandles, numberOfImages, tracks.mImageOffsets,
+            tracks.mImageObservations);
+  *this = std::move(tracks);
+}
+
+void TrackStore::clear() {
+  mPointOffsets.clear();
+  mPointObservations.clear();
+  mImageOffsets.clear();
+  mImageObservations.clear();
+}
+
+TrackStore::Range
+TrackStore::getPointObservations(const Handle pointHandle) const {
+  if (pointHandle >= getNumberOfPoints()) {
+    throw std::out_of_range("Cannot find the given point in the track store!");
+  }
+  const Index *observations = mPointObservations.data();
+  return Range(observations + mPointOffsets[pointHandle],
+               observations + mPointOffsets[pointHandle + 1]);
+}
+
+TrackStore::Range
+TrackStore::getImageObservations(const Handle imageHandle) const {
+  if (imageHandle >= getNumberOfImages()) {
+    throw std::out_of_range("Cannot find the given image in the track store!");
+  }
+  const Index *observations = mImageObservations.data();
+  return Range(observations + mImageOffsets[imageHandle],
+               observations + mImageOffsets[imageHandle + 1]);
+}
+
+std::size_t TrackStore::getTrackLength(const Handle pointHandle) const {
+  return getPointObservations(pointHandle).size();
+}
+
+std::size_t TrackStore::getNumberOfPoints() const {
+  return mPointOffsets.empty() ? 0 : mPointOffsets.size() - 1;
+}
+
+std::size_t TrackStore::getNumberOfImages() const {
+  return mImageOffsets.empty() ? 0 : mImageOffsets.size() - 1;
+}
+
+std::size_t TrackStore::getNumberOfObservations() const {
+  return mPointObservations.size();
+}
+
+std::size_t TrackStore::getMemoryUsage() const {
+  return sizeof(Index) *
+         (mPointOffsets.capacity() + mPointObservations.capacity() +
+          mImageOffsets.capacity() + mImageObservations.capacity());
+}
+
+void TrackStore::BuildRows(const std::vector<Handle> &keys,
+                           const std::size_t numberOfRows,
+                           std::vector<Index> &offsets,
+                           std::vector<Index> &indices) {
+  // Count the observations of every row
+  offsets.assign(numberOfRows + 1, 0);
+  for (const Handle key : keys) {
+    if (key >= numberOfRows) {
+      throw std::invalid_argument(
+          "Cannot find the given handle in the image block!");
+    }
+    ++offsets[key + 1];
+  }
+  for (std::size_t row = 0; row < numberOfRows; ++row) {
+    offsets[row + 1] += offsets[row];
+  }
+
+  // Scatter the observation indices, which keeps them in ascending order
+  indices.resize(keys.size());
+  std::vector<Index> positions(offsets.begin(), offsets.end() - 1);
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    indices[positions[keys[i]]++] = static_cast<Index>(i);
+  }
+}
+} // namespace Core